@@ -61,6 +61,7 @@ WARNING: This file was autogenerated by
 #undef H5MD
 #undef SCAFACOS
 #undef GSL
+#undef OPENMP
 // these undefs need to match the externals in ../features.def
 
 """ % (sys.argv[0], time.asctime()))
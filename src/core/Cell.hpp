@@ -19,6 +19,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef CORE_CELL_HPP
 #define CORE_CELL_HPP
 
+#include "CellSoA.hpp"
+#include "VerletList.hpp"
 #include "particle_data.hpp"
 
 #include <utils/Span.hpp>
@@ -99,8 +101,13 @@ class Cell : public ParticleList {
 public:
   neighbors_type m_neighbors;
 
-  /** Interaction pairs */
-  std::vector<std::pair<Particle *, Particle *>> m_verlet_list;
+  /** Interaction pairs, as indices into this cell and
+      its red neighbors */
+  VerletList m_verlet_list;
+
+  /** Packed copy of the particle data, only maintained
+      if CellStructure::use_soa is set. */
+  CellSoA m_soa;
 
   /**
    * @brief All neighbors of the cell.
@@ -0,0 +1,107 @@
+/*
+Copyright (C) 2010-2018 The ESPResSo project
+
+This file is part of ESPResSo.
+
+ESPResSo is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ESPResSo is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef CORE_CELL_SOA_HPP
+#define CORE_CELL_SOA_HPP
+
+#include "particle_data.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Structure-of-arrays mirror of the particles in a cell.
+ *
+ * Holds packed copies of the particle data needed by the
+ * short-range pair loop, so that the distance calculation
+ * and simple pair kernels do not have to pull whole @ref Particle
+ * objects through the cache. Entry i corresponds to
+ * ParticleList::part[i] of the owning cell.
+ *
+ * The mirror is only a cache: the particle list stays the
+ * authoritative storage. Positions, types and charges are
+ * gathered with @ref update, forces accumulated into the
+ * packed arrays are added back to the particles with
+ * @ref add_forces.
+ */
+struct CellSoA {
+  /** Folded (or ghost-shifted) positions */
+  std::vector<double> x, y, z;
+  /** Force accumulators */
+  std::vector<double> fx, fy, fz;
+  /** Particle types */
+  std::vector<int> type;
+  /** Particle charges */
+  std::vector<double> q;
+
+  std::size_t size() const { return x.size(); }
+
+  void resize(std::size_t n) {
+    for (auto v : {&x, &y, &z, &fx, &fy, &fz, &q}) {
+      v->resize(n);
+    }
+    type.resize(n);
+  }
+
+  /**
+   * @brief Gather positions, types and charges
+   *        and reset the force accumulators.
+   *
+   * @param parts Particles to mirror.
+   * @param n Number of particles.
+   */
+  void update(Particle const *parts, int n) {
+    resize(n);
+
+    for (int i = 0; i < n; i++) {
+      auto const &p = parts[i];
+      x[i] = p.r.p[0];
+      y[i] = p.r.p[1];
+      z[i] = p.r.p[2];
+      type[i] = p.p.type;
+      q[i] = p.p.q;
+    }
+
+    reset_forces();
+  }
+
+  void reset_forces() {
+    std::fill(fx.begin(), fx.end(), 0.);
+    std::fill(fy.begin(), fy.end(), 0.);
+    std::fill(fz.begin(), fz.end(), 0.);
+  }
+
+  /**
+   * @brief Add the accumulated forces to the particles
+   *        and reset the accumulators.
+   */
+  void add_forces(Particle *parts, int n) {
+    auto const n_soa = std::min(n, static_cast<int>(size()));
+    for (int i = 0; i < n_soa; i++) {
+      auto &f = parts[i].f.f;
+      f[0] += fx[i];
+      f[1] += fy[i];
+      f[2] += fz[i];
+    }
+
+    reset_forces();
+  }
+};
+
+#endif
@@ -136,6 +136,13 @@ struct is_commutative<::detail::Merge<Container, ::detail::IdCompare>,
  * To update the cache particles are sorted by id on the nodes,
  * and the sorted arrays a merged in a reduction tree, until the
  * master node receives a complete and sorted particle array.
+ * Invalidation keeps the cached particles, and the nodes keep
+ * a copy of the particles they sent. The next update only sends
+ * the particles that are new on a node or have changed since,
+ * and the ids of the particles that have left the node. Particles
+ * are compared with their flat_equal member, which has to compare
+ * the parts that flat_copy copies. clear() drops the cached
+ * particles, so that the next update sends all particles again.
  *
  * This class can be customized by running a unary operation on
  * the particles. This op is run on all the nodes. It can be used
@@ -162,10 +169,15 @@ class ParticleCache {
   std::unordered_map<int, int> id_index;
   /** The particle data */
   map_type remote_parts;
+  /** Copies of the local particles as of the last update,
+      on all nodes. */
+  map_type m_sent;
   /** State */
   bool m_valid, m_valid_bonds;
+  /** Whether remote_parts can be updated incrementally. */
+  bool m_valid_base;
 
-  Communication::CallbackHandle<> update_cb;
+  Communication::CallbackHandle<bool> update_cb;
   Communication::CallbackHandle<> update_bonds_cb;
 
   /** Functor to get a particle range */
@@ -224,30 +236,116 @@ class ParticleCache {
   /**
    * @brief Actual update implementation.
    *
-   * This gets a new particle range, packs
-   * the particles into a buffer and then
-   * merges these buffers hierarchically to the
-   * master node
+   * This gets a new particle range and compares
+   * it to the particles sent in the last update.
+   * New and modified particles are packed into a
+   * buffer, and these buffers are merged hierarchically
+   * to the master node. The ids of the particles that
+   * are no longer on the node are gathered separately.
+   *
+   * @param full Discard the particles sent in the last
+   *             update and send all particles.
    */
-  void m_update() {
-    remote_parts.clear();
+  void m_update(bool full) {
+    if (full)
+      m_sent.clear();
 
+    map_type local;
+    local.reserve(m_sent.size());
     for (auto const &p : m_parts()) {
       typename map_type::iterator it;
       /* Add the particle to the map */
-      std::tie(it, std::ignore) = remote_parts.emplace(p.flat_copy());
+      std::tie(it, std::ignore) = local.emplace(p.flat_copy());
 
       /* And run the op on it. */
       m_op(*it);
     }
 
+    /* Both sets are sorted by id, so they can be compared
+     * in one pass. */
+    map_type changed;
+    std::vector<int> removed;
+    auto sent = m_sent.begin();
+    for (auto const &p : local) {
+      while ((sent != m_sent.end()) and (sent->identity() < p.identity())) {
+        removed.push_back((sent++)->identity());
+      }
+
+      auto const known =
+          (sent != m_sent.end()) and (sent->identity() == p.identity());
+      if (not(known and sent->flat_equal(p))) {
+        changed.emplace_hint(changed.end(), p);
+      }
+      if (known)
+        ++sent;
+    }
+    for (; sent != m_sent.end(); ++sent) {
+      removed.push_back(sent->identity());
+    }
+    m_sent = std::move(local);
+
     /* Reduce data to the master by merging the flat_sets from
      * the nodes in a reduction tree. */
-    boost::mpi::reduce(m_cb.comm(), remote_parts, remote_parts,
+    boost::mpi::reduce(m_cb.comm(), changed, changed,
                        detail::Merge<map_type, detail::IdCompare>(), 0);
+    Utils::Mpi::gather_buffer(removed, m_cb.comm());
+
+    if (m_cb.comm().rank() == 0) {
+      m_apply(std::move(changed), std::move(removed), full);
+    }
+  }
+
+  /**
+   * @brief Apply an update to remote_parts.
+   *
+   * Master part of m_update(). If no particle was
+   * added or removed, the changed particles are
+   * replaced in place, otherwise the cache is
+   * rebuilt by merging the unchanged particles with
+   * the changed ones.
+   */
+  void m_apply(map_type &&changed, std::vector<int> &&removed, bool full) {
+    if (full) {
+      remote_parts = std::move(changed);
+      m_update_index();
+      return;
+    }
+
+    auto const same_ids =
+        removed.empty() and
+        std::all_of(changed.begin(), changed.end(), [this](Particle const &p) {
+          return id_index.count(p.identity()) != 0;
+        });
+
+    if (same_ids) {
+      for (auto const &p : changed) {
+        remote_parts.begin()[id_index[p.identity()]] = p;
+      }
+      return;
+    }
+
+    std::sort(removed.begin(), removed.end());
+
+    map_type kept;
+    kept.reserve(remote_parts.size());
+    auto ch = changed.begin();
+    for (auto const &p : remote_parts) {
+      while ((ch != changed.end()) and (ch->identity() < p.identity()))
+        ++ch;
+
+      if (((ch != changed.end()) and (ch->identity() == p.identity())) or
+          std::binary_search(removed.begin(), removed.end(), p.identity()))
+        continue;
+
+      kept.emplace_hint(kept.end(), p);
+    }
+
+    remote_parts = detail::Merge<map_type, detail::IdCompare>()(kept, changed);
+    m_update_index();
   }
 
   void m_update_index() {
+    id_index.clear();
     /* Try to avoid rehashing along the way */
     id_index.reserve(remote_parts.size() + 1);
 
@@ -264,8 +362,8 @@ public:
   ParticleCache() = delete;
   ParticleCache(Communication::MpiCallbacks &cb, GetParticles parts,
                 UnaryOp &&op = UnaryOp{})
-      : m_cb(cb), m_valid(false), m_valid_bonds(false),
-        update_cb(&cb, [this]() { m_update(); }),
+      : m_cb(cb), m_valid(false), m_valid_bonds(false), m_valid_base(false),
+        update_cb(&cb, [this](bool full) { m_update(full); }),
         update_bonds_cb(&cb, [this]() { m_update_bonds(); }), m_parts(parts),
         m_op(std::forward<UnaryOp>(op)) {}
   /* Because the this ptr is captured by the callback lambdas,
@@ -277,10 +375,13 @@ public:
 
   /**
    * @brief Clear cache.
+   *
+   * The next update will fetch all particles.
    */
   void clear() {
     id_index.clear();
     remote_parts.clear();
+    m_valid_base = false;
   }
 
   /**
@@ -335,13 +436,12 @@ public:
   bool valid_bonds() const { return m_valid_bonds; }
 
   /**
-   * @brief Invalidate the cache and free memory.
+   * @brief Invalidate the cache.
+   *
+   * The cached particles are kept for the next
+   * incremental update.
    */
   void invalidate() {
-    clear();
-    /* Release memory */
-    remote_parts.shrink_to_fit();
-    /* Adjust state */
     m_valid = false;
     m_valid_bonds = false;
   }
@@ -366,21 +466,23 @@ public:
    * @brief Update particle information.
    *
    * This triggers a global update. All nodes
-   * sort their particle by id, and send them
+   * sort their particle by id, and send the
+   * particles that changed since the last update
    * to the master.
    *
-   * Complexity: 2*N*(1 - 0.5^(log(p) + 1))
+   * Complexity: 2*M*(1 - 0.5^(log(p) + 1)), where M
+   * is the number of changed particles.
    */
   void update() {
     if (m_valid)
       return;
 
-    update_cb();
-
-    m_update();
-    m_update_index();
+    auto const full = not m_valid_base;
+    update_cb(full);
+    m_update(full);
 
     m_valid = true;
+    m_valid_base = true;
   }
 
   /** Number of particles in the config.
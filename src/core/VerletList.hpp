@@ -0,0 +1,107 @@
+/*
+Copyright (C) 2010-2018 The ESPResSo project
+
+This file is part of ESPResSo.
+
+ESPResSo is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ESPResSo is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef CORE_VERLET_LIST_HPP
+#define CORE_VERLET_LIST_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Compact half neighbor list of a cell.
+ *
+ * The partners of the particles of a cell are stored in
+ * compressed row format: row i holds the partners of particle
+ * i of the cell as 32-bit indices. The indices refer to the
+ * concatenation of the particles of the cell itself and of
+ * its neighbor cells, in the order the cells were added with
+ * @ref add_cell. Within a row, the partners are ordered by
+ * this index, so the cell a partner belongs to can be found
+ * by walking through the cell offsets.
+ *
+ * Clearing the list keeps the allocated memory, so that
+ * rebuilding the list does not allocate in the steady state.
+ */
+class VerletList {
+public:
+  using index_type = std::uint32_t;
+
+  /**
+   * @brief Remove all cells and rows, keeping the capacity.
+   */
+  void clear() {
+    m_cell_offsets.clear();
+    m_cell_offsets.push_back(0);
+    m_row_offsets.clear();
+    m_row_offsets.push_back(0);
+    m_partners.clear();
+  }
+
+  /**
+   * @brief Append a cell with n particles to the index range.
+   */
+  void add_cell(int n) {
+    assert(not m_cell_offsets.empty());
+    assert(static_cast<std::size_t>(m_cell_offsets.back()) + n <=
+           std::numeric_limits<index_type>::max());
+    m_cell_offsets.push_back(m_cell_offsets.back() + n);
+  }
+
+  /**
+   * @brief Add particle j of the cell with number cell
+   *        as a partner to the current row.
+   */
+  void add_partner(int cell, int j) {
+    m_partners.push_back(m_cell_offsets[cell] + j);
+  }
+
+  /**
+   * @brief Finish the current row.
+   */
+  void end_row() {
+    m_row_offsets.push_back(static_cast<index_type>(m_partners.size()));
+  }
+
+  /** Number of finished rows */
+  std::size_t n_rows() const { return m_row_offsets.size() - 1; }
+  /** Total number of pairs */
+  std::size_t n_pairs() const { return m_partners.size(); }
+
+  index_type const *row_begin(std::size_t i) const {
+    return m_partners.data() + m_row_offsets[i];
+  }
+  index_type const *row_end(std::size_t i) const {
+    return m_partners.data() + m_row_offsets[i + 1];
+  }
+
+  /** First index of cell c */
+  index_type cell_offset(std::size_t c) const { return m_cell_offsets[c]; }
+
+private:
+  /** Start of the cells in the index range, size n_cells + 1 */
+  std::vector<index_type> m_cell_offsets = {0};
+  /** Start of the rows in m_partners, size n_rows + 1 */
+  std::vector<index_type> m_row_offsets = {0};
+  /** Partner indices of all rows */
+  std::vector<index_type> m_partners;
+};
+
+#endif
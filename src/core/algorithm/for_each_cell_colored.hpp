@@ -0,0 +1,56 @@
+/*
+Copyright (C) 2010-2018 The ESPResSo project
+
+This file is part of ESPResSo.
+
+ESPResSo is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ESPResSo is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef CORE_ALGORITHM_FOR_EACH_CELL_COLORED_HPP
+#define CORE_ALGORITHM_FOR_EACH_CELL_COLORED_HPP
+
+namespace Algorithm {
+/**
+ * @brief Run a kernel on all cells of a range of colors,
+ *        the cells of one color concurrently.
+ *
+ * The colors are processed one after another, the cells
+ * within a color are distributed over the OpenMP threads,
+ * if OpenMP is enabled. The kernel has to be safe to run
+ * concurrently for all the cells of a color, e.g. because
+ * the cells of a color have no common neighbors.
+ *
+ * @param first Iterator to the first color, a color is
+ *        a random access range of cells.
+ * @param last Iterator past the last color.
+ * @param kernel Called with every cell (reference to the
+ *        element of the color).
+ */
+template <typename ColorIterator, typename CellKernel>
+void for_each_cell_colored(ColorIterator first, ColorIterator last,
+                           CellKernel &&kernel) {
+  for (; first != last; ++first) {
+    auto &color = *first;
+    auto const n_cells = static_cast<long>(color.size());
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (long i = 0; i < n_cells; i++) {
+      kernel(color[i]);
+    }
+  }
+}
+} // namespace Algorithm
+
+#endif
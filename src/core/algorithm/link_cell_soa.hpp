@@ -0,0 +1,119 @@
+/*
+Copyright (C) 2010-2018 The ESPResSo project
+
+This file is part of ESPResSo.
+
+ESPResSo is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ESPResSo is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef ALGORITHM_LINK_CELL_SOA_HPP
+#define ALGORITHM_LINK_CELL_SOA_HPP
+
+#include <utils/Vector.hpp>
+
+#include <utility>
+
+namespace Algorithm {
+namespace detail {
+/**
+ * @brief Run the pair kernel for particle i of cell c1 and the
+ *        particles [begin, end) of cell c2, if they are closer
+ *        than the cutoff.
+ *
+ * Only the packed positions are read for the distance check.
+ */
+template <typename Cell, typename PairKernel>
+void soa_particle_cell(Cell &c1, int i, Cell &c2, int begin, int end,
+                       PairKernel &pair_kernel, double cutoff2) {
+  auto const &s1 = c1.m_soa;
+  auto const &s2 = c2.m_soa;
+  auto const xi = s1.x[i], yi = s1.y[i], zi = s1.z[i];
+
+  for (int j = begin; j < end; j++) {
+    auto const dx = xi - s2.x[j];
+    auto const dy = yi - s2.y[j];
+    auto const dz = zi - s2.z[j];
+    auto const dist2 = dx * dx + dy * dy + dz * dz;
+
+    if (dist2 <= cutoff2) {
+      pair_kernel(c1.part[i], c2.part[j], Utils::Vector3d{dx, dy, dz});
+    }
+  }
+}
+} // namespace detail
+
+/**
+ * @brief Iterates over all particles in the cell range,
+ *        and hands every particle together with the
+ *        blocks of partner particles in its own cell
+ *        and the neighbor cells to the block kernel.
+ *
+ * This is the same traversal as @ref link_cell, but instead of
+ * single pairs the block kernel is called as
+ * block_kernel(c1, i, c2, begin, end) for the particle i of
+ * cell c1 and the particles [begin, end) of cell c2. No distance
+ * check is done, this is up to the kernel.
+ */
+template <typename CellIterator, typename ParticleKernel, typename BlockKernel>
+void link_cell_blocks(CellIterator first, CellIterator last,
+                      ParticleKernel &&particle_kernel,
+                      BlockKernel &&block_kernel) {
+  for (; first != last; ++first) {
+    for (int i = 0; i != first->n; i++) {
+      particle_kernel(first->part[i]);
+
+      /* Pairs in this cell */
+      block_kernel(*first, i, *first, i + 1, first->n);
+
+      /* Pairs with neighbors */
+      for (auto &neighbor : first->neighbors().red()) {
+        block_kernel(*first, i, *neighbor, 0, neighbor->n);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Iterates over all particles in the cell range,
+ *        and over all pairs within the cells and with
+ *        their neighbors, using the packed positions
+ *        of the cells.
+ *
+ * This is the same traversal as @ref link_cell, but the
+ * distances are calculated from the packed positions in
+ * Cell::m_soa (Euclidean distance, so only valid for cell
+ * systems where the ghosts carry shifted positions) and
+ * the pair kernel is only called for pairs that are closer
+ * than the cutoff. The mirrors have to be up to date.
+ *
+ * The pair kernel is called with the two particles and the
+ * distance vector p1 - p2.
+ */
+template <typename CellIterator, typename ParticleKernel, typename PairKernel>
+void link_cell_soa(CellIterator first, CellIterator last,
+                   ParticleKernel &&particle_kernel, PairKernel &&pair_kernel,
+                   double cutoff) {
+  auto const cutoff2 = cutoff * cutoff;
+
+  link_cell_blocks(
+      first, last, std::forward<ParticleKernel>(particle_kernel),
+      [&pair_kernel, cutoff2](typename CellIterator::reference c1, int i,
+                              typename CellIterator::reference c2, int begin,
+                              int end) {
+        detail::soa_particle_cell(c1, i, c2, begin, end, pair_kernel,
+                                  cutoff2);
+      });
+}
+} // namespace Algorithm
+
+#endif
@@ -19,6 +19,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef CORE_ALGORITHM_VERLET_IA_HPP
 #define CORE_ALGORITHM_VERLET_IA_HPP
 
+#include <cassert>
+#include <cstddef>
 #include <utility>
 
 namespace Algorithm {
@@ -32,8 +34,16 @@ void update_and_kernel(CellIterator first, CellIterator last,
                        DistanceFunction &&distance_function,
                        VerletCriterion &&verlet_criterion) {
   for (; first != last; ++first) {
-    /* Clear the VL */
-    first->m_verlet_list.clear();
+    auto &verlet_list = first->m_verlet_list;
+    auto neighbors = first->neighbors().red();
+
+    /* Clear the VL, cell 0 is the cell itself,
+       followed by the red neighbors. */
+    verlet_list.clear();
+    verlet_list.add_cell(first->n);
+    for (auto &neighbor : neighbors) {
+      verlet_list.add_cell(neighbor->n);
+    }
 
     for (int i = 0; i != first->n; i++) {
       auto &p1 = first->part[i];
@@ -45,21 +55,25 @@ void update_and_kernel(CellIterator first, CellIterator last,
         auto dist = distance_function(p1, first->part[j]);
         if (verlet_criterion(p1, first->part[j], dist)) {
           pair_kernel(p1, first->part[j], dist);
-          first->m_verlet_list.emplace_back(&p1, &(first->part[j]));
+          verlet_list.add_partner(0, j);
         }
       }
 
       /* Pairs with neighbors */
-      for (auto &neighbor : first->neighbors().red()) {
+      int c = 1;
+      for (auto &neighbor : neighbors) {
         for (int j = 0; j < neighbor->n; j++) {
           auto &p2 = neighbor->part[j];
           auto dist = distance_function(p1, p2);
           if (verlet_criterion(p1, p2, dist)) {
             pair_kernel(p1, p2, dist);
-            first->m_verlet_list.emplace_back(&p1, &p2);
+            verlet_list.add_partner(c, j);
           }
         }
+        c++;
       }
+
+      verlet_list.end_row();
     }
   }
 }
@@ -70,13 +84,30 @@ void kernel(CellIterator first, CellIterator last,
             ParticleKernel &&particle_kernel, PairKernel &&pair_kernel,
             DistanceFunction &&distance_function) {
   for (; first != last; ++first) {
+    auto const &verlet_list = first->m_verlet_list;
+    auto const neighbors = first->neighbors().red().begin();
+
+    assert(verlet_list.n_rows() == static_cast<std::size_t>(first->n));
+
     for (int i = 0; i != first->n; i++) {
-      particle_kernel(first->part[i]);
-    }
+      auto &p1 = first->part[i];
+
+      particle_kernel(p1);
 
-    for (auto &pair : first->m_verlet_list) {
-      auto dist = distance_function(*pair.first, *pair.second);
-      pair_kernel(*pair.first, *pair.second, dist);
+      /* The partners are sorted by cell, so the current
+         cell only has to be advanced. */
+      std::size_t c = 0;
+      auto cell = &(*first);
+      for (auto it = verlet_list.row_begin(i); it != verlet_list.row_end(i);
+           ++it) {
+        while (*it >= verlet_list.cell_offset(c + 1)) {
+          cell = neighbors[c++];
+        }
+
+        auto &p2 = cell->part[*it - verlet_list.cell_offset(c)];
+        auto dist = distance_function(p1, p2);
+        pair_kernel(p1, p2, dist);
+      }
     }
   }
 }
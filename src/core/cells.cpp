@@ -185,6 +185,13 @@ static void topology_release(int cs) {
 void topology_init(int cs, CellPList *local) {
   /** broadcast the flag for using Verlet list */
   boost::mpi::broadcast(comm_cart, cell_structure.use_verlet_list, 0);
+  /** broadcast the flag for using the packed particle mirrors */
+  boost::mpi::broadcast(comm_cart, cell_structure.use_soa, 0);
+
+  /* only the domain decomposition supports load balanced node domains */
+  if ((cs == CELL_STRUCTURE_NSQUARE || cs == CELL_STRUCTURE_LAYERED) &&
+      not node_domain_bounds.regular())
+    grid_set_node_domain_bounds({});
 
   switch (cs) {
   case CELL_STRUCTURE_NONEYET:
@@ -390,9 +397,13 @@ void cells_resort_particles(int global_flag) {
 #endif
   }
 
+  ghosts_check_rotation();
   ghost_communicator(&cell_structure.ghost_cells_comm);
   ghost_communicator(&cell_structure.exchange_ghosts_comm);
 
+  if (cell_structure.use_soa)
+    cells_update_soa();
+
   /* Particles are now sorted, but Verlet lists are invalid
      and p_old has to be reset. */
   resort_particles = Cells::RESORT_NONE;
@@ -444,7 +455,18 @@ void check_resort_particles() {
 }
 
 /*************************************************/
+/** Whether the ghost positions are still in flight,
+ *  see \ref cells_update_ghosts_begin. */
+static bool ghosts_pending = false;
+
 void cells_update_ghosts() {
+  cells_update_ghosts_begin();
+  cells_update_ghosts_finish();
+}
+
+void cells_update_ghosts_begin() {
+  assert(not ghosts_pending);
+
   if (topology_check_resort(cell_structure.type, resort_particles)) {
     int global = (resort_particles & Cells::RESORT_GLOBAL)
                      ? CELL_GLOBAL_EXCHANGE
@@ -452,10 +474,45 @@ void cells_update_ghosts() {
 
     /* Communication step:  number of ghosts and ghost information */
     cells_resort_particles(global);
-
-  } else
+  } else {
     /* Communication step: ghost information */
-    ghost_communicator(&cell_structure.update_ghost_pos_comm);
+    ghost_communicator_begin(&cell_structure.update_ghost_pos_comm);
+    ghosts_pending = true;
+
+    if (cell_structure.use_soa) {
+      for (auto &c : local_cells) {
+        c->m_soa.update(c->part, c->n);
+      }
+    }
+  }
+}
+
+void cells_update_ghosts_finish() {
+  if (not ghosts_pending)
+    return;
+
+  ghost_communicator_finish();
+  ghosts_pending = false;
+
+  if (cell_structure.use_soa) {
+    for (auto &c : ghost_cells) {
+      c->m_soa.update(c->part, c->n);
+    }
+  }
+}
+
+bool cells_ghosts_pending() { return ghosts_pending; }
+
+void cells_update_soa() {
+  for (auto &c : cells) {
+    c.m_soa.update(c.part, c.n);
+  }
+}
+
+void cells_soa_add_forces() {
+  for (auto &c : cells) {
+    c.m_soa.add_forces(c.part, c.n);
+  }
 }
 
 Cell *find_current_cell(const Particle &p) {
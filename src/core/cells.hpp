@@ -147,6 +147,10 @@ struct CellStructure {
 
   bool use_verlet_list = true;
 
+  /** Maintain the packed per-cell particle mirrors (Cell::m_soa)
+   *  and use them in the short-range loop. */
+  bool use_soa = false;
+
   /** Communicator to exchange ghost cell information. */
   GhostCommunicator ghost_cells_comm;
   /** Communicator to exchange ghost particles. */
@@ -262,6 +266,35 @@ void cells_on_geometry_change(int flags);
  */
 void cells_update_ghosts();
 
+/** Start the update of the ghost information. If the particles have
+ *  to be resorted, this is the same as \ref cells_update_ghosts.
+ *  Otherwise, the update of the ghost positions is only started, and
+ *  until \ref cells_update_ghosts_finish is called, only the local
+ *  particles may be accessed.
+ */
+void cells_update_ghosts_begin();
+
+/** Complete the ghost update started by \ref cells_update_ghosts_begin,
+ *  if it is still in flight.
+ */
+void cells_update_ghosts_finish();
+
+/** Whether a ghost update started by \ref cells_update_ghosts_begin
+ *  is still in flight.
+ */
+bool cells_ghosts_pending();
+
+/** Gather the packed particle data (Cell::m_soa) of all cells,
+ *  local and ghost. Only needed if CellStructure::use_soa is set,
+ *  in which case it is called on every resort and ghost update.
+ */
+void cells_update_soa();
+
+/** Add the forces accumulated in the packed mirrors of the local
+ *  and ghost cells to the particles.
+ */
+void cells_soa_add_forces();
+
 /** Calculate and return the total number of particles on this node. */
 int cells_get_n_particles();
 
@@ -607,6 +607,8 @@ void mpi_send_exclusion(int part1, int part2, int _delete) {
 void mpi_iccp3m_init_slave(const iccp3m_struct &iccp3m_cfg_) {
 #ifdef ELECTROSTATICS
   iccp3m_cfg = iccp3m_cfg_;
+  /* discards the charge history, as on the master */
+  iccp3m_alloc_lists();
 
   check_runtime_errors(comm_cart);
 #endif
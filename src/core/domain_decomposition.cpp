@@ -38,8 +38,13 @@ using Utils::get_linear_index;
 
 #include "event.hpp"
 
+#include <boost/algorithm/clamp.hpp>
 #include <boost/mpi/collectives.hpp>
 
+#include <cmath>
+#include <functional>
+#include <vector>
+
 /** Returns pointer to the cell which corresponds to the position if the
  *  position is in the nodes spatial domain otherwise a nullptr pointer.
  */
@@ -56,6 +61,9 @@ int max_num_cells = CELLS_MAX_NUM_CELLS;
 int min_num_cells = 1;
 double max_skin = 0.0;
 
+/** Integration steps since the last load balancing. */
+static int dd_balance_steps = 0;
+
 /*@}*/
 
 /************************************************************/
@@ -80,7 +88,17 @@ void dd_create_cell_grid() {
   /* initialize */
   cell_range[0] = cell_range[1] = cell_range[2] = max_range;
 
-  if (max_range < ROUND_ERROR_PREC * box_geo.length()[0]) {
+  if (not node_domain_bounds.regular()) {
+    /* load balanced node domains: the cells are the lattice
+       cells the domain of this node consists of */
+    auto const node_pos = calc_node_pos(comm_cart);
+    n_local_cells = 1;
+    for (i = 0; i < 3; i++) {
+      auto const &cuts = node_domain_bounds.cuts[i];
+      dd.cell_grid[i] = cuts[node_pos[i] + 1] - cuts[node_pos[i]];
+      n_local_cells *= dd.cell_grid[i];
+    }
+  } else if (max_range < ROUND_ERROR_PREC * box_geo.length()[0]) {
     /* this is the non-interacting case */
     const int cells_per_dir = std::ceil(std::pow(min_num_cells, 1. / 3.));
 
@@ -149,8 +167,9 @@ void dd_create_cell_grid() {
     }
   }
 
-  /* quit program if unsuccessful */
-  if (n_local_cells > max_num_cells) {
+  /* quit program if unsuccessful. With load balancing, max_num_cells
+     limits the average number of cells per node. */
+  if (node_domain_bounds.regular() && n_local_cells > max_num_cells) {
     runtimeErrorMsg() << "no suitable cell grid found ";
   }
 
@@ -460,6 +479,61 @@ void dd_update_communicators_w_boxl(const Utils::Vector3i &grid) {
   }
 }
 
+/** Group the local cells by color, so that cells of the same color
+ *  do not share any cell in their neighborhood (the cell and its red
+ *  neighbors). The cells are also split into the interior and the
+ *  boundary cells, see \ref DomainDecomposition::interior_cells.
+ *  The red neighbors are at most one cell away in each direction, so
+ *  cells that are at least three cells apart in one direction are
+ *  independent. This is the case for cells that have the same color
+ *  when coloring the grid with period three, except for the fully
+ *  connected directions, where every cell gets its own color.
+ */
+static void dd_init_cell_colors() {
+  int n_colors[3];
+  for (int i = 0; i < 3; i++) {
+    n_colors[i] =
+        dd.fully_connected[i] ? dd.cell_grid[i] : std::min(3, dd.cell_grid[i]);
+  }
+
+  auto const n_total_colors = n_colors[0] * n_colors[1] * n_colors[2];
+  dd.cell_colors.clear();
+  dd.cell_colors.resize(n_total_colors);
+  dd.interior_cells.clear();
+  dd.interior_colors.clear();
+  dd.interior_colors.resize(n_total_colors);
+  dd.boundary_cells.clear();
+  dd.boundary_colors.clear();
+  dd.boundary_colors.resize(n_total_colors);
+
+  /* A cell is in the interior, if none of its neighbors is a ghost cell */
+  auto const is_interior = [](int i, int ind) {
+    return not dd.fully_connected[i] && (ind > 1) && (ind < dd.cell_grid[i]);
+  };
+
+  for (int o = 1; o < dd.cell_grid[2] + 1; o++)
+    for (int n = 1; n < dd.cell_grid[1] + 1; n++)
+      for (int m = 1; m < dd.cell_grid[0] + 1; m++) {
+        auto const color = get_linear_index(
+            (m - 1) % n_colors[0], (n - 1) % n_colors[1],
+            (o - 1) % n_colors[2], {n_colors[0], n_colors[1], n_colors[2]});
+        auto const ind = get_linear_index(
+            m, n, o,
+            {dd.ghost_cell_grid[0], dd.ghost_cell_grid[1],
+             dd.ghost_cell_grid[2]});
+
+        dd.cell_colors[color].push_back(&cells[ind]);
+
+        if (is_interior(0, m) && is_interior(1, n) && is_interior(2, o)) {
+          dd.interior_cells.push_back(&cells[ind]);
+          dd.interior_colors[color].push_back(&cells[ind]);
+        } else {
+          dd.boundary_cells.push_back(&cells[ind]);
+          dd.boundary_colors[color].push_back(&cells[ind]);
+        }
+      }
+}
+
 /** Init cell interactions for cell system domain decomposition.
  * initializes the interacting neighbor cell list of a cell The
  * created list of interacting neighbor cells is used by the Verlet
@@ -514,6 +588,8 @@ void dd_init_cell_interactions(const Utils::Vector3i &grid) {
         cells[ind1].m_neighbors =
             Neighbors<Cell *>(red_neighbors, black_neighbors);
       }
+
+  dd_init_cell_colors();
 }
 
 /*************************************************/
@@ -560,7 +636,90 @@ Cell *dd_save_position_to_cell(const Utils::Vector3d &pos) {
 /* Public Functions */
 /************************************************************/
 
+/** Lattice for the load balanced node domains. The lattice cells are
+ *  as small as \ref max_range and \ref max_num_cells cells per node on
+ *  average allow, but there is at least one lattice cell per node.
+ */
+static Utils::Vector3i dd_balance_lattice() {
+  auto const &box_l = box_geo.length();
+  auto const scale = std::cbrt(static_cast<double>(max_num_cells) * n_nodes /
+                               (box_l[0] * box_l[1] * box_l[2]));
+
+  Utils::Vector3i n_cells;
+  for (int i = 0; i < 3; i++) {
+    auto n = static_cast<int>(std::ceil(box_l[i] * scale));
+    if (max_range > 0.)
+      n = std::min(n, static_cast<int>(std::floor(box_l[i] / max_range)));
+    n_cells[i] = std::max(n, node_grid[i]);
+  }
+
+  return n_cells;
+}
+
+/** Whether the lattice cells are at least as large as \ref max_range. */
+static bool dd_balance_lattice_fits(Utils::Vector3i const &n_cells) {
+  for (int i = 0; i < 3; i++) {
+    if (box_geo.length()[i] / n_cells[i] < max_range)
+      return false;
+  }
+  return true;
+}
+
+void dd_balance() {
+  auto const n_cells = dd_balance_lattice();
+  if (not dd_balance_lattice_fits(n_cells)) {
+    runtimeErrorMsg() << "load balancing: interaction range " << max_range
+                      << " too large for the node grid";
+    return;
+  }
+
+  NodeDomainBounds bounds;
+  bounds.n_cells = n_cells;
+  for (int i = 0; i < 3; i++) {
+    /* number of particles in the lattice slabs along this axis */
+    std::vector<double> local_weights(n_cells[i], 0.);
+    for (auto const &p : local_cells.particles()) {
+      auto const slab = static_cast<int>(
+          std::floor(p.r.p[i] / box_geo.length()[i] * n_cells[i]));
+      local_weights[boost::algorithm::clamp(slab, 0, n_cells[i] - 1)] += 1.;
+    }
+
+    std::vector<double> weights(n_cells[i]);
+    boost::mpi::all_reduce(comm_cart, local_weights.data(), n_cells[i],
+                           weights.data(), std::plus<double>());
+
+    bounds.cuts[i] = balanced_partition(weights, node_grid[i]);
+  }
+
+  if ((bounds.n_cells == node_domain_bounds.n_cells) &&
+      (bounds.cuts == node_domain_bounds.cuts))
+    return;
+
+  CELL_TRACE(fprintf(stderr, "%d: dd_balance: new node domains\n", this_node));
+
+  grid_set_node_domain_bounds(bounds);
+  cells_re_init(CELL_STRUCTURE_CURRENT);
+}
+
+void dd_balance_on_step() {
+  if (dd.balance_interval <= 0)
+    return;
+
+  if (dd_balance_steps == 0)
+    dd_balance();
+
+  dd_balance_steps = (dd_balance_steps + 1) % dd.balance_interval;
+}
+
 void dd_on_geometry_change(int flags, const Utils::Vector3i &grid) {
+  /* the cells of load balanced node domains are the lattice cells,
+     they can not be changed without changing the domains. */
+  if (not node_domain_bounds.regular() &&
+      not dd_balance_lattice_fits(node_domain_bounds.n_cells)) {
+    cells_re_init(CELL_STRUCTURE_CURRENT);
+    return;
+  }
+
   /* check that the CPU domains are still sufficiently large. */
   for (int i = 0; i < 3; i++)
     if (local_geo.length()[i] < max_range) {
@@ -607,7 +766,8 @@ void dd_on_geometry_change(int flags, const Utils::Vector3i &grid) {
 
   /* If we are not in a hurry, check if we can maybe optimize the cell
      system by using smaller cells. */
-  if (!(flags & CELL_FLAG_FAST) && max_range > 0) {
+  if (!(flags & CELL_FLAG_FAST) && max_range > 0 &&
+      node_domain_bounds.regular()) {
     int i;
     for (i = 0; i < 3; i++) {
       auto poss_size = (int)floor(local_geo.length()[i] / max_range);
@@ -633,6 +793,18 @@ void dd_topology_init(CellPList *old, const Utils::Vector3i &grid) {
     but may be set to a larger value by the user for performance reasons. */
   min_num_cells = std::max(min_num_cells, calc_processor_min_num_cells(grid));
 
+  /* Go back to the regular decomposition if load balancing was
+     switched off, or if the lattice of the node domains is too
+     fine for the interaction range. The domains are balanced
+     again in the next integration step. */
+  boost::mpi::broadcast(comm_cart, dd.balance_interval, 0);
+  if (not node_domain_bounds.regular() &&
+      (dd.balance_interval <= 0 ||
+       not dd_balance_lattice_fits(node_domain_bounds.n_cells))) {
+    grid_set_node_domain_bounds({});
+  }
+  dd_balance_steps = 0;
+
   cell_structure.type = CELL_STRUCTURE_DOMDEC;
   cell_structure.particle_to_cell = [](const Particle &p) {
     return dd_save_position_to_cell(p.r.p);
@@ -689,6 +861,11 @@ void dd_topology_release() {
   CELL_TRACE(fprintf(stderr, "%d: dd_topology_release:\n", this_node));
   /* release cell interactions */
 
+  dd.cell_colors.clear();
+  dd.interior_cells.clear();
+  dd.interior_colors.clear();
+  dd.boundary_cells.clear();
+  dd.boundary_colors.clear();
   /* free ghost cell pointer list */
   realloc_cellplist(&ghost_cells, ghost_cells.n = 0);
   /* free ghost communicators */
@@ -59,13 +59,15 @@
 
 #include "cells.hpp"
 
+#include <vector>
+
 /** Structure containing the information about the cell grid used for domain
  *  decomposition.
  */
 struct DomainDecomposition {
   DomainDecomposition()
       : cell_grid{0, 0, 0}, ghost_cell_grid{0, 0, 0}, cell_size{0, 0, 0},
-        inv_cell_size{0, 0, 0} {}
+        inv_cell_size{0, 0, 0}, balance_interval(0) {}
   /** linked cell grid in nodes spatial domain. */
   int cell_grid[3];
   /** linked cell grid with ghost frame. */
@@ -78,6 +80,24 @@ struct DomainDecomposition {
   /** inverse cell size = \see DomainDecomposition::cell_size ^ -1. */
   double inv_cell_size[3];
   bool fully_connected[3];
+  /** Number of integration steps between the load balancing
+   *  of the node domains, 0 for the regular decomposition.
+   */
+  int balance_interval;
+  /** local cells, grouped such that the cells in a group
+   *  do not have any neighbor cells in common, and can
+   *  therefore be worked on concurrently.
+   */
+  std::vector<std::vector<Cell *>> cell_colors;
+  /** local cells that do not have any ghost cells as neighbors,
+   *  and can therefore be worked on while the ghosts are updated.
+   */
+  std::vector<Cell *> interior_cells;
+  /** local cells that have ghost cells as neighbors. */
+  std::vector<Cell *> boundary_cells;
+  /** @ref cell_colors split into interior and boundary cells. */
+  std::vector<std::vector<Cell *>> interior_colors;
+  std::vector<std::vector<Cell *>> boundary_colors;
 };
 
 /************************************************************/
@@ -162,6 +182,22 @@ void dd_topology_release();
 void dd_exchange_and_sort_particles(int global, ParticleList *pl,
                                     const Utils::Vector3i &grid);
 
+/** Move the boundaries of the node domains such that all nodes
+ *  have approximately the same number of particles.
+ *
+ *  The boundaries are chosen independently along each axis, on
+ *  a global lattice of cells that are at least \ref max_range
+ *  wide, so that the cells of all nodes have the same size. The
+ *  particles are then resorted into the new domains. Has to be
+ *  called on all nodes.
+ */
+void dd_balance();
+
+/** Count an integration step, and call \ref dd_balance every
+ *  \ref DomainDecomposition::balance_interval steps.
+ */
+void dd_balance_on_step();
+
 /** calculate physical (processor) minimal number of cells */
 int calc_processor_min_num_cells(const Utils::Vector3i &grid);
 
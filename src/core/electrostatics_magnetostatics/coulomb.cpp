@@ -105,7 +105,9 @@ void sanity_checks(int &state) {
 double cutoff(const Utils::Vector3d &box_l) {
   switch (coulomb.method) {
   case COULOMB_MMM1D:
-    return std::numeric_limits<double>::infinity();
+    return (mmm1d_params.near_cut > 0)
+               ? mmm1d_params.near_cut
+               : std::numeric_limits<double>::infinity();
 #ifdef P3M
   case COULOMB_ELC_P3M:
     return std::max(elc_params.space_layer, p3m.params.r_cut_iL * box_l[0]);
@@ -200,6 +202,7 @@ void on_coulomb_change() {
 #ifdef CUDA
   case COULOMB_P3M_GPU:
     p3m_gpu_init(p3m.params.cao, p3m.params.mesh, p3m.params.alpha);
+    p3m_tabulate_real_space();
     break;
 #endif
   case COULOMB_ELC_P3M:
@@ -329,6 +332,9 @@ void calc_long_range_force() {
       p3m_calc_kspace_forces(1, 0);
     break;
 #endif
+  case COULOMB_MMM1D:
+    MMM1D_add_far_force();
+    break;
   case COULOMB_MMM2D:
     MMM2D_add_far_force();
     MMM2D_dielectric_layers_force_contribution();
@@ -396,6 +402,9 @@ void calc_energy_long_range(Observable_stat &energy) {
     energy.coulomb[1] += Scafacos::long_range_energy();
     break;
 #endif
+  case COULOMB_MMM1D:
+    *energy.coulomb += MMM1D_far_energy();
+    break;
   case COULOMB_MMM2D:
     *energy.coulomb += MMM2D_far_energy();
     *energy.coulomb += MMM2D_dielectric_layers_energy_contribution();
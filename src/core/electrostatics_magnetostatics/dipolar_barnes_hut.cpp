@@ -0,0 +1,426 @@
+/*
+  Copyright (C) 2019 The ESPResSo project
+
+  This file is part of ESPResSo.
+
+  ESPResSo is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** \file
+ *  Barnes-Hut tree code for magnetic dipoles, see \ref dipolar_barnes_hut.hpp.
+ */
+
+#include "electrostatics_magnetostatics/dipolar_barnes_hut.hpp"
+
+#ifdef DIPOLES
+#include "cells.hpp"
+#include "communication.hpp"
+#include "electrostatics_magnetostatics/dipole.hpp"
+#include "errorhandling.hpp"
+#include "grid.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/constants.hpp>
+#include <utils/math/sqr.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+DipolarBarnesHutParameters dbh_params;
+
+namespace {
+using Utils::Vector3d;
+
+/** Maximal number of dipoles in a leaf cell. */
+constexpr int leaf_size = 8;
+/** Maximal depth of the tree, limits the refinement of coincident
+ *  dipoles. */
+constexpr int max_depth = 48;
+
+/** Symmetric traceless 3x3 matrix, row-major. */
+using Matrix3d = std::array<double, 9>;
+
+Vector3d mat_vec(Matrix3d const &s, Vector3d const &v) {
+  return {s[0] * v[0] + s[1] * v[1] + s[2] * v[2],
+          s[3] * v[0] + s[4] * v[1] + s[5] * v[2],
+          s[6] * v[0] + s[7] * v[1] + s[8] * v[2]};
+}
+
+/** Add the field @p B of the dipole @p m at distance @p R and the
+ *  force @p F on the dipole @p mu.
+ */
+void add_dipole(Vector3d const &R, Vector3d const &m, Vector3d const &mu,
+                Vector3d &B, Vector3d &F) {
+  auto const ir2 = 1. / R.norm2();
+  auto const ir3 = ir2 * std::sqrt(ir2);
+  auto const ir5 = ir3 * ir2;
+  auto const ir7 = ir5 * ir2;
+  auto const Rm = R * m;
+  auto const Rmu = R * mu;
+
+  B += (3. * Rm * ir5) * R - ir3 * m;
+  F += (-15. * Rm * Rmu * ir7 + 3. * (m * mu) * ir5) * R +
+       (3. * ir5) * (Rmu * m + Rm * mu);
+}
+
+/** Add the field and force due to the first moment @p S of the dipole
+ *  distribution of a cell, i.e. the symmetric traceless part of
+ *  \f$ \sum_i (r_i - c) \otimes m_i \f$.
+ */
+void add_first_moment(Vector3d const &R, Matrix3d const &S,
+                      Vector3d const &mu, Vector3d &B, Vector3d &F) {
+  auto const ir2 = 1. / R.norm2();
+  auto const ir5 = ir2 * ir2 * std::sqrt(ir2);
+  auto const ir7 = ir5 * ir2;
+  auto const ir9 = ir7 * ir2;
+  auto const SR = mat_vec(S, R);
+  auto const Smu = mat_vec(S, mu);
+  auto const RSR = R * SR;
+  auto const muSR = mu * SR;
+  auto const Rmu = R * mu;
+
+  B += (15. * RSR * ir7) * R - (6. * ir5) * SR;
+  F -= (105. * RSR * Rmu * ir9 - 30. * muSR * ir7) * R -
+       (30. * Rmu * ir7) * SR - (15. * RSR * ir7) * mu + (6. * ir5) * Smu;
+}
+
+/** Octree over a set of dipoles. */
+class Tree {
+public:
+  Tree(std::vector<Vector3d> const &pos, std::vector<Vector3d> const &dip)
+      : m_index(pos.size()) {
+    for (std::size_t i = 0; i < m_index.size(); i++)
+      m_index[i] = static_cast<int>(i);
+    if (pos.empty())
+      return;
+
+    Vector3d lo = pos[0], hi = pos[0];
+    for (auto const &r : pos) {
+      for (int d = 0; d < 3; d++) {
+        lo[d] = std::min(lo[d], r[d]);
+        hi[d] = std::max(hi[d], r[d]);
+      }
+    }
+    auto const size =
+        std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2], 1e-12});
+
+    m_cells.reserve(2 * pos.size() / leaf_size + 1);
+    build(pos, 0, static_cast<int>(pos.size()), lo, size, 0);
+
+    /* store the dipoles in the order of the leaves */
+    m_pos.reserve(pos.size());
+    m_dip.reserve(pos.size());
+    for (auto const i : m_index) {
+      m_pos.push_back(pos[i]);
+      m_dip.push_back(dip[i]);
+    }
+    for (auto &cell : m_cells)
+      moments(cell);
+  }
+
+  /** Field and force on the dipole @p mu at @p x due to all dipoles of
+   *  the tree except the one with index @p self.
+   */
+  void interact(Vector3d const &x, Vector3d const &mu, int self, double theta,
+                Vector3d &B, Vector3d &F) const {
+    if (m_cells.empty())
+      return;
+    auto const accept = Utils::sqr(1. + theta);
+    auto const theta2 = Utils::sqr(theta);
+
+    std::vector<int> stack{0};
+    while (not stack.empty()) {
+      auto const &cell = m_cells[stack.back()];
+      stack.pop_back();
+
+      auto const R = x - cell.center;
+      /* d > b (1 + 1/theta) */
+      if (theta2 * R.norm2() > accept * Utils::sqr(cell.radius)) {
+        add_dipole(R, cell.M, mu, B, F);
+        add_first_moment(R, cell.S, mu, B, F);
+      } else if (cell.children.empty()) {
+        for (int j = cell.begin; j < cell.end; j++) {
+          if (m_index[j] != self)
+            add_dipole(x - m_pos[j], m_dip[j], mu, B, F);
+        }
+      } else {
+        stack.insert(stack.end(), cell.children.begin(), cell.children.end());
+      }
+    }
+  }
+
+private:
+  struct Cell {
+    int begin, end;
+    std::vector<int> children;
+    Vector3d center;
+    Vector3d M;
+    Matrix3d S;
+    double radius;
+  };
+
+  /** Recursively sort the dipoles in [@p begin, @p end) into the cube
+   *  with the corner @p lo and edge length @p size.
+   */
+  void build(std::vector<Vector3d> const &pos, int begin, int end,
+             Vector3d const &lo, double size, int depth) {
+    auto const id = static_cast<int>(m_cells.size());
+    m_cells.emplace_back();
+    m_cells[id].begin = begin;
+    m_cells[id].end = end;
+
+    if (end - begin <= leaf_size or depth == max_depth)
+      return;
+
+    auto const half = 0.5 * size;
+    auto const octant = [&](int i) {
+      auto const &r = pos[i];
+      return (r[0] >= lo[0] + half) + 2 * (r[1] >= lo[1] + half) +
+             4 * (r[2] >= lo[2] + half);
+    };
+    std::stable_sort(m_index.begin() + begin, m_index.begin() + end,
+                     [&](int a, int b) { return octant(a) < octant(b); });
+
+    std::vector<int> children;
+    for (int i = begin; i < end;) {
+      auto const o = octant(m_index[i]);
+      auto j = i;
+      while (j < end and octant(m_index[j]) == o)
+        j++;
+      Vector3d const child_lo = {lo[0] + half * (o & 1),
+                                 lo[1] + half * ((o >> 1) & 1),
+                                 lo[2] + half * ((o >> 2) & 1)};
+      children.push_back(static_cast<int>(m_cells.size()));
+      build(pos, i, j, child_lo, half, depth + 1);
+      i = j;
+    }
+    m_cells[id].children = std::move(children);
+  }
+
+  /** Expansion center, multipole moments and radius of a cell. The
+   *  center is the average position weighted by the magnitudes of the
+   *  dipole moments.
+   */
+  void moments(Cell &cell) const {
+    Vector3d c{};
+    double w = 0.;
+    cell.M = Vector3d{};
+    for (int j = cell.begin; j < cell.end; j++) {
+      auto const wj = m_dip[j].norm();
+      c += wj * m_pos[j];
+      w += wj;
+      cell.M += m_dip[j];
+    }
+    cell.center = c / w;
+
+    Matrix3d Q{};
+    cell.radius = 0.;
+    for (int j = cell.begin; j < cell.end; j++) {
+      auto const d = m_pos[j] - cell.center;
+      for (int a = 0; a < 3; a++)
+        for (int b = 0; b < 3; b++)
+          Q[3 * a + b] += d[a] * m_dip[j][b];
+      cell.radius = std::max(cell.radius, d.norm());
+    }
+    auto const trace = (Q[0] + Q[4] + Q[8]) / 3.;
+    for (int a = 0; a < 3; a++) {
+      for (int b = 0; b < 3; b++)
+        cell.S[3 * a + b] = 0.5 * (Q[3 * a + b] + Q[3 * b + a]);
+      cell.S[4 * a] -= trace;
+    }
+  }
+
+  std::vector<int> m_index;
+  std::vector<Vector3d> m_pos, m_dip;
+  std::vector<Cell> m_cells;
+};
+
+/** Dipoles of all nodes and the local particles they belong to. */
+struct GatheredDipoles {
+  std::vector<Vector3d> pos, dip;
+  std::vector<Particle *> local;
+  /** Index of the first local dipole in @ref pos. */
+  int offset;
+};
+
+GatheredDipoles gather_dipoles() {
+  GatheredDipoles g;
+  std::vector<double> send;
+  for (auto &p : local_cells.particles()) {
+    if (p.p.dipm == 0.0)
+      continue;
+    auto const pos = folded_position(p.r.p, box_geo);
+    auto const dip = p.calc_dip();
+    send.insert(send.end(), pos.begin(), pos.end());
+    send.insert(send.end(), dip.begin(), dip.end());
+    g.local.push_back(&p);
+  }
+
+  std::vector<int> sizes(n_nodes), displ(n_nodes, 0);
+  int const size = static_cast<int>(send.size());
+  MPI_Allgather(&size, 1, MPI_INT, sizes.data(), 1, MPI_INT, comm_cart);
+  for (int i = 1; i < n_nodes; i++)
+    displ[i] = displ[i - 1] + sizes[i - 1];
+  std::vector<double> recv(displ.back() + sizes.back());
+  MPI_Allgatherv(send.data(), size, MPI_DOUBLE, recv.data(), sizes.data(),
+                 displ.data(), MPI_DOUBLE, comm_cart);
+
+  g.offset = displ[this_node] / 6;
+  for (std::size_t i = 0; i < recv.size(); i += 6) {
+    g.pos.push_back({recv[i], recv[i + 1], recv[i + 2]});
+    g.dip.push_back({recv[i + 3], recv[i + 4], recv[i + 5]});
+  }
+  return g;
+}
+
+/** Shifts of the periodic images, in spherical order. */
+std::vector<Vector3d> image_shifts() {
+  int n[3];
+  for (int i = 0; i < 3; i++)
+    n[i] = box_geo.periodic(i) ? dbh_params.n_replica : 0;
+
+  std::vector<Vector3d> shifts;
+  for (int nx = -n[0]; nx <= n[0]; nx++)
+    for (int ny = -n[1]; ny <= n[1]; ny++)
+      for (int nz = -n[2]; nz <= n[2]; nz++)
+        if (nx * nx + ny * ny + nz * nz <=
+            Utils::sqr(dbh_params.n_replica))
+          shifts.push_back({nx * box_geo.length()[0], ny * box_geo.length()[1],
+                            nz * box_geo.length()[2]});
+  return shifts;
+}
+
+/** Field and force on the local dipole @p k, summed over all images. */
+void field_and_force(Tree const &tree, GatheredDipoles const &g,
+                     std::vector<Vector3d> const &shifts, int k, double theta,
+                     Vector3d &B, Vector3d &F) {
+  auto const i = g.offset + k;
+  B = F = Vector3d{};
+  for (auto const &shift : shifts) {
+    auto const self = (shift == Vector3d{}) ? i : -1;
+    tree.interact(g.pos[i] - shift, g.dip[i], self, theta, B, F);
+  }
+}
+
+/** Tune the opening angle on all nodes, such that the RMS errors of the
+ *  forces and torques of a sample of dipoles relative to the exact sum
+ *  are below the accuracy.
+ */
+void dbh_tune_local() {
+  auto const g = gather_dipoles();
+  auto const n_total = static_cast<int>(g.pos.size());
+  if (n_total < 2)
+    return;
+  Tree const tree(g.pos, g.dip);
+  auto const shifts = image_shifts();
+
+  /* about 256 dipoles, evenly spread over the nodes */
+  auto const stride = std::max(1, n_total / 256);
+  std::vector<int> sample;
+  std::vector<Vector3d> F_exact, T_exact;
+  for (int k = 0; k < static_cast<int>(g.local.size()); k++) {
+    if ((g.offset + k) % stride != 0)
+      continue;
+    Vector3d B, F;
+    field_and_force(tree, g, shifts, k, 0., B, F);
+    sample.push_back(k);
+    F_exact.push_back(F);
+    T_exact.push_back(vector_product(g.dip[g.offset + k], B));
+  }
+
+  auto const error = [&](double theta) {
+    double sums[4] = {0., 0., 0., 0.};
+    for (std::size_t s = 0; s < sample.size(); s++) {
+      Vector3d B, F;
+      field_and_force(tree, g, shifts, sample[s], theta, B, F);
+      auto const T = vector_product(g.dip[g.offset + sample[s]], B);
+      sums[0] += (F - F_exact[s]).norm2();
+      sums[1] += F_exact[s].norm2();
+      sums[2] += (T - T_exact[s]).norm2();
+      sums[3] += T_exact[s].norm2();
+    }
+    MPI_Allreduce(MPI_IN_PLACE, sums, 4, MPI_DOUBLE, MPI_SUM, comm_cart);
+    auto const rel = [](double d, double n) {
+      return (n > 0.) ? std::sqrt(d / n) : 0.;
+    };
+    return std::max(rel(sums[0], sums[1]), rel(sums[2], sums[3]));
+  };
+
+  /* Bisection for the largest opening angle up to 1 with
+     error(lo) <= accuracy < error(hi); the exact sum has no error. */
+  double lo = 0., hi = 1.;
+  if (error(hi) <= dbh_params.accuracy) {
+    lo = hi;
+  } else {
+    for (int i = 0; i < 12; i++) {
+      auto const mid = 0.5 * (lo + hi);
+      if (error(mid) <= dbh_params.accuracy)
+        lo = mid;
+      else
+        hi = mid;
+    }
+  }
+  dbh_params.theta = lo;
+}
+} // namespace
+
+REGISTER_CALLBACK(dbh_tune_local)
+
+int dbh_set_params(double accuracy, int n_replica) {
+  if (accuracy <= 0.) {
+    runtimeErrorMsg() << "Barnes-Hut accuracy has to be positive";
+    return ES_ERROR;
+  }
+  if (n_replica < 0) {
+    runtimeErrorMsg() << "Barnes-Hut n_replica has to be non-negative";
+    return ES_ERROR;
+  }
+
+  dbh_params.accuracy = accuracy;
+  dbh_params.n_replica = n_replica;
+  Dipole::set_method_local(DIPOLAR_BH_CPU);
+  mpi_bcast_coulomb_params();
+
+  mpi_call(dbh_tune_local);
+  dbh_tune_local();
+
+  return ES_OK;
+}
+
+double dbh_calculations(int force_flag, int energy_flag) {
+  auto const g = gather_dipoles();
+  Tree const tree(g.pos, g.dip);
+  auto const shifts = image_shifts();
+
+  double u = 0.;
+  for (int k = 0; k < static_cast<int>(g.local.size()); k++) {
+    Vector3d B, F;
+    field_and_force(tree, g, shifts, k, dbh_params.theta, B, F);
+    auto &p = *g.local[k];
+    auto const &mu = g.dip[g.offset + k];
+    if (force_flag) {
+      p.f.f += dipole.prefactor * F;
+#ifdef ROTATION
+      p.f.torque += dipole.prefactor * vector_product(mu, B);
+#endif
+    }
+    if (energy_flag)
+      u -= 0.5 * dipole.prefactor * (mu * B);
+  }
+
+  return u;
+}
+
+#endif /* DIPOLES */
@@ -0,0 +1,80 @@
+/*
+  Copyright (C) 2019 The ESPResSo project
+
+  This file is part of ESPResSo.
+
+  ESPResSo is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef DIPOLAR_BARNES_HUT_HPP
+#define DIPOLAR_BARNES_HUT_HPP
+/** \file
+ *  Barnes-Hut tree code for magnetic dipoles on the CPU.
+ *
+ *  The dipoles of all nodes are gathered on every node, where an octree is
+ *  built over them. Each node then calculates the fields, forces and
+ *  torques of its own particles by traversing the tree. A cell is
+ *  accepted if the target lies outside of the sphere of radius
+ *  \f$ b (1 + 1/\theta) \f$ around its expansion center, where \f$ b \f$
+ *  is the radius of the cell (J. K. Salmon, M. S. Warren, J. Comput. Phys.
+ *  111, p. 136, 1994). The far field of an accepted cell is expanded up to
+ *  the first moment of its dipole distribution, so that the truncation
+ *  error of a cell scales like \f$ \theta^2 \f$.
+ *
+ *  The opening angle \f$ \theta \f$ is tuned on activation, such that the
+ *  root mean square error of the forces and torques of a sample of
+ *  particles relative to the exact sum is below the requested accuracy.
+ *
+ *  For periodic systems, the interactions with the images of the system
+ *  are summed up to @ref DipolarBarnesHutParameters::n_replica box lengths
+ *  in spherical order, as in the direct summation
+ *  @ref magnetic_dipolar_direct_sum_calculations.
+ */
+#include "config.hpp"
+
+#ifdef DIPOLES
+
+struct DipolarBarnesHutParameters {
+  /** Requested RMS error of the forces and torques relative to their RMS
+   *  value. */
+  double accuracy = 1e-3;
+  /** Number of periodic images in each periodic direction. */
+  int n_replica = 0;
+  /** Opening angle of the tree traversal, tuned for @ref accuracy. */
+  double theta = 0.5;
+
+  template <typename Archive>
+  void serialize(Archive &ar, long int /* version */) {
+    ar &accuracy;
+    ar &n_replica;
+    ar &theta;
+  }
+};
+
+extern DipolarBarnesHutParameters dbh_params;
+
+/** Switch on the Barnes-Hut magnetostatics and tune the opening angle.
+ *  @param accuracy  requested relative RMS error of forces and torques
+ *  @param n_replica number of periodic images in each periodic direction
+ *  @return ES_ERROR if the parameters are invalid
+ */
+int dbh_set_params(double accuracy, int n_replica);
+
+/** Calculate the magnetic forces, torques and the energy of the local
+ *  particles.
+ *  @return the local contribution to the energy if @p energy_flag is set
+ */
+double dbh_calculations(int force_flag, int energy_flag);
+
+#endif /* DIPOLES */
+#endif /* DIPOLAR_BARNES_HUT_HPP */
@@ -8,6 +8,7 @@ double dipolar_cutoff;
 
 #include "actor/DipolarBarnesHut.hpp"
 #include "actor/DipolarDirectSum.hpp"
+#include "electrostatics_magnetostatics/dipolar_barnes_hut.hpp"
 #include "electrostatics_magnetostatics/magnetic_non_p3m_methods.hpp"
 #include "electrostatics_magnetostatics/mdlc_correction.hpp"
 #include "electrostatics_magnetostatics/p3m-dipolar.hpp"
@@ -184,6 +185,9 @@ void calc_long_range_force() {
   case DIPOLAR_DS:
     magnetic_dipolar_direct_sum_calculations(1, 0);
     break;
+  case DIPOLAR_BH_CPU:
+    dbh_calculations(1, 0);
+    break;
   case DIPOLAR_DS_GPU:
     // Do nothing. It's an actor
     break;
@@ -230,6 +234,9 @@ void calc_energy_long_range(Observable_stat &energy) {
   case DIPOLAR_DS:
     energy.dipolar[1] = magnetic_dipolar_direct_sum_calculations(0, 1);
     break;
+  case DIPOLAR_BH_CPU:
+    energy.dipolar[1] = dbh_calculations(0, 1);
+    break;
   case DIPOLAR_DS_GPU:
     break;
 #ifdef DIPOLAR_BARNES_HUT
@@ -274,6 +281,9 @@ void energy_n(int &n_dipolar) {
   case DIPOLAR_DS_GPU:
     n_dipolar = 2;
     break;
+  case DIPOLAR_BH_CPU:
+    n_dipolar = 2;
+    break;
 #ifdef DIPOLAR_BARNES_HUT
   case DIPOLAR_BH_GPU:
     n_dipolar = 2;
@@ -330,6 +340,9 @@ void bcast_params(const boost::mpi::communicator &comm) {
   case DIPOLAR_BH_GPU:
     break;
 #endif
+  case DIPOLAR_BH_CPU:
+    mpi::broadcast(comm, dbh_params, 0);
+    break;
   case DIPOLAR_SCAFACOS:
     break;
   default:
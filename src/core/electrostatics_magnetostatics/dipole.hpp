@@ -41,7 +41,9 @@ enum DipolarInteraction {
   DIPOLAR_BH_GPU,
 #endif
   /** Scafacos library */
-  DIPOLAR_SCAFACOS
+  DIPOLAR_SCAFACOS,
+  /** Barnes-Hut tree code on the cpu */
+  DIPOLAR_BH_CPU
 };
 
 /** field containing the interaction parameters for
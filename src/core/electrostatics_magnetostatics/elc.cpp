@@ -30,8 +30,10 @@
 #include "mmm-common.hpp"
 #include "particle_data.hpp"
 #include "pressure.hpp"
+#include <algorithm>
 #include <cmath>
 #include <mpi.h>
+#include <vector>
 
 #include "electrostatics_magnetostatics/coulomb.hpp"
 #include "electrostatics_magnetostatics/elc.hpp"
@@ -85,57 +87,63 @@ ELC_struct elc_params = {1e100, 10,    1, 0, 1, 1, false, 1,
 #define PQECCM 7
 /*@}*/
 
-/** number of local particles, equals the size of \ref elc::partblk. */
+/** number of local charged particles, equals the size of \ref partptr. */
 static int n_localpart = 0;
 
-/** temporary buffers for product decomposition */
-static std::vector<double> partblk;
+/** local charged particles, in the order of the sin/cos caches */
+static std::vector<Particle *> partptr;
 /** collected data from the other cells */
 static double gblcblk[8];
 
-/** structure for storing of sin and cos values */
-typedef struct {
-  double s, c;
-} SCCache;
+/** sin and cos values of all frequencies. The values of one frequency
+    are contiguous over the particles, such that the recurrences in
+    \ref prepare_sc_cache vectorize. */
+struct SCCache {
+  std::vector<double> s, c;
+};
 
 /** \name sin/cos caching */
 /*@{*/
-static std::vector<SCCache> scxcache;
+static SCCache scxcache;
 static int n_scxcache;
-static std::vector<SCCache> scycache;
+static SCCache scycache;
 static int n_scycache;
 /*@}*/
 
+/** A term of the far formula, with q = 0 for the p terms and p = 0 for
+    the q terms. */
+struct FarTerm {
+  int p, q;
+  double omega;
+  /** position of the collected data of the term in \ref far_blocks */
+  int offset;
+};
+
+/** all terms of the far formula within the cutoff */
+static std::vector<FarTerm> far_terms;
+/** collected data of all terms of the far formula */
+static std::vector<double> far_blocks;
+
 /****************************************
  * LOCAL FUNCTIONS
  ****************************************/
 
 /** \name sin/cos storage */
 /*@{*/
-static void prepare_scx_cache();
-static void prepare_scy_cache();
+static void prepare_sc_cache(SCCache &cache, int n_freq, int dir, double u);
 /*@}*/
 /** \name common code */
 /*@{*/
 static void distribute(int size);
+static void setup_far_terms();
 /*@}*/
-/** \name p=0 per frequency code */
-/*@{*/
-static void setup_P(int p, double omega);
-static void add_P_force();
-static double P_energy(double omega);
-/*@}*/
-/** \name q=0 per frequency code */
+/** \name p=0 or q=0 per frequency code */
 /*@{*/
-static void setup_Q(int q, double omega);
-static void add_Q_force();
-static double Q_energy(double omega);
+static void setup_PoQ(SCCache const &sc, int o, double omega, double *blk);
 /*@}*/
 /** \name p,q <> 0 per frequency code */
 /*@{*/
-static void setup_PQ(int p, int q, double omega);
-static void add_PQ_force(int p, int q, double omega);
-static double PQ_energy(double omega);
+static void setup_PQ(int p, int q, double omega, double *blk);
 static void add_dipole_force();
 static double dipole_energy();
 static double z_energy();
@@ -157,36 +165,50 @@ void ELC_setup_constants() {
 
 /* SC Cache */
 /************/
-static void prepare_scx_cache() {
-  int freq;
-  double arg;
-
-  for (freq = 1; freq <= n_scxcache; freq++) {
-    double pref = C_2PI * ux * freq;
-    int o = (freq - 1) * n_localpart;
-    int ic = 0;
-    for (auto const &part : local_cells.particles()) {
-      arg = pref * part.r.p[0];
-      scxcache[o + ic].s = sin(arg);
-      scxcache[o + ic].c = cos(arg);
-      ic++;
-    }
+
+/** Collect the local charged particles and size the caches. */
+static void collect_particles() {
+  partptr.clear();
+  for (auto &p : local_cells.particles()) {
+    if (p.p.q != 0.0)
+      partptr.push_back(&p);
   }
+  n_localpart = static_cast<int>(partptr.size());
+  scxcache.s.resize(n_scxcache * n_localpart);
+  scxcache.c.resize(n_scxcache * n_localpart);
+  scycache.s.resize(n_scycache * n_localpart);
+  scycache.c.resize(n_scycache * n_localpart);
 }
 
-static void prepare_scy_cache() {
-  int freq;
-  double arg;
-
-  for (freq = 1; freq <= n_scycache; freq++) {
-    double pref = C_2PI * uy * freq;
-    int o = (freq - 1) * n_localpart;
-    int ic = 0;
-    for (auto const &part : local_cells.particles()) {
-      arg = pref * part.r.p[1];
-      scycache[o + ic].s = sin(arg);
-      scycache[o + ic].c = cos(arg);
-      ic++;
+/** Block of particles for the sin/cos recurrences. */
+constexpr int sc_block_size = 64;
+
+/** Calculate sin and cos of the frequencies 1 to @p n_freq along the
+ *  direction @p dir. Only the first frequency is evaluated directly,
+ *  the others follow from the angle addition theorems.
+ */
+static void prepare_sc_cache(SCCache &cache, int n_freq, int dir, double u) {
+  double const pref = C_2PI * u;
+  double *const s = cache.s.data();
+  double *const c = cache.c.data();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int b = 0; b < n_localpart; b += sc_block_size) {
+    int const e = std::min(b + sc_block_size, n_localpart);
+    for (int ic = b; ic < e; ic++) {
+      double const arg = pref * partptr[ic]->r.p[dir];
+      s[ic] = sin(arg);
+      c[ic] = cos(arg);
+    }
+    for (int freq = 2; freq <= n_freq; freq++) {
+      int const o = (freq - 1) * n_localpart;
+      int const o1 = (freq - 2) * n_localpart;
+      for (int ic = b; ic < e; ic++) {
+        s[o + ic] = s[o1 + ic] * c[ic] + c[o1 + ic] * s[ic];
+        c[o + ic] = c[o1 + ic] * c[ic] - s[o1 + ic] * s[ic];
+      }
     }
   }
 }
@@ -237,37 +259,6 @@ void distribute(int size) {
   MPI_Allreduce(send_buf, gblcblk, size, MPI_DOUBLE, MPI_SUM, comm_cart);
 }
 
-#ifdef CHECKPOINTS
-static void checkpoint(char *text, int p, int q, int e_size) {
-  int c, i;
-  fprintf(stderr, "%d: %s %d %d\n", this_node, text, p, q);
-
-  fprintf(stderr, "partblk\n");
-  for (c = 0; c < n_localpart; c++) {
-    fprintf(stderr, "%d", c);
-    for (i = 0; i < e_size; i++)
-      fprintf(stderr, " %10.3g", block(partblk.data(), c, 2 * e_size)[i]);
-    fprintf(stderr, " m");
-    for (i = 0; i < e_size; i++)
-      fprintf(stderr, " %10.3g",
-              block(partblk.data(), c, 2 * e_size)[i + e_size]);
-    fprintf(stderr, "\n");
-  }
-  fprintf(stderr, "\n");
-
-  fprintf(stderr, "gblcblk\n");
-  for (i = 0; i < e_size; i++)
-    fprintf(stderr, " %10.3g", gblcblk[i]);
-  fprintf(stderr, " m");
-  for (i = 0; i < e_size; i++)
-    fprintf(stderr, " %10.3g", gblcblk[i + e_size]);
-  fprintf(stderr, "\n");
-}
-
-#else
-#define checkpoint(text, p, q, size)
-#endif
-
 #ifdef LOG_FORCES
 static void clear_log_forces(char *where) {
   fprintf(stderr, "%s\n", where);
@@ -569,13 +560,27 @@ static void add_z_force() {
 /* PoQ exp sum */
 /*****************************************************************/
 
-static void setup_P(int p, double omega) {
-  int ic, o = (p - 1) * n_localpart;
+/** Particle block of a p=0 or q=0 term. */
+inline void PoQ_particle_block(SCCache const &sc, int i, double q, double e,
+                               double *blk) {
+  blk[POQESM] = q * sc.s[i] / e;
+  blk[POQESP] = q * sc.s[i] * e;
+  blk[POQECM] = q * sc.c[i] / e;
+  blk[POQECP] = q * sc.c[i] * e;
+}
+
+/** Collect the local data of a p=0 or q=0 term.
+ *  @param sc     sin/cos cache of the direction of the term
+ *  @param o      offset of the frequency in the cache
+ *  @param omega  frequency
+ *  @param blk    local data of the term
+ */
+static void setup_PoQ(SCCache const &sc, int o, double omega, double *blk) {
   double pref = -coulomb.prefactor * 4 * M_PI * ux * uy /
                 (expm1(omega * box_geo.length()[2]));
   double pref_di = coulomb.prefactor * 4 * M_PI * ux * uy;
   int size = 4;
-  double lclimgebot[4], lclimgetop[4], lclimge[4];
+  double lclblk[4], lclimgebot[4], lclimgetop[4], lclimge[4];
   double fac_delta_mid_bot = 1, fac_delta_mid_top = 1, fac_delta = 1;
   double scale = 1;
 
@@ -589,18 +594,14 @@ static void setup_P(int p, double omega) {
   }
 
   clear_vec(lclimge, size);
-  clear_vec(gblcblk, size);
+  clear_vec(blk, size);
 
-  ic = 0;
-  for (auto &p : local_cells.particles()) {
+  for (int ic = 0; ic < n_localpart; ic++) {
+    auto const &p = *partptr[ic];
     double e = exp(omega * p.r.p[2]);
 
-    partblk[size * ic + POQESM] = p.p.q * scxcache[o + ic].s / e;
-    partblk[size * ic + POQESP] = p.p.q * scxcache[o + ic].s * e;
-    partblk[size * ic + POQECM] = p.p.q * scxcache[o + ic].c / e;
-    partblk[size * ic + POQECP] = p.p.q * scxcache[o + ic].c * e;
-
-    add_vec(gblcblk, gblcblk, block(partblk.data(), ic, size), size);
+    PoQ_particle_block(sc, o + ic, p.p.q, e, lclblk);
+    add_vec(blk, blk, lclblk, size);
 
     if (elc_params.dielectric_contrast_on) {
       if (p.r.p[2] < elc_params.space_layer) { // handle the lower case first
@@ -611,12 +612,12 @@ static void setup_P(int p, double omega) {
 
         scale = p.p.q * elc_params.delta_mid_bot;
 
-        lclimgebot[POQESM] = scxcache[o + ic].s / e;
-        lclimgebot[POQESP] = scxcache[o + ic].s * e;
-        lclimgebot[POQECM] = scxcache[o + ic].c / e;
-        lclimgebot[POQECP] = scxcache[o + ic].c * e;
+        lclimgebot[POQESM] = sc.s[o + ic] / e;
+        lclimgebot[POQESP] = sc.s[o + ic] * e;
+        lclimgebot[POQECM] = sc.c[o + ic] / e;
+        lclimgebot[POQECP] = sc.c[o + ic] * e;
 
-        addscale_vec(gblcblk, scale, lclimgebot, gblcblk, size);
+        addscale_vec(blk, scale, lclimgebot, blk, size);
 
         e = (exp(omega * (-p.r.p[2] - 2 * elc_params.h)) *
                  elc_params.delta_mid_bot +
@@ -631,8 +632,8 @@ static void setup_P(int p, double omega) {
             fac_delta_mid_bot;
       }
 
-      lclimge[POQESP] += p.p.q * scxcache[o + ic].s * e;
-      lclimge[POQECP] += p.p.q * scxcache[o + ic].c * e;
+      lclimge[POQESP] += p.p.q * sc.s[o + ic] * e;
+      lclimge[POQECP] += p.p.q * sc.c[o + ic] * e;
 
       if (p.r.p[2] > (elc_params.h -
                       elc_params.space_layer)) { // handle the upper case now
@@ -641,12 +642,12 @@ static void setup_P(int p, double omega) {
 
         scale = p.p.q * elc_params.delta_mid_top;
 
-        lclimgetop[POQESM] = scxcache[o + ic].s / e;
-        lclimgetop[POQESP] = scxcache[o + ic].s * e;
-        lclimgetop[POQECM] = scxcache[o + ic].c / e;
-        lclimgetop[POQECP] = scxcache[o + ic].c * e;
+        lclimgetop[POQESM] = sc.s[o + ic] / e;
+        lclimgetop[POQESP] = sc.s[o + ic] * e;
+        lclimgetop[POQECM] = sc.c[o + ic] / e;
+        lclimgetop[POQECP] = sc.c[o + ic] * e;
 
-        addscale_vec(gblcblk, scale, lclimgetop, gblcblk, size);
+        addscale_vec(blk, scale, lclimgetop, blk, size);
 
         e = (exp(omega * (p.r.p[2] - 4 * elc_params.h)) *
                  elc_params.delta_mid_top +
@@ -661,204 +662,63 @@ static void setup_P(int p, double omega) {
             fac_delta_mid_top;
       }
 
-      lclimge[POQESM] += p.p.q * scxcache[o + ic].s * e;
-      lclimge[POQECM] += p.p.q * scxcache[o + ic].c * e;
-    }
-
-    ic++;
-  }
-
-  scale_vec(pref, gblcblk, size);
-
-  if (elc_params.dielectric_contrast_on) {
-    scale_vec(pref_di, lclimge, size);
-    add_vec(gblcblk, gblcblk, lclimge, size);
-  }
-}
-
-static void setup_Q(int q, double omega) {
-  int ic, o = (q - 1) * n_localpart;
-  double pref = -coulomb.prefactor * 4 * M_PI * ux * uy /
-                (expm1(omega * box_geo.length()[2]));
-  double pref_di = coulomb.prefactor * 4 * M_PI * ux * uy;
-  int size = 4;
-  double lclimgebot[4], lclimgetop[4], lclimge[4];
-  double fac_delta_mid_bot = 1, fac_delta_mid_top = 1, fac_delta = 1;
-  double scale = 1;
-
-  if (elc_params.dielectric_contrast_on) {
-    double fac_elc =
-        1.0 / (1 - elc_params.delta_mid_top * elc_params.delta_mid_bot *
-                       exp(-omega * 2 * elc_params.h));
-    fac_delta_mid_bot = elc_params.delta_mid_bot * fac_elc;
-    fac_delta_mid_top = elc_params.delta_mid_top * fac_elc;
-    fac_delta = fac_delta_mid_bot * elc_params.delta_mid_top;
-  }
-
-  clear_vec(lclimge, size);
-  clear_vec(gblcblk, size);
-  ic = 0;
-  for (auto &p : local_cells.particles()) {
-    double e = exp(omega * p.r.p[2]);
-
-    partblk[size * ic + POQESM] = p.p.q * scycache[o + ic].s / e;
-    partblk[size * ic + POQESP] = p.p.q * scycache[o + ic].s * e;
-    partblk[size * ic + POQECM] = p.p.q * scycache[o + ic].c / e;
-    partblk[size * ic + POQECP] = p.p.q * scycache[o + ic].c * e;
-
-    add_vec(gblcblk, gblcblk, block(partblk.data(), ic, size), size);
-
-    if (elc_params.dielectric_contrast_on) {
-      if (p.r.p[2] < elc_params.space_layer) { // handle the lower case first
-        // negative sign before omega is okay here as the image is located
-        // at
-        // -p.r.p[2]
-
-        e = exp(-omega * p.r.p[2]);
-
-        scale = p.p.q * elc_params.delta_mid_bot;
-
-        lclimgebot[POQESM] = scycache[o + ic].s / e;
-        lclimgebot[POQESP] = scycache[o + ic].s * e;
-        lclimgebot[POQECM] = scycache[o + ic].c / e;
-        lclimgebot[POQECP] = scycache[o + ic].c * e;
-
-        addscale_vec(gblcblk, scale, lclimgebot, gblcblk, size);
-
-        e = (exp(omega * (-p.r.p[2] - 2 * elc_params.h)) *
-                 elc_params.delta_mid_bot +
-             exp(omega * (p.r.p[2] - 2 * elc_params.h))) *
-            fac_delta;
-
-      } else {
-
-        e = (exp(omega * (-p.r.p[2])) +
-             exp(omega * (p.r.p[2] - 2 * elc_params.h)) *
-                 elc_params.delta_mid_top) *
-            fac_delta_mid_bot;
-      }
-
-      lclimge[POQESP] += p.p.q * scycache[o + ic].s * e;
-      lclimge[POQECP] += p.p.q * scycache[o + ic].c * e;
-
-      if (p.r.p[2] > (elc_params.h -
-                      elc_params.space_layer)) { // handle the upper case now
-
-        e = exp(omega * (2 * elc_params.h - p.r.p[2]));
-
-        scale = p.p.q * elc_params.delta_mid_top;
-
-        lclimgetop[POQESM] = scycache[o + ic].s / e;
-        lclimgetop[POQESP] = scycache[o + ic].s * e;
-        lclimgetop[POQECM] = scycache[o + ic].c / e;
-        lclimgetop[POQECP] = scycache[o + ic].c * e;
-
-        addscale_vec(gblcblk, scale, lclimgetop, gblcblk, size);
-
-        e = (exp(omega * (p.r.p[2] - 4 * elc_params.h)) *
-                 elc_params.delta_mid_top +
-             exp(omega * (-p.r.p[2] - 2 * elc_params.h))) *
-            fac_delta;
-
-      } else {
-
-        e = (exp(omega * (p.r.p[2] - 2 * elc_params.h)) +
-             exp(omega * (-p.r.p[2] - 2 * elc_params.h)) *
-                 elc_params.delta_mid_bot) *
-            fac_delta_mid_top;
-      }
-
-      lclimge[POQESM] += p.p.q * scycache[o + ic].s * e;
-      lclimge[POQECM] += p.p.q * scycache[o + ic].c * e;
+      lclimge[POQESM] += p.p.q * sc.s[o + ic] * e;
+      lclimge[POQECM] += p.p.q * sc.c[o + ic] * e;
     }
-
-    ic++;
   }
 
-  scale_vec(pref, gblcblk, size);
+  scale_vec(pref, blk, size);
 
   if (elc_params.dielectric_contrast_on) {
     scale_vec(pref_di, lclimge, size);
-    add_vec(gblcblk, gblcblk, lclimge, size);
+    add_vec(blk, blk, lclimge, size);
   }
 }
 
-static void add_P_force() {
-  int ic;
-  int size = 4;
-
-  ic = 0;
-  for (auto &p : local_cells.particles()) {
-    p.f.f[0] += partblk[size * ic + POQESM] * gblcblk[POQECP] -
-                partblk[size * ic + POQECM] * gblcblk[POQESP] +
-                partblk[size * ic + POQESP] * gblcblk[POQECM] -
-                partblk[size * ic + POQECP] * gblcblk[POQESM];
-    p.f.f[2] += partblk[size * ic + POQECM] * gblcblk[POQECP] +
-                partblk[size * ic + POQESM] * gblcblk[POQESP] -
-                partblk[size * ic + POQECP] * gblcblk[POQECM] -
-                partblk[size * ic + POQESP] * gblcblk[POQESM];
-    ic++;
-  }
+/** Force of a p=0 or q=0 term along its direction @p f_xy and along z. */
+inline void add_PoQ_force(double const *partblk, double const *gblcblk,
+                          double &f_xy, double &f_z) {
+  f_xy += partblk[POQESM] * gblcblk[POQECP] -
+          partblk[POQECM] * gblcblk[POQESP] +
+          partblk[POQESP] * gblcblk[POQECM] -
+          partblk[POQECP] * gblcblk[POQESM];
+  f_z += partblk[POQECM] * gblcblk[POQECP] +
+         partblk[POQESM] * gblcblk[POQESP] -
+         partblk[POQECP] * gblcblk[POQECM] -
+         partblk[POQESP] * gblcblk[POQESM];
 }
 
-static double P_energy(double omega) {
-  int size = 4;
-  double eng = 0;
-  double pref = 1 / omega;
-
-  for (unsigned ic = 0; ic < n_localpart; ic++) {
-    eng += pref * (partblk[size * ic + POQECM] * gblcblk[POQECP] +
-                   partblk[size * ic + POQESM] * gblcblk[POQESP] +
-                   partblk[size * ic + POQECP] * gblcblk[POQECM] +
-                   partblk[size * ic + POQESP] * gblcblk[POQESM]);
-  }
-
-  return eng;
-}
-
-static void add_Q_force() {
-  int ic;
-  int size = 4;
-
-  ic = 0;
-  for (auto &p : local_cells.particles()) {
-    p.f.f[1] += partblk[size * ic + POQESM] * gblcblk[POQECP] -
-                partblk[size * ic + POQECM] * gblcblk[POQESP] +
-                partblk[size * ic + POQESP] * gblcblk[POQECM] -
-                partblk[size * ic + POQECP] * gblcblk[POQESM];
-    p.f.f[2] += partblk[size * ic + POQECM] * gblcblk[POQECP] +
-                partblk[size * ic + POQESM] * gblcblk[POQESP] -
-                partblk[size * ic + POQECP] * gblcblk[POQECM] -
-                partblk[size * ic + POQESP] * gblcblk[POQESM];
-    ic++;
-  }
-}
-
-static double Q_energy(double omega) {
-  int size = 4;
-  double eng = 0;
-  double pref = 1 / omega;
-
-  for (unsigned ic = 0; ic < n_localpart; ic++) {
-    eng += pref * (partblk[size * ic + POQECM] * gblcblk[POQECP] +
-                   partblk[size * ic + POQESM] * gblcblk[POQESP] +
-                   partblk[size * ic + POQECP] * gblcblk[POQECM] +
-                   partblk[size * ic + POQESP] * gblcblk[POQESM]);
-  }
-  return eng;
+inline double PoQ_energy(double const *partblk, double const *gblcblk) {
+  return partblk[POQECM] * gblcblk[POQECP] + partblk[POQESM] * gblcblk[POQESP] +
+         partblk[POQECP] * gblcblk[POQECM] + partblk[POQESP] * gblcblk[POQESM];
 }
 
 /*****************************************************************/
 /* PQ particle blocks */
 /*****************************************************************/
 
-static void setup_PQ(int p, int q, double omega) {
-  int ic, ox = (p - 1) * n_localpart, oy = (q - 1) * n_localpart;
+/** Particle block of a p,q <> 0 term. */
+inline void PQ_particle_block(int ix, int iy, double q, double e,
+                              double *blk) {
+  blk[PQESSM] = scxcache.s[ix] * scycache.s[iy] * q / e;
+  blk[PQESCM] = scxcache.s[ix] * scycache.c[iy] * q / e;
+  blk[PQECSM] = scxcache.c[ix] * scycache.s[iy] * q / e;
+  blk[PQECCM] = scxcache.c[ix] * scycache.c[iy] * q / e;
+
+  blk[PQESSP] = scxcache.s[ix] * scycache.s[iy] * q * e;
+  blk[PQESCP] = scxcache.s[ix] * scycache.c[iy] * q * e;
+  blk[PQECSP] = scxcache.c[ix] * scycache.s[iy] * q * e;
+  blk[PQECCP] = scxcache.c[ix] * scycache.c[iy] * q * e;
+}
+
+/** Collect the local data of a p,q <> 0 term. */
+static void setup_PQ(int p, int q, double omega, double *blk) {
+  int ox = (p - 1) * n_localpart, oy = (q - 1) * n_localpart;
   double pref = -coulomb.prefactor * 8 * M_PI * ux * uy /
                 (expm1(omega * box_geo.length()[2]));
   double pref_di = coulomb.prefactor * 8 * M_PI * ux * uy;
   int size = 8;
-  double lclimgebot[8], lclimgetop[8], lclimge[8];
+  double lclblk[8], lclimgebot[8], lclimgetop[8], lclimge[8];
   double fac_delta_mid_bot = 1, fac_delta_mid_top = 1, fac_delta = 1;
   double scale = 1;
   if (elc_params.dielectric_contrast_on) {
@@ -871,31 +731,14 @@ static void setup_PQ(int p, int q, double omega) {
   }
 
   clear_vec(lclimge, size);
-  clear_vec(gblcblk, size);
+  clear_vec(blk, size);
 
-  ic = 0;
-  for (auto &p : local_cells.particles()) {
+  for (int ic = 0; ic < n_localpart; ic++) {
+    auto const &p = *partptr[ic];
     double e = exp(omega * p.r.p[2]);
 
-    partblk[size * ic + PQESSM] =
-        scxcache[ox + ic].s * scycache[oy + ic].s * p.p.q / e;
-    partblk[size * ic + PQESCM] =
-        scxcache[ox + ic].s * scycache[oy + ic].c * p.p.q / e;
-    partblk[size * ic + PQECSM] =
-        scxcache[ox + ic].c * scycache[oy + ic].s * p.p.q / e;
-    partblk[size * ic + PQECCM] =
-        scxcache[ox + ic].c * scycache[oy + ic].c * p.p.q / e;
-
-    partblk[size * ic + PQESSP] =
-        scxcache[ox + ic].s * scycache[oy + ic].s * p.p.q * e;
-    partblk[size * ic + PQESCP] =
-        scxcache[ox + ic].s * scycache[oy + ic].c * p.p.q * e;
-    partblk[size * ic + PQECSP] =
-        scxcache[ox + ic].c * scycache[oy + ic].s * p.p.q * e;
-    partblk[size * ic + PQECCP] =
-        scxcache[ox + ic].c * scycache[oy + ic].c * p.p.q * e;
-
-    add_vec(gblcblk, gblcblk, block(partblk.data(), ic, size), size);
+    PQ_particle_block(ox + ic, oy + ic, p.p.q, e, lclblk);
+    add_vec(blk, blk, lclblk, size);
 
     if (elc_params.dielectric_contrast_on) {
       if (p.r.p[2] < elc_params.space_layer) { // handle the lower case first
@@ -904,17 +747,17 @@ static void setup_PQ(int p, int q, double omega) {
         e = exp(-omega * p.r.p[2]);
         scale = p.p.q * elc_params.delta_mid_bot;
 
-        lclimgebot[PQESSM] = scxcache[ox + ic].s * scycache[oy + ic].s / e;
-        lclimgebot[PQESCM] = scxcache[ox + ic].s * scycache[oy + ic].c / e;
-        lclimgebot[PQECSM] = scxcache[ox + ic].c * scycache[oy + ic].s / e;
-        lclimgebot[PQECCM] = scxcache[ox + ic].c * scycache[oy + ic].c / e;
+        lclimgebot[PQESSM] = scxcache.s[ox + ic] * scycache.s[oy + ic] / e;
+        lclimgebot[PQESCM] = scxcache.s[ox + ic] * scycache.c[oy + ic] / e;
+        lclimgebot[PQECSM] = scxcache.c[ox + ic] * scycache.s[oy + ic] / e;
+        lclimgebot[PQECCM] = scxcache.c[ox + ic] * scycache.c[oy + ic] / e;
 
-        lclimgebot[PQESSP] = scxcache[ox + ic].s * scycache[oy + ic].s * e;
-        lclimgebot[PQESCP] = scxcache[ox + ic].s * scycache[oy + ic].c * e;
-        lclimgebot[PQECSP] = scxcache[ox + ic].c * scycache[oy + ic].s * e;
-        lclimgebot[PQECCP] = scxcache[ox + ic].c * scycache[oy + ic].c * e;
+        lclimgebot[PQESSP] = scxcache.s[ox + ic] * scycache.s[oy + ic] * e;
+        lclimgebot[PQESCP] = scxcache.s[ox + ic] * scycache.c[oy + ic] * e;
+        lclimgebot[PQECSP] = scxcache.c[ox + ic] * scycache.s[oy + ic] * e;
+        lclimgebot[PQECCP] = scxcache.c[ox + ic] * scycache.c[oy + ic] * e;
 
-        addscale_vec(gblcblk, scale, lclimgebot, gblcblk, size);
+        addscale_vec(blk, scale, lclimgebot, blk, size);
 
         e = (exp(omega * (-p.r.p[2] - 2 * elc_params.h)) *
                  elc_params.delta_mid_bot +
@@ -929,10 +772,10 @@ static void setup_PQ(int p, int q, double omega) {
             fac_delta_mid_bot * p.p.q;
       }
 
-      lclimge[PQESSP] += scxcache[ox + ic].s * scycache[oy + ic].s * e;
-      lclimge[PQESCP] += scxcache[ox + ic].s * scycache[oy + ic].c * e;
-      lclimge[PQECSP] += scxcache[ox + ic].c * scycache[oy + ic].s * e;
-      lclimge[PQECCP] += scxcache[ox + ic].c * scycache[oy + ic].c * e;
+      lclimge[PQESSP] += scxcache.s[ox + ic] * scycache.s[oy + ic] * e;
+      lclimge[PQESCP] += scxcache.s[ox + ic] * scycache.c[oy + ic] * e;
+      lclimge[PQECSP] += scxcache.c[ox + ic] * scycache.s[oy + ic] * e;
+      lclimge[PQECCP] += scxcache.c[ox + ic] * scycache.c[oy + ic] * e;
 
       if (p.r.p[2] > (elc_params.h -
                       elc_params.space_layer)) { // handle the upper case now
@@ -940,17 +783,17 @@ static void setup_PQ(int p, int q, double omega) {
         e = exp(omega * (2 * elc_params.h - p.r.p[2]));
         scale = p.p.q * elc_params.delta_mid_top;
 
-        lclimgetop[PQESSM] = scxcache[ox + ic].s * scycache[oy + ic].s / e;
-        lclimgetop[PQESCM] = scxcache[ox + ic].s * scycache[oy + ic].c / e;
-        lclimgetop[PQECSM] = scxcache[ox + ic].c * scycache[oy + ic].s / e;
-        lclimgetop[PQECCM] = scxcache[ox + ic].c * scycache[oy + ic].c / e;
+        lclimgetop[PQESSM] = scxcache.s[ox + ic] * scycache.s[oy + ic] / e;
+        lclimgetop[PQESCM] = scxcache.s[ox + ic] * scycache.c[oy + ic] / e;
+        lclimgetop[PQECSM] = scxcache.c[ox + ic] * scycache.s[oy + ic] / e;
+        lclimgetop[PQECCM] = scxcache.c[ox + ic] * scycache.c[oy + ic] / e;
 
-        lclimgetop[PQESSP] = scxcache[ox + ic].s * scycache[oy + ic].s * e;
-        lclimgetop[PQESCP] = scxcache[ox + ic].s * scycache[oy + ic].c * e;
-        lclimgetop[PQECSP] = scxcache[ox + ic].c * scycache[oy + ic].s * e;
-        lclimgetop[PQECCP] = scxcache[ox + ic].c * scycache[oy + ic].c * e;
+        lclimgetop[PQESSP] = scxcache.s[ox + ic] * scycache.s[oy + ic] * e;
+        lclimgetop[PQESCP] = scxcache.s[ox + ic] * scycache.c[oy + ic] * e;
+        lclimgetop[PQECSP] = scxcache.c[ox + ic] * scycache.s[oy + ic] * e;
+        lclimgetop[PQECCP] = scxcache.c[ox + ic] * scycache.c[oy + ic] * e;
 
-        addscale_vec(gblcblk, scale, lclimgetop, gblcblk, size);
+        addscale_vec(blk, scale, lclimgetop, blk, size);
 
         e = (exp(omega * (p.r.p[2] - 4 * elc_params.h)) *
                  elc_params.delta_mid_top +
@@ -965,87 +808,135 @@ static void setup_PQ(int p, int q, double omega) {
             fac_delta_mid_top * p.p.q;
       }
 
-      lclimge[PQESSM] += scxcache[ox + ic].s * scycache[oy + ic].s * e;
-      lclimge[PQESCM] += scxcache[ox + ic].s * scycache[oy + ic].c * e;
-      lclimge[PQECSM] += scxcache[ox + ic].c * scycache[oy + ic].s * e;
-      lclimge[PQECCM] += scxcache[ox + ic].c * scycache[oy + ic].c * e;
+      lclimge[PQESSM] += scxcache.s[ox + ic] * scycache.s[oy + ic] * e;
+      lclimge[PQESCM] += scxcache.s[ox + ic] * scycache.c[oy + ic] * e;
+      lclimge[PQECSM] += scxcache.c[ox + ic] * scycache.s[oy + ic] * e;
+      lclimge[PQECCM] += scxcache.c[ox + ic] * scycache.c[oy + ic] * e;
     }
-
-    ic++;
   }
 
-  scale_vec(pref, gblcblk, size);
+  scale_vec(pref, blk, size);
   if (elc_params.dielectric_contrast_on) {
     scale_vec(pref_di, lclimge, size);
-    add_vec(gblcblk, gblcblk, lclimge, size);
+    add_vec(blk, blk, lclimge, size);
   }
 }
 
-static void add_PQ_force(int p, int q, double omega) {
-  int ic;
-
-  double pref_x = C_2PI * ux * p / omega;
-  double pref_y = C_2PI * uy * q / omega;
-  int size = 8;
-
-  ic = 0;
-  for (auto &p : local_cells.particles()) {
-    p.f.f[0] += pref_x * (partblk[size * ic + PQESCM] * gblcblk[PQECCP] +
-                          partblk[size * ic + PQESSM] * gblcblk[PQECSP] -
-                          partblk[size * ic + PQECCM] * gblcblk[PQESCP] -
-                          partblk[size * ic + PQECSM] * gblcblk[PQESSP] +
-                          partblk[size * ic + PQESCP] * gblcblk[PQECCM] +
-                          partblk[size * ic + PQESSP] * gblcblk[PQECSM] -
-                          partblk[size * ic + PQECCP] * gblcblk[PQESCM] -
-                          partblk[size * ic + PQECSP] * gblcblk[PQESSM]);
-    p.f.f[1] += pref_y * (partblk[size * ic + PQECSM] * gblcblk[PQECCP] +
-                          partblk[size * ic + PQESSM] * gblcblk[PQESCP] -
-                          partblk[size * ic + PQECCM] * gblcblk[PQECSP] -
-                          partblk[size * ic + PQESCM] * gblcblk[PQESSP] +
-                          partblk[size * ic + PQECSP] * gblcblk[PQECCM] +
-                          partblk[size * ic + PQESSP] * gblcblk[PQESCM] -
-                          partblk[size * ic + PQECCP] * gblcblk[PQECSM] -
-                          partblk[size * ic + PQESCP] * gblcblk[PQESSM]);
-    p.f.f[2] += (partblk[size * ic + PQECCM] * gblcblk[PQECCP] +
-                 partblk[size * ic + PQECSM] * gblcblk[PQECSP] +
-                 partblk[size * ic + PQESCM] * gblcblk[PQESCP] +
-                 partblk[size * ic + PQESSM] * gblcblk[PQESSP] -
-                 partblk[size * ic + PQECCP] * gblcblk[PQECCM] -
-                 partblk[size * ic + PQECSP] * gblcblk[PQECSM] -
-                 partblk[size * ic + PQESCP] * gblcblk[PQESCM] -
-                 partblk[size * ic + PQESSP] * gblcblk[PQESSM]);
-    ic++;
-  }
+inline void add_PQ_force(double const *partblk, double const *gblcblk,
+                         double pref_x, double pref_y,
+                         Utils::Vector3d &force) {
+  force[0] += pref_x * (partblk[PQESCM] * gblcblk[PQECCP] +
+                        partblk[PQESSM] * gblcblk[PQECSP] -
+                        partblk[PQECCM] * gblcblk[PQESCP] -
+                        partblk[PQECSM] * gblcblk[PQESSP] +
+                        partblk[PQESCP] * gblcblk[PQECCM] +
+                        partblk[PQESSP] * gblcblk[PQECSM] -
+                        partblk[PQECCP] * gblcblk[PQESCM] -
+                        partblk[PQECSP] * gblcblk[PQESSM]);
+  force[1] += pref_y * (partblk[PQECSM] * gblcblk[PQECCP] +
+                        partblk[PQESSM] * gblcblk[PQESCP] -
+                        partblk[PQECCM] * gblcblk[PQECSP] -
+                        partblk[PQESCM] * gblcblk[PQESSP] +
+                        partblk[PQECSP] * gblcblk[PQECCM] +
+                        partblk[PQESSP] * gblcblk[PQESCM] -
+                        partblk[PQECCP] * gblcblk[PQECSM] -
+                        partblk[PQESCP] * gblcblk[PQESSM]);
+  force[2] += (partblk[PQECCM] * gblcblk[PQECCP] +
+               partblk[PQECSM] * gblcblk[PQECSP] +
+               partblk[PQESCM] * gblcblk[PQESCP] +
+               partblk[PQESSM] * gblcblk[PQESSP] -
+               partblk[PQECCP] * gblcblk[PQECCM] -
+               partblk[PQECSP] * gblcblk[PQECSM] -
+               partblk[PQESCP] * gblcblk[PQESCM] -
+               partblk[PQESSP] * gblcblk[PQESSM]);
 }
 
-static double PQ_energy(double omega) {
-  int size = 8;
-  double eng = 0;
-  double pref = 1 / omega;
-
-  for (unsigned ic = 0; ic < n_localpart; ic++) {
-    eng += pref * (partblk[size * ic + PQECCM] * gblcblk[PQECCP] +
-                   partblk[size * ic + PQECSM] * gblcblk[PQECSP] +
-                   partblk[size * ic + PQESCM] * gblcblk[PQESCP] +
-                   partblk[size * ic + PQESSM] * gblcblk[PQESSP] +
-                   partblk[size * ic + PQECCP] * gblcblk[PQECCM] +
-                   partblk[size * ic + PQECSP] * gblcblk[PQECSM] +
-                   partblk[size * ic + PQESCP] * gblcblk[PQESCM] +
-                   partblk[size * ic + PQESSP] * gblcblk[PQESSM]);
-  }
-  return eng;
+inline double PQ_energy(double const *partblk, double const *gblcblk) {
+  return partblk[PQECCM] * gblcblk[PQECCP] + partblk[PQECSM] * gblcblk[PQECSP] +
+         partblk[PQESCM] * gblcblk[PQESCP] + partblk[PQESSM] * gblcblk[PQESSP] +
+         partblk[PQECCP] * gblcblk[PQECCM] + partblk[PQECSP] * gblcblk[PQECSM] +
+         partblk[PQESCP] * gblcblk[PQESCM] + partblk[PQESSP] * gblcblk[PQESSM];
 }
 
 /*****************************************************************/
 /* main loops */
 /*****************************************************************/
 
-void ELC_add_force() {
-  int p, q;
-  double omega;
+/** Collect the data of all terms of the far formula from all nodes.
+ *  The local data of the terms is independent, so the terms are set up
+ *  concurrently, and all of them are summed up in a single reduction.
+ */
+static void setup_far_terms() {
+  collect_particles();
+  prepare_sc_cache(scxcache, n_scxcache, 0, ux);
+  prepare_sc_cache(scycache, n_scycache, 1, uy);
 
-  prepare_scx_cache();
-  prepare_scy_cache();
+  far_terms.clear();
+  int size = 0;
+  /* the second condition is just for the case of numerical accident */
+  for (int p = 1; ux * (p - 1) < elc_params.far_cut && p <= n_scxcache; p++) {
+    far_terms.push_back({p, 0, C_2PI * ux * p, size});
+    size += 4;
+  }
+  for (int q = 1; uy * (q - 1) < elc_params.far_cut && q <= n_scycache; q++) {
+    far_terms.push_back({0, q, C_2PI * uy * q, size});
+    size += 4;
+  }
+  for (int p = 1; ux * (p - 1) < elc_params.far_cut && p <= n_scxcache; p++) {
+    for (int q = 1; Utils::sqr(ux * (p - 1)) + Utils::sqr(uy * (q - 1)) <
+                        elc_params.far_cut2 &&
+                    q <= n_scycache;
+         q++) {
+      far_terms.push_back(
+          {p, q, C_2PI * sqrt(Utils::sqr(ux * p) + Utils::sqr(uy * q)), size});
+      size += 8;
+    }
+  }
+  far_blocks.resize(size);
+
+  int const n_terms = static_cast<int>(far_terms.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int t = 0; t < n_terms; t++) {
+    auto const &term = far_terms[t];
+    auto *const blk = far_blocks.data() + term.offset;
+    if (term.q == 0)
+      setup_PoQ(scxcache, (term.p - 1) * n_localpart, term.omega, blk);
+    else if (term.p == 0)
+      setup_PoQ(scycache, (term.q - 1) * n_localpart, term.omega, blk);
+    else
+      setup_PQ(term.p, term.q, term.omega, blk);
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, far_blocks.data(), size, MPI_DOUBLE, MPI_SUM,
+                comm_cart);
+}
+
+/** Apply a function to the particle blocks of all terms of the far
+ *  formula for the local particle @p ic.
+ */
+template <typename F> void for_each_far_term(int ic, F f) {
+  auto const &part = *partptr[ic];
+  double partblk[8];
+  for (auto const &term : far_terms) {
+    auto const *const gblcblk = far_blocks.data() + term.offset;
+    double const e = exp(term.omega * part.r.p[2]);
+    if (term.q == 0)
+      PoQ_particle_block(scxcache, (term.p - 1) * n_localpart + ic, part.p.q,
+                         e, partblk);
+    else if (term.p == 0)
+      PoQ_particle_block(scycache, (term.q - 1) * n_localpart + ic, part.p.q,
+                         e, partblk);
+    else
+      PQ_particle_block((term.p - 1) * n_localpart + ic,
+                        (term.q - 1) * n_localpart + ic, part.p.q, e, partblk);
+    f(term, partblk, gblcblk);
+  }
+}
+
+void ELC_add_force() {
+  setup_far_terms();
 
   clear_log_forces("start");
 
@@ -1057,34 +948,21 @@ void ELC_add_force() {
 
   clear_log_forces("z_force");
 
-  /* the second condition is just for the case of numerical accident */
-  for (p = 1; ux * (p - 1) < elc_params.far_cut && p <= n_scxcache; p++) {
-    omega = C_2PI * ux * p;
-    setup_P(p, omega);
-    distribute(4);
-    add_P_force();
-    checkpoint("************distri p", p, 0, 2);
-  }
-
-  for (q = 1; uy * (q - 1) < elc_params.far_cut && q <= n_scycache; q++) {
-    omega = C_2PI * uy * q;
-    setup_Q(q, omega);
-    distribute(4);
-    add_Q_force();
-    checkpoint("************distri q", 0, q, 2);
-  }
-
-  for (p = 1; ux * (p - 1) < elc_params.far_cut && p <= n_scxcache; p++) {
-    for (q = 1; Utils::sqr(ux * (p - 1)) + Utils::sqr(uy * (q - 1)) <
-                    elc_params.far_cut2 &&
-                q <= n_scycache;
-         q++) {
-      omega = C_2PI * sqrt(Utils::sqr(ux * p) + Utils::sqr(uy * q));
-      setup_PQ(p, q, omega);
-      distribute(8);
-      add_PQ_force(p, q, omega);
-      checkpoint("************distri pq", p, q, 4);
-    }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int ic = 0; ic < n_localpart; ic++) {
+    auto &force = partptr[ic]->f.f;
+    for_each_far_term(ic, [&force](FarTerm const &term, double const *partblk,
+                                   double const *gblcblk) {
+      if (term.q == 0)
+        add_PoQ_force(partblk, gblcblk, force[0], force[2]);
+      else if (term.p == 0)
+        add_PoQ_force(partblk, gblcblk, force[1], force[2]);
+      else
+        add_PQ_force(partblk, gblcblk, C_2PI * ux * term.p / term.omega,
+                     C_2PI * uy * term.q / term.omega, force);
+    });
   }
 
   clear_log_forces("end");
@@ -1092,41 +970,26 @@ void ELC_add_force() {
 
 double ELC_energy() {
   double eng;
-  int p, q;
-  double omega;
 
   eng = dipole_energy();
   eng += z_energy();
-  prepare_scx_cache();
-  prepare_scy_cache();
+  setup_far_terms();
 
-  /* the second condition is just for the case of numerical accident */
-  for (p = 1; ux * (p - 1) < elc_params.far_cut && p <= n_scxcache; p++) {
-    omega = C_2PI * ux * p;
-    setup_P(p, omega);
-    distribute(4);
-    eng += P_energy(omega);
-    checkpoint("E************distri p", p, 0, 2);
-  }
-  for (q = 1; uy * (q - 1) < elc_params.far_cut && q <= n_scycache; q++) {
-    omega = C_2PI * uy * q;
-    setup_Q(q, omega);
-    distribute(4);
-    eng += Q_energy(omega);
-    checkpoint("E************distri q", 0, q, 2);
-  }
-  for (p = 1; ux * (p - 1) < elc_params.far_cut && p <= n_scxcache; p++) {
-    for (q = 1; Utils::sqr(ux * (p - 1)) + Utils::sqr(uy * (q - 1)) <
-                    elc_params.far_cut2 &&
-                q <= n_scycache;
-         q++) {
-      omega = C_2PI * sqrt(Utils::sqr(ux * p) + Utils::sqr(uy * q));
-      setup_PQ(p, q, omega);
-      distribute(8);
-      eng += PQ_energy(omega);
-      checkpoint("E************distri pq", p, q, 4);
-    }
+  double far_eng = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+ : far_eng)
+#endif
+  for (int ic = 0; ic < n_localpart; ic++) {
+    for_each_far_term(ic, [&far_eng](FarTerm const &term,
+                                     double const *partblk,
+                                     double const *gblcblk) {
+      far_eng += ((term.p == 0 || term.q == 0) ? PoQ_energy(partblk, gblcblk)
+                                               : PQ_energy(partblk, gblcblk)) /
+                 term.omega;
+    });
   }
+  eng += far_eng;
+
   /* we count both i<->j and j<->i, so return just half of it */
   return 0.5 * eng;
 }
@@ -1246,13 +1109,8 @@ void ELC_init() {
 }
 
 void ELC_on_resort_particles() {
-  n_localpart = cells_get_n_particles();
   n_scxcache = (int)(ceil(elc_params.far_cut / ux) + 1);
   n_scycache = (int)(ceil(elc_params.far_cut / uy) + 1);
-  scxcache.resize(n_scxcache * n_localpart);
-  scycache.resize(n_scycache * n_localpart);
-
-  partblk.resize(n_localpart * 8);
 }
 
 int ELC_set_params(double maxPWerror, double gap_size, double far_cut,
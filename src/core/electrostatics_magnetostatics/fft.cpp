@@ -38,7 +38,10 @@ using Utils::get_linear_index;
 #include <fftw3.h>
 #include <mpi.h>
 
+#include <algorithm>
 #include <cstring>
+#include <numeric>
+#include <vector>
 
 /************************************************
  * DEFINES
@@ -362,66 +365,149 @@ void pack_block_permute2(double const *const in, double *const out,
   }
 }
 
-/** Communicate the grid data according to the given forward FFT plan.
- *  \param plan   FFT communication plan.
- *  \param in     input mesh.
- *  \param out    output mesh.
- *  \param fft    FFT communication plan.
- *  \param comm   MPI communicator.
+/** Redistribute a mesh between two node grids.
+ *
+ *  All receives of the communication group are posted first. The send
+ *  blocks are then packed and sent with non-blocking communication in
+ *  the order of their last plane (slowest changing index of the input
+ *  mesh), and the receive blocks are unpacked as they arrive. If
+ *  @p plane_plan is given, the 1D FFTs of the input mesh are performed
+ *  plane by plane right before the first block which needs the plane
+ *  is packed, so that the FFTs overlap with the communication of the
+ *  blocks which are already on their way.
+ *
+ *  \param group         Communication group.
+ *  \param send_block    Send block specifications (input mesh).
+ *  \param send_size     Send block communication sizes.
+ *  \param recv_block    Recv block specifications (output mesh).
+ *  \param recv_size     Recv block communication sizes.
+ *  \param pack_function Packing function for the send blocks.
+ *  \param in_mesh       Size of the input mesh.
+ *  \param out_mesh      Size of the output mesh.
+ *  \param element       Size of a mesh element.
+ *  \param plane_plan    FFT of one plane of the input mesh (may be null).
+ *  \param tag           MPI tag.
+ *  \param in            input mesh.
+ *  \param out           output mesh.
+ *  \param fft           FFT communication plan.
+ *  \param comm          MPI communicator.
  */
-void forw_grid_comm(fft_forw_plan plan, const double *in, double *out,
-                    fft_data_struct &fft,
-                    const boost::mpi::communicator &comm) {
-  for (int i = 0; i < plan.group.size(); i++) {
-    plan.pack_function(in, fft.send_buf, &(plan.send_block[6 * i]),
-                       &(plan.send_block[6 * i + 3]), plan.old_mesh,
-                       plan.element);
-
-    if (plan.group[i] != comm.rank()) {
-      MPI_Sendrecv(fft.send_buf, plan.send_size[i], MPI_DOUBLE, plan.group[i],
-                   REQ_FFT_FORW, fft.recv_buf, plan.recv_size[i], MPI_DOUBLE,
-                   plan.group[i], REQ_FFT_FORW, comm, MPI_STATUS_IGNORE);
+void grid_comm(std::vector<int> const &group, int const *send_block,
+               int const *send_size, int const *recv_block,
+               int const *recv_size,
+               decltype(fft_forw_plan::pack_function) pack_function,
+               int const *in_mesh, int const *out_mesh, int element,
+               fftw_plan plane_plan, int tag, double *in, double *out,
+               fft_data_struct &fft, const boost::mpi::communicator &comm) {
+  auto const g_size = static_cast<int>(group.size());
+  std::vector<MPI_Request> recv_req(g_size, MPI_REQUEST_NULL);
+  std::vector<MPI_Request> send_req(g_size, MPI_REQUEST_NULL);
+  std::vector<int> recv_offset(g_size);
+
+  int offset = 0;
+  for (int i = 0; i < g_size; i++) {
+    recv_offset[i] = offset;
+    if (group[i] != comm.rank()) {
+      MPI_Irecv(fft.recv_buf + offset, recv_size[i], MPI_DOUBLE, group[i], tag,
+                comm, &recv_req[i]);
+    }
+    offset += recv_size[i];
+  }
+
+  auto unpack = [&](int i, double const *buf) {
+    fft_unpack_block(buf, out, &(recv_block[6 * i]), &(recv_block[6 * i + 3]),
+                     out_mesh, element);
+  };
+  /* unpack the blocks which have arrived, returns false if none is left */
+  auto unpack_arrived = [&](bool wait) {
+    int i, flag = 1;
+    if (wait)
+      MPI_Waitany(g_size, recv_req.data(), &i, MPI_STATUS_IGNORE);
+    else
+      MPI_Testany(g_size, recv_req.data(), &i, &flag, MPI_STATUS_IGNORE);
+    if (flag && i != MPI_UNDEFINED)
+      unpack(i, fft.recv_buf + recv_offset[i]);
+    return i != MPI_UNDEFINED;
+  };
+
+  auto const last_plane = [send_block](int i) {
+    return send_block[6 * i] + send_block[6 * i + 3];
+  };
+  std::vector<int> order(g_size);
+  std::iota(order.begin(), order.end(), 0);
+  if (plane_plan) {
+    std::stable_sort(order.begin(), order.end(), [&](int i, int j) {
+      return last_plane(i) < last_plane(j);
+    });
+  }
+
+  auto const plane_size = in_mesh[1] * in_mesh[2];
+  int planes_done = 0;
+  offset = 0;
+  for (auto const i : order) {
+    if (plane_plan) {
+      for (; planes_done < last_plane(i); planes_done++) {
+        auto *c_plane =
+            reinterpret_cast<fftw_complex *>(in) + planes_done * plane_size;
+        fftw_execute_dft(plane_plan, c_plane, c_plane);
+        unpack_arrived(false);
+      }
+    }
+    auto *buf = fft.send_buf + offset;
+    pack_function(in, buf, &(send_block[6 * i]), &(send_block[6 * i + 3]),
+                  in_mesh, element);
+    if (group[i] != comm.rank()) {
+      MPI_Isend(buf, send_size[i], MPI_DOUBLE, group[i], tag, comm,
+                &send_req[i]);
     } else { /* Self communication... */
-      std::swap(fft.send_buf, fft.recv_buf);
+      unpack(i, buf);
     }
-    fft_unpack_block(fft.recv_buf, out, &(plan.recv_block[6 * i]),
-                     &(plan.recv_block[6 * i + 3]), plan.new_mesh,
-                     plan.element);
+    offset += send_size[i];
   }
+
+  while (unpack_arrived(true))
+    ;
+  MPI_Waitall(g_size, send_req.data(), MPI_STATUSES_IGNORE);
+}
+
+/** Communicate the grid data according to the given forward FFT plan.
+ *  \param plan       FFT communication plan.
+ *  \param plane_plan FFT to perform on the input mesh before sending
+ *                    (may be null).
+ *  \param in         input mesh.
+ *  \param out        output mesh.
+ *  \param fft        FFT communication plan.
+ *  \param comm       MPI communicator.
+ */
+void forw_grid_comm(fft_forw_plan const &plan, fftw_plan plane_plan,
+                    double *in, double *out, fft_data_struct &fft,
+                    const boost::mpi::communicator &comm) {
+  grid_comm(plan.group, plan.send_block, plan.send_size, plan.recv_block,
+            plan.recv_size, plan.pack_function, plan.old_mesh, plan.new_mesh,
+            plan.element, plane_plan, REQ_FFT_FORW, in, out, fft, comm);
 }
 
 /** Communicate the grid data according to the given backward FFT plan.
- *  \param plan_f Forward FFT plan.
- *  \param plan_b Backward FFT plan.
- *  \param in     input mesh.
- *  \param out    output mesh.
- *  \param fft    FFT communication plan.
- *  \param comm   MPI communicator.
+ *  \param plan_f     Forward FFT plan.
+ *  \param plan_b     Backward FFT plan.
+ *  \param plane_plan FFT to perform on the input mesh before sending
+ *                    (may be null).
+ *  \param in         input mesh.
+ *  \param out        output mesh.
+ *  \param fft        FFT communication plan.
+ *  \param comm       MPI communicator.
  */
-void back_grid_comm(fft_forw_plan plan_f, fft_back_plan plan_b,
-                    const double *in, double *out, fft_data_struct &fft,
+void back_grid_comm(fft_forw_plan const &plan_f, fft_back_plan const &plan_b,
+                    fftw_plan plane_plan, double *in, double *out,
+                    fft_data_struct &fft,
                     const boost::mpi::communicator &comm) {
   /* Back means: Use the send/receive stuff from the forward plan but
      replace the receive blocks by the send blocks and vice
      versa. Attention then also new_mesh and old_mesh are exchanged */
-
-  for (int i = 0; i < plan_f.group.size(); i++) {
-    plan_b.pack_function(in, fft.send_buf, &(plan_f.recv_block[6 * i]),
-                         &(plan_f.recv_block[6 * i + 3]), plan_f.new_mesh,
-                         plan_f.element);
-
-    if (plan_f.group[i] != comm.rank()) { /* send first, receive second */
-      MPI_Sendrecv(fft.send_buf, plan_f.recv_size[i], MPI_DOUBLE,
-                   plan_f.group[i], REQ_FFT_BACK, fft.recv_buf,
-                   plan_f.send_size[i], MPI_DOUBLE, plan_f.group[i],
-                   REQ_FFT_BACK, comm, MPI_STATUS_IGNORE);
-    } else { /* Self communication... */
-      std::swap(fft.send_buf, fft.recv_buf);
-    }
-    fft_unpack_block(fft.recv_buf, out, &(plan_f.send_block[6 * i]),
-                     &(plan_f.send_block[6 * i + 3]), plan_f.old_mesh,
-                     plan_f.element);
-  }
+  grid_comm(plan_f.group, plan_f.recv_block, plan_f.recv_size,
+            plan_f.send_block, plan_f.send_size, plan_b.pack_function,
+            plan_f.new_mesh, plan_f.old_mesh, plan_f.element, plane_plan,
+            REQ_FFT_BACK, in, out, fft, comm);
 }
 
 /** calculate 'best' mapping between a 2d and 3d grid.
@@ -603,8 +689,6 @@ int fft_init(double **data, int const *ca_mesh_dim, int const *ca_mesh_margin,
                      -(fft.plan[i - 1].n_permute));
       permute_ifield(&(fft.plan[i].send_block[6 * j + 3]), 3,
                      -(fft.plan[i - 1].n_permute));
-      if (fft.plan[i].send_size[j] > fft.max_comm_size)
-        fft.max_comm_size = fft.plan[i].send_size[j];
       /* First plan send blocks have to be adjusted, since the CA grid
          may have an additional margin outside the actual domain of the
          node */
@@ -620,8 +704,6 @@ int fft_init(double **data, int const *ca_mesh_dim, int const *ca_mesh_margin,
                      -(fft.plan[i].n_permute));
       permute_ifield(&(fft.plan[i].recv_block[6 * j + 3]), 3,
                      -(fft.plan[i].n_permute));
-      if (fft.plan[i].recv_size[j] > fft.max_comm_size)
-        fft.max_comm_size = fft.plan[i].recv_size[j];
     }
 
     for (j = 0; j < 3; j++)
@@ -635,10 +717,17 @@ int fft_init(double **data, int const *ca_mesh_dim, int const *ca_mesh_margin,
         fft.plan[i].recv_size[j] *= 2;
       }
     }
+
+    /* all blocks of a group are in flight at the same time */
+    auto const n = static_cast<int>(fft.plan[i].group.size());
+    fft.max_comm_size =
+        std::max({fft.max_comm_size,
+                  std::accumulate(fft.plan[i].send_size,
+                                  fft.plan[i].send_size + n, 0),
+                  std::accumulate(fft.plan[i].recv_size,
+                                  fft.plan[i].recv_size + n, 0)});
   }
 
-  /* Factor 2 for complex fields */
-  fft.max_comm_size *= 2;
   fft.max_mesh_size = (ca_mesh_dim[0] * ca_mesh_dim[1] * ca_mesh_dim[2]);
   for (i = 1; i < 4; i++)
     if (2 * fft.plan[i].new_size > fft.max_mesh_size)
@@ -657,7 +746,6 @@ int fft_init(double **data, int const *ca_mesh_dim, int const *ca_mesh_margin,
     (*ks_pnum) = 5;
   }
 
-  /* Factor 2 for complex numbers */
   fft.send_buf =
       Utils::realloc(fft.send_buf, fft.max_comm_size * sizeof(double));
   fft.recv_buf =
@@ -674,6 +762,16 @@ int fft_init(double **data, int const *ca_mesh_dim, int const *ca_mesh_margin,
 
   auto *c_data = (fftw_complex *)(*data);
 
+  /* The plane plans are executed on every plane of the mesh, which
+     need not have the alignment of the first one. */
+  auto plane_flags = [&](int i) {
+    auto const plane_size = fft.plan[i].new_mesh[1] * fft.plan[i].new_mesh[2];
+    return (fftw_alignment_of(*data) ==
+            fftw_alignment_of(*data + 2 * plane_size))
+               ? FFTW_PATIENT
+               : FFTW_PATIENT | FFTW_UNALIGNED;
+  };
+
   /* === FFT Routines (Using FFTW / RFFTW package)=== */
   for (i = 1; i < 4; i++) {
     fft.plan[i].dir = FFTW_FORWARD;
@@ -687,6 +785,13 @@ int fft_init(double **data, int const *ca_mesh_dim, int const *ca_mesh_margin,
         1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
         fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
         fft.plan[i].dir, FFTW_PATIENT);
+
+    if (fft.init_tag)
+      fftw_destroy_plan(fft.plan[i].our_fftw_plane_plan);
+    fft.plan[i].our_fftw_plane_plan = fftw_plan_many_dft(
+        1, &fft.plan[i].new_mesh[2], fft.plan[i].new_mesh[1], c_data, nullptr,
+        1, fft.plan[i].new_mesh[2], c_data, nullptr, 1,
+        fft.plan[i].new_mesh[2], fft.plan[i].dir, plane_flags(i));
   }
 
   /* === The BACK Direction === */
@@ -701,6 +806,13 @@ int fft_init(double **data, int const *ca_mesh_dim, int const *ca_mesh_margin,
         fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
         fft.back[i].dir, FFTW_PATIENT);
 
+    if (fft.init_tag)
+      fftw_destroy_plan(fft.back[i].our_fftw_plane_plan);
+    fft.back[i].our_fftw_plane_plan = fftw_plan_many_dft(
+        1, &fft.plan[i].new_mesh[2], fft.plan[i].new_mesh[1], c_data, nullptr,
+        1, fft.plan[i].new_mesh[2], c_data, nullptr, 1,
+        fft.plan[i].new_mesh[2], fft.back[i].dir, plane_flags(i));
+
     fft.back[i].pack_function = pack_block_permute1;
   }
   if (fft.plan[1].row_dir == 2) {
@@ -723,26 +835,25 @@ void fft_perform_forw(double *data, fft_data_struct &fft,
   /* ===== first direction  ===== */
 
   auto *c_data = (fftw_complex *)data;
-  auto *c_data_buf = (fftw_complex *)fft.data_buf;
 
   /* communication to current dir row format (in is data) */
-  forw_grid_comm(fft.plan[1], data, fft.data_buf, fft, comm);
+  forw_grid_comm(fft.plan[1], nullptr, data, fft.data_buf, fft, comm);
 
   /* complexify the real data array (in is fft.data_buf) */
   for (int i = 0; i < fft.plan[1].new_size; i++) {
     data[2 * i + 0] = fft.data_buf[i]; /* real value */
     data[2 * i + 1] = 0;               /* complex value */
   }
-  /* perform FFT (in/out is data)*/
-  fftw_execute_dft(fft.plan[1].our_fftw_plan, c_data, c_data);
   /* ===== second direction ===== */
-  /* communication to current dir row format (in is data) */
-  forw_grid_comm(fft.plan[2], data, fft.data_buf, fft, comm);
-  /* perform FFT (in/out is fft.data_buf)*/
-  fftw_execute_dft(fft.plan[2].our_fftw_plan, c_data_buf, c_data_buf);
+  /* perform FFT of the first direction plane by plane (in/out is data)
+     and communicate to current dir row format */
+  forw_grid_comm(fft.plan[2], fft.plan[1].our_fftw_plane_plan, data,
+                 fft.data_buf, fft, comm);
   /* ===== third direction  ===== */
-  /* communication to current dir row format (in is fft.data_buf) */
-  forw_grid_comm(fft.plan[3], fft.data_buf, data, fft, comm);
+  /* perform FFT of the second direction plane by plane (in/out is
+     fft.data_buf) and communicate to current dir row format */
+  forw_grid_comm(fft.plan[3], fft.plan[2].our_fftw_plane_plan, fft.data_buf,
+                 data, fft, comm);
   /* perform FFT (in/out is data)*/
   fftw_execute_dft(fft.plan[3].our_fftw_plan, c_data, c_data);
 
@@ -754,20 +865,17 @@ void fft_perform_back(double *data, bool check_complex, fft_data_struct &fft,
   int i;
 
   auto *c_data = (fftw_complex *)data;
-  auto *c_data_buf = (fftw_complex *)fft.data_buf;
 
   /* ===== third direction  ===== */
 
-  /* perform FFT (in is data) */
-  fftw_execute_dft(fft.back[3].our_fftw_plan, c_data, c_data);
-  /* communicate (in is data)*/
-  back_grid_comm(fft.plan[3], fft.back[3], data, fft.data_buf, fft, comm);
+  /* perform FFT plane by plane and communicate (in is data) */
+  back_grid_comm(fft.plan[3], fft.back[3], fft.back[3].our_fftw_plane_plan,
+                 data, fft.data_buf, fft, comm);
 
   /* ===== second direction ===== */
-  /* perform FFT (in is fft.data_buf) */
-  fftw_execute_dft(fft.back[2].our_fftw_plan, c_data_buf, c_data_buf);
-  /* communicate (in is fft.data_buf) */
-  back_grid_comm(fft.plan[2], fft.back[2], fft.data_buf, data, fft, comm);
+  /* perform FFT plane by plane and communicate (in is fft.data_buf) */
+  back_grid_comm(fft.plan[2], fft.back[2], fft.back[2].our_fftw_plane_plan,
+                 fft.data_buf, data, fft, comm);
 
   /* ===== first direction  ===== */
   /* perform FFT (in is data) */
@@ -784,7 +892,8 @@ void fft_perform_back(double *data, bool check_complex, fft_data_struct &fft,
     }
   }
   /* communicate (in is fft.data_buf) */
-  back_grid_comm(fft.plan[1], fft.back[1], fft.data_buf, data, fft, comm);
+  back_grid_comm(fft.plan[1], fft.back[1], nullptr, fft.data_buf, data, fft,
+                 comm);
 
   /* REMARK: Result has to be in data. */
 }
@@ -31,6 +31,12 @@
  *  1D-FFT. After performing the FFT on that direction the data is
  *  redistributed.
  *
+ *  The redistribution uses non-blocking point-to-point communication
+ *  within the communication groups. The 1D-FFTs preceding a
+ *  redistribution are done plane by plane, and each block is sent as
+ *  soon as its planes are transformed, so that the remaining FFTs
+ *  overlap with the communication.
+ *
  *  For simplicity at the moment I have implemented a full complex to
  *  complex FFT (even though a real to complex FFT would be
  *  sufficient)
@@ -70,6 +76,8 @@ struct fft_forw_plan {
   int n_ffts;
   /** plan for fft. */
   fftw_plan our_fftw_plan;
+  /** plan for the ffts of one plane (rows with the same slow index). */
+  fftw_plan our_fftw_plane_plan;
 
   /** size of local mesh before communication. */
   int old_mesh[3];
@@ -104,6 +112,8 @@ struct fft_back_plan {
   int dir;
   /** plan for fft. */
   fftw_plan our_fftw_plan;
+  /** plan for the ffts of one plane (rows with the same slow index). */
+  fftw_plan our_fftw_plane_plan;
 
   /** packing function for send blocks. */
   void (*pack_function)(double const *const, double *const, int const *,
@@ -126,7 +136,8 @@ struct fft_data_struct {
   /** Whether FFT is initialized or not. */
   bool init_tag = false;
 
-  /** Maximal size of the communication buffers. */
+  /** Maximal size of the communication buffers (sum over all blocks
+   *  of a communication group). */
   int max_comm_size = 0;
 
   /** Maximal local mesh size. */
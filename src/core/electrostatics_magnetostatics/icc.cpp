@@ -28,11 +28,14 @@
 
 #ifdef ELECTROSTATICS
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <vector>
 
 #include "electrostatics_magnetostatics/p3m_gpu.hpp"
 
@@ -42,6 +45,7 @@
 #include "errorhandling.hpp"
 #include "event.hpp"
 #include "forces.hpp"
+#include "integrate.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "particle_data.hpp"
 
@@ -77,6 +81,168 @@ inline void add_non_bonded_pair_force_iccp3m(Particle *p1, Particle *p2,
   p2->f.f -= force;
 }
 
+namespace {
+/** Converged induced charges of the last two time steps, for the
+ *  extrapolation in time. Every node holds all charges.
+ */
+struct ChargeHistory {
+  std::vector<double> q[2];
+  double time[2];
+  int size = 0;
+
+  void clear() { size = 0; }
+
+  /** Store the charges of time @p t, replacing those of the same time. */
+  void push(double t, std::vector<double> charges) {
+    if (size > 0 and t == time[1]) {
+      q[1] = std::move(charges);
+      return;
+    }
+    std::swap(q[0], q[1]);
+    time[0] = time[1];
+    q[1] = std::move(charges);
+    time[1] = t;
+    size = std::min(size + 1, 2);
+  }
+
+  /** Whether the charges at time @p t can be extrapolated. */
+  bool can_extrapolate(double t) const {
+    return size == 2 and t > time[1] and time[1] > time[0];
+  }
+
+  double extrapolate(int id, double t) const {
+    auto const w = (t - time[1]) / (time[1] - time[0]);
+    return q[1][id] + w * (q[1][id] - q[0][id]);
+  }
+};
+
+ChargeHistory charge_history;
+
+/** Solve the small dense system @p a x = @p b by Gaussian elimination with
+ *  partial pivoting. @p b is overwritten with the solution.
+ *  @return false if the matrix is singular.
+ */
+bool solve_dense(std::vector<double> a, std::vector<double> &b) {
+  auto const n = static_cast<int>(b.size());
+  for (int k = 0; k < n; k++) {
+    int piv = k;
+    for (int i = k + 1; i < n; i++)
+      if (std::abs(a[i * n + k]) > std::abs(a[piv * n + k]))
+        piv = i;
+    if (a[piv * n + k] == 0.)
+      return false;
+    if (piv != k) {
+      for (int j = 0; j < n; j++)
+        std::swap(a[k * n + j], a[piv * n + j]);
+      std::swap(b[k], b[piv]);
+    }
+    for (int i = k + 1; i < n; i++) {
+      auto const l = a[i * n + k] / a[k * n + k];
+      for (int j = k; j < n; j++)
+        a[i * n + j] -= l * a[k * n + j];
+      b[i] -= l * b[k];
+    }
+  }
+  for (int k = n - 1; k >= 0; k--) {
+    for (int j = k + 1; j < n; j++)
+      b[k] -= a[k * n + j] * b[j];
+    b[k] /= a[k * n + k];
+  }
+  return true;
+}
+
+/** Anderson mixing for the fixed-point problem x = g(x), distributed over
+ *  the nodes. Each node passes its part of the iterate and of the map; the
+ *  least-squares problem for the mixing coefficients is reduced over all
+ *  nodes, so every node has to call this the same number of times.
+ */
+class AndersonMixing {
+public:
+  AndersonMixing(int depth, double beta) : m_depth(depth), m_beta(beta) {}
+
+  std::vector<double> operator()(std::vector<double> const &x,
+                                 std::vector<double> const &g) {
+    auto const n = x.size();
+    std::vector<double> f(n);
+    for (std::size_t i = 0; i < n; i++)
+      f[i] = g[i] - x[i];
+
+    /* The history has the same length on all nodes, also on nodes without
+     * particles, where the differences are empty. */
+    if (m_iterations++ > 0) {
+      m_dx.emplace_back(n);
+      m_df.emplace_back(n);
+      for (std::size_t i = 0; i < n; i++) {
+        m_dx.back()[i] = x[i] - m_x[i];
+        m_df.back()[i] = f[i] - m_f[i];
+      }
+      if (m_dx.size() > static_cast<std::size_t>(m_depth)) {
+        m_dx.pop_front();
+        m_df.pop_front();
+      }
+    }
+    m_x = x;
+    m_f = f;
+
+    /* Normal equations of min |f - df gamma| */
+    auto const m = static_cast<int>(m_df.size());
+    std::vector<double> sys(m * m + m, 0.);
+    for (int a = 0; a < m; a++) {
+      for (int b = 0; b <= a; b++)
+        sys[a * m + b] = dot(m_df[a], m_df[b]);
+      sys[m * m + a] = dot(m_df[a], f);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, sys.data(), static_cast<int>(sys.size()),
+                  MPI_DOUBLE, MPI_SUM, comm_cart);
+
+    std::vector<double> a(m * m);
+    double trace = 0.;
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j <= i; j++)
+        a[i * m + j] = a[j * m + i] = sys[i * m + j];
+      trace += a[i * m + i];
+    }
+    /* Tikhonov regularization against nearly collinear differences */
+    for (int i = 0; i < m; i++)
+      a[i * m + i] += 1e-10 * trace / m;
+    std::vector<double> gamma(sys.begin() + m * m, sys.end());
+    if (not solve_dense(std::move(a), gamma)) {
+      m_dx.clear();
+      m_df.clear();
+      gamma.clear();
+    }
+
+    std::vector<double> x_new(n);
+    for (std::size_t i = 0; i < n; i++) {
+      x_new[i] = x[i] + m_beta * f[i];
+      for (std::size_t k = 0; k < gamma.size(); k++)
+        x_new[i] -= gamma[k] * (m_dx[k][i] + m_beta * m_df[k][i]);
+    }
+    return x_new;
+  }
+
+private:
+  static double dot(std::vector<double> const &u,
+                    std::vector<double> const &v) {
+    double s = 0.;
+    for (std::size_t i = 0; i < u.size(); i++)
+      s += u[i] * v[i];
+    return s;
+  }
+
+  int m_depth;
+  double m_beta;
+  int m_iterations = 0;
+  std::vector<double> m_x, m_f;
+  std::deque<std::vector<double>> m_dx, m_df;
+};
+
+bool is_induced(Particle const &p) {
+  return p.p.identity < iccp3m_cfg.n_ic + iccp3m_cfg.first_id &&
+         p.p.identity >= iccp3m_cfg.first_id;
+}
+} // namespace
+
 void iccp3m_alloc_lists() {
   auto const n_ic = iccp3m_cfg.n_ic;
 
@@ -84,6 +250,8 @@ void iccp3m_alloc_lists() {
   iccp3m_cfg.ein.resize(n_ic);
   iccp3m_cfg.normals.resize(n_ic);
   iccp3m_cfg.sigma.resize(n_ic);
+
+  charge_history.clear();
 }
 
 int iccp3m_iteration() {
@@ -100,6 +268,23 @@ int iccp3m_iteration() {
   auto const pref = 1.0 / (coulomb.prefactor * 6.283185307);
   iccp3m_cfg.citeration = 0;
 
+  /* The particles do not move during the iteration */
+  std::vector<Particle *> induced;
+  for (auto &p : local_cells.particles()) {
+    if (is_induced(p))
+      induced.push_back(&p);
+  }
+
+  if (iccp3m_cfg.extrapolate and charge_history.can_extrapolate(sim_time)) {
+    for (auto p : induced)
+      p->p.q = charge_history.extrapolate(
+          p->p.identity - iccp3m_cfg.first_id, sim_time);
+    ghost_communicator(&cell_structure.exchange_ghosts_comm);
+  }
+
+  AndersonMixing anderson(iccp3m_cfg.anderson_depth, iccp3m_cfg.relax);
+  std::vector<double> h_old(induced.size()), h_map(induced.size());
+
   double globalmax = 1e100;
 
   for (int j = 0; j < iccp3m_cfg.num_iteration; j++) {
@@ -111,60 +296,72 @@ int iccp3m_iteration() {
 
     double diff = 0;
 
-    for (auto &p : local_cells.particles()) {
-      if (p.p.identity < iccp3m_cfg.n_ic + iccp3m_cfg.first_id &&
-          p.p.identity >= iccp3m_cfg.first_id) {
-        auto const id = p.p.identity - iccp3m_cfg.first_id;
-        /* the dielectric-related prefactor: */
-        auto const del_eps = (iccp3m_cfg.ein[id] - iccp3m_cfg.eout) /
-                             (iccp3m_cfg.ein[id] + iccp3m_cfg.eout);
-        /* calculate the electric field at the certain position */
-        auto const E = p.f.f / p.p.q + iccp3m_cfg.ext_field;
-
-        if (E[0] == 0 && E[1] == 0 && E[2] == 0) {
-          runtimeErrorMsg()
-              << "ICCP3M found zero electric field on a charge. This must "
-                 "never happen";
-        }
-
-        /* recalculate the old charge density */
-        auto const hold = p.p.q / iccp3m_cfg.areas[id];
-        /* determine if it is higher than the previously highest charge
-         * density */
-        hmax = std::max(hmax, std::abs(hold));
-
-        auto const f1 = del_eps * pref * (E * iccp3m_cfg.normals[id]);
-        auto const f2 = (not iccp3m_cfg.sigma.empty())
-                            ? (2 * iccp3m_cfg.eout) /
-                                  (iccp3m_cfg.eout + iccp3m_cfg.ein[id]) *
-                                  (iccp3m_cfg.sigma[id])
-                            : 0.;
-        /* relative variation: never use an estimator which can be negative
-         * here */
-        auto const hnew =
-            (1. - iccp3m_cfg.relax) * hold + (iccp3m_cfg.relax) * (f1 + f2);
-
-        /* Take the largest error to check for convergence */
-        auto const relative_difference =
-            std::abs(1 * (hnew - hold) / (hmax + std::abs(hnew + hold)));
-
-        diff = std::max(diff, relative_difference);
-
-        p.p.q = hnew * iccp3m_cfg.areas[id];
-
-        /* check if the charge now is more than 1e6, to determine if ICC still
-         * leads to reasonable results */
-        /* this is kind a arbitrary measure but, does a good job spotting
-         * divergence !*/
-        if (std::abs(p.p.q) > 1e6) {
-          runtimeErrorMsg()
-              << "too big charge assignment in iccp3m! q >1e6 , assigned "
-                 "charge= "
-              << p.p.q;
-
-          diff = 1e90; /* A very high value is used as error code */
-          break;
-        }
+    for (std::size_t i = 0; i < induced.size(); i++) {
+      auto const &p = *induced[i];
+      auto const id = p.p.identity - iccp3m_cfg.first_id;
+      /* the dielectric-related prefactor: */
+      auto const del_eps = (iccp3m_cfg.ein[id] - iccp3m_cfg.eout) /
+                           (iccp3m_cfg.ein[id] + iccp3m_cfg.eout);
+      /* calculate the electric field at the certain position */
+      auto const E = p.f.f / p.p.q + iccp3m_cfg.ext_field;
+
+      if (E[0] == 0 && E[1] == 0 && E[2] == 0) {
+        runtimeErrorMsg()
+            << "ICCP3M found zero electric field on a charge. This must "
+               "never happen";
+      }
+
+      /* recalculate the old charge density */
+      h_old[i] = p.p.q / iccp3m_cfg.areas[id];
+
+      auto const f1 = del_eps * pref * (E * iccp3m_cfg.normals[id]);
+      auto const f2 = (not iccp3m_cfg.sigma.empty())
+                          ? (2 * iccp3m_cfg.eout) /
+                                (iccp3m_cfg.eout + iccp3m_cfg.ein[id]) *
+                                (iccp3m_cfg.sigma[id])
+                          : 0.;
+      h_map[i] = f1 + f2;
+    }
+
+    std::vector<double> h_new;
+    if (iccp3m_cfg.anderson_depth > 0) {
+      h_new = anderson(h_old, h_map);
+    } else {
+      h_new.resize(induced.size());
+      for (std::size_t i = 0; i < induced.size(); i++)
+        h_new[i] =
+            (1. - iccp3m_cfg.relax) * h_old[i] + (iccp3m_cfg.relax) * h_map[i];
+    }
+
+    for (std::size_t i = 0; i < induced.size(); i++) {
+      auto &p = *induced[i];
+      auto const id = p.p.identity - iccp3m_cfg.first_id;
+      auto const hold = h_old[i];
+      auto const hnew = h_new[i];
+      /* determine if it is higher than the previously highest charge
+       * density */
+      hmax = std::max(hmax, std::abs(hold));
+
+      /* Take the largest error to check for convergence */
+      auto const relative_difference =
+          std::abs(1 * (hnew - hold) / (hmax + std::abs(hnew + hold)));
+
+      diff = std::max(diff, relative_difference);
+
+      p.p.q = hnew * iccp3m_cfg.areas[id];
+
+      /* check if the charge now is more than 1e6, to determine if ICC still
+       * leads to reasonable results */
+      /* this is kind a arbitrary measure but, does a good job spotting
+       * divergence !*/
+      if (std::abs(p.p.q) > 1e6) {
+        runtimeErrorMsg()
+            << "too big charge assignment in iccp3m! q >1e6 , assigned "
+               "charge= "
+            << p.p.q;
+
+        diff = 1e90; /* A very high value is used as error code */
+        break;
       }
     } /* cell particles */
     /* Update charges on ghosts. */
@@ -183,6 +380,15 @@ int iccp3m_iteration() {
         << "ICC failed to converge in the given number of maximal steps.";
   }
 
+  if (iccp3m_cfg.extrapolate) {
+    std::vector<double> charges(iccp3m_cfg.n_ic, 0.);
+    for (auto const p : induced)
+      charges[p->p.identity - iccp3m_cfg.first_id] = p->p.q;
+    MPI_Allreduce(MPI_IN_PLACE, charges.data(), iccp3m_cfg.n_ic, MPI_DOUBLE,
+                  MPI_SUM, comm_cart);
+    charge_history.push(sim_time, std::move(charges));
+  }
+
   on_particle_charge_change();
 
   return iccp3m_cfg.citeration;
@@ -46,6 +46,16 @@
  *  calculation was modified to avoid the calculation of the short
  *  range part of the source-source force calculation.  For different
  *  particle data organisation schemes this is performed differently.
+ *
+ *  Every iteration needs a full Coulomb force calculation. Instead of the
+ *  damped fixed-point iteration, the induced charge densities can be
+ *  updated by Anderson mixing (D. G. Anderson, J. ACM 12, p. 547, 1965;
+ *  H. F. Walker, P. Ni, SIAM J. Numer. Anal. 49, p. 1715, 2011), which
+ *  combines the last @ref iccp3m_struct::anderson_depth iterates to
+ *  minimize the residual of the fixed-point map. The iteration can
+ *  furthermore start from the charges of the last two time steps
+ *  extrapolated linearly to the current time, see
+ *  @ref iccp3m_struct::extrapolate.
  */
 
 #ifndef CORE_ICCP3M_HPP
@@ -72,6 +82,10 @@ struct iccp3m_struct {
   double relax = 0.7; /* relaxation parameter for iterative */
   int citeration = 0; /* current number of iterations*/
   int first_id = 0;
+  int anderson_depth = 0; /* Number of previous iterates used for Anderson
+                             mixing, 0 for the damped fixed-point iteration */
+  bool extrapolate = false; /* Start from the charges of the previous time
+                               steps, extrapolated linearly in time */
 
   template <typename Archive>
   void serialize(Archive &ar, long int /* version */) {
@@ -87,6 +101,8 @@ struct iccp3m_struct {
     ar &sigma;
     ar &ext_field;
     ar &citeration;
+    ar &anderson_depth;
+    ar &extrapolate;
   }
 };
 extern iccp3m_struct iccp3m_cfg; /* global variable with ICCP3M configuration */
@@ -96,7 +112,8 @@ extern iccp3m_struct iccp3m_cfg; /* global variable with ICCP3M configuration */
  */
 int iccp3m_iteration();
 
-/** The allocation of ICCP3M lists for python interface
+/** The allocation of ICCP3M lists for python interface. This also
+ *  discards the charges stored for the extrapolation in time.
  */
 void iccp3m_alloc_lists();
 
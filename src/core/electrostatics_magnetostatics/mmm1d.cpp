@@ -43,6 +43,10 @@ using Utils::strcat_alloc;
 #include <utils/constants.hpp>
 #include <utils/math/sqr.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 /** How many trial calculations */
 #define TEST_INTEGRATIONS 1000
 
@@ -68,7 +72,7 @@ using Utils::strcat_alloc;
 static double uz, L2, uz2, prefuz2, prefL3_i;
 /*@}*/
 
-MMM1D_struct mmm1d_params = {0.05, 1e-5, 0};
+MMM1D_struct mmm1d_params = {0.05, 1e-5, 0, -1};
 /** From which distance a certain Bessel cutoff is valid. Can't be part of the
     params since these get broadcasted. */
 static std::vector<double> bessel_radii;
@@ -137,10 +141,11 @@ static void prepare_polygamma_series(double maxPWerror, double maxrad2) {
   } while (err > 0.1 * maxPWerror);
 }
 
-int MMM1D_set_params(double switch_rad, double maxPWerror) {
+int MMM1D_set_params(double switch_rad, double maxPWerror, double near_cut) {
   mmm1d_params.far_switch_radius_2 =
       (switch_rad > 0) ? Utils::sqr(switch_rad) : -1;
   mmm1d_params.maxPWerror = maxPWerror;
+  mmm1d_params.near_cut = (near_cut > 0) ? near_cut : -1;
   coulomb.method = COULOMB_MMM1D;
 
   mpi_bcast_coulomb_params();
@@ -155,13 +160,318 @@ int MMM1D_sanity_checks() {
     return 1;
   }
 
-  if (cell_structure.type != CELL_STRUCTURE_NSQUARE) {
+  if (mmm1d_params.near_cut > 0) {
+    if (mmm1d_params.near_cut >= 0.5 * box_geo.length()[2]) {
+      runtimeErrorMsg() << "MMM1D near cutoff has to be smaller than half the "
+                           "box length in z";
+      return 1;
+    }
+  } else if (cell_structure.type != CELL_STRUCTURE_NSQUARE) {
     runtimeErrorMsg() << "MMM1D requires n-square cellsystem";
     return 1;
   }
   return 0;
 }
 
+/** Near formula of the force without the interaction with the primary
+ *  image.
+ *  @param[in]  rxy2   squared radial distance
+ *  @param[in]  z      axial distance, at most half the box length
+ *  @param[out] f_rho  radial force divided by the radial distance
+ *  @param[out] f_z    axial force
+ */
+static void near_force(double rxy2, double z, double &f_rho, double &f_z) {
+  double rxy2_d = rxy2 * uz2;
+  double z_d = z * uz;
+
+  /* polygamma summation */
+  double sr = 0;
+  double sz = mod_psi_odd(0, z_d);
+
+  double r2nm1 = 1.0;
+  for (int n = 1; n < n_modPsi; n++) {
+    double deriv = 2 * n;
+    double mpe = mod_psi_even(n, z_d);
+    double mpo = mod_psi_odd(n, z_d);
+    double r2n = r2nm1 * rxy2_d;
+
+    sz += r2n * mpo;
+    sr += deriv * r2nm1 * mpe;
+
+    if (fabs(deriv * r2nm1 * mpe) < mmm1d_params.maxPWerror)
+      break;
+
+    r2nm1 = r2n;
+  }
+
+  f_rho = prefL3_i * sr;
+  f_z = prefuz2 * sz;
+
+  /* real space parts of the two neighboring images */
+  for (double shift_z : {z + box_geo.length()[2], z - box_geo.length()[2]}) {
+    double rt2 = rxy2 + shift_z * shift_z;
+    double pref = 1. / (rt2 * sqrt(rt2));
+    f_rho += pref;
+    f_z += pref * shift_z;
+  }
+}
+
+/** Far formula of the force, see @ref near_force for the parameters. */
+static void far_force(double rxy2, double z, double &f_rho, double &f_z) {
+  double rxy = sqrt(rxy2);
+  double rxy_d = rxy * uz;
+  double z_d = z * uz;
+  double sr = 0, sz = 0;
+
+  for (int bp = 1; bp < MAXIMAL_B_CUT; bp++) {
+    if (bessel_radii[bp - 1] < rxy)
+      break;
+
+    double fq = C_2PI * bp, k0, k1;
+#ifdef BESSEL_MACHINE_PREC
+    k0 = K0(fq * rxy_d);
+    k1 = K1(fq * rxy_d);
+#else
+    LPK01(fq * rxy_d, &k0, &k1);
+#endif
+    sr += bp * k1 * cos(fq * z_d);
+    sz += bp * k0 * sin(fq * z_d);
+  }
+  sr *= uz2 * 4 * C_2PI;
+  sz *= uz2 * 4 * C_2PI;
+
+  f_rho = sr / rxy + 2 * uz / rxy2;
+  f_z = sz;
+}
+
+/** Near formula of the energy without the interaction with the primary
+ *  image, see @ref near_force for the parameters.
+ */
+static double near_energy(double rxy2, double z) {
+  double rxy2_d = rxy2 * uz2;
+  double z_d = z * uz;
+
+  double E = -2 * C_GAMMA;
+
+  /* polygamma summation */
+  double r2n = 1.0;
+  for (int n = 0; n < n_modPsi; n++) {
+    double add = mod_psi_even(n, z_d) * r2n;
+    E -= add;
+
+    if (fabs(add) < mmm1d_params.maxPWerror)
+      break;
+
+    r2n *= rxy2_d;
+  }
+  E *= uz;
+
+  /* real space parts of the two neighboring images */
+  for (double shift_z : {z + box_geo.length()[2], z - box_geo.length()[2]}) {
+    E += 1 / sqrt(rxy2 + shift_z * shift_z);
+  }
+
+  return E;
+}
+
+/** Far formula of the energy, see @ref near_force for the parameters. */
+static double far_energy(double rxy2, double z) {
+  double rxy = sqrt(rxy2);
+  double rxy_d = rxy * uz;
+  double z_d = z * uz;
+  /* The first Bessel term will compensate a little bit the
+     log term, so add them close together */
+  double E = -0.25 * log(rxy2 * uz2) + 0.5 * (M_LN2 - C_GAMMA);
+  for (int bp = 1; bp < MAXIMAL_B_CUT; bp++) {
+    if (bessel_radii[bp - 1] < rxy)
+      break;
+
+    double fq = C_2PI * bp;
+    E += K0(fq * rxy_d) * cos(fq * z_d);
+  }
+  return E * 4 * uz;
+}
+
+/** Force of all images except the primary one, which is smooth for
+ *  axial distances of at most half the box length. See @ref near_force
+ *  for the parameters.
+ */
+static void image_force(double rxy2, double z, double &f_rho, double &f_z) {
+  if (rxy2 <= mmm1d_params.far_switch_radius_2) {
+    near_force(rxy2, z, f_rho, f_z);
+  } else {
+    far_force(rxy2, z, f_rho, f_z);
+    double r2 = rxy2 + z * z;
+    double pref = 1. / (r2 * sqrt(r2));
+    f_rho -= pref;
+    f_z -= pref * z;
+  }
+}
+
+/** Energy of all images except the primary one, see @ref image_force. */
+static double image_energy(double rxy2, double z) {
+  if (rxy2 <= mmm1d_params.far_switch_radius_2)
+    return near_energy(rxy2, z);
+  return far_energy(rxy2, z) - 1 / sqrt(rxy2 + z * z);
+}
+
+/** @name Tabulated image interaction */
+/*@{*/
+/** Largest number of nodes of the image table */
+#define MAX_TABLE_NODES (1 << 18)
+
+/** Radial force divided by the radial distance, axial force and energy of
+ *  all images except the primary one on a regular grid with spacing
+ *  @ref ImageTable::h. The grid has one node beyond the largest radial
+ *  distance and half the box length in z, so that the cubic interpolation
+ *  does not need to handle the boundaries specially. The nodes at negative
+ *  distances are obtained by symmetry.
+ */
+struct ImageTable {
+  double h = 0;
+  double h_i = 0;
+  int n_rho = 0;
+  int n_z = 0;
+  std::vector<double> data;
+};
+static ImageTable image_table;
+
+/** Cubic Catmull-Rom interpolation weights at @p t in [0, 1]. */
+static void catmull_rom_weights(double t, double w[4]) {
+  w[0] = 0.5 * ((2 - t) * t - 1) * t;
+  w[1] = 0.5 * ((3 * t - 5) * t * t + 2);
+  w[2] = 0.5 * ((4 - 3 * t) * t + 1) * t;
+  w[3] = 0.5 * (t - 1) * t * t;
+}
+
+/** Interpolate the image interaction from @p table.
+ *  @param[in]  table  image table
+ *  @param[in]  rho    radial distance
+ *  @param[in]  z      axial distance, at most half the box length
+ *  @param[out] v      radial force divided by the radial distance, axial
+ *                     force and energy
+ *  @return whether @p rho is covered by the table
+ */
+static bool interpolate_images(ImageTable const &table, double rho, double z,
+                               double v[3]) {
+  double x = rho * table.h_i;
+  if (!(x <= table.n_rho - 2))
+    return false;
+  double y = fabs(z) * table.h_i;
+  int k = std::min(static_cast<int>(x), table.n_rho - 3);
+  int j = std::min(static_cast<int>(y), table.n_z - 3);
+
+  double wr[4], wz[4];
+  catmull_rom_weights(x - k, wr);
+  catmull_rom_weights(y - j, wz);
+
+  v[0] = v[1] = v[2] = 0;
+  for (int a = 0; a < 4; a++) {
+    /* the interaction is even in the radial distance */
+    auto const row = &table.data[3 * table.n_z * std::abs(k - 1 + a)];
+    double t[3] = {0, 0, 0};
+    for (int b = 0; b < 4; b++) {
+      /* the axial force is odd in z, the rest even */
+      int jb = j - 1 + b;
+      double sign = (jb < 0) ? -1 : 1;
+      auto const node = row + 3 * std::abs(jb);
+      t[0] += wz[b] * node[0];
+      t[1] += wz[b] * sign * node[1];
+      t[2] += wz[b] * node[2];
+    }
+    for (int c = 0; c < 3; c++)
+      v[c] += wr[a] * t[c];
+  }
+  if (z < 0)
+    v[1] = -v[1];
+  return true;
+}
+
+/** Calculate a node of the image table at axial distance @p z, which may
+ *  exceed half the box length.
+ */
+static void image_node(double rho, double z, double v[3]) {
+  double rxy2 = rho * rho;
+  if (z <= 0.5 * box_geo.length()[2]) {
+    image_force(rxy2, z, v[0], v[1]);
+    v[2] = image_energy(rxy2, z);
+    return;
+  }
+  /* beyond half the box, the nearest image is the one at z - L, so the
+     primary image has to be exchanged */
+  double zi = z - box_geo.length()[2];
+  image_force(rxy2, zi, v[0], v[1]);
+  v[2] = image_energy(rxy2, zi);
+  auto add_primary = [&](double shift_z, double sign) {
+    double r2 = rxy2 + shift_z * shift_z;
+    double r = sqrt(r2);
+    v[0] += sign / (r2 * r);
+    v[1] += sign * shift_z / (r2 * r);
+    v[2] += sign / r;
+  };
+  add_primary(zi, 1);
+  add_primary(z, -1);
+}
+
+/** Set up the image table with the smallest number of axial intervals
+ *  \f$ 2^n \f$ for which the interpolation error at the centers of the
+ *  grid cells is below @ref MMM1D_struct::maxPWerror. If this cannot be
+ *  reached with @ref MAX_TABLE_NODES nodes, the table stays empty and the
+ *  image interaction is always calculated directly.
+ */
+static void setup_image_table() {
+  image_table = ImageTable{};
+  if (mmm1d_params.near_cut <= 0)
+    return;
+
+  auto const rho_max = std::hypot(box_geo.length()[0], box_geo.length()[1]);
+  auto const n_nodes_of = [rho_max](int n_intervals) {
+    double h_i = 2. * n_intervals / box_geo.length()[2];
+    return (static_cast<int>(ceil(rho_max * h_i)) + 2) * (n_intervals + 2);
+  };
+
+  for (int n_intervals = 8; n_nodes_of(n_intervals) <= MAX_TABLE_NODES;
+       n_intervals *= 2) {
+    ImageTable table;
+    table.h = 0.5 * box_geo.length()[2] / n_intervals;
+    table.h_i = 1. / table.h;
+    table.n_z = n_intervals + 2;
+    table.n_rho = n_nodes_of(n_intervals) / table.n_z;
+
+    table.data.resize(3 * table.n_rho * table.n_z);
+    for (int k = 0; k < table.n_rho; k++)
+      for (int j = 0; j < table.n_z; j++)
+        image_node(k * table.h, j * table.h,
+                   &table.data[3 * (k * table.n_z + j)]);
+
+    double error = 0;
+    for (int k = 0; k < table.n_rho - 2; k++)
+      for (int j = 0; j < table.n_z - 2; j++) {
+        double rho = (k + 0.5) * table.h, z = (j + 0.5) * table.h;
+        double exact[3], v[3];
+        interpolate_images(table, rho, z, v);
+        image_node(rho, z, exact);
+        error = std::max({error, rho * fabs(v[0] - exact[0]),
+                          fabs(v[1] - exact[1]), fabs(v[2] - exact[2])});
+      }
+
+    if (error < mmm1d_params.maxPWerror) {
+      image_table = std::move(table);
+      return;
+    }
+
+    /* stop early if the largest table will not be accurate enough either,
+       given the third order convergence of the interpolation */
+    for (int n = 2 * n_intervals; n_nodes_of(n) <= MAX_TABLE_NODES; n *= 2)
+      error /= 8;
+    if (error >= mmm1d_params.maxPWerror)
+      return;
+  }
+}
+
+int MMM1D_image_table_size() { return image_table.n_rho * image_table.n_z; }
+/*@}*/
+
 void MMM1D_init() {
   if (MMM1D_sanity_checks())
     return;
@@ -172,180 +482,204 @@ void MMM1D_init() {
   uz = 1 / box_geo.length()[2];
   L2 = box_geo.length()[2] * box_geo.length()[2];
   uz2 = uz * uz;
-  prefuz2 = coulomb.prefactor * uz2;
+  /* the Coulomb prefactor is applied by the callers */
+  prefuz2 = uz2;
   prefL3_i = prefuz2 * uz;
 
   determine_bessel_radii(mmm1d_params.maxPWerror, MAXIMAL_B_CUT);
   prepare_polygamma_series(mmm1d_params.maxPWerror,
                            mmm1d_params.far_switch_radius_2);
+  setup_image_table();
 }
 
 void add_mmm1d_coulomb_pair_force(double chpref, const double d[3], double r,
                                   double force[3]) {
-  int dim;
-  double F[3];
-  double rxy2, rxy2_d, z_d;
-  double pref;
-  double Fx, Fy, Fz;
+  /* the pairs beyond the near cutoff are handled by MMM1D_add_far_force */
+  if (mmm1d_params.near_cut > 0 && r >= mmm1d_params.near_cut)
+    return;
 
-  rxy2 = d[0] * d[0] + d[1] * d[1];
-  rxy2_d = rxy2 * uz2;
-  z_d = d[2] * uz;
+  double rxy2 = d[0] * d[0] + d[1] * d[1];
+  double f_rho, f_z;
 
   if (rxy2 <= mmm1d_params.far_switch_radius_2) {
     /* near range formula */
-    double sr, sz, r2nm1, rt, rt2, shift_z;
-    int n;
-
-    /* polygamma summation */
-    sr = 0;
-    sz = mod_psi_odd(0, z_d);
-
-    r2nm1 = 1.0;
-    for (n = 1; n < n_modPsi; n++) {
-      double deriv = 2 * n;
-      double mpe = mod_psi_even(n, z_d);
-      double mpo = mod_psi_odd(n, z_d);
-      double r2n = r2nm1 * rxy2_d;
-
-      sz += r2n * mpo;
-      sr += deriv * r2nm1 * mpe;
-
-      if (fabs(deriv * r2nm1 * mpe) < mmm1d_params.maxPWerror)
-        break;
+    near_force(rxy2, d[2], f_rho, f_z);
 
-      r2nm1 = r2n;
-    }
-    // fprintf(stderr, "max_n %d\n", n);
-
-    Fx = prefL3_i * sr * d[0];
-    Fy = prefL3_i * sr * d[1];
-    Fz = prefuz2 * sz;
-
-    /* real space parts */
-
-    pref = 1. / (r * r * r);
-    Fx += pref * d[0];
-    Fy += pref * d[1];
-    Fz += pref * d[2];
-
-    shift_z = d[2] + box_geo.length()[2];
-    rt2 = rxy2 + shift_z * shift_z;
-    rt = sqrt(rt2);
-    pref = 1. / (rt2 * rt);
-    Fx += pref * d[0];
-    Fy += pref * d[1];
-    Fz += pref * shift_z;
-
-    shift_z = d[2] - box_geo.length()[2];
-    rt2 = rxy2 + shift_z * shift_z;
-    rt = sqrt(rt2);
-    pref = 1. / (rt2 * rt);
-    Fx += pref * d[0];
-    Fy += pref * d[1];
-    Fz += pref * shift_z;
-
-    F[0] = Fx;
-    F[1] = Fy;
-    F[2] = Fz;
+    /* real space part of the primary image */
+    double pref = 1. / (r * r * r);
+    f_rho += pref;
+    f_z += pref * d[2];
   } else {
     /* far range formula */
-    double rxy = sqrt(rxy2);
-    double rxy_d = rxy * uz;
-    double sr = 0, sz = 0;
-    int bp;
-
-    for (bp = 1; bp < MAXIMAL_B_CUT; bp++) {
-      if (bessel_radii[bp - 1] < rxy)
-        break;
-
-      double fq = C_2PI * bp, k0, k1;
-#ifdef BESSEL_MACHINE_PREC
-      k0 = K0(fq * rxy_d);
-      k1 = K1(fq * rxy_d);
-#else
-      LPK01(fq * rxy_d, &k0, &k1);
-#endif
-      sr += bp * k1 * cos(fq * z_d);
-      sz += bp * k0 * sin(fq * z_d);
-    }
-    sr *= uz2 * 4 * C_2PI;
-    sz *= uz2 * 4 * C_2PI;
-
-    pref = 1. * (sr / rxy + 2 * uz / rxy2);
-
-    F[0] = pref * d[0];
-    F[1] = pref * d[1];
-    F[2] = 1. * sz;
+    far_force(rxy2, d[2], f_rho, f_z);
   }
 
-  for (dim = 0; dim < 3; dim++)
-    force[dim] += chpref * F[dim];
+  force[0] += chpref * f_rho * d[0];
+  force[1] += chpref * f_rho * d[1];
+  force[2] += chpref * f_z;
 }
 
 double mmm1d_coulomb_pair_energy(double const chpref, double const d[3],
                                  double r2, double r) {
-  double rxy2, rxy2_d, z_d;
-  double E;
-
   if (chpref == 0)
     return 0;
 
-  rxy2 = d[0] * d[0] + d[1] * d[1];
-  rxy2_d = rxy2 * uz2;
-  z_d = d[2] * uz;
+  if (mmm1d_params.near_cut > 0 && r >= mmm1d_params.near_cut)
+    return 0;
+
+  double rxy2 = d[0] * d[0] + d[1] * d[1];
 
   if (rxy2 <= mmm1d_params.far_switch_radius_2) {
     /* near range formula */
-    double r2n, rt, shift_z;
-    int n;
+    return chpref * (near_energy(rxy2, d[2]) + 1 / r);
+  }
+  /* far range formula */
+  return chpref * far_energy(rxy2, d[2]);
+}
 
-    E = -2 * C_GAMMA;
+/** @name Pairs beyond the near cutoff */
+/*@{*/
+/** Gather the folded positions and charges of the charged particles of all
+ *  nodes, four values per particle, ordered by node.
+ *  @param[out] local   charged particles of this node
+ *  @param[out] counts  number of charged particles of each node
+ */
+static std::vector<double> gather_charges(std::vector<Particle *> &local,
+                                          std::vector<int> &counts) {
+  std::vector<double> send;
+  for (auto &p : local_cells.particles()) {
+    if (p.p.q == 0)
+      continue;
+    auto const pos = folded_position(p.r.p, box_geo);
+    send.insert(send.end(), {pos[0], pos[1], pos[2], p.p.q});
+    local.push_back(&p);
+  }
 
-    /* polygamma summation */
-    r2n = 1.0;
-    for (n = 0; n < n_modPsi; n++) {
-      double add = mod_psi_even(n, z_d) * r2n;
-      E -= add;
+  int n_local = local.size();
+  counts.resize(n_nodes);
+  MPI_Allgather(&n_local, 1, MPI_INT, counts.data(), 1, MPI_INT, comm_cart);
 
-      if (fabs(add) < mmm1d_params.maxPWerror)
-        break;
+  std::vector<int> sizes(n_nodes), displs(n_nodes);
+  int n_total = 0;
+  for (int i = 0; i < n_nodes; i++) {
+    sizes[i] = 4 * counts[i];
+    displs[i] = 4 * n_total;
+    n_total += counts[i];
+  }
 
-      r2n *= rxy2_d;
-    }
-    E *= uz;
+  std::vector<double> all(4 * n_total);
+  MPI_Allgatherv(send.data(), 4 * n_local, MPI_DOUBLE, all.data(),
+                 sizes.data(), displs.data(), MPI_DOUBLE, comm_cart);
+  return all;
+}
 
-    /* real space parts */
+/** First row of the upper triangle of the pair matrix of @p n particles
+ *  that is handled by @p node, such that all nodes handle about the same
+ *  number of pairs.
+ */
+static int first_row(int n, int node) {
+  double target = 0.5 * n * (n - 1.) * node / n_nodes;
+  double pairs = 0;
+  int i = 0;
+  while (i < n && pairs < target) {
+    pairs += n - 1 - i;
+    i++;
+  }
+  return i;
+}
 
-    E += 1 / r;
+/** Call @p kernel for all pairs of this node's share of the pair matrix
+ *  that are beyond the near cutoff, with the minimum image distance vector,
+ *  the radial distance and the distance.
+ */
+template <typename Kernel>
+static void for_each_far_pair(std::vector<double> const &parts,
+                              Kernel kernel) {
+  int n = parts.size() / 4;
+  int first = first_row(n, this_node), last = first_row(n, this_node + 1);
+  double near_cut2 = Utils::sqr(mmm1d_params.near_cut);
+  for (int i = first; i < last; i++) {
+    for (int j = i + 1; j < n; j++) {
+      double d[3] = {parts[4 * i] - parts[4 * j],
+                     parts[4 * i + 1] - parts[4 * j + 1],
+                     parts[4 * i + 2] - parts[4 * j + 2]};
+      d[2] -= box_geo.length()[2] * rint(d[2] * uz);
+      double rxy2 = d[0] * d[0] + d[1] * d[1];
+      double r2 = rxy2 + d[2] * d[2];
+      if (r2 < near_cut2)
+        continue;
+      kernel(i, j, d, rxy2, sqrt(r2));
+    }
+  }
+}
 
-    shift_z = d[2] + box_geo.length()[2];
-    rt = sqrt(rxy2 + shift_z * shift_z);
-    E += 1 / rt;
+/** Force and energy of a pair beyond the near cutoff, see
+ *  @ref interpolate_images for the parameters.
+ */
+static void far_pair(double const d[3], double rxy2, double r, double v[3],
+                     bool energy) {
+  if (!interpolate_images(image_table, sqrt(rxy2), d[2], v)) {
+    image_force(rxy2, d[2], v[0], v[1]);
+    v[2] = energy ? image_energy(rxy2, d[2]) : 0;
+  }
+  double pref = 1. / (r * r * r);
+  v[0] += pref;
+  v[1] += pref * d[2];
+  v[2] += 1 / r;
+}
 
-    shift_z = d[2] - box_geo.length()[2];
-    rt = sqrt(rxy2 + shift_z * shift_z);
-    E += 1 / rt;
-  } else {
-    /* far range formula */
-    double rxy = sqrt(rxy2);
-    double rxy_d = rxy * uz;
-    int bp;
-    /* The first Bessel term will compensate a little bit the
-       log term, so add them close together */
-    E = -0.25 * log(rxy2_d) + 0.5 * (M_LN2 - C_GAMMA);
-    for (bp = 1; bp < MAXIMAL_B_CUT; bp++) {
-      if (bessel_radii[bp - 1] < rxy)
-        break;
+void MMM1D_add_far_force() {
+  if (mmm1d_params.near_cut <= 0)
+    return;
 
-      double fq = C_2PI * bp;
-      E += K0(fq * rxy_d) * cos(fq * z_d);
+  std::vector<Particle *> local;
+  std::vector<int> counts;
+  auto const parts = gather_charges(local, counts);
+
+  std::vector<double> forces(3 * (parts.size() / 4), 0);
+  for_each_far_pair(parts, [&](int i, int j, double const d[3], double rxy2,
+                               double r) {
+    double v[3];
+    far_pair(d, rxy2, r, v, false);
+    double q1q2 = parts[4 * i + 3] * parts[4 * j + 3];
+    double f[3] = {q1q2 * v[0] * d[0], q1q2 * v[0] * d[1], q1q2 * v[1]};
+    for (int c = 0; c < 3; c++) {
+      forces[3 * i + c] += f[c];
+      forces[3 * j + c] -= f[c];
     }
-    E *= 4 * uz;
-  }
+  });
+
+  std::vector<int> sizes(n_nodes);
+  for (int i = 0; i < n_nodes; i++)
+    sizes[i] = 3 * counts[i];
+  std::vector<double> local_forces(3 * local.size());
+  MPI_Reduce_scatter(forces.data(), local_forces.data(), sizes.data(),
+                     MPI_DOUBLE, MPI_SUM, comm_cart);
+
+  for (std::size_t i = 0; i < local.size(); i++)
+    for (int c = 0; c < 3; c++)
+      local[i]->f.f[c] += coulomb.prefactor * local_forces[3 * i + c];
+}
+
+double MMM1D_far_energy() {
+  if (mmm1d_params.near_cut <= 0)
+    return 0;
 
-  return chpref * E;
+  std::vector<Particle *> local;
+  std::vector<int> counts;
+  auto const parts = gather_charges(local, counts);
+
+  double energy = 0;
+  for_each_far_pair(parts, [&](int i, int j, double const d[3], double rxy2,
+                               double r) {
+    double v[3];
+    far_pair(d, rxy2, r, v, true);
+    energy += parts[4 * i + 3] * parts[4 * j + 3] * v[2];
+  });
+
+  return coulomb.prefactor * energy;
 }
+/*@}*/
 
 int mmm1d_tune(char **log) {
   if (MMM1D_sanity_checks())
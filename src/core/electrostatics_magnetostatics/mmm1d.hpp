@@ -23,10 +23,18 @@
     MMM1D algorithm for long range Coulomb interactions.
     Implementation of the MMM1D method for the calculation of the electrostatic
     interaction in one dimensionally periodic systems. For details on the
-    method see MMM in general. The MMM1D method works only with the nsquared,
-    since neither the near nor far formula can be decomposed. However, this
-    implementation is reasonably fast, so that one can use up to 200 charges
-    easily in a simulation.  */
+    method see MMM in general. In its classic form, the MMM1D method works
+    only with the nsquared cell system, since neither the near nor far
+    formula can be decomposed. However, this implementation is reasonably
+    fast, so that one can use up to 200 charges easily in a simulation.
+
+    If a near cutoff is set, only the pairs closer than this cutoff are
+    calculated by the short range loop, which then also works with the
+    domain decomposition. The remaining pairs are distributed evenly over
+    all nodes by @ref MMM1D_add_far_force. For these pairs, the interaction
+    with all but the nearest image is smooth and is interpolated from a
+    table, which is set up in @ref MMM1D_init such that the interpolation
+    error stays below the maximal pairwise error.  */
 #ifndef MMM1D_H
 #define MMM1D_H
 
@@ -45,6 +53,10 @@ typedef struct {
   double maxPWerror;
   /** cutoff of the Bessel sum. Only used by the GPU implementation */
   int bessel_cutoff;
+  /** cutoff of the short range loop. If not positive, all pairs are
+   *  calculated in the short range loop, which requires the nsquared
+   *  cell system. */
+  double near_cut;
 } MMM1D_struct;
 extern MMM1D_struct mmm1d_params;
 
@@ -55,8 +67,10 @@ extern MMM1D_struct mmm1d_params;
  *  @param switch_rad at which xy-distance the calculation switches from the far
  *      to the near formula. If -1, this parameter will be tuned automatically.
  *  @param maxPWerror @copydoc MMM1D_struct::maxPWerror
+ *  @param near_cut @copybrief MMM1D_struct::near_cut
  */
-int MMM1D_set_params(double switch_rad, double maxPWerror);
+int MMM1D_set_params(double switch_rad, double maxPWerror,
+                     double near_cut = -1);
 
 /// check that MMM1D can run with the current parameters
 int MMM1D_sanity_checks();
@@ -70,6 +84,22 @@ void add_mmm1d_coulomb_pair_force(double chpref, const double d[3], double r,
 double mmm1d_coulomb_pair_energy(double q1q2, double const d[3], double r2,
                                  double r);
 
+/** Add the forces of the pairs beyond the near cutoff to the local
+ *  particles. Has to be called on all nodes.
+ */
+void MMM1D_add_far_force();
+
+/** Energy of the pairs beyond the near cutoff.
+ *  @return the contribution of this node
+ */
+double MMM1D_far_energy();
+
+/** Number of nodes of the image table.
+ *  @return 0 if the image interaction of the pairs beyond the near cutoff
+ *  is calculated directly
+ */
+int MMM1D_image_table_size();
+
 /** Tuning of the parameters which are not set by the user, e.g. the
  *  switching radius or the bessel_cutoff. Call this only on the master node.
  *
@@ -25,10 +25,21 @@
 
 #if defined(P3M) || defined(DP3M)
 #include "errorhandling.hpp"
+#include "fft.hpp"
+#include "grid.hpp"
 
 #include <utils/constants.hpp>
 #include <utils/math/sqr.hpp>
 
+#include <cmath>
+#include <mpi.h>
+
+/* MPI tags for the mesh communications: */
+/** Tag for communication in p3m_calc_send_mesh(). */
+#define REQ_P3M_INIT 200
+/** Tag for communication in p3m_gather_fft_grid(). */
+#define REQ_P3M_GATHER 201
+
 /* For debug messages */
 extern int this_node;
 
@@ -94,6 +105,214 @@ void p3m_add_block(double const *in, double *out, int const start[3],
   }
 }
 
+void p3m_calc_local_ca_mesh(p3m_local_mesh &local_mesh,
+                            P3MParameters const &params,
+                            Utils::Vector3d const &my_left,
+                            Utils::Vector3d const &my_right, double skin) {
+  int i;
+  int ind[3];
+  /* total skin size */
+  double full_skin[3];
+
+  for (i = 0; i < 3; i++)
+    full_skin[i] = params.cao_cut[i] + skin + params.additional_mesh[i];
+
+  /* inner left down grid point (global index) */
+  for (i = 0; i < 3; i++)
+    local_mesh.in_ld[i] =
+        (int)ceil(my_left[i] * params.ai[i] - params.mesh_off[i]);
+  /* inner up right grid point (global index) */
+  for (i = 0; i < 3; i++)
+    local_mesh.in_ur[i] =
+        (int)floor(my_right[i] * params.ai[i] - params.mesh_off[i]);
+
+  /* correct roundof errors at boundary */
+  for (i = 0; i < 3; i++) {
+    if ((my_right[i] * params.ai[i] - params.mesh_off[i]) -
+            local_mesh.in_ur[i] <
+        ROUND_ERROR_PREC)
+      local_mesh.in_ur[i]--;
+    if (1.0 + (my_left[i] * params.ai[i] - params.mesh_off[i]) -
+            local_mesh.in_ld[i] <
+        ROUND_ERROR_PREC)
+      local_mesh.in_ld[i]--;
+  }
+  /* inner grid dimensions */
+  for (i = 0; i < 3; i++)
+    local_mesh.inner[i] = local_mesh.in_ur[i] - local_mesh.in_ld[i] + 1;
+  /* index of left down grid point in global mesh */
+  for (i = 0; i < 3; i++)
+    local_mesh.ld_ind[i] =
+        (int)ceil((my_left[i] - full_skin[i]) * params.ai[i] -
+                  params.mesh_off[i]);
+  /* left down margin */
+  for (i = 0; i < 3; i++)
+    local_mesh.margin[i * 2] = local_mesh.in_ld[i] - local_mesh.ld_ind[i];
+  /* up right grid point */
+  for (i = 0; i < 3; i++)
+    ind[i] = (int)floor((my_right[i] + full_skin[i]) * params.ai[i] -
+                        params.mesh_off[i]);
+  /* correct roundof errors at up right boundary */
+  for (i = 0; i < 3; i++)
+    if (((my_right[i] + full_skin[i]) * params.ai[i] - params.mesh_off[i]) -
+            ind[i] ==
+        0)
+      ind[i]--;
+  /* up right margin */
+  for (i = 0; i < 3; i++)
+    local_mesh.margin[(i * 2) + 1] = ind[i] - local_mesh.in_ur[i];
+
+  /* grid dimension */
+  local_mesh.size = 1;
+  for (i = 0; i < 3; i++) {
+    local_mesh.dim[i] = ind[i] - local_mesh.ld_ind[i] + 1;
+    local_mesh.size *= local_mesh.dim[i];
+  }
+  /* reduce inner grid indices from global to local */
+  for (i = 0; i < 3; i++)
+    local_mesh.in_ld[i] = local_mesh.margin[i * 2];
+  for (i = 0; i < 3; i++)
+    local_mesh.in_ur[i] = local_mesh.margin[i * 2] + local_mesh.inner[i];
+
+  local_mesh.q_2_off = local_mesh.dim[2] - params.cao;
+  local_mesh.q_21_off = local_mesh.dim[2] * (local_mesh.dim[1] - params.cao);
+}
+
+void p3m_calc_send_mesh(p3m_local_mesh &local_mesh, p3m_send_mesh &sm,
+                        boost::mpi::communicator const &comm) {
+  int i, j, evenodd;
+  int done[3] = {0, 0, 0};
+  MPI_Status status;
+  /* send grids */
+  for (i = 0; i < 3; i++) {
+    for (j = 0; j < 3; j++) {
+      /* left */
+      sm.s_ld[i * 2][j] = 0 + done[j] * local_mesh.margin[j * 2];
+      if (j == i)
+        sm.s_ur[i * 2][j] = local_mesh.margin[j * 2];
+      else
+        sm.s_ur[i * 2][j] =
+            local_mesh.dim[j] - done[j] * local_mesh.margin[(j * 2) + 1];
+      /* right */
+      if (j == i)
+        sm.s_ld[(i * 2) + 1][j] = local_mesh.in_ur[j];
+      else
+        sm.s_ld[(i * 2) + 1][j] = 0 + done[j] * local_mesh.margin[j * 2];
+      sm.s_ur[(i * 2) + 1][j] =
+          local_mesh.dim[j] - done[j] * local_mesh.margin[(j * 2) + 1];
+    }
+    done[i] = 1;
+  }
+  sm.max = 0;
+  for (i = 0; i < 6; i++) {
+    sm.s_size[i] = 1;
+    for (j = 0; j < 3; j++) {
+      sm.s_dim[i][j] = sm.s_ur[i][j] - sm.s_ld[i][j];
+      sm.s_size[i] *= sm.s_dim[i][j];
+    }
+    if (sm.s_size[i] > sm.max)
+      sm.max = sm.s_size[i];
+  }
+  /* communication */
+  auto const node_neighbors = calc_node_neighbors(comm);
+  auto const node_pos = calc_node_pos(comm);
+
+  for (i = 0; i < 6; i++) {
+    if (i % 2 == 0)
+      j = i + 1;
+    else
+      j = i - 1;
+    if (node_neighbors[i] != comm.rank()) {
+      /* two step communication: first all even positions than all odd */
+      for (evenodd = 0; evenodd < 2; evenodd++) {
+        if ((node_pos[i / 2] + evenodd) % 2 == 0)
+          MPI_Send(&(local_mesh.margin[i]), 1, MPI_INT, node_neighbors[i],
+                   REQ_P3M_INIT, comm);
+        else
+          MPI_Recv(&(local_mesh.r_margin[j]), 1, MPI_INT, node_neighbors[j],
+                   REQ_P3M_INIT, comm, &status);
+      }
+    } else {
+      local_mesh.r_margin[j] = local_mesh.margin[i];
+    }
+  }
+  /* recv grids */
+  for (i = 0; i < 3; i++)
+    for (j = 0; j < 3; j++) {
+      if (j == i) {
+        sm.r_ld[i * 2][j] = sm.s_ld[i * 2][j] + local_mesh.margin[2 * j];
+        sm.r_ur[i * 2][j] = sm.s_ur[i * 2][j] + local_mesh.r_margin[2 * j];
+        sm.r_ld[(i * 2) + 1][j] =
+            sm.s_ld[(i * 2) + 1][j] - local_mesh.r_margin[(2 * j) + 1];
+        sm.r_ur[(i * 2) + 1][j] =
+            sm.s_ur[(i * 2) + 1][j] - local_mesh.margin[(2 * j) + 1];
+      } else {
+        sm.r_ld[i * 2][j] = sm.s_ld[i * 2][j];
+        sm.r_ur[i * 2][j] = sm.s_ur[i * 2][j];
+        sm.r_ld[(i * 2) + 1][j] = sm.s_ld[(i * 2) + 1][j];
+        sm.r_ur[(i * 2) + 1][j] = sm.s_ur[(i * 2) + 1][j];
+      }
+    }
+  for (i = 0; i < 6; i++) {
+    sm.r_size[i] = 1;
+    for (j = 0; j < 3; j++) {
+      sm.r_dim[i][j] = sm.r_ur[i][j] - sm.r_ld[i][j];
+      sm.r_size[i] *= sm.r_dim[i][j];
+    }
+    if (sm.r_size[i] > sm.max)
+      sm.max = sm.r_size[i];
+  }
+}
+
+void p3m_gather_fft_grid(double *themesh, p3m_local_mesh const &local_mesh,
+                         p3m_send_mesh const &sm,
+                         std::vector<double> &send_grid,
+                         std::vector<double> &recv_grid,
+                         boost::mpi::communicator const &comm) {
+  int s_dir, r_dir, evenodd;
+  MPI_Status status;
+  std::vector<double> tmp_vec;
+
+  auto const node_neighbors = calc_node_neighbors(comm);
+  auto const node_pos = calc_node_pos(comm);
+
+  /* direction loop */
+  for (s_dir = 0; s_dir < 6; s_dir++) {
+    if (s_dir % 2 == 0)
+      r_dir = s_dir + 1;
+    else
+      r_dir = s_dir - 1;
+    /* pack send block */
+    if (sm.s_size[s_dir] > 0)
+      fft_pack_block(themesh, send_grid.data(), sm.s_ld[s_dir],
+                     sm.s_dim[s_dir], local_mesh.dim, 1);
+
+    /* communication */
+    if (node_neighbors[s_dir] != comm.rank()) {
+      for (evenodd = 0; evenodd < 2; evenodd++) {
+        if ((node_pos[s_dir / 2] + evenodd) % 2 == 0) {
+          if (sm.s_size[s_dir] > 0)
+            MPI_Send(send_grid.data(), sm.s_size[s_dir], MPI_DOUBLE,
+                     node_neighbors[s_dir], REQ_P3M_GATHER, comm);
+        } else {
+          if (sm.r_size[r_dir] > 0)
+            MPI_Recv(recv_grid.data(), sm.r_size[r_dir], MPI_DOUBLE,
+                     node_neighbors[r_dir], REQ_P3M_GATHER, comm, &status);
+        }
+      }
+    } else {
+      tmp_vec = recv_grid;
+      recv_grid = send_grid;
+      send_grid = tmp_vec;
+    }
+    /* add recv block */
+    if (sm.r_size[r_dir] > 0) {
+      p3m_add_block(recv_grid.data(), themesh, sm.r_ld[r_dir],
+                    sm.r_dim[r_dir], local_mesh.dim);
+    }
+  }
+}
+
 double p3m_analytic_cotangent_sum(int n, double mesh_i, int cao) {
   double c, res = 0.0;
   c = Utils::sqr(cos(Utils::pi() * mesh_i * (double)n));
@@ -147,6 +366,14 @@ double p3m_analytic_cotangent_sum(int n, double mesh_i, int cao) {
   return res;
 }
 
+double p3m_analytic_k2_sum(int n, double mesh_i, int cao) {
+  /* (n + m N)^2 sinc^2((n + m N) / N) = (N sin(pi n / N) / pi)^2 for all m,
+   * the remaining sum is the cotangent sum of the next lower order. */
+  return Utils::sqr(sin(Utils::pi() * mesh_i * (double)n) /
+                    (Utils::pi() * mesh_i)) *
+         p3m_analytic_cotangent_sum(n, mesh_i, cao - 1);
+}
+
 double p3m_caf(int i, double x, int cao_value) {
   switch (cao_value) {
   case 1:
@@ -316,4 +543,18 @@ double p3m_caf(int i, double x, int cao_value) {
   }
   }
 }
+
+double p3m_caf_derivative(int i, double x, int cao_value) {
+  /* The assignment functions are cardinal B-splines, whose derivative is
+   * the difference of two neighbouring B-splines of the next lower order
+   * (see Essmann et al., J. Chem. Phys. 103, 8577, 1995). In the
+   * parametrization of p3m_caf() both orders share the argument @p x,
+   * terms outside of the lower order support vanish. */
+  double res = 0.0;
+  if (i > 0)
+    res += p3m_caf(i - 1, x, cao_value - 1);
+  if (i < cao_value - 1)
+    res -= p3m_caf(i, x, cao_value - 1);
+  return res;
+}
 #endif /* defined(P3M) || defined(DP3M) */
@@ -54,6 +54,12 @@
 
 #if defined(P3M) || defined(DP3M)
 
+#include <utils/Vector.hpp>
+
+#include <boost/mpi/communicator.hpp>
+
+#include <vector>
+
 /** Error Codes for p3m tuning (version 2) */
 enum P3M_TUNE_ERROR {
   /** force evaluation failed */
@@ -180,15 +186,57 @@ typedef struct {
   /** additional points around the charge assignment mesh, for method like
    *  dielectric ELC creating virtual charges. */
   double additional_mesh[3] = {};
+  /** compute the forces from the gradient of the charge assignment
+   *  function (analytical differentiation) instead of i*k differentiation
+   *  on the mesh. Only used by the charge P3M. */
+  bool analytical_differentiation = false;
 
   template <typename Archive> void serialize(Archive &ar, long int) {
     ar &tuning &alpha_L &r_cut_iL &mesh;
     ar &mesh_off &cao &inter &accuracy &epsilon &cao_cut;
     ar &a &ai &alpha &r_cut &inter2 &cao3 &additional_mesh;
+    ar &analytical_differentiation;
   }
 
 } P3MParameters;
 
+/** Calculate the properties of the local charge assignment mesh of a node.
+ *  @param[out] local_mesh  local mesh
+ *  @param params           mesh parameters, with the mesh constant and
+ *                          the charge assignment cutoff already set
+ *  @param my_left          left down corner of the node domain
+ *  @param my_right         up right corner of the node domain
+ *  @param skin             distance a particle may have left the domain
+ */
+void p3m_calc_local_ca_mesh(p3m_local_mesh &local_mesh,
+                            P3MParameters const &params,
+                            Utils::Vector3d const &my_left,
+                            Utils::Vector3d const &my_right, double skin);
+
+/** Calculate the properties of the send/recv sub-meshes of the local
+ *  mesh. In order to calculate the recv sub-meshes there is a
+ *  communication of the margins between neighbouring nodes.
+ */
+void p3m_calc_send_mesh(p3m_local_mesh &local_mesh, p3m_send_mesh &sm,
+                        boost::mpi::communicator const &comm);
+
+/** Gather the FFT grid.
+ *  After the charge assignment, each node needs to gather the
+ *  contributions of its neighbours to the mesh points of its spatial
+ *  domain.
+ *  @param[in,out] mesh  local mesh
+ *  @param local_mesh    local mesh properties
+ *  @param sm            send/recv sub-meshes
+ *  @param send_grid     send buffer of size @ref p3m_send_mesh::max
+ *  @param recv_grid     recv buffer of size @ref p3m_send_mesh::max
+ *  @param comm          cartesian communicator
+ */
+void p3m_gather_fft_grid(double *mesh, p3m_local_mesh const &local_mesh,
+                         p3m_send_mesh const &sm,
+                         std::vector<double> &send_grid,
+                         std::vector<double> &recv_grid,
+                         boost::mpi::communicator const &comm);
+
 /** Print local mesh content.
  *  \param l local mesh structure.
  */
@@ -221,11 +269,25 @@ void p3m_add_block(double const *in, double *out, int const start[3],
  */
 double p3m_analytic_cotangent_sum(int n, double mesh_i, int cao);
 
+/** Aliasing sum of the squared wave number weighted with the squared
+ *  Fourier transform of the charge assignment function,
+ *  \f$\sum_m (n + m N)^2 U^2\left(\frac{n + m N}{N}\right)\f$,
+ *  in units of the inverse box length. It reduces to
+ *  \ref p3m_analytic_cotangent_sum of order @p cao - 1 and is therefore
+ *  only defined for @p cao > 1.
+ */
+double p3m_analytic_k2_sum(int n, double mesh_i, int cao);
+
 /** Compute the assignment function for the \a i'th degree
  *  at value \a x.
  */
 double p3m_caf(int i, double x, int cao_value);
 
+/** Compute the derivative of the assignment function for the \a i'th
+ *  degree with respect to \a x, in units of the mesh constant.
+ */
+double p3m_caf_derivative(int i, double x, int cao_value);
+
 #endif /* P3M || DP3M */
 
 #endif /* _P3M_COMMON_H */
@@ -26,6 +26,7 @@
 
 #ifdef P3M
 
+#include "algorithm/for_each_cell_colored.hpp"
 #include "cells.hpp"
 #include "communication.hpp"
 #include "domain_decomposition.hpp"
@@ -53,10 +54,14 @@ using Utils::strcat_alloc;
 #include <utils/math/sqr.hpp>
 
 #include <boost/range/algorithm/min_element.hpp>
+
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <mpi.h>
+#include <numeric>
+#include <vector>
 
 /************************************************
  * variables
@@ -64,10 +69,6 @@ using Utils::strcat_alloc;
 p3m_data_struct p3m;
 
 /* MPI tags for the charge-charge p3m communications: */
-/** Tag for communication in p3m_init() -> p3m_calc_send_mesh(). */
-#define REQ_P3M_INIT 200
-/** Tag for communication in p3m_gather_fft_grid(). */
-#define REQ_P3M_GATHER 201
 /** Tag for communication in p3m_spread_force_grid(). */
 #define REQ_P3M_SPREAD 202
 
@@ -108,12 +109,6 @@ static void p3m_print(void) {
 
 #endif
 
-/** Calculate for charges the properties of the send/recv sub-meshes of the
- *  local FFT mesh.
- *  In order to calculate the recv sub-meshes there is a communication of
- *  the margins between neighbouring nodes. */
-static void p3m_calc_send_mesh();
-
 /** Initialize the (inverse) mesh constant @ref P3MParameters::a "a"
  *  (@ref P3MParameters::ai "ai") and the cutoff for charge assignment
  *  @ref P3MParameters::cao_cut "cao_cut".
@@ -126,7 +121,7 @@ static void p3m_init_a_ai_cao_cut();
 /** Calculate the spatial position of the left down mesh point of the local
  *  mesh, to be stored in @ref p3m_local_mesh::ld_pos "ld_pos".
  *
- *  Function called by @ref p3m_calc_local_ca_mesh() once and by
+ *  Function called by @ref p3m_init() once and by
  *  @ref p3m_scaleby_box_l() whenever the box length changes.
  */
 static void p3m_calc_lm_ld_pos();
@@ -134,12 +129,6 @@ static void p3m_calc_lm_ld_pos();
 /** Calculates the dipole term */
 static double p3m_calc_dipole_term(int force_flag, int energy_flag);
 
-/** Gather FFT grid.
- *  After the charge assignment Each node needs to gather the
- *  information for the FFT grid in his spatial domain.
- */
-static void p3m_gather_fft_grid(double *mesh);
-
 /** Spread force grid.
  *  After the k-space calculations each node needs to get all force
  *  information to reassign the forces from the grid to the
@@ -159,11 +148,6 @@ static bool p3m_sanity_checks_system(const Utils::Vector3i &grid);
  */
 static bool p3m_sanity_checks_boxl();
 
-/** Calculates properties of the local FFT mesh for the charge assignment
- *  process.
- */
-static void p3m_calc_local_ca_mesh();
-
 /** Interpolate the P-th order charge assignment function from
  *  Hockney/Eastwood 5-189 (or 8-61). The following charge fractions
  *  are also tabulated in Deserno/Holm.
@@ -247,6 +231,27 @@ static void p3m_tune_aliasing_sums(int nx, int ny, int nz, const int mesh[3],
                                    double alpha_L_i, double *alias1,
                                    double *alias2);
 
+/** Calculate the k-space error estimate for analytical differentiation
+ *  with the optimal influence function, see Ballenegger/Cerda/Holm.
+ *  \param prefac   Prefactor of Coulomb interaction.
+ *  \param mesh     number of mesh points in one direction.
+ *  \param cao      charge assignment order (>1).
+ *  \param n_c_part number of charged particles in the system.
+ *  \param sum_q2   sum of square of charges in the system
+ *  \param alpha_L  rescaled Ewald splitting parameter.
+ *  \return reciprocal (k) space error
+ */
+static double p3m_k_space_error_ad(double prefac, const int mesh[3], int cao,
+                                   int n_c_part, double sum_q2,
+                                   double alpha_L);
+
+/** Aliasing sums used by \ref p3m_k_space_error_ad. */
+static void p3m_tune_aliasing_sums_ad(int nx, int ny, int nz,
+                                      const int mesh[3],
+                                      const double mesh_i[3], int cao,
+                                      double alpha_L_i, double *alias1,
+                                      double *alias2);
+
 /** Template parameterized calculation of the charge assignment to be called by
  *  wrapper.
  *  \tparam cao      charge assignment order.
@@ -324,9 +329,10 @@ void p3m_init() {
     p3m_realloc_ca_fields(CA_INCREMENT);
 #endif
 
-    p3m_calc_local_ca_mesh();
+    p3m_calc_local_ca_mesh(p3m.local_mesh, p3m.params, local_geo.my_left(),
+                           local_geo.my_right(), skin);
 
-    p3m_calc_send_mesh();
+    p3m_calc_send_mesh(p3m.local_mesh, p3m.sm, comm_cart);
     P3M_TRACE(p3m_p3m_print_local_mesh(p3m.local_mesh));
     P3M_TRACE(p3m_p3m_print_send_mesh(p3m.sm));
     p3m.send_grid.resize(p3m.sm.max);
@@ -455,6 +461,14 @@ int p3m_set_eps(double eps) {
   return ES_OK;
 }
 
+int p3m_set_analytical_differentiation(bool ad) {
+  p3m.params.analytical_differentiation = ad;
+
+  mpi_bcast_coulomb_params();
+
+  return ES_OK;
+}
+
 int p3m_set_ninterpol(int n) {
   if (n < 0)
     return ES_ERROR;
@@ -519,23 +533,191 @@ void p3m_charge_assign() {
   }
 }
 
+namespace {
+/** Local charged particles, in the order in which their charge fractions
+ *  are stored.
+ */
+std::vector<Particle *> p3m_charged_particles() {
+  std::vector<Particle *> charged;
+  for (auto &p : local_cells.particles()) {
+    if (p.p.q != 0.0)
+      charged.push_back(&p);
+  }
+  return charged;
+}
+
+/** Calculate the charge fractions of a single charge.
+ *
+ *  The assignment function is separable, so it is evaluated once per
+ *  direction and the cao^3 fractions are products of these weights.
+ *
+ *  \param[in]  q         charge.
+ *  \param[in]  real_pos  position of the charge.
+ *  \param[out] frac      cao^3 charge fractions.
+ *  \return index of the first mesh point of the charge.
+ */
+template <int cao>
+int p3m_calc_charge_fractions(double q, Utils::Vector3d const &real_pos,
+                              double *frac) {
+  auto const inter = not(p3m.params.inter == 0);
+  /* assignment function along each direction */
+  double caf[3][cao];
+  /* index for rs_mesh array */
+  int q_ind = 0;
+
+  for (int d = 0; d < 3; d++) {
+    /* particle position in mesh coordinates */
+    auto const pos =
+        ((real_pos[d] - p3m.local_mesh.ld_pos[d]) * p3m.params.ai[d]) -
+        p3m.pos_shift;
+    /* nearest mesh point */
+    auto const nmp = (int)pos;
+    /* 3d-array index of nearest mesh point */
+    q_ind = (d == 0) ? nmp : nmp + p3m.local_mesh.dim[d] * q_ind;
+
+    if (!inter) {
+      /* distance to nearest mesh point */
+      auto const dist = (pos - nmp) - 0.5;
+      for (int i = 0; i < cao; i++)
+        caf[d][i] = p3m_caf(i, dist, cao);
+    } else {
+      /* distance to nearest mesh point for interpolation */
+      auto const arg = (int)((pos - nmp) * p3m.params.inter2);
+      for (int i = 0; i < cao; i++)
+        caf[d][i] = p3m.int_caf[i][arg];
+    }
+
+#ifdef ADDITIONAL_CHECKS
+    if (pos < -skin * p3m.params.ai[d]) {
+      fprintf(stderr, "%d: rs_mesh underflow! (pos %f)\n", this_node,
+              real_pos[d]);
+      fprintf(stderr, "%d: allowed coordinates: %f - %f\n", this_node,
+              local_geo.my_left()[d] - skin, local_geo.my_right()[d] + skin);
+    }
+    if ((nmp + cao) > p3m.local_mesh.dim[d]) {
+      fprintf(stderr, "%d: rs_mesh overflow! (pos %f, nmp=%d)\n", this_node,
+              real_pos[d], nmp);
+      fprintf(stderr, "%d: allowed coordinates: %f - %f\n", this_node,
+              local_geo.my_left()[d] - skin, local_geo.my_right()[d] + skin);
+    }
+#endif
+  }
+
+  for (int i0 = 0; i0 < cao; i0++) {
+    auto const tmp0 = caf[0][i0];
+    for (int i1 = 0; i1 < cao; i1++) {
+      auto const tmp1 = tmp0 * caf[1][i1];
+      for (int i2 = 0; i2 < cao; i2++) {
+        *(frac++) = q * tmp1 * caf[2][i2];
+      }
+    }
+  }
+
+  return q_ind;
+}
+
+/** Add the charge fractions of a single charge to the mesh.
+ *
+ *  \param[in] q_ind  index of the first mesh point of the charge.
+ *  \param[in] frac   cao^3 charge fractions.
+ */
+template <int cao>
+void p3m_add_charge_fractions(int q_ind, double const *frac) {
+  for (int i0 = 0; i0 < cao; i0++) {
+    for (int i1 = 0; i1 < cao; i1++) {
+      /* a mesh line of the stencil is contiguous */
+      double *mesh_line = p3m.rs_mesh + q_ind;
+      for (int i2 = 0; i2 < cao; i2++) {
+        mesh_line[i2] += frac[i2];
+      }
+      frac += cao;
+      q_ind += cao + p3m.local_mesh.q_2_off;
+    }
+    q_ind += p3m.local_mesh.q_21_off;
+  }
+}
+
+#ifdef P3M_STORE_CA_FRAC
+/** Add the stored charge fractions of the first @p n_charges charges
+ *  to the mesh.
+ *
+ *  The local mesh is cut into slabs of at least cao mesh planes along
+ *  its slowest index. The stencil of a charge whose first mesh point
+ *  lies in a slab then only reaches into this slab and the next one,
+ *  so the slabs are colored alternately and the slabs of one color are
+ *  filled concurrently without write conflicts. The charges are sorted
+ *  by slab beforehand, which also keeps the writes of a thread local.
+ *  The result does not depend on the number of threads.
+ */
+template <int cao> void p3m_add_charge_fractions_blocked(int n_charges) {
+  auto const plane_size = p3m.local_mesh.dim[1] * p3m.local_mesh.dim[2];
+  auto const n_slabs = std::max(p3m.local_mesh.dim[0] / cao, 1);
+  auto const slab = [plane_size, n_slabs](int q_ind) {
+    return std::min(q_ind / plane_size / cao, n_slabs - 1);
+  };
+
+  /* counting sort of the charges by slab */
+  std::vector<int> slab_begin(n_slabs + 1, 0);
+  for (int i = 0; i < n_charges; i++) {
+    slab_begin[slab(p3m.ca_fmp[i]) + 1]++;
+  }
+  std::partial_sum(slab_begin.begin(), slab_begin.end(), slab_begin.begin());
+  std::vector<int> sorted(n_charges);
+  {
+    auto next = slab_begin;
+    for (int i = 0; i < n_charges; i++) {
+      sorted[next[slab(p3m.ca_fmp[i])]++] = i;
+    }
+  }
+
+  std::vector<std::vector<int>> colors(2);
+  for (int s = 0; s < n_slabs; s++) {
+    colors[s % 2].push_back(s);
+  }
+
+  Algorithm::for_each_cell_colored(
+      colors.begin(), colors.end(), [&slab_begin, &sorted](int s) {
+        for (int j = slab_begin[s]; j < slab_begin[s + 1]; j++) {
+          auto const i = sorted[j];
+          p3m_add_charge_fractions<cao>(p3m.ca_fmp[i],
+                                        p3m.ca_frac.data() + cao * cao * cao * i);
+        }
+      });
+}
+#endif
+} // namespace
+
 /** Assign the charges */
 template <int cao> void p3m_do_charge_assign() {
-  /* charged particle counter, charge fraction counter */
-  int cp_cnt = 0;
   /* prepare local FFT mesh */
   for (int i = 0; i < p3m.local_mesh.size; i++)
     p3m.rs_mesh[i] = 0.0;
 
+#ifdef P3M_STORE_CA_FRAC
+  auto const charged = p3m_charged_particles();
+  auto const n_charges = static_cast<int>(charged.size());
+  if (n_charges > p3m.ca_num)
+    p3m_realloc_ca_fields(n_charges);
+
+  /* the charge fractions of different charges are independent */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int i = 0; i < n_charges; i++) {
+    auto const &p = *charged[i];
+    p3m.ca_fmp[i] = p3m_calc_charge_fractions<cao>(
+        p.p.q, p.r.p, p3m.ca_frac.data() + cao * cao * cao * i);
+  }
+
+  p3m_add_charge_fractions_blocked<cao>(n_charges);
+
+  p3m_shrink_wrap_charge_grid(n_charges);
+#else
   for (auto &p : local_cells.particles()) {
     if (p.p.q != 0.0) {
-      p3m_do_assign_charge<cao>(p.p.q, p.r.p, cp_cnt);
-      cp_cnt++;
+      p3m_do_assign_charge<cao>(p.p.q, p.r.p, -1);
     }
   }
-
-#ifdef P3M_STORE_CA_FRAC
-  p3m_shrink_wrap_charge_grid(cp_cnt);
 #endif
 }
 
@@ -568,99 +750,24 @@ void p3m_assign_charge(double q, Utils::Vector3d &real_pos, int cp_cnt) {
 
 template <int cao>
 void p3m_do_assign_charge(double q, Utils::Vector3d &real_pos, int cp_cnt) {
-  auto const inter = not(p3m.params.inter == 0);
-  /* distance to nearest mesh point */
-  double dist[3];
-  /* index for caf interpolation grid */
-  int arg[3];
-  /* index, index jumps for rs_mesh array */
-  int q_ind = 0;
 #ifdef P3M_STORE_CA_FRAC
-  // make sure we have enough space
-  if (cp_cnt >= p3m.ca_num)
-    p3m_realloc_ca_fields(cp_cnt + 1);
-  // do it here, since p3m_realloc_ca_fields may change the address of
-  // p3m.ca_frac
-  double *cur_ca_frac = p3m.ca_frac.data() + cao * cao * cao * cp_cnt;
-#endif
-
-  for (int d = 0; d < 3; d++) {
-    /* particle position in mesh coordinates */
-    auto const pos =
-        ((real_pos[d] - p3m.local_mesh.ld_pos[d]) * p3m.params.ai[d]) -
-        p3m.pos_shift;
-    /* nearest mesh point */
-    auto const nmp = (int)pos;
-    /* 3d-array index of nearest mesh point */
-    q_ind = (d == 0) ? nmp : nmp + p3m.local_mesh.dim[d] * q_ind;
-
-    if (!inter)
-      /* distance to nearest mesh point */
-      dist[d] = (pos - nmp) - 0.5;
-    else
-      /* distance to nearest mesh point for interpolation */
-      arg[d] = (int)((pos - nmp) * p3m.params.inter2);
-
-#ifdef ADDITIONAL_CHECKS
-    if (pos < -skin * p3m.params.ai[d]) {
-      fprintf(stderr, "%d: rs_mesh underflow! (pos %f)\n", this_node,
-              real_pos[d]);
-      fprintf(stderr, "%d: allowed coordinates: %f - %f\n", this_node,
-              local_geo.my_left()[d] - skin, local_geo.my_right()[d] + skin);
-    }
-    if ((nmp + cao) > p3m.local_mesh.dim[d]) {
-      fprintf(stderr, "%d: rs_mesh overflow! (pos %f, nmp=%d)\n", this_node,
-              real_pos[d], nmp);
-      fprintf(stderr, "%d: allowed coordinates: %f - %f\n", this_node,
-              local_geo.my_left()[d] - skin, local_geo.my_right()[d] + skin);
-    }
-#endif
+  if (cp_cnt >= 0) {
+    // make sure we have enough space
+    if (cp_cnt >= p3m.ca_num)
+      p3m_realloc_ca_fields(cp_cnt + 1);
+    // do it here, since p3m_realloc_ca_fields may change the address of
+    // p3m.ca_frac
+    double *cur_ca_frac = p3m.ca_frac.data() + cao * cao * cao * cp_cnt;
+    p3m.ca_fmp[cp_cnt] =
+        p3m_calc_charge_fractions<cao>(q, real_pos, cur_ca_frac);
+    p3m_add_charge_fractions<cao>(p3m.ca_fmp[cp_cnt], cur_ca_frac);
+    return;
   }
-
-#ifdef P3M_STORE_CA_FRAC
-  if (cp_cnt >= 0)
-    p3m.ca_fmp[cp_cnt] = q_ind;
 #endif
 
-  if (!inter) {
-    for (int i0 = 0; i0 < cao; i0++) {
-      auto const tmp0 = p3m_caf(i0, dist[0], cao);
-      for (int i1 = 0; i1 < cao; i1++) {
-        auto const tmp1 = tmp0 * p3m_caf(i1, dist[1], cao);
-        for (int i2 = 0; i2 < cao; i2++) {
-          auto const cur_ca_frac_val = q * tmp1 * p3m_caf(i2, dist[2], cao);
-          p3m.rs_mesh[q_ind] += cur_ca_frac_val;
-#ifdef P3M_STORE_CA_FRAC
-          /* store current ca frac */
-          if (cp_cnt >= 0)
-            *(cur_ca_frac++) = cur_ca_frac_val;
-#endif
-          q_ind++;
-        }
-        q_ind += p3m.local_mesh.q_2_off;
-      }
-      q_ind += p3m.local_mesh.q_21_off;
-    }
-  } else {
-    for (int i0 = 0; i0 < cao; i0++) {
-      auto const tmp0 = p3m.int_caf[i0][arg[0]];
-      for (int i1 = 0; i1 < cao; i1++) {
-        auto const tmp1 = tmp0 * p3m.int_caf[i1][arg[1]];
-        for (int i2 = 0; i2 < cao; i2++) {
-          auto const cur_ca_frac_val = q * tmp1 * p3m.int_caf[i2][arg[2]];
-          p3m.rs_mesh[q_ind] += cur_ca_frac_val;
-#ifdef P3M_STORE_CA_FRAC
-          /* store current ca frac */
-          if (cp_cnt >= 0)
-            *(cur_ca_frac++) = cur_ca_frac_val;
-#endif
-          q_ind++;
-        }
-        q_ind += p3m.local_mesh.q_2_off;
-      }
-      q_ind += p3m.local_mesh.q_21_off;
-    }
-  }
+  double ca_frac[cao * cao * cao];
+  auto const q_ind = p3m_calc_charge_fractions<cao>(q, real_pos, ca_frac);
+  p3m_add_charge_fractions<cao>(q_ind, ca_frac);
 }
 
 #ifdef P3M_STORE_CA_FRAC
@@ -674,38 +781,49 @@ void p3m_shrink_wrap_charge_grid(int n_charges) {
 /* Assign the forces obtained from k-space */
 template <int cao>
 static void P3M_assign_forces(double force_prefac, int d_rs) {
-  /* charged particle counter, charge fraction counter */
-  int cp_cnt = 0;
 #ifdef P3M_STORE_CA_FRAC
-  int cf_cnt = 0;
+  auto const charged = p3m_charged_particles();
+  auto const n_charges = static_cast<int>(charged.size());
+
+  /* the mesh is only read, so the charges are independent */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int cp_cnt = 0; cp_cnt < n_charges; cp_cnt++) {
+    auto &p = *charged[cp_cnt];
+    double const *frac = p3m.ca_frac.data() + cao * cao * cao * cp_cnt;
+    /* index for rs_mesh array */
+    int q_ind = p3m.ca_fmp[cp_cnt];
+    double force = 0.0;
+    for (int i0 = 0; i0 < cao; i0++) {
+      for (int i1 = 0; i1 < cao; i1++) {
+        /* a mesh line of the stencil is contiguous */
+        double const *mesh_line = p3m.rs_mesh + q_ind;
+        for (int i2 = 0; i2 < cao; i2++) {
+          force += frac[i2] * mesh_line[i2];
+        }
+        frac += cao;
+        q_ind += cao + p3m.local_mesh.q_2_off;
+      }
+      q_ind += p3m.local_mesh.q_21_off;
+    }
+    p.f.f[d_rs] -= force_prefac * force;
+
+    ONEPART_TRACE(if (p.p.identity == check_id) fprintf(
+        stderr, "%d: OPT: P3M  f = (%.3e,%.3e,%.3e) in dir %d\n", this_node,
+        p.f.f[0], p.f.f[1], p.f.f[2], d_rs));
+  }
 #else
   /* distance to nearest mesh point */
   double dist[3];
   /* index for caf interpolation grid */
   int arg[3];
-#endif
   /* index, index jumps for rs_mesh array */
   int q_ind = 0;
 
   for (auto &p : local_cells.particles()) {
     auto const q = p.p.q;
     if (q != 0.0) {
-#ifdef P3M_STORE_CA_FRAC
-      q_ind = p3m.ca_fmp[cp_cnt];
-      for (int i0 = 0; i0 < cao; i0++) {
-        for (int i1 = 0; i1 < cao; i1++) {
-          for (int i2 = 0; i2 < cao; i2++) {
-            p.f.f[d_rs] -=
-                force_prefac * p3m.ca_frac[cf_cnt] * p3m.rs_mesh[q_ind];
-            q_ind++;
-            cf_cnt++;
-          }
-          q_ind += p3m.local_mesh.q_2_off;
-        }
-        q_ind += p3m.local_mesh.q_21_off;
-      }
-      cp_cnt++;
-#else
       double pos;
       int nmp;
       double tmp0, tmp1;
@@ -758,13 +876,75 @@ static void P3M_assign_forces(double force_prefac, int d_rs) {
           q_ind += p3m.local_mesh.q_21_off;
         }
       }
-#endif
 
       ONEPART_TRACE(if (p.p.identity == check_id) fprintf(
           stderr, "%d: OPT: P3M  f = (%.3e,%.3e,%.3e) in dir %d\n", this_node,
           p.f.f[0], p.f.f[1], p.f.f[2], d_rs));
     }
   }
+#endif
+}
+
+/** Assign the forces obtained from the k-space potential mesh by
+ *  analytical differentiation, i.e. from the gradient of the charge
+ *  assignment function. All three components are assigned at once.
+ */
+template <int cao> static void P3M_assign_forces_ad(double force_prefac) {
+  auto const charged = p3m_charged_particles();
+  auto const n_charges = static_cast<int>(charged.size());
+
+  /* the mesh is only read, so the charges are independent */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int cp_cnt = 0; cp_cnt < n_charges; cp_cnt++) {
+    auto &p = *charged[cp_cnt];
+    /* assignment function and its derivative along each direction */
+    double caf[3][cao], dcaf[3][cao];
+    /* index for rs_mesh array */
+    int q_ind = 0;
+    for (int d = 0; d < 3; d++) {
+      /* particle position in mesh coordinates */
+      auto const pos =
+          ((p.r.p[d] - p3m.local_mesh.ld_pos[d]) * p3m.params.ai[d]) -
+          p3m.pos_shift;
+      /* nearest mesh point */
+      auto const nmp = (int)pos;
+      /* 3d-array index of nearest mesh point */
+      q_ind = (d == 0) ? nmp : nmp + p3m.local_mesh.dim[d] * q_ind;
+      /* distance to nearest mesh point */
+      auto const dist = (pos - nmp) - 0.5;
+      for (int i = 0; i < cao; i++) {
+        caf[d][i] = p3m_caf(i, dist, cao);
+        dcaf[d][i] = p3m_caf_derivative(i, dist, cao) * p3m.params.ai[d];
+      }
+    }
+
+    double force[3] = {0.0, 0.0, 0.0};
+    for (int i0 = 0; i0 < cao; i0++) {
+      for (int i1 = 0; i1 < cao; i1++) {
+        auto const w01 = caf[0][i0] * caf[1][i1];
+        auto const dw0 = dcaf[0][i0] * caf[1][i1];
+        auto const dw1 = caf[0][i0] * dcaf[1][i1];
+        /* a mesh line of the stencil is contiguous */
+        double const *mesh_line = p3m.rs_mesh + q_ind;
+        for (int i2 = 0; i2 < cao; i2++) {
+          force[0] += dw0 * caf[2][i2] * mesh_line[i2];
+          force[1] += dw1 * caf[2][i2] * mesh_line[i2];
+          force[2] += w01 * dcaf[2][i2] * mesh_line[i2];
+        }
+        q_ind += cao + p3m.local_mesh.q_2_off;
+      }
+      q_ind += p3m.local_mesh.q_21_off;
+    }
+
+    for (int d = 0; d < 3; d++)
+      p.f.f[d] -= force_prefac * p.p.q * force[d];
+
+    ONEPART_TRACE(if (p.p.identity == check_id) fprintf(
+        stderr, "%d: OPT: P3M  f = (%.3e,%.3e,%.3e)\n", this_node, p.f.f[0],
+        p.f.f[1], p.f.f[2]));
+  }
 }
 
 double p3m_calc_kspace_forces(int force_flag, int energy_flag) {
@@ -788,7 +968,8 @@ double p3m_calc_kspace_forces(int force_flag, int energy_flag) {
    */
   /* and Perform forward 3D FFT (Charge Assignment Mesh). */
   if (p3m.sum_q2 > 0) {
-    p3m_gather_fft_grid(p3m.rs_mesh);
+    p3m_gather_fft_grid(p3m.rs_mesh, p3m.local_mesh, p3m.sm, p3m.send_grid,
+                        p3m.recv_grid, comm_cart);
     fft_perform_forw(p3m.rs_mesh, p3m.fft, comm_cart);
   }
   // Note: after these calls, the grids are in the order yzx and not xyz
@@ -831,76 +1012,111 @@ double p3m_calc_kspace_forces(int force_flag, int energy_flag) {
     /***************************
      COULOMB FORCES (k-space)
      ****************************/
-    /* Force preparation */
-    ind = 0;
-    /* apply the influence function */
-    for (i = 0; i < p3m.fft.plan[3].new_size; i++) {
-      p3m.ks_mesh[ind] = p3m.g_force[i] * p3m.rs_mesh[ind];
-      ind++;
-      p3m.ks_mesh[ind] = p3m.g_force[i] * p3m.rs_mesh[ind];
-      ind++;
-    }
-
-    /* === 3 Fold backward 3D FFT (Force Component Meshes) === */
-
-    /* Force component loop */
-    for (d = 0; d < 3; d++) {
-      if (d == KX)
-        d_operator = p3m.d_op[RX].data();
-      else if (d == KY)
-        d_operator = p3m.d_op[RY].data();
-      else if (d == KZ)
-        d_operator = p3m.d_op[RZ].data();
-
-      /* direction in k-space: */
-      d_rs = (d + p3m.ks_pnum) % 3;
-      /* sqrt(-1)*k differentiation */
+    if (p3m.params.analytical_differentiation) {
+      /* apply the influence function */
       ind = 0;
-      for (j[0] = 0; j[0] < p3m.fft.plan[3].new_mesh[0]; j[0]++) {
-        for (j[1] = 0; j[1] < p3m.fft.plan[3].new_mesh[1]; j[1]++) {
-          for (j[2] = 0; j[2] < p3m.fft.plan[3].new_mesh[2]; j[2]++) {
-            /* i*k*(Re+i*Im) = - Im*k + i*Re*k     (i=sqrt(-1)) */
-            p3m.rs_mesh[ind] = -2.0 * Utils::pi() *
-                               (p3m.ks_mesh[ind + 1] *
-                                d_operator[j[d] + p3m.fft.plan[3].start[d]]) /
-                               box_geo.length()[d_rs];
-            ind++;
-            p3m.rs_mesh[ind] = 2.0 * Utils::pi() * p3m.ks_mesh[ind - 1] *
-                               d_operator[j[d] + p3m.fft.plan[3].start[d]] /
-                               box_geo.length()[d_rs];
-            ind++;
-          }
-        }
+      for (i = 0; i < p3m.fft.plan[3].new_size; i++) {
+        p3m.rs_mesh[ind++] *= p3m.g_force[i];
+        p3m.rs_mesh[ind++] *= p3m.g_force[i];
       }
-      /* Back FFT force component mesh */
+      /* Back FFT of the potential mesh */
       fft_perform_back(p3m.rs_mesh, /* check_complex */ !p3m.params.tuning,
                        p3m.fft, comm_cart);
-      /* redistribute force component mesh */
+      /* redistribute potential mesh */
       p3m_spread_force_grid(p3m.rs_mesh);
-      /* Assign force component from mesh to particle */
+      /* Assign forces from the gradient of the charge assignment */
       switch (p3m.params.cao) {
-      case 1:
-        P3M_assign_forces<1>(force_prefac, d_rs);
-        break;
       case 2:
-        P3M_assign_forces<2>(force_prefac, d_rs);
+        P3M_assign_forces_ad<2>(force_prefac);
         break;
       case 3:
-        P3M_assign_forces<3>(force_prefac, d_rs);
+        P3M_assign_forces_ad<3>(force_prefac);
         break;
       case 4:
-        P3M_assign_forces<4>(force_prefac, d_rs);
+        P3M_assign_forces_ad<4>(force_prefac);
         break;
       case 5:
-        P3M_assign_forces<5>(force_prefac, d_rs);
+        P3M_assign_forces_ad<5>(force_prefac);
         break;
       case 6:
-        P3M_assign_forces<6>(force_prefac, d_rs);
+        P3M_assign_forces_ad<6>(force_prefac);
         break;
       case 7:
-        P3M_assign_forces<7>(force_prefac, d_rs);
+        P3M_assign_forces_ad<7>(force_prefac);
         break;
       }
+    } else {
+      /* Force preparation */
+      ind = 0;
+      /* apply the influence function */
+      for (i = 0; i < p3m.fft.plan[3].new_size; i++) {
+        p3m.ks_mesh[ind] = p3m.g_force[i] * p3m.rs_mesh[ind];
+        ind++;
+        p3m.ks_mesh[ind] = p3m.g_force[i] * p3m.rs_mesh[ind];
+        ind++;
+      }
+
+      /* === 3 Fold backward 3D FFT (Force Component Meshes) === */
+
+      /* Force component loop */
+      for (d = 0; d < 3; d++) {
+        if (d == KX)
+          d_operator = p3m.d_op[RX].data();
+        else if (d == KY)
+          d_operator = p3m.d_op[RY].data();
+        else if (d == KZ)
+          d_operator = p3m.d_op[RZ].data();
+
+        /* direction in k-space: */
+        d_rs = (d + p3m.ks_pnum) % 3;
+        /* sqrt(-1)*k differentiation */
+        ind = 0;
+        for (j[0] = 0; j[0] < p3m.fft.plan[3].new_mesh[0]; j[0]++) {
+          for (j[1] = 0; j[1] < p3m.fft.plan[3].new_mesh[1]; j[1]++) {
+            for (j[2] = 0; j[2] < p3m.fft.plan[3].new_mesh[2]; j[2]++) {
+              /* i*k*(Re+i*Im) = - Im*k + i*Re*k     (i=sqrt(-1)) */
+              p3m.rs_mesh[ind] = -2.0 * Utils::pi() *
+                                 (p3m.ks_mesh[ind + 1] *
+                                  d_operator[j[d] + p3m.fft.plan[3].start[d]]) /
+                                 box_geo.length()[d_rs];
+              ind++;
+              p3m.rs_mesh[ind] = 2.0 * Utils::pi() * p3m.ks_mesh[ind - 1] *
+                                 d_operator[j[d] + p3m.fft.plan[3].start[d]] /
+                                 box_geo.length()[d_rs];
+              ind++;
+            }
+          }
+        }
+        /* Back FFT force component mesh */
+        fft_perform_back(p3m.rs_mesh, /* check_complex */ !p3m.params.tuning,
+                         p3m.fft, comm_cart);
+        /* redistribute force component mesh */
+        p3m_spread_force_grid(p3m.rs_mesh);
+        /* Assign force component from mesh to particle */
+        switch (p3m.params.cao) {
+        case 1:
+          P3M_assign_forces<1>(force_prefac, d_rs);
+          break;
+        case 2:
+          P3M_assign_forces<2>(force_prefac, d_rs);
+          break;
+        case 3:
+          P3M_assign_forces<3>(force_prefac, d_rs);
+          break;
+        case 4:
+          P3M_assign_forces<4>(force_prefac, d_rs);
+          break;
+        case 5:
+          P3M_assign_forces<5>(force_prefac, d_rs);
+          break;
+        case 6:
+          P3M_assign_forces<6>(force_prefac, d_rs);
+          break;
+        case 7:
+          P3M_assign_forces<7>(force_prefac, d_rs);
+          break;
+        }
+      }
     }
   } /* if(force_flag) */
 
@@ -951,53 +1167,6 @@ double p3m_calc_dipole_term(int force_flag, int energy_flag) {
 
 /************************************************************/
 
-void p3m_gather_fft_grid(double *themesh) {
-  int s_dir, r_dir, evenodd;
-  MPI_Status status;
-  std::vector<double> tmp_vec;
-
-  P3M_TRACE(fprintf(stderr, "%d: p3m_gather_fft_grid:\n", this_node));
-
-  auto const node_neighbors = calc_node_neighbors(comm_cart);
-  auto const node_pos = calc_node_pos(comm_cart);
-
-  /* direction loop */
-  for (s_dir = 0; s_dir < 6; s_dir++) {
-    if (s_dir % 2 == 0)
-      r_dir = s_dir + 1;
-    else
-      r_dir = s_dir - 1;
-    /* pack send block */
-    if (p3m.sm.s_size[s_dir] > 0)
-      fft_pack_block(themesh, p3m.send_grid.data(), p3m.sm.s_ld[s_dir],
-                     p3m.sm.s_dim[s_dir], p3m.local_mesh.dim, 1);
-
-    /* communication */
-    if (node_neighbors[s_dir] != this_node) {
-      for (evenodd = 0; evenodd < 2; evenodd++) {
-        if ((node_pos[s_dir / 2] + evenodd) % 2 == 0) {
-          if (p3m.sm.s_size[s_dir] > 0)
-            MPI_Send(p3m.send_grid.data(), p3m.sm.s_size[s_dir], MPI_DOUBLE,
-                     node_neighbors[s_dir], REQ_P3M_GATHER, comm_cart);
-        } else {
-          if (p3m.sm.r_size[r_dir] > 0)
-            MPI_Recv(p3m.recv_grid.data(), p3m.sm.r_size[r_dir], MPI_DOUBLE,
-                     node_neighbors[r_dir], REQ_P3M_GATHER, comm_cart, &status);
-        }
-      }
-    } else {
-      tmp_vec = p3m.recv_grid;
-      p3m.recv_grid = p3m.send_grid;
-      p3m.send_grid = tmp_vec;
-    }
-    /* add recv block */
-    if (p3m.sm.r_size[r_dir] > 0) {
-      p3m_add_block(p3m.recv_grid.data(), themesh, p3m.sm.r_ld[r_dir],
-                    p3m.sm.r_dim[r_dir], p3m.local_mesh.dim);
-    }
-  }
-}
-
 void p3m_spread_force_grid(double *themesh) {
   int s_dir, r_dir, evenodd;
   MPI_Status status;
@@ -1201,9 +1370,136 @@ template <int cao> void calc_influence_function_force() {
   }
 }
 
+/** Calculate the aliasing sums for the optimal influence function
+ *  with analytical differentiation.
+ *
+ *  Only the sum in the nominator is performed explicitly, the sums of
+ *  the squared assignment function in the denominator are evaluated
+ *  analytically, since the one weighted with k^2 converges slowly
+ *  (see Ballenegger/Cerda/Holm).
+ *
+ *  \param  n           n-vector for which the aliasing sum is to be performed.
+ *  \return influence function without the prefactor 2/pi
+ */
+template <int cao>
+inline double perform_aliasing_sums_force_ad(int const n[3]) {
+  using Utils::int_pow;
+
+  double nominator = 0.0;
+  double sx, sy, sz, f1, mx, my, mz, nmx, nmy, nmz, nm2, expo;
+  double limit = 30;
+
+  f1 = Utils::sqr(Utils::pi() / (p3m.params.alpha));
+
+  for (mx = -P3M_BRILLOUIN; mx <= P3M_BRILLOUIN; mx++) {
+    nmx = p3m.meshift_x[n[KX]] + p3m.params.mesh[RX] * mx;
+    sx = int_pow<2 * cao>(sinc(nmx / (double)p3m.params.mesh[RX]));
+    for (my = -P3M_BRILLOUIN; my <= P3M_BRILLOUIN; my++) {
+      nmy = p3m.meshift_y[n[KY]] + p3m.params.mesh[RY] * my;
+      sy = sx * int_pow<2 * cao>(sinc(nmy / (double)p3m.params.mesh[RY]));
+      for (mz = -P3M_BRILLOUIN; mz <= P3M_BRILLOUIN; mz++) {
+        nmz = p3m.meshift_z[n[KZ]] + p3m.params.mesh[RZ] * mz;
+        sz = sy * int_pow<2 * cao>(sinc(nmz / (double)p3m.params.mesh[RZ]));
+
+        nm2 = Utils::sqr(nmx / box_geo.length()[RX]) +
+              Utils::sqr(nmy / box_geo.length()[RY]) +
+              Utils::sqr(nmz / box_geo.length()[RZ]);
+        expo = f1 * nm2;
+        if (expo < limit)
+          nominator += sz * exp(-expo);
+      }
+    }
+  }
+
+  int const nm[3] = {static_cast<int>(p3m.meshift_x[n[KX]]),
+                     static_cast<int>(p3m.meshift_y[n[KY]]),
+                     static_cast<int>(p3m.meshift_z[n[KZ]])};
+  double u2[3], k2u2[3];
+  for (int i = 0; i < 3; i++) {
+    auto const mesh_i = 1. / p3m.params.mesh[i];
+    u2[i] = p3m_analytic_cotangent_sum(nm[i], mesh_i, cao);
+    k2u2[i] = p3m_analytic_k2_sum(nm[i], mesh_i, cao) /
+              Utils::sqr(box_geo.length()[i]);
+  }
+  auto const denominator = u2[RX] * u2[RY] * u2[RZ];
+  auto const k2_sum = k2u2[RX] * u2[RY] * u2[RZ] +
+                      u2[RX] * k2u2[RY] * u2[RZ] +
+                      u2[RX] * u2[RY] * k2u2[RZ];
+
+  return nominator / (denominator * k2_sum);
+}
+
+template <int cao> void calc_influence_function_force_ad() {
+  int n[3], end[3];
+  int size = 1;
+
+  p3m_calc_meshift();
+
+  for (int i = 0; i < 3; i++) {
+    size *= p3m.fft.plan[3].new_mesh[i];
+    end[i] = p3m.fft.plan[3].start[i] + p3m.fft.plan[3].new_mesh[i];
+  }
+
+  p3m.g_force.resize(size);
+
+  /* Skip influence function calculation in tuning mode,
+     the results need not be correct for timing. */
+  if (p3m.params.tuning) {
+    /* If resized, fill with zeros to avoid nan forces. */
+    memset(p3m.g_force.data(), 0, size * sizeof(double));
+
+    return;
+  }
+
+  for (n[0] = p3m.fft.plan[3].start[0]; n[0] < end[0]; n[0]++) {
+    for (n[1] = p3m.fft.plan[3].start[1]; n[1] < end[1]; n[1]++) {
+      for (n[2] = p3m.fft.plan[3].start[2]; n[2] < end[2]; n[2]++) {
+        auto const ind =
+            (n[2] - p3m.fft.plan[3].start[2]) +
+            p3m.fft.plan[3].new_mesh[2] * ((n[1] - p3m.fft.plan[3].start[1]) +
+                                           (p3m.fft.plan[3].new_mesh[1] *
+                                            (n[0] - p3m.fft.plan[3].start[0])));
+
+        if ((n[KX] % (p3m.params.mesh[RX] / 2) == 0) &&
+            (n[KY] % (p3m.params.mesh[RY] / 2) == 0) &&
+            (n[KZ] % (p3m.params.mesh[RZ] / 2) == 0)) {
+          p3m.g_force[ind] = 0.0;
+        } else {
+          p3m.g_force[ind] =
+              2 * perform_aliasing_sums_force_ad<cao>(n) / (Utils::pi());
+        }
+      }
+    }
+  }
+}
+
 } /* namespace */
 
 void p3m_calc_influence_function_force() {
+  if (p3m.params.analytical_differentiation) {
+    switch (p3m.params.cao) {
+    case 2:
+      calc_influence_function_force_ad<2>();
+      break;
+    case 3:
+      calc_influence_function_force_ad<3>();
+      break;
+    case 4:
+      calc_influence_function_force_ad<4>();
+      break;
+    case 5:
+      calc_influence_function_force_ad<5>();
+      break;
+    case 6:
+      calc_influence_function_force_ad<6>();
+      break;
+    case 7:
+      calc_influence_function_force_ad<7>();
+      break;
+    }
+    return;
+  }
+
   switch (p3m.params.cao) {
   case 1:
     calc_influence_function_force<1>();
@@ -1390,6 +1686,10 @@ static double p3m_get_accuracy(const int mesh[3], int cao, double r_cut_iL,
                               p3m.sum_q2, alpha_L, box_geo.length().data());
   else
 #endif
+      if (p3m.params.analytical_differentiation)
+    ks_err = p3m_k_space_error_ad(coulomb.prefactor, mesh, cao, p3m.sum_qpart,
+                                  p3m.sum_q2, alpha_L);
+  else
     ks_err = p3m_k_space_error(coulomb.prefactor, mesh, cao, p3m.sum_qpart,
                                p3m.sum_q2, alpha_L);
 
@@ -1860,9 +2160,13 @@ int p3m_adaptive_tune(char **log) {
   }
 
   if (p3m.params.cao == 0) {
-    cao_min = 1;
+    /* analytical differentiation needs a differentiable assignment */
+    cao_min = p3m.params.analytical_differentiation ? 2 : 1;
     cao_max = 7;
     cao = cao_max;
+  } else if (p3m.params.analytical_differentiation && p3m.params.cao < 2) {
+    *log = strcat_alloc(*log, "analytical differentiation requires cao > 1\n");
+    return ES_ERROR;
   } else {
     cao_min = cao_max = cao = p3m.params.cao;
 
@@ -2078,85 +2382,77 @@ void p3m_tune_aliasing_sums(int nx, int ny, int nz, const int mesh[3],
     }
   }
 }
-/**@}*/
 
-void p3m_calc_local_ca_mesh() {
-  int i;
-  int ind[3];
-  /* total skin size */
-  double full_skin[3];
+double p3m_k_space_error_ad(double prefac, const int mesh[3], int cao,
+                            int n_c_part, double sum_q2, double alpha_L) {
+  int nx, ny, nz;
+  double he_q = 0.0, mesh_i[3] = {1.0 / mesh[0], 1.0 / mesh[1], 1.0 / mesh[2]},
+         alpha_L_i = 1. / alpha_L;
+  double alias1, alias2, cs, k2_sum;
+  double ctan_x, ctan_y, k2_x, k2_y;
 
-  for (i = 0; i < 3; i++)
-    full_skin[i] = p3m.params.cao_cut[i] + skin + p3m.params.additional_mesh[i];
+  for (nx = -mesh[0] / 2; nx < mesh[0] / 2; nx++) {
+    ctan_x = p3m_analytic_cotangent_sum(nx, mesh_i[0], cao);
+    k2_x = p3m_analytic_k2_sum(nx, mesh_i[0], cao);
+    for (ny = -mesh[1] / 2; ny < mesh[1] / 2; ny++) {
+      auto const ctan_ny = p3m_analytic_cotangent_sum(ny, mesh_i[1], cao);
+      ctan_y = ctan_x * ctan_ny;
+      k2_y = k2_x * ctan_ny + ctan_x * p3m_analytic_k2_sum(ny, mesh_i[1], cao);
+      for (nz = -mesh[2] / 2; nz < mesh[2] / 2; nz++) {
+        if ((nx != 0) || (ny != 0) || (nz != 0)) {
+          auto const ctan_nz = p3m_analytic_cotangent_sum(nz, mesh_i[2], cao);
+          cs = ctan_nz * ctan_y;
+          k2_sum = k2_y * ctan_nz +
+                   ctan_y * p3m_analytic_k2_sum(nz, mesh_i[2], cao);
+          p3m_tune_aliasing_sums_ad(nx, ny, nz, mesh, mesh_i, cao, alpha_L_i,
+                                    &alias1, &alias2);
+
+          double d = alias1 - Utils::sqr(alias2) / (cs * k2_sum);
+          /* at high precisions, d can become negative due to extinction;
+             also, don't take values that have no significant digits left*/
+          if (d > 0 && (fabs(d / alias1) > ROUND_ERROR_PREC))
+            he_q += d;
+        }
+      }
+    }
+  }
+  return 2.0 * prefac * sum_q2 * sqrt(he_q / (double)n_c_part) /
+         (box_geo.length()[1] * box_geo.length()[2]);
+}
 
-  /* inner left down grid point (global index) */
-  for (i = 0; i < 3; i++)
-    p3m.local_mesh.in_ld[i] = (int)ceil(
-        local_geo.my_left()[i] * p3m.params.ai[i] - p3m.params.mesh_off[i]);
-  /* inner up right grid point (global index) */
-  for (i = 0; i < 3; i++)
-    p3m.local_mesh.in_ur[i] = (int)floor(
-        local_geo.my_right()[i] * p3m.params.ai[i] - p3m.params.mesh_off[i]);
+void p3m_tune_aliasing_sums_ad(int nx, int ny, int nz, const int mesh[3],
+                               const double mesh_i[3], int cao,
+                               double alpha_L_i, double *alias1,
+                               double *alias2) {
 
-  /* correct roundof errors at boundary */
-  for (i = 0; i < 3; i++) {
-    if ((local_geo.my_right()[i] * p3m.params.ai[i] - p3m.params.mesh_off[i]) -
-            p3m.local_mesh.in_ur[i] <
-        ROUND_ERROR_PREC)
-      p3m.local_mesh.in_ur[i]--;
-    if (1.0 +
-            (local_geo.my_left()[i] * p3m.params.ai[i] -
-             p3m.params.mesh_off[i]) -
-            p3m.local_mesh.in_ld[i] <
-        ROUND_ERROR_PREC)
-      p3m.local_mesh.in_ld[i]--;
-  }
-  /* inner grid dimensions */
-  for (i = 0; i < 3; i++)
-    p3m.local_mesh.inner[i] =
-        p3m.local_mesh.in_ur[i] - p3m.local_mesh.in_ld[i] + 1;
-  /* index of left down grid point in global mesh */
-  for (i = 0; i < 3; i++)
-    p3m.local_mesh.ld_ind[i] =
-        (int)ceil((local_geo.my_left()[i] - full_skin[i]) * p3m.params.ai[i] -
-                  p3m.params.mesh_off[i]);
-  /* left down margin */
-  for (i = 0; i < 3; i++)
-    p3m.local_mesh.margin[i * 2] =
-        p3m.local_mesh.in_ld[i] - p3m.local_mesh.ld_ind[i];
-  /* up right grid point */
-  for (i = 0; i < 3; i++)
-    ind[i] =
-        (int)floor((local_geo.my_right()[i] + full_skin[i]) * p3m.params.ai[i] -
-                   p3m.params.mesh_off[i]);
-  /* correct roundof errors at up right boundary */
-  for (i = 0; i < 3; i++)
-    if (((local_geo.my_right()[i] + full_skin[i]) * p3m.params.ai[i] -
-         p3m.params.mesh_off[i]) -
-            ind[i] ==
-        0)
-      ind[i]--;
-  /* up right margin */
-  for (i = 0; i < 3; i++)
-    p3m.local_mesh.margin[(i * 2) + 1] = ind[i] - p3m.local_mesh.in_ur[i];
+  int mx, my, mz;
+  double nmx, nmy, nmz;
+  double fnmx, fnmy, fnmz;
 
-  /* grid dimension */
-  p3m.local_mesh.size = 1;
-  for (i = 0; i < 3; i++) {
-    p3m.local_mesh.dim[i] = ind[i] - p3m.local_mesh.ld_ind[i] + 1;
-    p3m.local_mesh.size *= p3m.local_mesh.dim[i];
-  }
-  /* reduce inner grid indices from global to local */
-  for (i = 0; i < 3; i++)
-    p3m.local_mesh.in_ld[i] = p3m.local_mesh.margin[i * 2];
-  for (i = 0; i < 3; i++)
-    p3m.local_mesh.in_ur[i] =
-        p3m.local_mesh.margin[i * 2] + p3m.local_mesh.inner[i];
+  double ex, ex2, nm2, U2, factor1;
+
+  factor1 = Utils::sqr(Utils::pi() * alpha_L_i);
+
+  *alias1 = *alias2 = 0.0;
+  for (mx = -P3M_BRILLOUIN; mx <= P3M_BRILLOUIN; mx++) {
+    fnmx = mesh_i[0] * (nmx = nx + mx * mesh[0]);
+    for (my = -P3M_BRILLOUIN; my <= P3M_BRILLOUIN; my++) {
+      fnmy = mesh_i[1] * (nmy = ny + my * mesh[1]);
+      for (mz = -P3M_BRILLOUIN; mz <= P3M_BRILLOUIN; mz++) {
+        fnmz = mesh_i[2] * (nmz = nz + mz * mesh[2]);
 
-  p3m.local_mesh.q_2_off = p3m.local_mesh.dim[2] - p3m.params.cao;
-  p3m.local_mesh.q_21_off =
-      p3m.local_mesh.dim[2] * (p3m.local_mesh.dim[1] - p3m.params.cao);
+        nm2 = Utils::sqr(nmx) + Utils::sqr(nmy) + Utils::sqr(nmz);
+        ex2 = Utils::sqr(ex = exp(-factor1 * nm2));
+
+        U2 = pow(sinc(fnmx) * sinc(fnmy) * sinc(fnmz), 2.0 * cao);
+
+        *alias1 += ex2 / nm2;
+        *alias2 += U2 * ex;
+      }
+    }
+  }
 }
+/**@}*/
 
 void p3m_calc_lm_ld_pos() {
   int i;
@@ -2254,96 +2550,13 @@ bool p3m_sanity_checks() {
     runtimeErrorMsg() << "P3M_init: alpha must be >0";
     ret = true;
   }
-
-  return ret;
-}
-
-void p3m_calc_send_mesh() {
-  int i, j, evenodd;
-  int done[3] = {0, 0, 0};
-  MPI_Status status;
-  /* send grids */
-  for (i = 0; i < 3; i++) {
-    for (j = 0; j < 3; j++) {
-      /* left */
-      p3m.sm.s_ld[i * 2][j] = 0 + done[j] * p3m.local_mesh.margin[j * 2];
-      if (j == i)
-        p3m.sm.s_ur[i * 2][j] = p3m.local_mesh.margin[j * 2];
-      else
-        p3m.sm.s_ur[i * 2][j] = p3m.local_mesh.dim[j] -
-                                done[j] * p3m.local_mesh.margin[(j * 2) + 1];
-      /* right */
-      if (j == i)
-        p3m.sm.s_ld[(i * 2) + 1][j] = p3m.local_mesh.in_ur[j];
-      else
-        p3m.sm.s_ld[(i * 2) + 1][j] =
-            0 + done[j] * p3m.local_mesh.margin[j * 2];
-      p3m.sm.s_ur[(i * 2) + 1][j] =
-          p3m.local_mesh.dim[j] - done[j] * p3m.local_mesh.margin[(j * 2) + 1];
-    }
-    done[i] = 1;
-  }
-  p3m.sm.max = 0;
-  for (i = 0; i < 6; i++) {
-    p3m.sm.s_size[i] = 1;
-    for (j = 0; j < 3; j++) {
-      p3m.sm.s_dim[i][j] = p3m.sm.s_ur[i][j] - p3m.sm.s_ld[i][j];
-      p3m.sm.s_size[i] *= p3m.sm.s_dim[i][j];
-    }
-    if (p3m.sm.s_size[i] > p3m.sm.max)
-      p3m.sm.max = p3m.sm.s_size[i];
+  if (p3m.params.analytical_differentiation && p3m.params.cao == 1) {
+    runtimeErrorMsg()
+        << "P3M_init: analytical differentiation requires cao > 1";
+    ret = true;
   }
-  /* communication */
-  auto const node_neighbors = calc_node_neighbors(comm_cart);
-  auto const node_pos = calc_node_pos(comm_cart);
 
-  for (i = 0; i < 6; i++) {
-    if (i % 2 == 0)
-      j = i + 1;
-    else
-      j = i - 1;
-    if (node_neighbors[i] != this_node) {
-      /* two step communication: first all even positions than all odd */
-      for (evenodd = 0; evenodd < 2; evenodd++) {
-        if ((node_pos[i / 2] + evenodd) % 2 == 0)
-          MPI_Send(&(p3m.local_mesh.margin[i]), 1, MPI_INT, node_neighbors[i],
-                   REQ_P3M_INIT, comm_cart);
-        else
-          MPI_Recv(&(p3m.local_mesh.r_margin[j]), 1, MPI_INT, node_neighbors[j],
-                   REQ_P3M_INIT, comm_cart, &status);
-      }
-    } else {
-      p3m.local_mesh.r_margin[j] = p3m.local_mesh.margin[i];
-    }
-  }
-  /* recv grids */
-  for (i = 0; i < 3; i++)
-    for (j = 0; j < 3; j++) {
-      if (j == i) {
-        p3m.sm.r_ld[i * 2][j] =
-            p3m.sm.s_ld[i * 2][j] + p3m.local_mesh.margin[2 * j];
-        p3m.sm.r_ur[i * 2][j] =
-            p3m.sm.s_ur[i * 2][j] + p3m.local_mesh.r_margin[2 * j];
-        p3m.sm.r_ld[(i * 2) + 1][j] =
-            p3m.sm.s_ld[(i * 2) + 1][j] - p3m.local_mesh.r_margin[(2 * j) + 1];
-        p3m.sm.r_ur[(i * 2) + 1][j] =
-            p3m.sm.s_ur[(i * 2) + 1][j] - p3m.local_mesh.margin[(2 * j) + 1];
-      } else {
-        p3m.sm.r_ld[i * 2][j] = p3m.sm.s_ld[i * 2][j];
-        p3m.sm.r_ur[i * 2][j] = p3m.sm.s_ur[i * 2][j];
-        p3m.sm.r_ld[(i * 2) + 1][j] = p3m.sm.s_ld[(i * 2) + 1][j];
-        p3m.sm.r_ur[(i * 2) + 1][j] = p3m.sm.s_ur[(i * 2) + 1][j];
-      }
-    }
-  for (i = 0; i < 6; i++) {
-    p3m.sm.r_size[i] = 1;
-    for (j = 0; j < 3; j++) {
-      p3m.sm.r_dim[i][j] = p3m.sm.r_ur[i][j] - p3m.sm.r_ld[i][j];
-      p3m.sm.r_size[i] *= p3m.sm.r_dim[i][j];
-    }
-    if (p3m.sm.r_size[i] > p3m.sm.max)
-      p3m.sm.max = p3m.sm.r_size[i];
-  }
+  return ret;
 }
 
 void p3m_scaleby_box_l() {
@@ -2359,6 +2572,14 @@ void p3m_scaleby_box_l() {
   p3m_sanity_checks_boxl();
   p3m_calc_influence_function_force();
   p3m_calc_influence_function_energy();
+  p3m_tabulate_real_space();
+}
+
+void p3m_tabulate_real_space() {
+  if (p3m.params.r_cut > 0.)
+    p3m.real_space = P3MRealSpaceTable(p3m.params.alpha, p3m.params.r_cut);
+  else
+    p3m.real_space = P3MRealSpaceTable();
 }
 
 void p3m_calc_kspace_stress(double *stress) {
@@ -2384,7 +2605,8 @@ void p3m_calc_kspace_stress(double *stress) {
       k_space_stress[i] = 0.0;
     }
 
-    p3m_gather_fft_grid(p3m.rs_mesh);
+    p3m_gather_fft_grid(p3m.rs_mesh, p3m.local_mesh, p3m.sm, p3m.send_grid,
+                        p3m.recv_grid, comm_cart);
     fft_perform_forw(p3m.rs_mesh, p3m.fft, comm_cart);
     force_prefac =
         coulomb.prefactor /
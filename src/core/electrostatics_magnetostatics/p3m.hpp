@@ -47,6 +47,9 @@
  *  - J. J. Cerda,
  *    *P3M for dipolar interactions*,
  *    J. Chem. Phys (129) 234104, 2008
+ *  - V. Ballenegger, J. J. Cerda and C. Holm,
+ *    *How to convert SPME to P3M: influence functions and error estimates*,
+ *    J. Chem. Theory Comput. (8) 936-947, 2012
  *
  *  Implementation in p3m.cpp.
  */
@@ -58,6 +61,7 @@
 #include "debug.hpp"
 #include "fft.hpp"
 #include "p3m-common.hpp"
+#include "p3m_real_space.hpp"
 
 #include <utils/constants.hpp>
 #include <utils/math/AS_erfc_part.hpp>
@@ -95,7 +99,8 @@ struct p3m_data_struct {
   std::vector<double> meshift_y;
   std::vector<double> meshift_z;
 
-  /** Spatial differential operator in k-space. We use an i*k differentiation.
+  /** Spatial differential operator in k-space. We use an i*k differentiation,
+   *  unless @ref P3MParameters::analytical_differentiation is set.
    */
   std::array<std::vector<double>, 3> d_op;
   /** Force optimised influence function (k-space) */
@@ -103,6 +108,9 @@ struct p3m_data_struct {
   /** Energy optimised influence function (k-space) */
   std::vector<double> g_energy;
 
+  /** Tabulated real space interaction, see @ref p3m_tabulate_real_space */
+  P3MRealSpaceTable real_space;
+
 #ifdef P3M_STORE_CA_FRAC
   /** number of charged particles on the node. */
   int ca_num;
@@ -179,6 +187,11 @@ void p3m_init();
  */
 void p3m_scaleby_box_l();
 
+/** Tabulate the real space interaction for the current
+ *  @ref P3MParameters::alpha "alpha" and @ref P3MParameters::r_cut "r_cut".
+ */
+void p3m_tabulate_real_space();
+
 /** Compute the k-space part of forces and energies for the charge-charge
  *  interaction
  */
@@ -218,28 +231,34 @@ void p3m_shrink_wrap_charge_grid(int n_charges);
 
 /** Calculate real space contribution of Coulomb pair forces.
  *
- *  If NPT is compiled in, it returns the energy, which is needed for NPT.
+ *  The interaction is interpolated from @ref p3m_data_struct::real_space
+ *  "real_space", if it has been tabulated for the current parameters.
  */
 inline void p3m_add_pair_force(double q1q2, double const *d, double dist,
                                double *force) {
   if (dist < p3m.params.r_cut) {
     if (dist > 0.0) {
-      double adist = p3m.params.alpha * dist;
+      auto const dist2 = dist * dist;
+      double fac2;
+      if (dist2 < p3m.real_space.s_max()) {
+        fac2 = q1q2 * p3m.real_space.force(dist, dist2);
+      } else {
+        double adist = p3m.params.alpha * dist;
 #if USE_ERFC_APPROXIMATION
-      auto const erfc_part_ri = Utils::AS_erfc_part(adist) / dist;
-      auto const fac1 = q1q2 * exp(-adist * adist);
-      auto const fac2 =
-          fac1 * (erfc_part_ri + 2.0 * p3m.params.alpha * Utils::sqrt_pi_i()) /
-          (dist * dist);
+        auto const erfc_part_ri = Utils::AS_erfc_part(adist) / dist;
+        auto const fac1 = q1q2 * exp(-adist * adist);
+        fac2 = fac1 *
+               (erfc_part_ri + 2.0 * p3m.params.alpha * Utils::sqrt_pi_i()) /
+               dist2;
 #else
-      auto const erfc_part_ri = erfc(adist) / dist;
-      auto const fac1 = q1q2;
-      auto const fac2 =
-          fac1 *
-          (erfc_part_ri +
-           2.0 * p3m.params.alpha * Utils::sqrt_pi_i() * exp(-adist * adist)) /
-          (dist * dist);
+        auto const erfc_part_ri = erfc(adist) / dist;
+        auto const fac1 = q1q2;
+        fac2 = fac1 *
+               (erfc_part_ri + 2.0 * p3m.params.alpha * Utils::sqrt_pi_i() *
+                                   exp(-adist * adist)) /
+               dist2;
 #endif
+      }
       for (int j = 0; j < 3; j++)
         force[j] += fac2 * d[j];
     }
@@ -283,6 +302,13 @@ int p3m_set_mesh_offset(double x, double y, double z);
  */
 int p3m_set_eps(double eps);
 
+/** Set @ref P3MParameters::analytical_differentiation
+ *  "analytical_differentiation" parameter
+ *
+ *  @param[in]  ad  @copybrief P3MParameters::analytical_differentiation
+ */
+int p3m_set_analytical_differentiation(bool ad);
+
 /** Set @ref P3MParameters::inter "inter" parameter
  *
  *  @param[in]  n            @copybrief P3MParameters::inter
@@ -292,6 +318,9 @@ int p3m_set_ninterpol(int n);
 /** Calculate real space contribution of Coulomb pair energy. */
 inline double p3m_pair_energy(double chgfac, double dist) {
   if (dist < p3m.params.r_cut && dist != 0) {
+    auto const dist2 = dist * dist;
+    if (dist2 < p3m.real_space.s_max())
+      return chgfac * p3m.real_space.energy(dist, dist2);
     double adist = p3m.params.alpha * dist;
 #if USE_ERFC_APPROXIMATION
     double erfc_part_ri = Utils::AS_erfc_part(adist) / dist;
@@ -0,0 +1,124 @@
+/*
+  Copyright (C) 2019 The ESPResSo project
+
+  This file is part of ESPResSo.
+
+  ESPResSo is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "electrostatics_magnetostatics/p3m_real_space.hpp"
+
+#include <utils/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+/** Largest number of intervals of the table */
+constexpr int max_intervals = 1 << 16;
+/** Attainable precision of the interpolation relative to the Coulomb
+ *  interaction */
+constexpr double precision = 1e-10;
+
+/** Smooth parts E, F and the derivative of F with respect to the squared
+ *  distance @p s, see @ref p3m_real_space.hpp.
+ */
+void smooth_parts(double alpha, double s, double &e, double &f, double &df) {
+  auto const alpha2 = alpha * alpha;
+  auto const t = alpha2 * s;
+  auto const pref = 2. * alpha * Utils::sqrt_pi_i();
+
+  if (t < 0.1) {
+    /* the closed form loses precision for small distances, use the
+       Taylor series of erf(x)/x instead */
+    double term = 1., sum_e = 0., sum_f = 0., sum_df = 0.;
+    for (int n = 0; n < 12; n++) {
+      sum_e += term / (2 * n + 1);
+      sum_f += term / (2 * n + 3);
+      sum_df += term / (2 * n + 5);
+      term *= -t / (n + 1);
+    }
+    e = pref * sum_e;
+    f = 2. * alpha2 * pref * sum_f;
+    df = -2. * alpha2 * alpha2 * pref * sum_df;
+    return;
+  }
+
+  auto const r = std::sqrt(s);
+  auto const gauss = pref * std::exp(-t);
+  e = std::erf(alpha * r) / r;
+  f = (e - gauss) / s;
+  df = (2. * alpha2 * gauss - 3. * f) / (2. * s);
+}
+} // namespace
+
+P3MRealSpaceTable::P3MRealSpaceTable(double alpha, double r_cut,
+                                     double tolerance)
+    : m_s_max(r_cut * r_cut) {
+  /* the exact values at the cutoff set the scale of the error, but the
+     subtraction from the Coulomb interaction limits the precision */
+  double e_cut, f_cut, df_cut;
+  smooth_parts(alpha, m_s_max, e_cut, f_cut, df_cut);
+  auto const energy_tol = std::max(tolerance * (1. / r_cut - e_cut),
+                                   precision / r_cut);
+  auto const force_tol =
+      std::max(tolerance * (1. / (r_cut * m_s_max) - f_cut),
+               precision / (r_cut * m_s_max));
+
+  /* start with 16 intervals per unit of (alpha r)^2 */
+  auto n = std::max(
+      16, static_cast<int>(std::ceil(16. * alpha * alpha * m_s_max)));
+  for (;; n *= 2) {
+    auto const h = m_s_max / n;
+    m_h_i = 1. / h;
+
+    /* one interval beyond the cutoff absorbs round-off in the index */
+    m_coefficients.resize(n + 1);
+    double e0, f0, df0;
+    smooth_parts(alpha, 0., e0, f0, df0);
+    for (int k = 0; k <= n; k++) {
+      double e1, f1, df1;
+      smooth_parts(alpha, (k + 1) * h, e1, f1, df1);
+
+      /* dE/ds = -F/2 */
+      auto const de0 = -0.5 * h * f0, de1 = -0.5 * h * f1;
+      auto const dh0 = h * df0, dh1 = h * df1;
+      m_coefficients[k] = {e0,
+                           de0,
+                           3. * (e1 - e0) - 2. * de0 - de1,
+                           2. * (e0 - e1) + de0 + de1,
+                           f0,
+                           dh0,
+                           3. * (f1 - f0) - 2. * dh0 - dh1,
+                           2. * (f0 - f1) + dh0 + dh1};
+
+      e0 = e1;
+      f0 = f1;
+      df0 = df1;
+    }
+
+    double energy_err = 0., force_err = 0.;
+    for (int k = 0; k < n; k++) {
+      auto const s = (k + 0.5) * h;
+      double e, f, e_exact, f_exact, df_exact;
+      (*this)(s, e, f);
+      smooth_parts(alpha, s, e_exact, f_exact, df_exact);
+      energy_err = std::max(energy_err, std::abs(e - e_exact));
+      force_err = std::max(force_err, std::abs(f - f_exact));
+    }
+
+    if ((energy_err <= energy_tol and force_err <= force_tol) or
+        2 * n > max_intervals)
+      break;
+  }
+}
@@ -0,0 +1,115 @@
+/*
+  Copyright (C) 2019 The ESPResSo project
+
+  This file is part of ESPResSo.
+
+  ESPResSo is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef CORE_P3M_REAL_SPACE_HPP
+#define CORE_P3M_REAL_SPACE_HPP
+/** \file
+ *  Tabulated real space part of the Ewald sum.
+ *
+ *  In terms of the squared distance \f$ s = r^2 \f$, the real space energy
+ *  and the force factor of a pair of unit charges are split as
+ *  \f[
+ *    \frac{\mathrm{erfc}(\alpha r)}{r} = \frac{1}{r} - E(s), \quad
+ *    \frac{1}{r^2} \left( \frac{\mathrm{erfc}(\alpha r)}{r}
+ *      + \frac{2\alpha}{\sqrt{\pi}} e^{-\alpha^2 r^2} \right)
+ *    = \frac{1}{r^3} - F(s),
+ *  \f]
+ *  where \f$ E(s) = \mathrm{erf}(\alpha r)/r \f$ and
+ *  \f$ F(s) = -2 E'(s) \f$ are smooth functions of \f$ s \f$. These are
+ *  interpolated from a table of cubic Hermite polynomials on a regular grid
+ *  in \f$ s \f$, so that a pair needs a single table lookup instead of the
+ *  evaluation of \f$ \mathrm{erfc} \f$ and \f$ \exp \f$.
+ */
+
+#include <array>
+#include <vector>
+
+class P3MRealSpaceTable {
+public:
+  P3MRealSpaceTable() = default;
+
+  /**
+   * @brief Tabulate the real space interaction.
+   *
+   * The grid is refined until the interpolation error of the energy and
+   * the force at the centers of the intervals is below @p tolerance times
+   * their exact value at the cutoff. Beyond the precision of the
+   * subtraction from the Coulomb interaction, the grid is not refined.
+   *
+   * @param alpha     Ewald splitting parameter
+   * @param r_cut     real space cutoff
+   * @param tolerance relative interpolation error at the cutoff
+   */
+  P3MRealSpaceTable(double alpha, double r_cut, double tolerance = 1e-3);
+
+  /** Squared distance up to which the table is valid */
+  double s_max() const { return m_s_max; }
+
+  /**
+   * @brief Interpolate the smooth parts at squared distance @p s,
+   *        which has to be smaller than @ref s_max.
+   *
+   * @param[in]  s  squared distance
+   * @param[out] e  smooth part of the energy, \f$ E(s) \f$
+   * @param[out] f  smooth part of the force factor, \f$ F(s) \f$
+   */
+  void operator()(double s, double &e, double &f) const {
+    double t;
+    auto const &c = interval(s, t);
+    e = c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+    f = c[4] + t * (c[5] + t * (c[6] + t * c[7]));
+  }
+
+  /**
+   * @brief Force divided by the distance for a pair of unit charges.
+   *
+   * @param dist  distance, with 0 < dist^2 < @ref s_max
+   * @param dist2 squared distance
+   */
+  double force(double dist, double dist2) const {
+    double t;
+    auto const &c = interval(dist2, t);
+    return 1. / (dist * dist2) - (c[4] + t * (c[5] + t * (c[6] + t * c[7])));
+  }
+
+  /**
+   * @brief Energy \f$ \mathrm{erfc}(\alpha r)/r \f$ of a pair of unit
+   *        charges, see @ref force for the parameters.
+   */
+  double energy(double dist, double dist2) const {
+    double t;
+    auto const &c = interval(dist2, t);
+    return 1. / dist - (c[0] + t * (c[1] + t * (c[2] + t * c[3])));
+  }
+
+private:
+  double m_s_max = 0.;
+  double m_h_i = 0.;
+  /** Coefficients of the polynomials of E and F in each interval */
+  std::vector<std::array<double, 8>> m_coefficients;
+
+  /** Coefficients of the interval of @p s and the position @p t in it */
+  std::array<double, 8> const &interval(double s, double &t) const {
+    auto const x = s * m_h_i;
+    auto const k = static_cast<int>(x);
+    t = x - k;
+    return m_coefficients[k];
+  }
+};
+
+#endif
@@ -164,6 +164,10 @@ void on_integration_start() {
     runtimeErrorMsg() << "Nodes disagree about use of verlet lists.";
   }
 
+  if (!Utils::Mpi::all_compare(comm_cart, cell_structure.use_soa)) {
+    runtimeErrorMsg() << "Nodes disagree about use of packed particle data.";
+  }
+
 #ifdef ELECTROSTATICS
   if (!Utils::Mpi::all_compare(comm_cart, coulomb.method))
     runtimeErrorMsg() << "Nodes disagree about Coulomb long range method";
@@ -435,6 +439,10 @@ void on_parameter_change(int field) {
   case FIELD_SIMTIME:
     recalc_forces = 1;
     break;
+  case FIELD_LONG_RANGE_INTERVAL:
+    /* The stored forces carry the weight of the old interval */
+    recalc_forces = 1;
+    break;
   }
 }
 
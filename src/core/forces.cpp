@@ -39,11 +39,14 @@
 #include "grid_based_algorithms/lb_interface.hpp"
 #include "grid_based_algorithms/lb_particle_coupling.hpp"
 #include "immersed_boundaries.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj_wca_batch.hpp"
 #include "short_range_loop.hpp"
 
 #include <profiler/profiler.hpp>
 
 #include <cassert>
+#include <vector>
 
 ActorList forceActors;
 
@@ -67,11 +70,12 @@ void init_forces() {
   }
 
   /* initialize ghost forces with zero
-     set torque to zero for all and rescale quaternions
+     set torque to zero for all and rescale quaternions.
+     The ghosts may not be accessed while their update is in flight,
+     they are then initialized when the update is completed.
   */
-  for (auto &p : ghost_cells.particles()) {
-    init_ghost_force(&p);
-  }
+  if (not cells_ghosts_pending())
+    init_forces_ghosts();
 }
 
 void init_forces_ghosts() {
@@ -93,9 +97,102 @@ void check_forces() {
   }
 }
 
+/** @brief Whether the non-bonded pair forces only write to the two
+ *         particles of the pair, so that the pairs can be distributed
+ *         over threads.
+ */
+static bool pair_forces_thread_safe() {
+#ifdef COLLISION_DETECTION
+  if (collision_params.mode != COLLISION_MODE_OFF)
+    return false;
+#endif
+#ifdef NPT
+  /* The virial is accumulated in a global */
+  if (integ_switch == INTEG_METHOD_NPT_ISO)
+    return false;
+#endif
+#ifdef DPD
+  if (thermo_switch & THERMO_DPD)
+    return false;
+#endif
+#ifdef ELECTROSTATICS
+  switch (coulomb.method) {
+  case COULOMB_MMM1D:
+  case COULOMB_MMM2D:
+  case COULOMB_SCAFACOS:
+    return false;
+  default:
+    break;
+  }
+#endif
+#ifdef DIPOLES
+  switch (dipole.method) {
+  case DIPOLAR_NONE:
+  case DIPOLAR_P3M:
+  case DIPOLAR_MDLC_P3M:
+    break;
+  default:
+    return false;
+  }
+#endif
+  return true;
+}
+
+/** @brief Whether the calculations before the short-range loop only
+ *         need the local particles, so that they can overlap with the
+ *         update of the ghosts, see @ref cells_update_ghosts_begin.
+ */
+static bool ghost_update_can_overlap() {
+  /* The actors may copy all particles */
+  if (not forceActors.empty())
+    return false;
+#ifdef ELECTROSTATICS
+  /* The ICC iteration runs over the pairs */
+  if (iccp3m_cfg.n_ic > 0)
+    return false;
+#endif
+  return true;
+}
+
+/** @brief Add the long-range forces with a weight, see
+ *         @ref long_range_force_weight.
+ */
+static void add_long_range_forces(int weight) {
+  if (weight == 1) {
+    calc_long_range_forces();
+    return;
+  }
+  if (weight == 0)
+    return;
+
+  /* The long-range methods add to the forces of the local particles,
+     so only their contribution is scaled. */
+  auto const particles = local_cells.particles();
+  std::vector<ParticleForce> f_old;
+  f_old.reserve(particles.size());
+  for (auto const &p : particles)
+    f_old.push_back(p.f);
+
+  calc_long_range_forces();
+
+  auto f = f_old.begin();
+  for (auto &p : particles) {
+    p.f.f = f->f + weight * (p.f.f - f->f);
+#ifdef ROTATION
+    p.f.torque = f->torque + weight * (p.f.torque - f->torque);
+#endif
+    ++f;
+  }
+}
+
 void force_calc() {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
 
+  /* A ghost update started by the integrator is completed in the
+     short-range loop, after the interior cells. */
+  if (not ghost_update_can_overlap())
+    cells_update_ghosts_finish();
+
   espressoSystemInterface.update();
 
 #ifdef COLLISION_DETECTION
@@ -104,6 +201,9 @@ void force_calc() {
 
 #ifdef ELECTROSTATICS
   iccp3m_iteration();
+  /* the induced charges have changed since the last ghost update */
+  if (cell_structure.use_soa && iccp3m_cfg.n_ic > 0)
+    cells_update_soa();
 #endif
   init_forces();
 
@@ -114,21 +214,53 @@ void force_calc() {
 #endif
   }
 
-  calc_long_range_forces();
+  add_long_range_forces(long_range_force_weight());
 
   // Only calculate pair forces if the maximum cutoff is >0
   if (max_cut > 0) {
-    short_range_loop([](Particle &p) { add_single_particle_force(&p); },
-                     [](Particle &p1, Particle &p2, Distance &d) {
-                       add_non_bonded_pair_force(&(p1), &(p2), d.vec21.data(),
-                                                 sqrt(d.dist2), d.dist2);
-                     });
+    auto const thread_safe = pair_forces_thread_safe();
+
+    if (short_range_loop_uses_soa() && LJWCABatch::enabled()) {
+      /* Pairs with only LJ/WCA are done by the batched kernel, all
+         other pairs are passed on to the scalar pair force. */
+      LJWCABatch::Kernel const lj_wca_batch(max_cut + skin);
+      short_range_block_loop(
+          [](Particle &p) { add_single_particle_force(&p); },
+          [&lj_wca_batch](Cell &c1, int i, Cell &c2, int begin, int end) {
+            lj_wca_batch(c1, i, c2, begin, end,
+                         [](Particle &p1, Particle &p2,
+                            Utils::Vector3d const &vec21) {
+                           Distance d(vec21);
+                           add_non_bonded_pair_force(&(p1), &(p2),
+                                                     d.vec21.data(),
+                                                     sqrt(d.dist2), d.dist2);
+                         });
+          },
+          thread_safe);
+    } else {
+      short_range_loop([](Particle &p) { add_single_particle_force(&p); },
+                       [](Particle &p1, Particle &p2, Distance &d) {
+                         add_non_bonded_pair_force(&(p1), &(p2),
+                                                   d.vec21.data(),
+                                                   sqrt(d.dist2), d.dist2);
+                       },
+                       thread_safe);
+    }
   } else {
     // Otherwise only do single-particle contributions
+    if (cells_ghosts_pending()) {
+      cells_update_ghosts_finish();
+      init_forces_ghosts();
+    }
     for (auto &p : local_cells.particles()) {
       add_single_particle_force(&p);
     }
   }
+
+  // Kernels running on the packed particle data accumulate their forces there
+  if (cell_structure.use_soa) {
+    cells_soa_add_forces();
+  }
   auto local_parts = local_cells.particles();
   Constraints::constraints.add_forces(local_parts, sim_time);
 
@@ -30,12 +30,16 @@
 #include "debug.hpp"
 #include "errorhandling.hpp"
 #include "particle_data.hpp"
+#include "rattle.hpp"
+
+#include <boost/mpi/collectives/all_reduce.hpp>
 
 #include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <mpi.h>
+#include <unordered_set>
 #include <vector>
 
 /** Tag for communication in ghost_comm. */
@@ -63,6 +67,198 @@ std::vector<int> r_bondbuffer;
 int ghosts_have_v = 0;
 int ghosts_have_bonds = 0;
 
+/** Whether the ghosts need the rotational degrees of freedom, i.e. the
+    quaternions, angular velocities and torques. Set by
+    \ref ghosts_check_rotation on every resort.
+*/
+static bool ghosts_have_rotation = true;
+
+void ghosts_check_rotation() {
+#ifdef ROTATION
+  auto const identity = Utils::Vector4d{1., 0., 0., 0.};
+  bool local = false;
+  for (auto const &p : local_cells.particles()) {
+    if (p.p.rotation || (p.r.quat != identity)) {
+      local = true;
+      break;
+    }
+  }
+
+  ghosts_have_rotation =
+      boost::mpi::all_reduce(comm_cart, local, std::logical_or<bool>());
+#else
+  ghosts_have_rotation = false;
+#endif
+}
+
+/************************************************************/
+/* Packing of the particle data */
+
+namespace {
+template <typename T> char *pack(char *out, T const &value) {
+  std::memcpy(out, &value, sizeof(T));
+  return out + sizeof(T);
+}
+
+template <typename T> char const *unpack(char const *in, T &value) {
+  std::memcpy(&value, in, sizeof(T));
+  return in + sizeof(T);
+}
+
+/** Size of the transferred part of a \ref ParticlePosition. The
+ *  quaternion is only sent if particles rotate, the old position
+ *  only for RATTLE.
+ */
+int position_size() {
+  int size = sizeof(Utils::Vector3d);
+#ifdef ROTATION
+  if (ghosts_have_rotation)
+    size += sizeof(Utils::Vector4d);
+#endif
+#ifdef BOND_CONSTRAINT
+  if (n_rigidbonds)
+    size += sizeof(Utils::Vector3d);
+#endif
+  return size;
+}
+
+/** Pack a position, with the folded position replaced by pos. */
+char *pack_position(char *out, ParticlePosition const &r,
+                    Utils::Vector3d const &pos) {
+  out = pack(out, pos);
+#ifdef ROTATION
+  if (ghosts_have_rotation)
+    out = pack(out, r.quat);
+#endif
+#ifdef BOND_CONSTRAINT
+  if (n_rigidbonds)
+    out = pack(out, r.p_old);
+#endif
+  return out;
+}
+
+char const *unpack_position(char const *in, ParticlePosition &r) {
+  in = unpack(in, r.p);
+#ifdef ROTATION
+  if (ghosts_have_rotation)
+    in = unpack(in, r.quat);
+#endif
+#ifdef BOND_CONSTRAINT
+  if (n_rigidbonds)
+    in = unpack(in, r.p_old);
+#endif
+  return in;
+}
+
+void copy_position(ParticlePosition const &src, ParticlePosition &dst,
+                   Utils::Vector3d const &pos) {
+  dst.p = pos;
+#ifdef ROTATION
+  if (ghosts_have_rotation)
+    dst.quat = src.quat;
+#endif
+#ifdef BOND_CONSTRAINT
+  if (n_rigidbonds)
+    dst.p_old = src.p_old;
+#endif
+}
+
+/** Size of the transferred part of a \ref ParticleMomentum. */
+int momentum_size() {
+  int size = sizeof(Utils::Vector3d);
+#ifdef ROTATION
+  if (ghosts_have_rotation)
+    size += sizeof(Utils::Vector3d);
+#endif
+  return size;
+}
+
+char *pack_momentum(char *out, ParticleMomentum const &m) {
+  out = pack(out, m.v);
+#ifdef ROTATION
+  if (ghosts_have_rotation)
+    out = pack(out, m.omega);
+#endif
+  return out;
+}
+
+char const *unpack_momentum(char const *in, ParticleMomentum &m) {
+  in = unpack(in, m.v);
+#ifdef ROTATION
+  if (ghosts_have_rotation)
+    in = unpack(in, m.omega);
+#endif
+  return in;
+}
+
+void copy_momentum(ParticleMomentum const &src, ParticleMomentum &dst) {
+  dst.v = src.v;
+#ifdef ROTATION
+  if (ghosts_have_rotation)
+    dst.omega = src.omega;
+#endif
+}
+
+/** Size of the transferred part of a \ref ParticleForce. The torques
+ *  are only collected if particles rotate. Only doubles, so that the
+ *  forces can be reduced as such.
+ */
+int force_size() {
+  int size = sizeof(Utils::Vector3d);
+#ifdef ROTATION
+  if (ghosts_have_rotation)
+    size += sizeof(Utils::Vector3d);
+#endif
+  return size;
+}
+
+char *pack_force(char *out, ParticleForce const &f) {
+  out = pack(out, f.f);
+#ifdef ROTATION
+  if (ghosts_have_rotation)
+    out = pack(out, f.torque);
+#endif
+  return out;
+}
+
+char const *unpack_force(char const *in, ParticleForce &f) {
+  in = unpack(in, f.f);
+#ifdef ROTATION
+  if (ghosts_have_rotation)
+    in = unpack(in, f.torque);
+#endif
+  return in;
+}
+
+char const *unpack_add_force(char const *in, ParticleForce &f) {
+  Utils::Vector3d tmp;
+  in = unpack(in, tmp);
+  f.f += tmp;
+#ifdef ROTATION
+  if (ghosts_have_rotation) {
+    in = unpack(in, tmp);
+    f.torque += tmp;
+  }
+#endif
+  return in;
+}
+
+void add_force(ParticleForce const &src, ParticleForce &dst) {
+  dst.f += src.f;
+#ifdef ROTATION
+  if (ghosts_have_rotation)
+    dst.torque += src.torque;
+#endif
+}
+} // namespace
+
+/** Release the persistent request of a communication, if any. */
+static void free_request(GhostCommunication &gcn) {
+  if (gcn.request != MPI_REQUEST_NULL)
+    MPI_Request_free(&gcn.request);
+  gcn.buffer.clear();
+}
+
 void prepare_comm(GhostCommunicator *comm, int data_parts, int num) {
   assert(comm);
   comm->data_parts = data_parts;
@@ -71,7 +267,10 @@ void prepare_comm(GhostCommunicator *comm, int data_parts, int num) {
                       comm->data_parts));
 
   comm->num = num;
+  for (auto &gcn : comm->comm)
+    free_request(gcn);
   comm->comm.resize(num);
+  comm->rounds.clear();
   for (int i = 0; i < num; i++) {
     comm->comm[i].shift[0] = comm->comm[i].shift[1] = comm->comm[i].shift[2] =
         0.0;
@@ -84,8 +283,10 @@ void free_comm(GhostCommunicator *comm) {
   int n;
   GHOST_TRACE(fprintf(stderr, "%d: free_comm: %p has %d ghost communications\n",
                       this_node, (void *)comm, comm->num));
-  for (n = 0; n < comm->num; n++)
+  for (n = 0; n < comm->num; n++) {
     free(comm->comm[n].part_lists);
+    free_request(comm->comm[n]);
+  }
 }
 
 int calc_transmit_size(GhostCommunication *gc, int data_parts) {
@@ -110,11 +311,11 @@ int calc_transmit_size(GhostCommunication *gc, int data_parts) {
       }
     }
     if (data_parts & GHOSTTRANS_POSITION)
-      n_buffer_new += sizeof(ParticlePosition);
+      n_buffer_new += position_size();
     if (data_parts & GHOSTTRANS_MOMENTUM)
-      n_buffer_new += sizeof(ParticleMomentum);
+      n_buffer_new += momentum_size();
     if (data_parts & GHOSTTRANS_FORCE)
-      n_buffer_new += sizeof(ParticleForce);
+      n_buffer_new += force_size();
 
 #ifdef ENGINE
     if (data_parts & GHOSTTRANS_SWIMMING)
@@ -128,22 +329,16 @@ int calc_transmit_size(GhostCommunication *gc, int data_parts) {
   return n_buffer_new;
 }
 
-void prepare_send_buffer(GhostCommunication *gc, int data_parts) {
-  GHOST_TRACE(fprintf(stderr, "%d: prepare sending to/bcast from %d\n",
-                      this_node, gc->node));
-
-  /* reallocate send buffer */
-  n_s_buffer = calc_transmit_size(gc, data_parts);
-  if (n_s_buffer > max_s_buffer) {
-    max_s_buffer = n_s_buffer;
-    s_buffer = Utils::realloc(s_buffer, max_s_buffer);
-  }
-  GHOST_TRACE(fprintf(stderr, "%d: will send %d\n", this_node, n_s_buffer));
-
+/** Pack the data of the particles of a communication into a buffer
+ *  of size \ref calc_transmit_size. The bonds go to \ref s_bondbuffer.
+ */
+static void fill_send_buffer(GhostCommunication *gc, int data_parts,
+                             char *buffer, int size) {
   s_bondbuffer.resize(0);
+  auto const shift = Utils::Vector3d{gc->shift[0], gc->shift[1], gc->shift[2]};
 
   /* put in data */
-  char *insert = s_buffer;
+  char *insert = buffer;
   for (int pl = 0; pl < gc->n_part_lists; pl++) {
     int np = gc->part_lists[pl]->n;
     if (data_parts & GHOSTTRANS_PARTNUM) {
@@ -176,24 +371,15 @@ void prepare_send_buffer(GhostCommunication *gc, int data_parts) {
           }
         }
         if (data_parts & GHOSTTRANS_POSSHFTD) {
-          /* ok, this is not nice, but perhaps fast */
-          auto *pp = reinterpret_cast<ParticlePosition *>(insert);
-          int i;
-          *pp = pt->r;
-          for (i = 0; i < 3; i++)
-            pp->p[i] += gc->shift[i];
-          insert += sizeof(ParticlePosition);
+          insert = pack_position(insert, pt->r, pt->r.p + shift);
         } else if (data_parts & GHOSTTRANS_POSITION) {
-          memcpy(insert, &pt->r, sizeof(ParticlePosition));
-          insert += sizeof(ParticlePosition);
+          insert = pack_position(insert, pt->r, pt->r.p);
         }
         if (data_parts & GHOSTTRANS_MOMENTUM) {
-          memcpy(insert, &pt->m, sizeof(ParticleMomentum));
-          insert += sizeof(ParticleMomentum);
+          insert = pack_momentum(insert, pt->m);
         }
         if (data_parts & GHOSTTRANS_FORCE) {
-          memcpy(insert, &pt->f, sizeof(ParticleForce));
-          insert += sizeof(ParticleForce);
+          insert = pack_force(insert, pt->f);
         }
 
 #ifdef ENGINE
@@ -212,15 +398,30 @@ void prepare_send_buffer(GhostCommunication *gc, int data_parts) {
     insert += sizeof(int);
   }
 
-  if (insert - s_buffer != n_s_buffer) {
+  if (insert - buffer != size) {
     fprintf(stderr,
             "%d: INTERNAL ERROR: send buffer size %d "
             "differs from what I put in (%td)\n",
-            this_node, n_s_buffer, insert - s_buffer);
+            this_node, size, insert - buffer);
     errexit();
   }
 }
 
+void prepare_send_buffer(GhostCommunication *gc, int data_parts) {
+  GHOST_TRACE(fprintf(stderr, "%d: prepare sending to/bcast from %d\n",
+                      this_node, gc->node));
+
+  /* reallocate send buffer */
+  n_s_buffer = calc_transmit_size(gc, data_parts);
+  if (n_s_buffer > max_s_buffer) {
+    max_s_buffer = n_s_buffer;
+    s_buffer = Utils::realloc(s_buffer, max_s_buffer);
+  }
+  GHOST_TRACE(fprintf(stderr, "%d: will send %d\n", this_node, n_s_buffer));
+
+  fill_send_buffer(gc, data_parts, s_buffer, n_s_buffer);
+}
+
 static void prepare_ghost_cell(Cell *cell, int size) {
   if (ghosts_have_bonds) {
     // free all allocated information, will be resent
@@ -258,9 +459,10 @@ void prepare_recv_buffer(GhostCommunication *gc, int data_parts) {
   GHOST_TRACE(fprintf(stderr, "%d: will get %d\n", this_node, n_r_buffer));
 }
 
-void put_recv_buffer(GhostCommunication *gc, int data_parts) {
+void put_recv_buffer(GhostCommunication *gc, int data_parts,
+                     char const *buffer, int size) {
   /* put back data */
-  char *retrieve = r_buffer;
+  char const *retrieve = buffer;
 
   std::vector<int>::const_iterator bond_retrieve = r_bondbuffer.begin();
 
@@ -305,16 +507,13 @@ void put_recv_buffer(GhostCommunication *gc, int data_parts) {
           }
         }
         if (data_parts & GHOSTTRANS_POSITION) {
-          memcpy(&pt->r, retrieve, sizeof(ParticlePosition));
-          retrieve += sizeof(ParticlePosition);
+          retrieve = unpack_position(retrieve, pt->r);
         }
         if (data_parts & GHOSTTRANS_MOMENTUM) {
-          memcpy(&pt->m, retrieve, sizeof(ParticleMomentum));
-          retrieve += sizeof(ParticleMomentum);
+          retrieve = unpack_momentum(retrieve, pt->m);
         }
         if (data_parts & GHOSTTRANS_FORCE) {
-          memcpy(&pt->f, retrieve, sizeof(ParticleForce));
-          retrieve += sizeof(ParticleForce);
+          retrieve = unpack_force(retrieve, pt->f);
         }
 
 #ifdef ENGINE
@@ -332,11 +531,11 @@ void put_recv_buffer(GhostCommunication *gc, int data_parts) {
     retrieve += sizeof(int);
   }
 
-  if (retrieve - r_buffer != n_r_buffer) {
+  if (retrieve - buffer != size) {
     fprintf(stderr,
             "%d: recv buffer size %d differs "
             "from what I read out (%td)\n",
-            this_node, n_r_buffer, retrieve - r_buffer);
+            this_node, size, retrieve - buffer);
     errexit();
   }
   if (bond_retrieve != r_bondbuffer.end()) {
@@ -348,27 +547,27 @@ void put_recv_buffer(GhostCommunication *gc, int data_parts) {
   r_bondbuffer.resize(0);
 }
 
-void add_forces_from_recv_buffer(GhostCommunication *gc) {
+void add_forces_from_recv_buffer(GhostCommunication *gc, char const *buffer,
+                                 int size) {
   int pl, p;
   Particle *part, *pt;
-  char *retrieve;
+  char const *retrieve;
 
   /* put back data */
-  retrieve = r_buffer;
+  retrieve = buffer;
   for (pl = 0; pl < gc->n_part_lists; pl++) {
     int np = gc->part_lists[pl]->n;
     part = gc->part_lists[pl]->part;
     for (p = 0; p < np; p++) {
       pt = &part[p];
-      pt->f += *(reinterpret_cast<ParticleForce *>(retrieve));
-      retrieve += sizeof(ParticleForce);
+      retrieve = unpack_add_force(retrieve, pt->f);
     }
   }
-  if (retrieve - r_buffer != n_r_buffer) {
+  if (retrieve - buffer != size) {
     fprintf(stderr,
             "%d: recv buffer size %d differs "
             "from what I put in %td\n",
-            this_node, n_r_buffer, retrieve - r_buffer);
+            this_node, size, retrieve - buffer);
     errexit();
   }
 }
@@ -380,6 +579,8 @@ void cell_cell_transfer(GhostCommunication *gc, int data_parts) {
   GHOST_TRACE(fprintf(stderr, "%d: local_transfer: type %d data_parts %d\n",
                       this_node, gc->type, data_parts));
 
+  auto const shift = Utils::Vector3d{gc->shift[0], gc->shift[1], gc->shift[2]};
+
   /* transfer data */
   offset = gc->n_part_lists / 2;
   for (pl = 0; pl < offset; pl++) {
@@ -405,18 +606,14 @@ void cell_cell_transfer(GhostCommunication *gc, int data_parts) {
           }
         }
         if (data_parts & GHOSTTRANS_POSSHFTD) {
-          /* ok, this is not nice, but perhaps fast */
-          int i;
-          pt2->r = pt1->r;
-          for (i = 0; i < 3; i++)
-            pt2->r.p[i] += gc->shift[i];
+          copy_position(pt1->r, pt2->r, pt1->r.p + shift);
         } else if (data_parts & GHOSTTRANS_POSITION)
-          pt2->r = pt1->r;
+          copy_position(pt1->r, pt2->r, pt1->r.p);
         if (data_parts & GHOSTTRANS_MOMENTUM) {
-          pt2->m = pt1->m;
+          copy_momentum(pt1->m, pt2->m);
         }
         if (data_parts & GHOSTTRANS_FORCE)
-          pt2->f += pt1->f;
+          add_force(pt1->f, pt2->f);
 
 #ifdef ENGINE
         if (data_parts & GHOSTTRANS_SWIMMING)
@@ -427,21 +624,6 @@ void cell_cell_transfer(GhostCommunication *gc, int data_parts) {
   }
 }
 
-void reduce_forces_sum(void *add, void *to, int const *const len,
-                       MPI_Datatype *type) {
-  auto *cadd = static_cast<ParticleForce *>(add),
-       *cto = static_cast<ParticleForce *>(to);
-  int i, clen = *len / sizeof(ParticleForce);
-
-  if (*type != MPI_BYTE || (*len % sizeof(ParticleForce)) != 0) {
-    fprintf(stderr, "%d: transfer data type wrong\n", this_node);
-    errexit();
-  }
-
-  for (i = 0; i < clen; i++)
-    cto[i] += cadd[i];
-}
-
 static int is_send_op(int comm_type, int node) {
   return ((comm_type == GHOST_SEND) || (comm_type == GHOST_RDCE) ||
           (comm_type == GHOST_BCST && node == this_node));
@@ -453,6 +635,196 @@ static int is_recv_op(int comm_type, int node) {
           (comm_type == GHOST_RDCE && node == this_node));
 }
 
+/************************************************************/
+/* Non-blocking ghost communication */
+
+/** Whether a communication can be done with non-blocking calls:
+ *  only point-to-point and local transfers of data of fixed size.
+ */
+static bool is_nonblocking(GhostCommunicator const *gc, int data_parts) {
+  if (data_parts & (GHOSTTRANS_PARTNUM | GHOSTTRANS_PROPRTS))
+    return false;
+
+  return std::all_of(gc->comm.begin(), gc->comm.end(),
+                     [](GhostCommunication const &gcn) {
+                       auto const comm_type = gcn.type & GHOST_JOBMASK;
+                       return (comm_type == GHOST_SEND) ||
+                              (comm_type == GHOST_RECV) ||
+                              (comm_type == GHOST_LOCL);
+                     });
+}
+
+/** Split a communicator into rounds. A round ends before the first
+ *  communication that reads from a cell which is received in the
+ *  round, e.g. the ghost cells of one direction are sent on in the
+ *  next direction.
+ */
+static void init_rounds(GhostCommunicator *gc) {
+  std::unordered_set<Cell const *> received;
+
+  gc->rounds.clear();
+  for (int n = 0; n < gc->num; n++) {
+    auto const &gcn = gc->comm[n];
+    auto const comm_type = gcn.type & GHOST_JOBMASK;
+    auto const first = gcn.part_lists;
+    auto const last = gcn.part_lists + gcn.n_part_lists;
+
+    if (comm_type == GHOST_RECV) {
+      received.insert(first, last);
+    } else if (std::any_of(first, last, [&received](Cell const *c) {
+                 return received.count(c) != 0;
+               })) {
+      gc->rounds.push_back(n);
+      received.clear();
+    }
+  }
+  gc->rounds.push_back(gc->num);
+}
+
+namespace {
+/** The communication started by \ref ghost_communicator_begin. */
+struct PendingCommunication {
+  GhostCommunicator *gc = nullptr;
+  int data_parts = 0;
+  /** Current round */
+  int round = 0;
+  std::vector<MPI_Request> requests;
+};
+
+PendingCommunication pending;
+} // namespace
+
+/** Set up the persistent request of a send or receive for the
+ *  given data parts. The request and its buffer are reused as long as
+ *  the size of the transfer does not change, i.e. until the next
+ *  resort in the steady state.
+ */
+static void init_request(GhostCommunication *gcn, int data_parts) {
+  auto const size = calc_transmit_size(gcn, data_parts);
+
+  if ((gcn->request != MPI_REQUEST_NULL) &&
+      (gcn->request_data_parts == data_parts) &&
+      (static_cast<int>(gcn->buffer.size()) == size))
+    return;
+
+  free_request(*gcn);
+  gcn->buffer.resize(size);
+  gcn->request_data_parts = data_parts;
+
+  if ((gcn->type & GHOST_JOBMASK) == GHOST_SEND)
+    MPI_Send_init(gcn->buffer.data(), size, MPI_BYTE, gcn->node,
+                  REQ_GHOST_SEND, comm_cart, &gcn->request);
+  else
+    MPI_Recv_init(gcn->buffer.data(), size, MPI_BYTE, gcn->node,
+                  REQ_GHOST_SEND, comm_cart, &gcn->request);
+}
+
+/** Do the local transfers of the current round and start its
+ *  sends and receives. */
+static void start_round() {
+  auto *gc = pending.gc;
+  auto const first = (pending.round == 0) ? 0 : gc->rounds[pending.round - 1];
+  auto const last = gc->rounds[pending.round];
+
+  pending.requests.clear();
+
+  for (int n = first; n < last; n++) {
+    auto *gcn = &gc->comm[n];
+
+    switch (gcn->type & GHOST_JOBMASK) {
+    case GHOST_LOCL:
+      cell_cell_transfer(gcn, pending.data_parts);
+      break;
+    case GHOST_SEND:
+      init_request(gcn, pending.data_parts);
+      fill_send_buffer(gcn, pending.data_parts, gcn->buffer.data(),
+                       static_cast<int>(gcn->buffer.size()));
+      MPI_Start(&gcn->request);
+      pending.requests.push_back(gcn->request);
+      break;
+    case GHOST_RECV:
+      init_request(gcn, pending.data_parts);
+      MPI_Start(&gcn->request);
+      pending.requests.push_back(gcn->request);
+      break;
+    }
+  }
+}
+
+/** Wait for the sends and receives of the current round and
+ *  write back the received data. */
+static void finish_round() {
+  auto *gc = pending.gc;
+  auto const first = (pending.round == 0) ? 0 : gc->rounds[pending.round - 1];
+  auto const last = gc->rounds[pending.round];
+
+  MPI_Waitall(static_cast<int>(pending.requests.size()),
+              pending.requests.data(), MPI_STATUSES_IGNORE);
+
+  for (int n = first; n < last; n++) {
+    auto *gcn = &gc->comm[n];
+    if ((gcn->type & GHOST_JOBMASK) != GHOST_RECV)
+      continue;
+
+    auto const &buffer = gcn->buffer;
+    /* forces have to be added, the rest overwritten. */
+    if (pending.data_parts == GHOSTTRANS_FORCE)
+      add_forces_from_recv_buffer(gcn, buffer.data(),
+                                  static_cast<int>(buffer.size()));
+    else
+      put_recv_buffer(gcn, pending.data_parts, buffer.data(),
+                      static_cast<int>(buffer.size()));
+  }
+}
+
+static void ghost_communicator_start(GhostCommunicator *gc, int data_parts) {
+  assert(pending.gc == nullptr);
+
+  if (gc->rounds.empty())
+    init_rounds(gc);
+
+  pending.gc = gc;
+  pending.data_parts = data_parts;
+  pending.round = 0;
+
+  start_round();
+}
+
+void ghost_communicator_finish() {
+  if (pending.gc == nullptr)
+    return;
+
+  finish_round();
+  for (pending.round++;
+       pending.round < static_cast<int>(pending.gc->rounds.size());
+       pending.round++) {
+    start_round();
+    finish_round();
+  }
+
+  pending.gc = nullptr;
+}
+
+/** Add the momentum to the data parts if the ghosts need
+ *  velocities, see \ref ghosts_have_v. */
+static int ghost_data_parts(int data_parts) {
+  /* if ghosts should have uptodate velocities, they have to be updated like
+     positions (except for shifting...) */
+  if (ghosts_have_v && (data_parts & GHOSTTRANS_POSITION))
+    data_parts |= GHOSTTRANS_MOMENTUM;
+
+  return data_parts;
+}
+
+void ghost_communicator_begin(GhostCommunicator *gc) {
+  auto const data_parts = ghost_data_parts(gc->data_parts);
+
+  if (is_nonblocking(gc, data_parts))
+    ghost_communicator_start(gc, data_parts);
+  else
+    ghost_communicator(gc, data_parts);
+}
+
 void ghost_communicator(GhostCommunicator *gc) {
   ghost_communicator(gc, gc->data_parts);
 }
@@ -460,10 +832,13 @@ void ghost_communicator(GhostCommunicator *gc) {
 void ghost_communicator(GhostCommunicator *gc, int data_parts) {
   MPI_Status status;
   int n, n2;
-  /* if ghosts should have uptodate velocities, they have to be updated like
-     positions (except for shifting...) */
-  if (ghosts_have_v && (data_parts & GHOSTTRANS_POSITION))
-    data_parts |= GHOSTTRANS_MOMENTUM;
+  data_parts = ghost_data_parts(data_parts);
+
+  if (is_nonblocking(gc, data_parts)) {
+    ghost_communicator_start(gc, data_parts);
+    ghost_communicator_finish();
+    return;
+  }
 
   GHOST_TRACE(fprintf(stderr, "%d: ghost_comm %p, data_parts %d\n", this_node,
                       (void *)gc, data_parts));
@@ -623,9 +998,9 @@ void ghost_communicator(GhostCommunicator *gc, int data_parts) {
           /* forces have to be added, the rest overwritten. Exception is RDCE,
              where the addition is integrated into the communication. */
           if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
-            add_forces_from_recv_buffer(gcn);
+            add_forces_from_recv_buffer(gcn, r_buffer, n_r_buffer);
           else
-            put_recv_buffer(gcn, data_parts);
+            put_recv_buffer(gcn, data_parts, r_buffer, n_r_buffer);
         } else {
           GHOST_TRACE(fprintf(
               stderr, "%d: ghost_comm delaying operation %d, recv from %d\n",
@@ -657,9 +1032,9 @@ void ghost_communicator(GhostCommunicator *gc, int data_parts) {
 #endif
               /* as above */
               if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
-                add_forces_from_recv_buffer(gcn2);
+                add_forces_from_recv_buffer(gcn2, r_buffer, n_r_buffer);
               else
-                put_recv_buffer(gcn2, data_parts);
+                put_recv_buffer(gcn2, data_parts, r_buffer, n_r_buffer);
               break;
             }
           }
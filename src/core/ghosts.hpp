@@ -62,6 +62,10 @@ with GHOSTTRANS_POSITION. <li> GHOSTTRANS_MOMENTUM transfers the \ref
 ParticleMomentum <li> GHOSTTRANS_FORCE transfers the \ref ParticleForce <li>
 GHOSTTRANS_PARTNUM transfers the cell sizes
 </ul>
+Of the positions, momenta and forces only the parts are transferred that the
+ghosts need: the quaternions, angular velocities and torques only if any
+particle rotates or has an orientation (see \ref ghosts_check_rotation), the
+old positions only if there are rigid bonds.
 Each ghost communication describes a single communication of the local with
 another node (or all other nodes). The data transferred can be any number of
 cells, there are five communication types: <ul> <li> GHOST_SEND sends data to
@@ -98,6 +102,7 @@ further details.
 */
 #include "Cell.hpp"
 #include <mpi.h>
+#include <vector>
 
 /** \name Transfer types, for \ref GhostCommunicator::type */
 /************************************************************/
@@ -170,6 +175,14 @@ typedef struct {
      this is the shift vector. Normally this a integer multiple of the box
      length. The shift is done on the sender side */
   double shift[3];
+
+  /** Buffer of the non-blocking send or receive, kept between the
+   *  communications, see \ref ghost_communicator_begin. */
+  std::vector<char> buffer;
+  /** Persistent request on \ref buffer. */
+  MPI_Request request = MPI_REQUEST_NULL;
+  /** Data parts \ref request was set up for. */
+  int request_data_parts = 0;
 } GhostCommunication;
 
 /** Properties for a ghost communication. A ghost communication is defined */
@@ -184,6 +197,10 @@ typedef struct {
   /** List of ghost communications. */
   std::vector<GhostCommunication> comm;
 
+  /** End of the rounds of non-blocking communications, see
+   *  \ref ghost_communicator_begin. Filled on first use. */
+  std::vector<int> rounds;
+
 } GhostCommunicator;
 
 /*@}*/
@@ -209,10 +226,41 @@ void ghost_communicator(GhostCommunicator *gc);
  */
 void ghost_communicator(GhostCommunicator *gc, int data_parts);
 
+/**
+ * @brief Start a ghost communication with the data parts specified
+ *        in the communicator, without waiting for it to complete.
+ *
+ * Communicators that only transfer positions, momenta or forces
+ * between single nodes run with non-blocking MPI calls. They are
+ * split into rounds of communications that do not depend on each
+ * other, e.g. one round per direction for the domain decomposition.
+ * The first round is started here, the rest is done by
+ * \ref ghost_communicator_finish. Until then, the particles
+ * that take part in the communication must not be accessed.
+ * The sends and receives are persistent requests on buffers kept
+ * in the communications, which are set up again only if the
+ * amount of data changes. Other communicators are done completely.
+ *
+ * Only one communication can be in flight at a time.
+ */
+void ghost_communicator_begin(GhostCommunicator *gc);
+
+/**
+ * @brief Complete the communication started with
+ *        \ref ghost_communicator_begin, if any.
+ */
+void ghost_communicator_finish();
+
 /** Go through \ref ghost_cells and remove the ghost entries from \ref
     local_particles. Part of \ref dd_exchange_and_sort_particles.*/
 void invalidate_ghosts();
 
+/** Check whether any particle rotates or has an orientation, so that
+    the ghosts need quaternions, angular velocities and torques.
+    Otherwise these are not transferred. Has to be called on all nodes
+    before the ghosts are set up. */
+void ghosts_check_rotation();
+
 /*@}*/
 
 #endif
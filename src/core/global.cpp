@@ -169,7 +169,10 @@ const std::unordered_map<int, Datafield> fields{
       "n_thermalized_bonds"}}, /* 56 from thermalized_bond.cpp */
     {FIELD_FORCE_CAP, {&force_cap, Datafield::Type::DOUBLE, 1, "force_cap"}},
     {FIELD_THERMO_VIRTUAL,
-     {&thermo_virtual, Datafield::Type::BOOL, 1, "thermo_virtual"}}};
+     {&thermo_virtual, Datafield::Type::BOOL, 1, "thermo_virtual"}},
+    {FIELD_LONG_RANGE_INTERVAL,
+     {&long_range_interval, Datafield::Type::INT, 1,
+      "long_range_interval"}}}; /* from integrate.cpp */
 
 std::size_t hash_value(Datafield const &field) {
   using boost::hash_range;
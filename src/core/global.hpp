@@ -109,7 +109,9 @@ enum Fields {
   FIELD_THERMALIZEDBONDS,
   FIELD_FORCE_CAP,
   FIELD_THERMO_VIRTUAL,
-  FIELD_SWIMMING_PARTICLES_EXIST
+  FIELD_SWIMMING_PARTICLES_EXIST,
+  /** index of \ref long_range_interval */
+  FIELD_LONG_RANGE_INTERVAL
 };
 
 #endif
@@ -34,10 +34,12 @@
 #include <mpi.h>
 #include <utils/mpi/cart_comm.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <numeric>
 
 /**********************************************
  * variables
@@ -47,6 +49,7 @@ BoxGeometry box_geo;
 LocalBox<double> local_geo;
 
 Utils::Vector3i node_grid{};
+NodeDomainBounds node_domain_bounds;
 
 /************************************************************/
 
@@ -60,7 +63,15 @@ int map_position_node_array(const Utils::Vector3d &pos) {
 
   Utils::Vector3i im;
   for (int i = 0; i < 3; i++) {
-    im[i] = std::floor(f_pos[i] / local_geo.length()[i]);
+    if (node_domain_bounds.regular()) {
+      im[i] = std::floor(f_pos[i] / local_geo.length()[i]);
+    } else {
+      auto const &cuts = node_domain_bounds.cuts[i];
+      int const slab = std::floor(f_pos[i] / box_geo.length()[i] *
+                                  node_domain_bounds.n_cells[i]);
+      im[i] = std::upper_bound(cuts.begin(), cuts.end(), slab) - cuts.begin() -
+              1;
+    }
     im[i] = boost::algorithm::clamp(im[i], 0, node_grid[i] - 1);
   }
 
@@ -105,14 +116,79 @@ LocalBox<double> regular_decomposition(const BoxGeometry &box,
   return {my_left, local_length, boundaries};
 }
 
+LocalBox<double> balanced_decomposition(const BoxGeometry &box,
+                                        Utils::Vector3i const &node_pos,
+                                        NodeDomainBounds const &bounds) {
+  Utils::Vector3d local_length;
+  Utils::Vector3d my_left;
+  Utils::Array<int, 6> boundaries;
+
+  for (int dir = 0; dir < 3; dir++) {
+    auto const &cuts = bounds.cuts[dir];
+    auto const slab_length = box.length()[dir] / bounds.n_cells[dir];
+
+    my_left[dir] = cuts[node_pos[dir]] * slab_length;
+    local_length[dir] =
+        (cuts[node_pos[dir] + 1] - cuts[node_pos[dir]]) * slab_length;
+
+    boundaries[2 * dir] = (node_pos[dir] == 0);
+    boundaries[2 * dir + 1] = -(node_pos[dir] + 2 == int(cuts.size()));
+  }
+
+  return {my_left, local_length, boundaries};
+}
+
+std::vector<int> balanced_partition(std::vector<double> const &weights,
+                                    int n_parts) {
+  auto const n = static_cast<int>(weights.size());
+  assert(n >= n_parts);
+
+  std::vector<double> prefix(n + 1, 0.);
+  std::partial_sum(weights.begin(), weights.end(), prefix.begin() + 1);
+  auto const total = prefix.back();
+
+  std::vector<int> cuts(n_parts + 1);
+  cuts[0] = 0;
+  cuts[n_parts] = n;
+  for (int j = 1; j < n_parts; j++) {
+    int cut;
+    if (total > 0.) {
+      /* First element boundary with at least the target weight
+         below it, or the one before if that is closer. */
+      auto const target = j * total / n_parts;
+      cut = std::lower_bound(prefix.begin(), prefix.end(), target) -
+            prefix.begin();
+      if (cut > 0 && (target - prefix[cut - 1]) < (prefix[cut] - target))
+        cut--;
+    } else {
+      cut = (j * n) / n_parts;
+    }
+    /* Leave at least one element for this and all the remaining parts */
+    cuts[j] = boost::algorithm::clamp(cut, cuts[j - 1] + 1, n - (n_parts - j));
+  }
+
+  return cuts;
+}
+
 void grid_changed_box_l(const BoxGeometry &box) {
-  local_geo = regular_decomposition(box, calc_node_pos(comm_cart), node_grid);
+  auto const node_pos = calc_node_pos(comm_cart);
+  local_geo = node_domain_bounds.regular()
+                  ? regular_decomposition(box, node_pos, node_grid)
+                  : balanced_decomposition(box, node_pos, node_domain_bounds);
+}
+
+void grid_set_node_domain_bounds(NodeDomainBounds const &bounds) {
+  node_domain_bounds = bounds;
+  grid_changed_box_l(box_geo);
 }
 
 void grid_changed_n_nodes() {
   comm_cart =
       Utils::Mpi::cart_create(comm_cart, node_grid, /* reorder */ false);
 
+  /* The bounds refer to the old node grid */
+  node_domain_bounds = NodeDomainBounds{};
+
   this_node = comm_cart.rank();
 
   calc_node_neighbors(comm_cart);
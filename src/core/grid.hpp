@@ -40,8 +40,10 @@
 #include <utils/Vector.hpp>
 
 #include <boost/mpi/communicator.hpp>
+#include <array>
 #include <cassert>
 #include <limits>
+#include <vector>
 
 extern BoxGeometry box_geo;
 extern LocalBox<double> local_geo;
@@ -53,6 +55,24 @@ extern LocalBox<double> local_geo;
 /** The number of nodes in each spatial dimension. */
 extern Utils::Vector3i node_grid;
 
+/** @brief Boundaries of the node domains on a global cell lattice.
+ *
+ *  Along every axis i, the box is divided into n_cells[i] slabs
+ *  of equal width, and node j of the node grid in this direction
+ *  holds the slabs [cuts[i][j], cuts[i][j + 1]). If there are no
+ *  cuts, the box is divided into equal parts for each node.
+ */
+struct NodeDomainBounds {
+  Utils::Vector3i n_cells = {0, 0, 0};
+  std::array<std::vector<int>, 3> cuts;
+
+  /** Whether this is the regular decomposition. */
+  bool regular() const { return cuts[0].empty(); }
+};
+
+/** Boundaries of the node domains, see \ref grid_set_node_domain_bounds. */
+extern NodeDomainBounds node_domain_bounds;
+
 /*@}*/
 
 /** \name Exported Functions */
@@ -88,6 +108,16 @@ void grid_changed_n_nodes();
 /** called from \ref mpi_bcast_parameter . */
 void grid_changed_box_l(const BoxGeometry &box);
 
+/** @brief Set the boundaries of the node domains and update
+ *  \ref local_geo accordingly.
+ *
+ *  This has to be called on all nodes with the same argument.
+ *  An empty argument restores the regular decomposition.
+ *
+ *  @param bounds New boundaries of the node domains.
+ */
+void grid_set_node_domain_bounds(NodeDomainBounds const &bounds);
+
 /** rescales the box in dimension 'dir' to the new value 'd_new', and rescales
  * the particles accordingly */
 void rescale_boxl(int dir, double d_new);
@@ -188,5 +218,34 @@ inline Utils::Vector3d unfolded_position(const Utils::Vector3d &pos,
 LocalBox<double> regular_decomposition(const BoxGeometry &box,
                                        Utils::Vector3i const &node_pos,
                                        Utils::Vector3i const &node_grid);
+
+/**
+ * @brief Composition of the simulation box into parts of different size
+ *        along the axes, given by the bounds of the nodes on a lattice.
+ *
+ * @param box Geometry of the simulation box
+ * @param node_pos Position of node in the node grid
+ * @param bounds Boundaries of the node domains on the lattice
+ * @return Geometry for the node
+ */
+LocalBox<double> balanced_decomposition(const BoxGeometry &box,
+                                        Utils::Vector3i const &node_pos,
+                                        NodeDomainBounds const &bounds);
+
+/**
+ * @brief Split a sequence of weights into consecutive parts
+ *        of approximately equal weight.
+ *
+ * Every part gets at least one element, so there have to be
+ * at least as many weights as parts. If all weights are zero,
+ * the elements are split evenly.
+ *
+ * @param weights Non-negative weights of the elements.
+ * @param n_parts Number of parts.
+ * @return First element of every part, followed by the number
+ *         of elements.
+ */
+std::vector<int> balanced_partition(std::vector<double> const &weights,
+                                    int n_parts);
 /*@}*/
 #endif
@@ -38,6 +38,34 @@
 struct _Fieldtype fieldtype_double = {0, nullptr, nullptr, sizeof(double), 0,
                                       0, 0,       0,       nullptr};
 
+void halo_create_fieldtype(int count, int const *const lengths,
+                           int const *const disps, int extent,
+                           Fieldtype *const newtype) {
+  Fieldtype ntype = *newtype = (Fieldtype)Utils::malloc(sizeof(*ntype));
+
+  ntype->subtype = nullptr;
+  ntype->vflag = 0;
+
+  ntype->vblocks = 1;
+  ntype->vstride = 1;
+  ntype->vskip = 1;
+
+  ntype->extent = extent;
+
+  ntype->count = count;
+  ntype->lengths = nullptr;
+  ntype->disps = nullptr;
+  if (count > 0) {
+    ntype->lengths = (int *)Utils::malloc(count * 2 * sizeof(int));
+    ntype->disps = (int *)((char *)ntype->lengths + count * sizeof(int));
+
+    for (int i = 0; i < count; i++) {
+      ntype->disps[i] = disps[i];
+      ntype->lengths[i] = lengths[i];
+    }
+  }
+}
+
 void halo_create_field_vector(int vblocks, int vstride, int vskip,
                               Fieldtype oldtype, Fieldtype *const newtype) {
   int i;
@@ -290,79 +318,95 @@ void release_halo_communication(HaloCommunicator *const hc) {
   free(hc->halo_info);
 }
 
-void halo_communication(HaloCommunicator const *const hc, char *const base) {
+void halo_communication_start(HaloCommunicator const *const hc, int n,
+                              char *const base, MPI_Request *const requests) {
   int s_node, r_node;
 
   Fieldtype fieldtype;
   MPI_Datatype datatype;
-  MPI_Request request;
-  MPI_Status status;
 
-  HALO_TRACE(fprintf(stderr, "%d: halo_comm base=%p num=%d\n", this_node,
-                     static_cast<void *>(base), hc->num));
+  HALO_TRACE(fprintf(stderr, "%d: halo_comm round %d\n", this_node, n));
 
-  for (int n = 0; n < hc->num; n++) {
+  int comm_type = hc->halo_info[n].type;
+  char *s_buffer = (char *)base + hc->halo_info[n].s_offset;
+  char *r_buffer = (char *)base + hc->halo_info[n].r_offset;
 
-    HALO_TRACE(fprintf(stderr, "%d: halo_comm round %d\n", this_node, n));
+  requests[0] = requests[1] = MPI_REQUEST_NULL;
 
-    int comm_type = hc->halo_info[n].type;
-    char *s_buffer = (char *)base + hc->halo_info[n].s_offset;
-    char *r_buffer = (char *)base + hc->halo_info[n].r_offset;
+  switch (comm_type) {
 
-    switch (comm_type) {
+  case HALO_LOCL:
+    fieldtype = hc->halo_info[n].fieldtype;
+    halo_dtcopy(r_buffer, s_buffer, 1, fieldtype);
+    break;
 
-    case HALO_LOCL:
-      fieldtype = hc->halo_info[n].fieldtype;
-      halo_dtcopy(r_buffer, s_buffer, 1, fieldtype);
-      break;
+  case HALO_SENDRECV:
+    datatype = hc->halo_info[n].datatype;
+    s_node = hc->halo_info[n].source_node;
+    r_node = hc->halo_info[n].dest_node;
 
-    case HALO_SENDRECV:
-      datatype = hc->halo_info[n].datatype;
-      s_node = hc->halo_info[n].source_node;
-      r_node = hc->halo_info[n].dest_node;
+    HALO_TRACE(fprintf(stderr, "%d: halo_comm sendrecv %d to %d (%d) (%p)\n",
+                       this_node, s_node, r_node, REQ_HALO_SPREAD,
+                       (void *)&datatype));
 
-      HALO_TRACE(fprintf(stderr, "%d: halo_comm sendrecv %d to %d (%d) (%p)\n",
-                         this_node, s_node, r_node, REQ_HALO_SPREAD,
-                         (void *)&datatype));
+    MPI_Irecv(r_buffer, 1, datatype, s_node, REQ_HALO_SPREAD, comm_cart,
+              &requests[0]);
+    MPI_Isend(s_buffer, 1, datatype, r_node, REQ_HALO_SPREAD, comm_cart,
+              &requests[1]);
+    break;
 
-      MPI_Sendrecv(s_buffer, 1, datatype, r_node, REQ_HALO_SPREAD, r_buffer, 1,
-                   datatype, s_node, REQ_HALO_SPREAD, comm_cart, &status);
-      break;
+  case HALO_SEND:
+    datatype = hc->halo_info[n].datatype;
+    r_node = hc->halo_info[n].dest_node;
 
-    case HALO_SEND:
-      datatype = hc->halo_info[n].datatype;
-      fieldtype = hc->halo_info[n].fieldtype;
-      r_node = hc->halo_info[n].dest_node;
+    HALO_TRACE(
+        fprintf(stderr, "%d: halo_comm send to %d.\n", this_node, r_node));
 
-      HALO_TRACE(
-          fprintf(stderr, "%d: halo_comm send to %d.\n", this_node, r_node));
+    MPI_Isend(s_buffer, 1, datatype, r_node, REQ_HALO_SPREAD, comm_cart,
+              &requests[1]);
+    break;
 
-      MPI_Isend(s_buffer, 1, datatype, r_node, REQ_HALO_SPREAD, comm_cart,
-                &request);
-      halo_dtset(r_buffer, 0, fieldtype);
-      MPI_Wait(&request, &status);
-      break;
+  case HALO_RECV:
+    datatype = hc->halo_info[n].datatype;
+    s_node = hc->halo_info[n].source_node;
 
-    case HALO_RECV:
-      datatype = hc->halo_info[n].datatype;
-      s_node = hc->halo_info[n].source_node;
+    HALO_TRACE(
+        fprintf(stderr, "%d: halo_comm recv from %d.\n", this_node, s_node));
 
-      HALO_TRACE(
-          fprintf(stderr, "%d: halo_comm recv from %d.\n", this_node, s_node));
+    MPI_Irecv(r_buffer, 1, datatype, s_node, REQ_HALO_SPREAD, comm_cart,
+              &requests[0]);
+    break;
 
-      MPI_Irecv(r_buffer, 1, datatype, s_node, REQ_HALO_SPREAD, comm_cart,
-                &request);
-      MPI_Wait(&request, &status);
-      break;
+  case HALO_OPEN:
+    fieldtype = hc->halo_info[n].fieldtype;
 
-    case HALO_OPEN:
-      fieldtype = hc->halo_info[n].fieldtype;
+    HALO_TRACE(fprintf(stderr, "%d: halo_comm open boundaries\n", this_node));
+
+    /* \todo this does not work for the n_i - <n_i> */
+    halo_dtset(r_buffer, 0, fieldtype);
+    break;
+  }
+}
 
-      HALO_TRACE(fprintf(stderr, "%d: halo_comm open boundaries\n", this_node));
+void halo_communication_finish(HaloCommunicator const *const hc, int n,
+                               char *const base, MPI_Request *const requests) {
+  if (hc->halo_info[n].type == HALO_SEND) {
+    /* the halo of the sender is cleared while the message is in flight */
+    halo_dtset((char *)base + hc->halo_info[n].r_offset, 0,
+               hc->halo_info[n].fieldtype);
+  }
 
-      /* \todo this does not work for the n_i - <n_i> */
-      halo_dtset(r_buffer, 0, fieldtype);
-      break;
-    }
+  MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
+}
+
+void halo_communication(HaloCommunicator const *const hc, char *const base) {
+  MPI_Request requests[2];
+
+  HALO_TRACE(fprintf(stderr, "%d: halo_comm base=%p num=%d\n", this_node,
+                     static_cast<void *>(base), hc->num));
+
+  for (int n = 0; n < hc->num; n++) {
+    halo_communication_start(hc, n, base, requests);
+    halo_communication_finish(hc, n, base, requests);
   }
 }
@@ -99,6 +99,16 @@ typedef struct {
 
 } HaloCommunicator;
 
+/** Creates a fieldtype describing the data layout
+ *  @param count         number of subtypes
+ *  @param lengths       array of lengths of the subtypes
+ *  @param disps         array of displacements of the subtypes
+ *  @param extent        extent of the whole new fieldtype
+ *  @param[out] newtype  newly created fieldtype
+ */
+void halo_create_fieldtype(int count, int const *lengths, int const *disps,
+                           int extent, Fieldtype *newtype);
+
 /** Creates a field vector layout
  *  @param vblocks       number of vector blocks
  *  @param vstride       size of strides in field vector
@@ -140,4 +150,28 @@ void release_halo_communication(HaloCommunicator *hc);
  */
 void halo_communication(HaloCommunicator const *hc, char *base);
 
+/** Start one round of the communication described by the halo
+ *  communicator without waiting for the messages. Local copies are done
+ *  right away. The send and receive buffers must not be touched until
+ *  \ref halo_communication_finish has been called for the round.
+ *  @param[in]  hc        halo communicator describing the parallelization
+ *                        scheme
+ *  @param[in]  n         index of the round
+ *  @param[in]  base      base plane of local node
+ *  @param[out] requests  the two requests of the round
+ */
+void halo_communication_start(HaloCommunicator const *hc, int n, char *base,
+                              MPI_Request *requests);
+
+/** Complete one round of the communication started with
+ *  \ref halo_communication_start.
+ *  @param[in]     hc        halo communicator describing the
+ *                           parallelization scheme
+ *  @param[in]     n         index of the round
+ *  @param[in]     base      base plane of local node
+ *  @param[in,out] requests  the two requests of the round
+ */
+void halo_communication_finish(HaloCommunicator const *hc, int n, char *base,
+                               MPI_Request *requests);
+
 #endif /* HALO_H */
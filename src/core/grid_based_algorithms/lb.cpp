@@ -56,11 +56,15 @@ using Utils::get_linear_index;
 #include <mpi.h>
 #include <profiler/profiler.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cinttypes>
 #include <cstdio>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <numeric>
+#include <vector>
 
 namespace {
 /** Basis of the mode space as described in [Duenweg, Schiller, Ladd] */
@@ -141,7 +145,9 @@ LB_Parameters lbpar = {
     // phi
     {},
     // Thermal energy
-    0.0};
+    0.0,
+    // in_place_streaming
+    false};
 
 /** The underlying lattice structure */
 Lattice lblattice;
@@ -157,12 +163,28 @@ static LB_FluidData lbfluid_b;
 LB_Fluid lbfluid;
 LB_Fluid lbfluid_post;
 
+/** Whether the populations are in the intermediate layout of the in-place
+ *  scheme, i.e. after an even step every node holds its post-collision
+ *  populations in the slots of the reversed velocities.
+ */
+static bool lbfluid_reversed = false;
+
 /** Pointer to the hydrodynamic fields of the fluid nodes */
 std::vector<LB_FluidNode> lbfields;
 
 /** Communicator for halo exchange between processors */
 HaloCommunicator update_halo_comm = {0, nullptr};
 
+/** Communicator sending the populations streamed into the halo to the
+ *  nodes they belong to (push scheme)
+ */
+static HaloCommunicator push_halo_comm = {0, nullptr};
+
+/** Layouts of the populations streaming along the axes in either
+ *  direction, which are sent by @ref push_halo_comm
+ */
+static std::array<Fieldtype, 6> push_fieldtypes = {};
+
 /** measures the MD time since the last fluid update */
 static double fluidstep = 0.0;
 
@@ -208,6 +230,7 @@ void lb_init() {
 }
 
 void lb_reinit_fluid() {
+  lbfluid_reversed = false;
   std::fill(lbfields.begin(), lbfields.end(), LB_FluidNode());
   /* default values for fields in lattice units */
   Utils::Vector3d momentum_density{};
@@ -285,268 +308,152 @@ void lb_reinit_parameters() {
   }
 }
 
-/* Halo communication for push scheme */
-static void halo_push_communication(LB_Fluid &lbfluid) {
-  Lattice::index_t index;
-  int x, y, z, count;
-  int rnode, snode;
-  double *buffer = nullptr, *sbuf = nullptr, *rbuf = nullptr;
-  MPI_Status status;
-
-  auto const yperiod = lblattice.halo_grid[0];
-  auto const zperiod = lblattice.halo_grid[0] * lblattice.halo_grid[1];
-
-  auto const node_neighbors = calc_node_neighbors(comm_cart);
-
-  /***************
-   * X direction *
-   ***************/
-  count = 5 * lblattice.halo_grid[1] * lblattice.halo_grid[2];
-  sbuf = (double *)Utils::malloc(count * sizeof(double));
-  rbuf = (double *)Utils::malloc(count * sizeof(double));
-
-  /* send to right, recv from left i = 1, 7, 9, 11, 13 */
-  snode = node_neighbors[1];
-  rnode = node_neighbors[0];
-
-  buffer = sbuf;
-  index = get_linear_index(lblattice.grid[0] + 1, 0, 0, lblattice.halo_grid);
-  for (z = 0; z < lblattice.halo_grid[2]; z++) {
-    for (y = 0; y < lblattice.halo_grid[1]; y++) {
-      buffer[0] = lbfluid[1][index];
-      buffer[1] = lbfluid[7][index];
-      buffer[2] = lbfluid[9][index];
-      buffer[3] = lbfluid[11][index];
-      buffer[4] = lbfluid[13][index];
-      buffer += 5;
-
-      index += yperiod;
-    }
-  }
-
-  MPI_Sendrecv(sbuf, count, MPI_DOUBLE, snode, REQ_HALO_SPREAD, rbuf, count,
-               MPI_DOUBLE, rnode, REQ_HALO_SPREAD, comm_cart, &status);
-
-  buffer = rbuf;
-  index = get_linear_index(1, 0, 0, lblattice.halo_grid);
-  for (z = 0; z < lblattice.halo_grid[2]; z++) {
-    for (y = 0; y < lblattice.halo_grid[1]; y++) {
-      lbfluid[1][index] = buffer[0];
-      lbfluid[7][index] = buffer[1];
-      lbfluid[9][index] = buffer[2];
-      lbfluid[11][index] = buffer[3];
-      lbfluid[13][index] = buffer[4];
-      buffer += 5;
-
-      index += yperiod;
-    }
-  }
-
-  /* send to left, recv from right i = 2, 8, 10, 12, 14 */
-  snode = node_neighbors[0];
-  rnode = node_neighbors[1];
-
-  buffer = sbuf;
-  index = get_linear_index(0, 0, 0, lblattice.halo_grid);
-  for (z = 0; z < lblattice.halo_grid[2]; z++) {
-    for (y = 0; y < lblattice.halo_grid[1]; y++) {
-      buffer[0] = lbfluid[2][index];
-      buffer[1] = lbfluid[8][index];
-      buffer[2] = lbfluid[10][index];
-      buffer[3] = lbfluid[12][index];
-      buffer[4] = lbfluid[14][index];
-      buffer += 5;
-
-      index += yperiod;
-    }
-  }
-
-  MPI_Sendrecv(sbuf, count, MPI_DOUBLE, snode, REQ_HALO_SPREAD, rbuf, count,
-               MPI_DOUBLE, rnode, REQ_HALO_SPREAD, comm_cart, &status);
-
-  buffer = rbuf;
-  index = get_linear_index(lblattice.grid[0], 0, 0, lblattice.halo_grid);
-  for (z = 0; z < lblattice.halo_grid[2]; z++) {
-    for (y = 0; y < lblattice.halo_grid[1]; y++) {
-      lbfluid[2][index] = buffer[0];
-      lbfluid[8][index] = buffer[1];
-      lbfluid[10][index] = buffer[2];
-      lbfluid[12][index] = buffer[3];
-      lbfluid[14][index] = buffer[4];
-      buffer += 5;
-
-      index += yperiod;
-    }
-  }
-
-  /***************
-   * Y direction *
-   ***************/
-  count = 5 * lblattice.halo_grid[0] * lblattice.halo_grid[2];
-  sbuf = Utils::realloc(sbuf, count * sizeof(double));
-  rbuf = Utils::realloc(rbuf, count * sizeof(double));
-
-  /* send to right, recv from left i = 3, 7, 10, 15, 17 */
-  snode = node_neighbors[3];
-  rnode = node_neighbors[2];
-
-  buffer = sbuf;
-  index = get_linear_index(0, lblattice.grid[1] + 1, 0, lblattice.halo_grid);
-  for (z = 0; z < lblattice.halo_grid[2]; z++) {
-    for (x = 0; x < lblattice.halo_grid[0]; x++) {
-      buffer[0] = lbfluid[3][index];
-      buffer[1] = lbfluid[7][index];
-      buffer[2] = lbfluid[10][index];
-      buffer[3] = lbfluid[15][index];
-      buffer[4] = lbfluid[17][index];
-      buffer += 5;
-
-      ++index;
-    }
-    index += zperiod - lblattice.halo_grid[0];
-  }
+namespace {
+/** Index of the reversed velocity of each velocity */
+constexpr const std::array<int, 19> reverse = {
+    {0, 2, 1, 4, 3, 6, 5, 8, 7, 10, 9, 12, 11, 14, 13, 16, 15, 18, 17}};
 
-  MPI_Sendrecv(sbuf, count, MPI_DOUBLE, snode, REQ_HALO_SPREAD, rbuf, count,
-               MPI_DOUBLE, rnode, REQ_HALO_SPREAD, comm_cart, &status);
-
-  buffer = rbuf;
-  index = get_linear_index(0, 1, 0, lblattice.halo_grid);
-  for (z = 0; z < lblattice.halo_grid[2]; z++) {
-    for (x = 0; x < lblattice.halo_grid[0]; x++) {
-      lbfluid[3][index] = buffer[0];
-      lbfluid[7][index] = buffer[1];
-      lbfluid[10][index] = buffer[2];
-      lbfluid[15][index] = buffer[3];
-      lbfluid[17][index] = buffer[4];
-      buffer += 5;
-
-      ++index;
-    }
-    index += zperiod - lblattice.halo_grid[0];
+/** Offsets of the linear indices of the neighbors along the velocities. */
+std::array<Lattice::index_t, 19> lb_neighbor_offsets() {
+  std::array<Lattice::index_t, 19> offsets;
+  for (int i = 0; i < 19; i++) {
+    offsets[i] = static_cast<Lattice::index_t>(
+        D3Q19::c[i][0] +
+        lblattice.halo_grid[0] *
+            (D3Q19::c[i][1] + lblattice.halo_grid[1] * D3Q19::c[i][2]));
   }
+  return offsets;
+}
 
-  /* send to left, recv from right i = 4, 8, 9, 16, 18 */
-  snode = node_neighbors[2];
-  rnode = node_neighbors[3];
-
-  buffer = sbuf;
-  index = get_linear_index(0, 0, 0, lblattice.halo_grid);
-  for (z = 0; z < lblattice.halo_grid[2]; z++) {
-    for (x = 0; x < lblattice.halo_grid[0]; x++) {
-      buffer[0] = lbfluid[4][index];
-      buffer[1] = lbfluid[8][index];
-      buffer[2] = lbfluid[9][index];
-      buffer[3] = lbfluid[16][index];
-      buffer[4] = lbfluid[18][index];
-      buffer += 5;
-
-      ++index;
-    }
-    index += zperiod - lblattice.halo_grid[0];
+/** Pre-collision populations of a node (without the equilibrium density).
+ *  In the intermediate layout of the in-place scheme, population i of a
+ *  node is still stored in the reversed slot of the neighbor it streams in
+ *  from. For the outermost halo nodes, the populations streaming in from
+ *  beyond the halo are kept in the node's own slots instead, see
+ *  @ref halo_reversed_communication.
+ *  @param index    linear index of the node
+ *  @param offsets  the result of @ref lb_neighbor_offsets, which sweeps
+ *                  over many nodes compute once
+ */
+std::array<double, 19>
+lb_node_populations(Lattice::index_t index,
+                    std::array<Lattice::index_t, 19> const &offsets) {
+  std::array<double, 19> populations;
+  if (not lbfluid_reversed) {
+    for (int i = 0; i < 19; i++)
+      populations[i] = lbfluid[i][index];
+    return populations;
   }
 
-  MPI_Sendrecv(sbuf, count, MPI_DOUBLE, snode, REQ_HALO_SPREAD, rbuf, count,
-               MPI_DOUBLE, rnode, REQ_HALO_SPREAD, comm_cart, &status);
-
-  buffer = rbuf;
-  index = get_linear_index(0, lblattice.grid[1], 0, lblattice.halo_grid);
-  for (z = 0; z < lblattice.halo_grid[2]; z++) {
-    for (x = 0; x < lblattice.halo_grid[0]; x++) {
-      lbfluid[4][index] = buffer[0];
-      lbfluid[8][index] = buffer[1];
-      lbfluid[9][index] = buffer[2];
-      lbfluid[16][index] = buffer[3];
-      lbfluid[18][index] = buffer[4];
-      buffer += 5;
-
-      ++index;
+  auto const &halo_grid = lblattice.halo_grid;
+  auto const pos = Utils::Vector3i{index % halo_grid[0],
+                                   (index / halo_grid[0]) % halo_grid[1],
+                                   index / (halo_grid[0] * halo_grid[1])};
+  for (int i = 0; i < 19; i++) {
+    bool source_inside = true;
+    for (int d = 0; d < 3; d++) {
+      auto const source = pos[d] - static_cast<int>(D3Q19::c[i][d]);
+      source_inside &= (source >= 0) and (source < halo_grid[d]);
     }
-    index += zperiod - lblattice.halo_grid[0];
+    populations[i] = source_inside ? lbfluid[reverse[i]][index - offsets[i]]
+                                   : lbfluid[i][index];
   }
+  return populations;
+}
 
-  /***************
-   * Z direction *
-   ***************/
-  count = 5 * lblattice.halo_grid[0] * lblattice.halo_grid[1];
-  sbuf = Utils::realloc(sbuf, count * sizeof(double));
-  rbuf = Utils::realloc(rbuf, count * sizeof(double));
-
-  /* send to right, recv from left i = 5, 11, 14, 15, 18 */
-  snode = node_neighbors[5];
-  rnode = node_neighbors[4];
-
-  buffer = sbuf;
-  index = get_linear_index(0, 0, lblattice.grid[2] + 1, lblattice.halo_grid);
-  for (y = 0; y < lblattice.halo_grid[1]; y++) {
-    for (x = 0; x < lblattice.halo_grid[0]; x++) {
-      buffer[0] = lbfluid[5][index];
-      buffer[1] = lbfluid[11][index];
-      buffer[2] = lbfluid[14][index];
-      buffer[3] = lbfluid[15][index];
-      buffer[4] = lbfluid[18][index];
-      buffer += 5;
-
-      ++index;
-    }
-  }
+/** Pre-collision populations of a single node, see above. */
+std::array<double, 19> lb_node_populations(Lattice::index_t index) {
+  if (not lbfluid_reversed)
+    return lb_node_populations(index, {});
+  return lb_node_populations(index, lb_neighbor_offsets());
+}
+} // namespace
 
-  MPI_Sendrecv(sbuf, count, MPI_DOUBLE, snode, REQ_HALO_SPREAD, rbuf, count,
-               MPI_DOUBLE, rnode, REQ_HALO_SPREAD, comm_cart, &status);
-
-  buffer = rbuf;
-  index = get_linear_index(0, 0, 1, lblattice.halo_grid);
-  for (y = 0; y < lblattice.halo_grid[1]; y++) {
-    for (x = 0; x < lblattice.halo_grid[0]; x++) {
-      lbfluid[5][index] = buffer[0];
-      lbfluid[11][index] = buffer[1];
-      lbfluid[14][index] = buffer[2];
-      lbfluid[15][index] = buffer[3];
-      lbfluid[18][index] = buffer[4];
-      buffer += 5;
-
-      ++index;
+/** Halo communication for the intermediate layout of the in-place scheme.
+ *  After @ref update_halo_comm, the populations of the outermost halo nodes
+ *  that stream in from beyond the halo are not available locally. They are
+ *  taken from the node owning the halo node, plane by plane in the same
+ *  order as the regular halo communication, so that the edges and corners
+ *  are filled from the previous directions.
+ */
+static void halo_reversed_communication() {
+  auto const &grid = lblattice.grid;
+  auto const &halo_grid = lblattice.halo_grid;
+  auto const offsets = lb_neighbor_offsets();
+
+  for (int n = 0; n < update_halo_comm.num; n++) {
+    auto const &hinfo = update_halo_comm.halo_info[n];
+    auto const dir = n / 2;
+    auto const lr = n % 2;
+    /* the two directions spanning the planes */
+    auto const dir1 = (dir + 1) % 3;
+    auto const dir2 = (dir + 2) % 3;
+
+    auto plane_pos = [&](int plane, int i1, int i2) {
+      Utils::Vector3i pos;
+      pos[dir] = plane;
+      pos[dir1] = i1;
+      pos[dir2] = i2;
+      return pos;
+    };
+
+    auto const s_plane = (lr == 0) ? 1 : grid[dir];
+    auto const r_plane = (lr == 0) ? grid[dir] + 1 : 0;
+    auto const count = D3Q19::n_vel * halo_grid[dir1] * halo_grid[dir2];
+    std::vector<double> s_buffer(count);
+    std::vector<double> r_buffer(count, 0.0);
+
+    if (hinfo.type != HALO_RECV and hinfo.type != HALO_OPEN) {
+      auto buffer = s_buffer.begin();
+      for (int i2 = 0; i2 < halo_grid[dir2]; i2++) {
+        for (int i1 = 0; i1 < halo_grid[dir1]; i1++) {
+          auto const populations = lb_node_populations(
+              get_linear_index(plane_pos(s_plane, i1, i2), halo_grid),
+              offsets);
+          buffer = std::copy(populations.begin(), populations.end(), buffer);
+        }
+      }
     }
-  }
 
-  /* send to left, recv from right i = 6, 12, 13, 16, 17 */
-  snode = node_neighbors[4];
-  rnode = node_neighbors[5];
-
-  buffer = sbuf;
-  index = get_linear_index(0, 0, 0, lblattice.halo_grid);
-  for (y = 0; y < lblattice.halo_grid[1]; y++) {
-    for (x = 0; x < lblattice.halo_grid[0]; x++) {
-      buffer[0] = lbfluid[6][index];
-      buffer[1] = lbfluid[12][index];
-      buffer[2] = lbfluid[13][index];
-      buffer[3] = lbfluid[16][index];
-      buffer[4] = lbfluid[17][index];
-      buffer += 5;
-
-      ++index;
+    switch (hinfo.type) {
+    case HALO_LOCL:
+      r_buffer = s_buffer;
+      break;
+    case HALO_SENDRECV:
+      MPI_Sendrecv(s_buffer.data(), count, MPI_DOUBLE, hinfo.dest_node,
+                   REQ_HALO_SPREAD, r_buffer.data(), count, MPI_DOUBLE,
+                   hinfo.source_node, REQ_HALO_SPREAD, comm_cart,
+                   MPI_STATUS_IGNORE);
+      break;
+    case HALO_SEND:
+      MPI_Send(s_buffer.data(), count, MPI_DOUBLE, hinfo.dest_node,
+               REQ_HALO_SPREAD, comm_cart);
+      break;
+    case HALO_RECV:
+      MPI_Recv(r_buffer.data(), count, MPI_DOUBLE, hinfo.source_node,
+               REQ_HALO_SPREAD, comm_cart, MPI_STATUS_IGNORE);
+      break;
     }
-  }
 
-  MPI_Sendrecv(sbuf, count, MPI_DOUBLE, snode, REQ_HALO_SPREAD, rbuf, count,
-               MPI_DOUBLE, rnode, REQ_HALO_SPREAD, comm_cart, &status);
-
-  buffer = rbuf;
-  index = get_linear_index(0, 0, lblattice.grid[2], lblattice.halo_grid);
-  for (y = 0; y < lblattice.halo_grid[1]; y++) {
-    for (x = 0; x < lblattice.halo_grid[0]; x++) {
-      lbfluid[6][index] = buffer[0];
-      lbfluid[12][index] = buffer[1];
-      lbfluid[13][index] = buffer[2];
-      lbfluid[16][index] = buffer[3];
-      lbfluid[17][index] = buffer[4];
-      buffer += 5;
-
-      ++index;
+    /* only the populations streaming in from beyond the halo are stored,
+     * the other slots hold post-collision populations of the neighbors */
+    auto buffer = r_buffer.begin();
+    for (int i2 = 0; i2 < halo_grid[dir2]; i2++) {
+      for (int i1 = 0; i1 < halo_grid[dir1]; i1++) {
+        auto const pos = plane_pos(r_plane, i1, i2);
+        auto const index = get_linear_index(pos, halo_grid);
+        for (int i = 0; i < D3Q19::n_vel; i++, ++buffer) {
+          for (int d = 0; d < 3; d++) {
+            auto const source = pos[d] - static_cast<int>(D3Q19::c[i][d]);
+            if (source < 0 or source >= halo_grid[d]) {
+              lbfluid[i][index] = *buffer;
+              break;
+            }
+          }
+        }
+      }
     }
   }
-
-  free(rbuf);
-  free(sbuf);
 }
 
 /***********************************************************************/
@@ -597,23 +504,163 @@ void lb_fluid_set_rng_state(uint64_t counter) {
 
 /***********************************************************************/
 
-/** (Re-)allocate memory for the fluid and initialize pointers. */
-void lb_realloc_fluid() {
-  LB_TRACE(printf("reallocating fluid\n"));
+/** (Re-)allocate the population arrays and initialize pointers.
+ *  The second array is only needed by the push scheme. The populations
+ *  in the first array are kept.
+ */
+static void lb_alloc_populations() {
   const std::array<int, 2> size = {{D3Q19::n_vel, lblattice.halo_grid_volume}};
 
   lbfluid_a.resize(size);
-  lbfluid_b.resize(size);
+  if (lbpar.in_place_streaming) {
+    lbfluid_b.resize(std::array<int, 2>{{0, 0}});
+  } else {
+    lbfluid_b.resize(size);
+  }
 
   using Utils::Span;
   for (int i = 0; i < size[0]; i++) {
     lbfluid[i] = Span<double>(lbfluid_a[i].origin(), size[1]);
-    lbfluid_post[i] = Span<double>(lbfluid_b[i].origin(), size[1]);
+    lbfluid_post[i] = lbpar.in_place_streaming
+                          ? Span<double>()
+                          : Span<double>(lbfluid_b[i].origin(), size[1]);
   }
+}
+
+/** (Re-)allocate memory for the fluid and initialize pointers. */
+void lb_realloc_fluid() {
+  LB_TRACE(printf("reallocating fluid\n"));
+
+  lbfluid_reversed = false;
+  lb_alloc_populations();
 
   lbfields.resize(lblattice.halo_grid_volume);
 }
 
+void lb_realloc_populations() {
+  lb_complete_streaming();
+
+  /* after an odd number of push steps the populations are in lbfluid_b */
+  if (lbfluid_b.num_elements() != 0 and
+      lbfluid[0].data() == lbfluid_b.data()) {
+    lbfluid_a = lbfluid_b;
+  }
+  lb_alloc_populations();
+}
+
+void lb_complete_streaming() {
+  if (not lbfluid_reversed)
+    return;
+
+  /* Each post-collision population is swapped with the one stored in the
+   * reversed slot of its target node, which in turn streams back to the
+   * node. The pairs are disjoint, so this is an in-place streaming. */
+  auto const &halo_grid = lblattice.halo_grid;
+  auto const offsets = lb_neighbor_offsets();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int z = 0; z < halo_grid[2]; z++) {
+    for (int y = 0; y < halo_grid[1]; y++) {
+      for (int x = 0; x < halo_grid[0]; x++) {
+        auto const index = get_linear_index(x, y, z, halo_grid);
+        for (int i = 1; i < D3Q19::n_vel; i += 2) {
+          auto const target = Utils::Vector3i{x, y, z} +
+                              Utils::Vector3i{static_cast<int>(D3Q19::c[i][0]),
+                                              static_cast<int>(D3Q19::c[i][1]),
+                                              static_cast<int>(D3Q19::c[i][2])};
+          if (target[0] >= 0 and target[0] < halo_grid[0] and
+              target[1] >= 0 and target[1] < halo_grid[1] and
+              target[2] >= 0 and target[2] < halo_grid[2]) {
+            std::swap(lbfluid[reverse[i]][index],
+                      lbfluid[i][index + offsets[i]]);
+          }
+        }
+      }
+    }
+  }
+  lbfluid_reversed = false;
+
+  halo_communication(&update_halo_comm,
+                     reinterpret_cast<char *>(lbfluid[0].data()));
+}
+
+/** Prepare @ref push_halo_comm from the communication of a single
+ *  velocity. In round n = 2 * dir + lr, the populations pushed into the
+ *  left (lr = 0) or right (lr = 1) halo plane along dir are sent to the
+ *  neighbor and stored in its outermost local plane. The directions are
+ *  done one after the other, which forwards the populations that leave
+ *  through an edge of the local domain. Like the regular halo, the
+ *  populations are always exchanged periodically.
+ *  @param comm  halo communicator for a single velocity
+ */
+static void lb_prepare_push_communication(HaloCommunicator const &comm) {
+  for (int n = 0; n < push_halo_comm.num; n++) {
+    halo_free_fieldtype(&push_halo_comm.halo_info[n].fieldtype);
+  }
+  release_halo_communication(&push_halo_comm);
+  push_halo_comm = {0, nullptr};
+  for (auto &fieldtype : push_fieldtypes) {
+    if (fieldtype)
+      halo_free_fieldtype(&fieldtype);
+  }
+
+  push_halo_comm.num = comm.num;
+  push_halo_comm.halo_info =
+      Utils::realloc(push_halo_comm.halo_info, comm.num * sizeof(HaloInfo));
+
+  MPI_Aint lower;
+  MPI_Aint extent;
+  MPI_Type_get_extent(MPI_DOUBLE, &lower, &extent);
+
+  for (int n = 0; n < comm.num; n++) {
+    auto const dir = n / 2;
+    auto const lr = n % 2;
+    HaloInfo *hinfo = &(push_halo_comm.halo_info[n]);
+
+    /* the populations leaving through the halo plane */
+    std::vector<int> lengths, disps;
+    std::vector<MPI_Aint> mpi_disps;
+    for (int i = 0; i < D3Q19::n_vel; i++) {
+      if (D3Q19::c[i][dir] == (lr == 0 ? -1 : 1)) {
+        lengths.push_back(sizeof(double));
+        disps.push_back(i * lblattice.halo_grid_volume * sizeof(double));
+        mpi_disps.push_back(i * lblattice.halo_grid_volume * extent);
+      }
+    }
+    auto const count = static_cast<int>(disps.size());
+
+    halo_create_fieldtype(count, lengths.data(), disps.data(), sizeof(double),
+                          &push_fieldtypes[n]);
+    auto const &plane = *comm.halo_info[n].fieldtype;
+    halo_create_field_vector(plane.vblocks, plane.vstride, plane.vskip,
+                             push_fieldtypes[n], &hinfo->fieldtype);
+
+    std::vector<int> const blocklengths(count, 1);
+    MPI_Type_create_hindexed(count, blocklengths.data(), mpi_disps.data(),
+                             comm.halo_info[n].datatype, &hinfo->datatype);
+    MPI_Type_commit(&hinfo->datatype);
+
+    /* from the halo plane to the outermost local plane */
+    auto const stride = static_cast<unsigned long>(
+        std::accumulate(lblattice.halo_grid.begin(),
+                        lblattice.halo_grid.begin() + dir, 1,
+                        std::multiplies<int>()) *
+        sizeof(double));
+    if (lr == 0) {
+      hinfo->s_offset = 0;
+      hinfo->r_offset = stride * lblattice.grid[dir];
+    } else {
+      hinfo->s_offset = stride * (lblattice.grid[dir] + 1);
+      hinfo->r_offset = stride;
+    }
+
+    hinfo->source_node = comm.halo_info[n].source_node;
+    hinfo->dest_node = comm.halo_info[n].dest_node;
+    hinfo->type = (node_grid[dir] == 1) ? HALO_LOCL : HALO_SENDRECV;
+  }
+}
+
 /** Set up the structures for exchange of the halo regions.
  *  See also \ref halo.cpp
  */
@@ -664,6 +711,8 @@ void lb_prepare_communication() {
                               comm.halo_info[i].fieldtype, &hinfo->fieldtype);
   }
 
+  lb_prepare_push_communication(comm);
+
   release_halo_communication(&comm);
 }
 
@@ -759,17 +808,112 @@ void lb_set_population_from_density_momentum_density_stress(
 }
 /*@}*/
 
-#include <boost/range/numeric.hpp>
-
 /** Calculation of hydrodynamic modes */
 std::array<double, 19> lb_calc_modes(Lattice::index_t index) {
   return Utils::matrix_vector_product<double, 19, e_ki>(
-      LB_Fluid_Ref(index, lbfluid));
+      lb_node_populations(index));
 }
 
-template <typename T>
-inline std::array<T, 19> lb_relax_modes(Lattice::index_t index,
-                                        const std::array<T, 19> &modes) {
+Utils::Vector19d lb_get_population(Lattice::index_t index) {
+  auto const populations = lb_node_populations(index);
+  Utils::Vector19d pop{};
+  for (int i = 0; i < D3Q19::n_vel; ++i) {
+    pop[i] = populations[i] + D3Q19::coefficients[i][0] * lbpar.density;
+  }
+  return pop;
+}
+
+namespace {
+/** Number of consecutive nodes of a row that are collided together. */
+constexpr std::size_t lb_block_size = 8;
+
+/** @brief Values of consecutive lattice nodes.
+ *
+ *  The arithmetic operators work node by node, with the same operations
+ *  as for a single double. A kernel instantiated with blocks therefore
+ *  gives bitwise the same results as for single nodes, while the loops
+ *  over the nodes of a block are vectorized by the compiler.
+ */
+template <std::size_t N> struct NodeBlock {
+  std::array<double, N> v = {};
+
+  double &operator[](std::size_t k) { return v[k]; }
+  double const &operator[](std::size_t k) const { return v[k]; }
+};
+
+template <std::size_t N, typename Op>
+NodeBlock<N> nodewise(NodeBlock<N> const &a, NodeBlock<N> const &b, Op op) {
+  NodeBlock<N> ret;
+  for (std::size_t k = 0; k < N; k++)
+    ret[k] = op(a[k], b[k]);
+  return ret;
+}
+
+template <std::size_t N, typename Op>
+NodeBlock<N> nodewise(double a, NodeBlock<N> const &b, Op op) {
+  NodeBlock<N> ret;
+  for (std::size_t k = 0; k < N; k++)
+    ret[k] = op(a, b[k]);
+  return ret;
+}
+
+template <std::size_t N, typename Op>
+NodeBlock<N> nodewise(NodeBlock<N> const &a, double b, Op op) {
+  NodeBlock<N> ret;
+  for (std::size_t k = 0; k < N; k++)
+    ret[k] = op(a[k], b);
+  return ret;
+}
+
+template <std::size_t N>
+NodeBlock<N> operator+(NodeBlock<N> const &a, NodeBlock<N> const &b) {
+  return nodewise(a, b, std::plus<double>());
+}
+template <std::size_t N>
+NodeBlock<N> operator+(NodeBlock<N> const &a, double b) {
+  return nodewise(a, b, std::plus<double>());
+}
+template <std::size_t N>
+NodeBlock<N> operator-(NodeBlock<N> const &a, NodeBlock<N> const &b) {
+  return nodewise(a, b, std::minus<double>());
+}
+template <std::size_t N>
+NodeBlock<N> operator*(NodeBlock<N> const &a, NodeBlock<N> const &b) {
+  return nodewise(a, b, std::multiplies<double>());
+}
+template <std::size_t N>
+NodeBlock<N> operator*(double a, NodeBlock<N> const &b) {
+  return nodewise(a, b, std::multiplies<double>());
+}
+template <std::size_t N>
+NodeBlock<N> operator*(NodeBlock<N> const &a, double b) {
+  return nodewise(a, b, std::multiplies<double>());
+}
+template <std::size_t N>
+NodeBlock<N> operator/(NodeBlock<N> const &a, NodeBlock<N> const &b) {
+  return nodewise(a, b, std::divides<double>());
+}
+template <std::size_t N>
+NodeBlock<N> operator/(NodeBlock<N> const &a, double b) {
+  return nodewise(a, b, std::divides<double>());
+}
+
+void store_population(Utils::Span<double> &population, Lattice::index_t index,
+                      double value) {
+  population[index] = value;
+}
+
+template <std::size_t N>
+void store_population(Utils::Span<double> &population, Lattice::index_t index,
+                      NodeBlock<N> const &value) {
+  for (std::size_t k = 0; k < N; k++)
+    population[index + k] = value[k];
+}
+} // namespace
+
+template <typename T, typename Force>
+inline std::array<T, 19> lb_relax_modes(const std::array<T, 19> &modes,
+                                        const Force &force_density) {
   T density, momentum_density[3], stress_eq[6];
 
   /* re-construct the real density
@@ -777,10 +921,9 @@ inline std::array<T, 19> lb_relax_modes(Lattice::index_t index,
    * equilibrium value */
   density = modes[0] + lbpar.density;
 
-  momentum_density[0] = modes[1] + 0.5 * lbfields[index].force_density[0];
-  momentum_density[1] = modes[2] + 0.5 * lbfields[index].force_density[1];
-  momentum_density[2] = modes[3] + 0.5 * lbfields[index].force_density[2];
-
+  momentum_density[0] = modes[1] + 0.5 * force_density[0];
+  momentum_density[1] = modes[2] + 0.5 * force_density[1];
+  momentum_density[2] = modes[3] + 0.5 * force_density[2];
   using Utils::sqr;
   auto const momentum_density2 = sqr(momentum_density[0]) +
                                  sqr(momentum_density[1]) +
@@ -857,25 +1000,24 @@ inline std::array<T, 19> lb_thermalize_modes(Lattice::index_t index,
   return modes;
 }
 
-template <typename T>
-std::array<T, 19> lb_apply_forces(Lattice::index_t index,
-                                  const std::array<T, 19> &modes) {
-  const auto &f = lbfields[index].force_density;
-
+template <typename T, typename Force>
+std::array<T, 19> lb_apply_forces(const std::array<T, 19> &modes,
+                                  const Force &f) {
   auto const density = modes[0] + lbpar.density;
 
   /* hydrodynamic momentum density is redefined when external forces present */
-  auto const u = Utils::Vector3d{modes[1] + 0.5 * f[0], modes[2] + 0.5 * f[1],
-                                 modes[3] + 0.5 * f[2]} /
-                 density;
+  T const u[3] = {(modes[1] + 0.5 * f[0]) / density,
+                  (modes[2] + 0.5 * f[1]) / density,
+                  (modes[3] + 0.5 * f[2]) / density};
+  auto const u_f = T{} + u[0] * f[0] + u[1] * f[1] + u[2] * f[2];
 
-  double C[6];
+  T C[6];
   C[0] = (1. + lbpar.gamma_bulk) * u[0] * f[0] +
-         1. / 3. * (lbpar.gamma_bulk - lbpar.gamma_shear) * (u * f);
+         1. / 3. * (lbpar.gamma_bulk - lbpar.gamma_shear) * u_f;
   C[2] = (1. + lbpar.gamma_bulk) * u[1] * f[1] +
-         1. / 3. * (lbpar.gamma_bulk - lbpar.gamma_shear) * (u * f);
+         1. / 3. * (lbpar.gamma_bulk - lbpar.gamma_shear) * u_f;
   C[5] = (1. + lbpar.gamma_bulk) * u[2] * f[2] +
-         1. / 3. * (lbpar.gamma_bulk - lbpar.gamma_shear) * (u * f);
+         1. / 3. * (lbpar.gamma_bulk - lbpar.gamma_shear) * u_f;
   C[1] = 1. / 2. * (1. + lbpar.gamma_shear) * (u[0] * f[1] + u[1] * f[0]);
   C[3] = 1. / 2. * (1. + lbpar.gamma_shear) * (u[0] * f[2] + u[2] * f[0]);
   C[4] = 1. / 2. * (1. + lbpar.gamma_shear) * (u[1] * f[2] + u[2] * f[1]);
@@ -894,7 +1036,7 @@ template <typename T>
 std::array<T, 19> normalize_modes(const std::array<T, 19> &modes) {
   auto normalized_modes = modes;
   for (int i = 0; i < modes.size(); i++) {
-    normalized_modes[i] /= D3Q19::w_k[i];
+    normalized_modes[i] = normalized_modes[i] / D3Q19::w_k[i];
   }
   return normalized_modes;
 }
@@ -903,28 +1045,272 @@ template <typename T, std::size_t N>
 std::array<T, N> lb_calc_n_from_m(const std::array<T, N> &modes) {
   auto ret = Utils::matrix_vector_product<T, N, e_ki_transposed>(
       normalize_modes(modes));
-  std::transform(ret.begin(), ret.end(), ::D3Q19::w.begin(), ret.begin(),
-                 std::multiplies<T>());
+  for (std::size_t i = 0; i < N; i++) {
+    ret[i] = ret[i] * ::D3Q19::w[i];
+  }
   return ret;
 }
 
-template <typename T>
-inline void lb_calc_n_from_modes_push(LB_Fluid &lbfluid, Lattice::index_t index,
-                                      const std::array<T, 19> &m) {
-  const std::array<int, 3> period = {
-      {1, lblattice.halo_grid[0],
-       lblattice.halo_grid[0] * lblattice.halo_grid[1]}};
-  auto const f = lb_calc_n_from_m(m);
+namespace {
+/** @brief Where the collision of a node reads and writes its populations.
+ *
+ *  Population i of the node at index is read from slot load_slot[i] of
+ *  the node index + load_offset[i] in @ref lbfluid, and the post-collision
+ *  population i is written to slot store_slot[i] of the node
+ *  index + store_offset[i] in target.
+ */
+struct Streaming {
+  LB_Fluid *target;
+  std::array<Lattice::index_t, 19> load_offset;
+  std::array<int, 19> load_slot;
+  std::array<Lattice::index_t, 19> store_offset;
+  std::array<int, 19> store_slot;
+};
+
+/** Push scheme: read the node, push to the neighbors in @ref lbfluid_post. */
+Streaming push_streaming(std::array<Lattice::index_t, 19> const &offsets) {
+  Streaming s;
+  s.target = &lbfluid_post;
+  for (int i = 0; i < 19; i++) {
+    s.load_offset[i] = 0;
+    s.load_slot[i] = i;
+    s.store_offset[i] = offsets[i];
+    s.store_slot[i] = i;
+  }
+  return s;
+}
+
+/** Even step of the in-place scheme: read the node, write the
+ *  post-collision populations back to the reversed slots of the node.
+ */
+Streaming in_place_even_streaming() {
+  Streaming s;
+  s.target = &lbfluid;
   for (int i = 0; i < 19; i++) {
-    auto const next = index + boost::inner_product(period, D3Q19::c[i], 0);
-    lbfluid[i][next] = f[i];
+    s.load_offset[i] = 0;
+    s.load_slot[i] = i;
+    s.store_offset[i] = 0;
+    s.store_slot[i] = reverse[i];
+  }
+  return s;
+}
+
+/** Odd step of the in-place scheme: gather the populations from the
+ *  reversed slots of the neighbors, push to the neighbors. Every slot is
+ *  read and written by the same node, so no second array is needed.
+ */
+Streaming
+in_place_odd_streaming(std::array<Lattice::index_t, 19> const &offsets) {
+  Streaming s;
+  s.target = &lbfluid;
+  for (int i = 0; i < 19; i++) {
+    s.load_offset[i] = -offsets[i];
+    s.load_slot[i] = reverse[i];
+    s.store_offset[i] = offsets[i];
+    s.store_slot[i] = i;
+  }
+  return s;
+}
+} // namespace
+
+/** Collide a single node and stream its populations. */
+inline void lb_collide_stream_node(Lattice::index_t index,
+                                   Streaming const &streaming) {
+#ifdef LB_BOUNDARIES
+  if (lbfields[index].boundary)
+    return;
+#endif // LB_BOUNDARIES
+
+  std::array<double, 19> populations;
+  for (int i = 0; i < 19; i++)
+    populations[i] =
+        lbfluid[streaming.load_slot[i]][index + streaming.load_offset[i]];
+
+  /* calculate modes locally */
+  auto const modes =
+      Utils::matrix_vector_product<double, 19, e_ki>(populations);
+
+  /* deterministic collisions */
+  auto const relaxed_modes =
+      lb_relax_modes(modes, lbfields[index].force_density);
+
+  /* fluctuating hydrodynamics */
+  auto const thermalized_modes = lb_thermalize_modes(index, relaxed_modes);
+
+  /* apply forces */
+  auto const modes_with_forces =
+      lb_apply_forces(thermalized_modes, lbfields[index].force_density);
+
+  /* reset the force density */
+  lbfields[index].force_density = lbpar.ext_force_density;
+
+  /* transform back to populations and streaming */
+  auto const f = lb_calc_n_from_m(modes_with_forces);
+  for (int i = 0; i < 19; i++)
+    store_population((*streaming.target)[streaming.store_slot[i]],
+                     index + streaming.store_offset[i], f[i]);
+}
+
+/** Collide the nodes index, ..., index + N - 1 of a row, which must
+ *  not contain boundary nodes, and stream their populations. Same as
+ *  \ref lb_collide_stream_node for each of the nodes.
+ */
+template <std::size_t N>
+void lb_collide_stream_block(Lattice::index_t index,
+                             Streaming const &streaming) {
+  using Block = NodeBlock<N>;
+
+  std::array<Block, 19> populations;
+  for (int i = 0; i < 19; i++) {
+    auto const &source = lbfluid[streaming.load_slot[i]];
+    auto const first = index + streaming.load_offset[i];
+    for (std::size_t k = 0; k < N; k++)
+      populations[i][k] = source[first + k];
+  }
+
+  std::array<Block, 3> force_density;
+  for (std::size_t k = 0; k < N; k++)
+    for (int j = 0; j < 3; j++)
+      force_density[j][k] = lbfields[index + k].force_density[j];
+
+  auto const modes =
+      Utils::matrix_vector_product<Block, 19, e_ki>(populations);
+
+  auto thermalized_modes = lb_relax_modes(modes, force_density);
+
+  /* the random numbers are drawn node by node */
+  if (lbpar.kT > 0.0) {
+    for (std::size_t k = 0; k < N; k++) {
+      std::array<double, 19> node_modes;
+      for (int i = 0; i < 19; i++)
+        node_modes[i] = thermalized_modes[i][k];
+      node_modes = lb_thermalize_modes(index + k, node_modes);
+      for (int i = 4; i < 19; i++)
+        thermalized_modes[i][k] = node_modes[i];
+    }
+  }
+
+  auto const modes_with_forces =
+      lb_apply_forces(thermalized_modes, force_density);
+
+  for (std::size_t k = 0; k < N; k++)
+    lbfields[index + k].force_density = lbpar.ext_force_density;
+
+  auto const f = lb_calc_n_from_m(modes_with_forces);
+  for (int i = 0; i < 19; i++)
+    store_population((*streaming.target)[streaming.store_slot[i]],
+                     index + streaming.store_offset[i], f[i]);
+}
+
+/** Collide the n nodes of a row starting at index. */
+void lb_collide_stream_row(Lattice::index_t index, int n,
+                           Streaming const &streaming) {
+  int x = 0;
+  for (; x + static_cast<int>(lb_block_size) <= n; x += lb_block_size) {
+#ifdef LB_BOUNDARIES
+    /* blocks with boundary nodes are done node by node */
+    if (std::any_of(lbfields.begin() + index + x,
+                    lbfields.begin() + index + x + lb_block_size,
+                    [](LB_FluidNode const &node) { return node.boundary; })) {
+      for (std::size_t k = 0; k < lb_block_size; k++)
+        lb_collide_stream_node(index + x + k, streaming);
+      continue;
+    }
+#endif // LB_BOUNDARIES
+    lb_collide_stream_block<lb_block_size>(index + x, streaming);
+  }
+
+  for (; x < n; x++)
+    lb_collide_stream_node(index + x, streaming);
+}
+
+/** Collide all local nodes (halo excluded). */
+void lb_collide_stream_nodes(Streaming const &streaming) {
+  /* The nodes only write their own force density and distinct
+     populations, so the z-slabs can be done concurrently. The random
+     numbers only depend on the node index. */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int z = 1; z <= lblattice.grid[2]; z++) {
+    for (int y = 1; y <= lblattice.grid[1]; y++) {
+      lb_collide_stream_row(get_linear_index(1, y, z, lblattice.halo_grid),
+                            lblattice.grid[0], streaming);
+    }
   }
 }
 
-/* Collisions and streaming (push scheme) */
+/** Collide the local nodes next to the halo, which are the only ones
+ *  streaming into it.
+ */
+void lb_collide_stream_surface(Streaming const &streaming) {
+  auto const &grid = lblattice.grid;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int z = 1; z <= grid[2]; z++) {
+    for (int y = 1; y <= grid[1]; y++) {
+      auto const index = get_linear_index(1, y, z, lblattice.halo_grid);
+      if (z == 1 or z == grid[2] or y == 1 or y == grid[1]) {
+        lb_collide_stream_row(index, grid[0], streaming);
+      } else {
+        lb_collide_stream_node(index, streaming);
+        if (grid[0] > 1)
+          lb_collide_stream_node(index + grid[0] - 1, streaming);
+      }
+    }
+  }
+}
+
+/** Collide the local nodes not next to the halo in the z-planes
+ *  [z_begin, z_end).
+ */
+void lb_collide_stream_bulk(Streaming const &streaming, int z_begin,
+                            int z_end) {
+  auto const &grid = lblattice.grid;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int z = z_begin; z < z_end; z++) {
+    for (int y = 2; y < grid[1]; y++) {
+      lb_collide_stream_row(get_linear_index(2, y, z, lblattice.halo_grid),
+                            grid[0] - 2, streaming);
+    }
+  }
+}
+
+/** Collide all local nodes and send the populations streamed into the
+ *  halo to their nodes.
+ *
+ *  The nodes next to the halo are collided first. Then the halo planes
+ *  are exchanged direction by direction with @ref push_halo_comm, while a
+ *  third of the bulk is collided per direction. The bulk nodes neither
+ *  read nor write the populations in flight: they only stream into local
+ *  nodes, and the received populations are those coming in from the halo.
+ */
+void lb_collide_stream_overlapped(Streaming const &streaming) {
+  lb_collide_stream_surface(streaming);
+
+  auto base = reinterpret_cast<char *>((*streaming.target)[0].data());
+  auto const bulk_planes = std::max(lblattice.grid[2] - 2, 0);
+  for (int dir = 0; dir < 3; dir++) {
+    std::array<MPI_Request, 4> requests;
+    halo_communication_start(&push_halo_comm, 2 * dir, base, &requests[0]);
+    halo_communication_start(&push_halo_comm, 2 * dir + 1, base,
+                             &requests[2]);
+
+    lb_collide_stream_bulk(streaming, 2 + (dir * bulk_planes) / 3,
+                           2 + ((dir + 1) * bulk_planes) / 3);
+
+    halo_communication_finish(&push_halo_comm, 2 * dir, base, &requests[0]);
+    halo_communication_finish(&push_halo_comm, 2 * dir + 1, base,
+                              &requests[2]);
+  }
+}
+
+/* Collisions and streaming */
 inline void lb_collide_stream() {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
-/* loop over all lattice cells (halo excluded) */
 #ifdef LB_BOUNDARIES
   for (auto &lbboundarie : LBBoundaries::lbboundaries) {
     (*lbboundarie).reset_force();
@@ -943,55 +1329,42 @@ inline void lb_collide_stream() {
   }
 #endif
 
-  Lattice::index_t index = lblattice.halo_offset;
-  for (int z = 1; z <= lblattice.grid[2]; z++) {
-    for (int y = 1; y <= lblattice.grid[1]; y++) {
-      for (int x = 1; x <= lblattice.grid[0]; x++) {
-// as we only want to apply this to non-boundary nodes we can throw out
-// the if-clause if we have a non-bounded domain
-#ifdef LB_BOUNDARIES
-        if (!lbfields[index].boundary)
-#endif // LB_BOUNDARIES
-        {
-          /* calculate modes locally */
-          auto const modes = lb_calc_modes(index);
+  auto const offsets = lb_neighbor_offsets();
 
-          /* deterministic collisions */
-          auto const relaxed_modes = lb_relax_modes(index, modes);
+  if (lbpar.in_place_streaming and not lbfluid_reversed) {
+    /* even step: the post-collision populations stay at their node */
+    lb_collide_stream_nodes(in_place_even_streaming());
+    lbfluid_reversed = true;
 
-          /* fluctuating hydrodynamics */
-          auto const thermalized_modes =
-              lb_thermalize_modes(index, relaxed_modes);
+    halo_communication(&update_halo_comm,
+                       reinterpret_cast<char *>(lbfluid[0].data()));
 
-          /* apply forces */
-          auto const modes_with_forces =
-              lb_apply_forces(index, thermalized_modes);
+#ifdef LB_BOUNDARIES
+    /* boundary conditions for links */
+    lb_bounce_back(lbfluid, true);
+#endif // LB_BOUNDARIES
 
-          /* reset the force density */
-          lbfields[index].force_density = lbpar.ext_force_density;
+    halo_reversed_communication();
+    return;
+  }
 
-          /* transform back to populations and streaming */
-          lb_calc_n_from_modes_push(lbfluid_post, index, modes_with_forces);
-        }
+  /* collide and exchange the halo regions */
+  if (lbpar.in_place_streaming) {
+    /* odd step: completes the streaming of the even step */
+    lb_collide_stream_overlapped(in_place_odd_streaming(offsets));
+    lbfluid_reversed = false;
+  } else {
+    lb_collide_stream_overlapped(push_streaming(offsets));
 
-        ++index; /* next node */
-      }
-      index += 2; /* skip halo region */
-    }
-    index += 2 * lblattice.halo_grid[0]; /* skip halo region */
+    /* swap the pointers for old and new population fields */
+    std::swap(lbfluid, lbfluid_post);
   }
 
-  /* exchange halo regions */
-  halo_push_communication(lbfluid_post);
-
 #ifdef LB_BOUNDARIES
   /* boundary conditions for links */
-  lb_bounce_back(lbfluid_post);
+  lb_bounce_back(lbfluid);
 #endif // LB_BOUNDARIES
 
-  /* swap the pointers for old and new population fields */
-  std::swap(lbfluid, lbfluid_post);
-
   halo_communication(&update_halo_comm,
                      reinterpret_cast<char *>(lbfluid[0].data()));
 
@@ -1318,7 +1691,7 @@ Utils::Vector6d lb_calc_stress(std::array<double, 19> const &modes,
  *
  * [cf. Ladd and Verberg, J. Stat. Phys. 104(5/6):1191-1251, 2001]
  */
-void lb_bounce_back(LB_Fluid &lbfluid) {
+void lb_bounce_back(LB_Fluid &lbfluid, bool reversed) {
   int k, i, l;
   int yperiod = lblattice.halo_grid[0];
   int zperiod = lblattice.halo_grid[0] * lblattice.halo_grid[1];
@@ -1343,9 +1716,6 @@ void lb_bounce_back(LB_Fluid &lbfluid) {
   next[16] = -(yperiod + zperiod); // ( 0,-1,-1)
   next[17] = (yperiod - zperiod);  // ( 0, 1,-1)
   next[18] = -(yperiod - zperiod); // ( 0,-1, 1) +
-  int reverse[] = {0, 2,  1,  4,  3,  6,  5,  8,  7, 10,
-                   9, 12, 11, 14, 13, 16, 15, 18, 17};
-
   /* bottom-up sweep */
   for (int z = 0; z < lblattice.grid[2] + 2; z++) {
     for (int y = 0; y < lblattice.grid[1] + 2; y++) {
@@ -1361,22 +1731,39 @@ void lb_bounce_back(LB_Fluid &lbfluid) {
                                   D3Q19::c_sound_sq<double>;
             }
 
-            if (x - D3Q19::c[i][0] > 0 &&
-                x - D3Q19::c[i][0] < lblattice.grid[0] + 1 &&
-                y - D3Q19::c[i][1] > 0 &&
-                y - D3Q19::c[i][1] < lblattice.grid[1] + 1 &&
-                z - D3Q19::c[i][2] > 0 &&
-                z - D3Q19::c[i][2] < lblattice.grid[2] + 1) {
+            auto const source = Utils::Vector3i{
+                x - static_cast<int>(D3Q19::c[i][0]),
+                y - static_cast<int>(D3Q19::c[i][1]),
+                z - static_cast<int>(D3Q19::c[i][2])};
+            auto const source_local =
+                source[0] > 0 && source[0] < lblattice.grid[0] + 1 &&
+                source[1] > 0 && source[1] < lblattice.grid[1] + 1 &&
+                source[2] > 0 && source[2] < lblattice.grid[2] + 1;
+            /* In the intermediate layout of the in-place scheme, the
+             * population streaming into the boundary node is still stored
+             * at its source, and the one streaming back to the source at
+             * the boundary node. This is also done for sources in the halo,
+             * which are not updated by a halo communication afterwards. */
+            auto const source_inside =
+                source[0] >= 0 && source[0] < lblattice.halo_grid[0] &&
+                source[1] >= 0 && source[1] < lblattice.halo_grid[1] &&
+                source[2] >= 0 && source[2] < lblattice.halo_grid[2];
+            if (source_local || (reversed && source_inside)) {
+              auto &incoming = reversed ? lbfluid[reverse[i]][k - next[i]]
+                                        : lbfluid[i][k];
+              auto &outgoing = reversed ? lbfluid[i][k]
+                                        : lbfluid[reverse[i]][k - next[i]];
               if (!lbfields[k - next[i]].boundary) {
-                for (l = 0; l < 3; l++) {
-                  (*LBBoundaries::lbboundaries[lbfields[k].boundary - 1])
-                      .force()[l] += // TODO
-                      (2 * lbfluid[i][k] + population_shift) * D3Q19::c[i][l];
+                if (source_local) {
+                  for (l = 0; l < 3; l++) {
+                    (*LBBoundaries::lbboundaries[lbfields[k].boundary - 1])
+                        .force()[l] += // TODO
+                        (2 * incoming + population_shift) * D3Q19::c[i][l];
+                  }
                 }
-                lbfluid[reverse[i]][k - next[i]] =
-                    lbfluid[i][k] + population_shift;
+                outgoing = incoming + population_shift;
               } else {
-                lbfluid[reverse[i]][k - next[i]] = lbfluid[i][k] = 0.0;
+                outgoing = incoming = 0.0;
               }
             }
           }
@@ -1389,22 +1776,19 @@ void lb_bounce_back(LB_Fluid &lbfluid) {
 
 /** Calculate the local fluid momentum.
  *  The calculation is implemented explicitly for the special case of D3Q19.
- *  @param[in]  index  Local lattice site
+ *  @param[in]  index    Local lattice site
+ *  @param[in]  offsets  Offsets of the neighbors, see lb_neighbor_offsets
  *  @retval The local fluid momentum.
  */
-inline Utils::Vector3d lb_calc_local_momentum_density(Lattice::index_t index) {
-  return {{lbfluid[1][index] - lbfluid[2][index] + lbfluid[7][index] -
-               lbfluid[8][index] + lbfluid[9][index] - lbfluid[10][index] +
-               lbfluid[11][index] - lbfluid[12][index] + lbfluid[13][index] -
-               lbfluid[14][index],
-           lbfluid[3][index] - lbfluid[4][index] + lbfluid[7][index] -
-               lbfluid[8][index] - lbfluid[9][index] + lbfluid[10][index] +
-               lbfluid[15][index] - lbfluid[16][index] + lbfluid[17][index] -
-               lbfluid[18][index],
-           lbfluid[5][index] - lbfluid[6][index] + lbfluid[11][index] -
-               lbfluid[12][index] - lbfluid[13][index] + lbfluid[14][index] +
-               lbfluid[15][index] - lbfluid[16][index] - lbfluid[17][index] +
-               lbfluid[18][index]}};
+inline Utils::Vector3d lb_calc_local_momentum_density(
+    Lattice::index_t index, std::array<Lattice::index_t, 19> const &offsets) {
+  auto const f = lb_node_populations(index, offsets);
+  return {{f[1] - f[2] + f[7] - f[8] + f[9] - f[10] + f[11] - f[12] + f[13] -
+               f[14],
+           f[3] - f[4] + f[7] - f[8] - f[9] + f[10] + f[15] - f[16] + f[17] -
+               f[18],
+           f[5] - f[6] + f[11] - f[12] - f[13] + f[14] + f[15] - f[16] - f[17] +
+               f[18]}};
 }
 
 // Statistics in MD units.
@@ -1416,13 +1800,14 @@ void lb_calc_fluid_momentum(double *result) {
 
   int x, y, z, index;
   Utils::Vector3d momentum_density{}, momentum{};
+  auto const offsets = lb_neighbor_offsets();
 
   for (x = 1; x <= lblattice.grid[0]; x++) {
     for (y = 1; y <= lblattice.grid[1]; y++) {
       for (z = 1; z <= lblattice.grid[2]; z++) {
         index = get_linear_index(x, y, z, lblattice.halo_grid);
 
-        momentum_density = lb_calc_local_momentum_density(index);
+        momentum_density = lb_calc_local_momentum_density(index, offsets);
         momentum += momentum_density + .5 * lbfields[index].force_density;
       }
     }
@@ -59,6 +59,12 @@
  *  The hydrodynamic fields, corresponding to density, velocity and stress, are
  *  stored in LB_FluidNodes in the array lbfields, the populations in lbfluid
  *  which is constructed as 2 x (Nx x Ny x Nz) x 19 array.
+ *
+ *  With in-place streaming (AA pattern, see lb.cpp), only one population
+ *  array is allocated. After an even step, every fluid node then holds its
+ *  post-collision populations in the slots of the reversed velocities, and
+ *  the next (odd) step completes the streaming while colliding. The
+ *  functions reading populations below work for both layouts.
  */
 
 /** Description of the LB Model in terms of the unit vectors of the
@@ -128,9 +134,15 @@ struct LB_Parameters {
   // Thermal energy
   double kT;
 
+  /** Stream in place in a single population array (AA pattern) instead of
+   *  pushing into a second array.
+   */
+  bool in_place_streaming;
+
   template <class Archive> void serialize(Archive &ar, long int) {
     ar &density &viscosity &bulk_viscosity &agrid &tau &ext_force_density
-        &gamma_odd &gamma_even &gamma_shear &gamma_bulk &is_TRT &phi &kT;
+        &gamma_odd &gamma_even &gamma_shear &gamma_bulk &is_TRT &phi &kT
+        &in_place_streaming;
   }
 };
 
@@ -149,6 +161,21 @@ void lb_init();
 void lb_reinit_fluid();
 
 void lb_reinit_parameters();
+
+/** (Re-)allocate the population arrays after a change of the streaming
+ *  scheme, keeping the populations.
+ */
+void lb_realloc_populations();
+
+/** Complete a pending in-place streaming step.
+ *  If the fluid is between the two steps of the in-place scheme, the
+ *  post-collision populations are streamed to their target nodes, so that
+ *  @ref lbfluid holds the pre-collision populations of every node again,
+ *  and the halo is updated. Has to be called on all nodes before
+ *  populations are written or the boundaries change.
+ */
+void lb_complete_streaming();
+
 /** Pointer to the velocity populations of the fluid.
  *  lbfluid contains pre-collision populations, lbfluid_post
  *  contains post-collision populations
@@ -156,27 +183,6 @@ void lb_reinit_parameters();
 using LB_Fluid = std::array<Utils::Span<double>, 19>;
 extern LB_Fluid lbfluid;
 
-class LB_Fluid_Ref {
-public:
-  LB_Fluid_Ref(std::size_t index, const LB_Fluid &lb_fluid)
-      : m_index(index), m_lb_fluid(lb_fluid) {}
-  template <std::size_t I> const auto &get() const {
-    return m_lb_fluid[I][m_index];
-  }
-
-private:
-  const std::size_t m_index;
-  const LB_Fluid &m_lb_fluid;
-};
-
-namespace Utils {
-
-template <std::size_t I> auto get(const LB_Fluid_Ref &lb_fluid) {
-  return lb_fluid.get<I>();
-}
-
-} // namespace Utils
-
 /** Pointer to the hydrodynamic fields of the fluid */
 extern std::vector<LB_FluidNode> lbfields;
 
@@ -239,14 +245,14 @@ Utils::Vector19d lb_get_population_from_density_momentum_density_stress(
     double density, Utils::Vector3d const &momentum_density,
     Utils::Vector6d const &stress);
 
-inline Utils::Vector19d lb_get_population(Lattice::index_t index) {
-  Utils::Vector19d pop{};
-  for (int i = 0; i < D3Q19::n_vel; ++i) {
-    pop[i] = lbfluid[i][index] + D3Q19::coefficients[i][0] * lbpar.density;
-  }
-  return pop;
-}
+/** Pre-collision populations of a node, including the equilibrium density
+ *  contribution. Works for both layouts of the populations.
+ */
+Utils::Vector19d lb_get_population(Lattice::index_t index);
 
+/** Set the pre-collision populations of a node. Requires the regular layout,
+ *  see @ref lb_complete_streaming.
+ */
 inline void lb_set_population(Lattice::index_t index,
                               const Utils::Vector19d &pop) {
   for (int i = 0; i < D3Q19::n_vel; ++i) {
@@ -265,8 +271,12 @@ void lb_prepare_communication();
  * in no slip boundary conditions.
  *
  * [cf. Ladd and Verberg, J. Stat. Phys. 104(5/6):1191-1251, 2001]
+ *
+ * @param lbfluid   populations after streaming
+ * @param reversed  whether the populations are in the intermediate layout
+ *                  of the in-place scheme, i.e. not streamed yet
  */
-void lb_bounce_back(LB_Fluid &lbfluid);
+void lb_bounce_back(LB_Fluid &lbfluid, bool reversed = false);
 
 #endif /* LB_BOUNDARIES */
 
@@ -223,6 +223,9 @@ void lb_init_boundaries() {
 #endif /* defined ( CUDA) && defined (LB_BOUNDARIES_GPU) */
   } else if (lattice_switch == ActiveLB::CPU) {
 #if defined(LB_BOUNDARIES)
+    /* the boundary flags change where populations are bounced back */
+    lb_complete_streaming();
+
     Utils::Vector3i offset;
     int the_boundary = -1;
 
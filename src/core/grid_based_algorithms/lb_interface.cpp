@@ -80,6 +80,7 @@ REGISTER_CALLBACK_ONE_RANK(mpi_lb_get_boundary_flag)
 
 void mpi_lb_set_population(Utils::Vector3i const &index,
                            Utils::Vector19d const &population) {
+  lb_complete_streaming();
   lb_set(index, [&](auto index) {
     auto const linear_index =
         get_linear_index(lblattice.local_index(index), lblattice.halo_grid);
@@ -200,6 +201,7 @@ void lb_lbfluid_on_integration_start() {
     }
 #endif
   } else if (lattice_switch == ActiveLB::CPU) {
+    lb_complete_streaming();
     halo_communication(&update_halo_comm,
                        reinterpret_cast<char *>(lbfluid[0].data()));
   }
@@ -532,6 +534,24 @@ void lb_lbfluid_set_kT(double kT) {
   }
 }
 
+void lb_lbfluid_set_in_place_streaming(bool in_place_streaming) {
+  if (lattice_switch == ActiveLB::GPU) {
+    if (in_place_streaming)
+      throw std::invalid_argument(
+          "In-place streaming is not supported by the GPU LB.");
+  } else if (lattice_switch == ActiveLB::CPU) {
+    lbpar.in_place_streaming = in_place_streaming;
+    mpi_bcast_lb_params(LBParam::IN_PLACE_STREAMING);
+  }
+}
+
+bool lb_lbfluid_get_in_place_streaming() {
+  if (lattice_switch == ActiveLB::CPU) {
+    return lbpar.in_place_streaming;
+  }
+  return false;
+}
+
 double lb_lbfluid_get_kT() {
   if (lattice_switch == ActiveLB::GPU) {
 #ifdef CUDA
@@ -1312,6 +1332,10 @@ void lb_lbfluid_on_lb_params_change(LBParam field) {
   case LBParam::GAMMA_EVEN:
   case LBParam::TAU:
     break;
+  case LBParam::IN_PLACE_STREAMING:
+    if (lattice_switch == ActiveLB::CPU)
+      lb_realloc_populations();
+    break;
   }
   lb_lbfluid_reinit_parameters();
 }
@@ -106,6 +106,12 @@ void lb_lbfluid_set_ext_force_density(const Utils::Vector3d &force_density);
  */
 void lb_lbfluid_set_kT(double kT);
 
+/**
+ * @brief Switch between push and in-place streaming of the CPU LB fluid.
+ * In-place streaming (AA pattern) needs only one population array.
+ */
+void lb_lbfluid_set_in_place_streaming(bool in_place_streaming);
+
 /**
  * @brief Invalidate the particle allocation on the GPU.
  */
@@ -167,6 +173,11 @@ const Utils::Vector3d lb_lbfluid_get_ext_force_density();
  */
 double lb_lbfluid_get_kT();
 
+/**
+ * @brief Get whether the CPU LB fluid streams in place.
+ */
+bool lb_lbfluid_get_in_place_streaming();
+
 /**
  * @brief Get the lattice speed (agrid/tau).
  */
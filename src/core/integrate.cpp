@@ -95,9 +95,17 @@ int db_maxf_id = 0, db_maxv_id = 0;
 #endif
 
 bool set_py_interrupt = false;
+
+int long_range_interval = 1;
+
 namespace {
 volatile std::sig_atomic_t ctrl_C = 0;
-}
+
+/** Position of the current force calculation in the long-range interval,
+ *  the long-range forces are evaluated at position 0.
+ */
+int long_range_step = 0;
+} // namespace
 
 /** \name Private Functions */
 /************************************************************/
@@ -132,6 +140,50 @@ void integrator_sanity_checks() {
   if (time_step < 0.0) {
     runtimeErrorMsg() << "time_step not set";
   }
+
+  /* The load balanced domain decomposition changes the node
+     domains, which the lattice and mesh based methods can not
+     follow. */
+  if (cell_structure.type == CELL_STRUCTURE_DOMDEC &&
+      dd.balance_interval > 0) {
+    if (lattice_switch != ActiveLB::NONE) {
+      runtimeErrorMsg() << "load balancing of the domain decomposition is not "
+                           "supported with lattice-Boltzmann";
+    }
+#ifdef ELECTROSTATICS
+    if (coulomb.method != COULOMB_NONE && coulomb.method != COULOMB_DH &&
+        coulomb.method != COULOMB_RF) {
+      runtimeErrorMsg() << "load balancing of the domain decomposition is "
+                           "only supported with short-ranged electrostatics";
+    }
+#endif
+#ifdef DIPOLES
+    if (dipole.method != DIPOLAR_NONE) {
+      runtimeErrorMsg() << "load balancing of the domain decomposition is not "
+                           "supported with magnetostatics";
+    }
+#endif
+  }
+
+  if (long_range_interval > 1) {
+    if (integ_switch == INTEG_METHOD_NPT_ISO) {
+      runtimeErrorMsg() << "multiple time stepping of the long-range forces "
+                           "is not supported with the NPT integrator";
+    }
+#if defined(ELECTROSTATICS) && defined(CUDA)
+    /* the GPU forces are added after the weighting */
+    if (coulomb.method == COULOMB_P3M_GPU) {
+      runtimeErrorMsg() << "multiple time stepping of the long-range forces "
+                           "is not supported with GPU P3M";
+    }
+#endif
+  }
+}
+
+int long_range_force_weight() {
+  if (integ_switch != INTEG_METHOD_NVT)
+    return 1;
+  return (long_range_step == 0) ? long_range_interval : 0;
 }
 
 #ifdef NPT
@@ -234,6 +286,9 @@ void integrate_vv(int n_steps, int reuse_forces) {
       langevin_rng_counter_increment();
     }
 
+    // A new long-range interval starts with fresh forces
+    long_range_step = 0;
+
     force_calc();
 
     if (integ_switch != INTEG_METHOD_STEEPEST_DESCENT) {
@@ -320,12 +375,18 @@ void integrate_vv(int n_steps, int reuse_forces) {
     virtual_sites()->update();
 #endif
 
-    // Communication step: distribute ghost positions
-    cells_update_ghosts();
+    if (cell_structure.type == CELL_STRUCTURE_DOMDEC)
+      dd_balance_on_step();
+
+    // Communication step: distribute ghost positions, this is
+    // completed in force_calc, overlapped with the local work.
+    cells_update_ghosts_begin();
 
     // Propagate langevin philox rng counter
     langevin_rng_counter_increment();
 
+    long_range_step = (long_range_step + 1) % long_range_interval;
+
     force_calc();
 
 #ifdef VIRTUAL_SITES
@@ -787,6 +848,17 @@ void integrate_set_nvt() {
   mpi_bcast_parameter(FIELD_INTEG_SWITCH);
 }
 
+int integrate_set_long_range_interval(int interval) {
+  if (interval < 1) {
+    runtimeErrorMsg() << "the long-range interval has to be a positive "
+                         "number of steps";
+    return ES_ERROR;
+  }
+  long_range_interval = interval;
+  mpi_bcast_parameter(FIELD_LONG_RANGE_INTERVAL);
+  return ES_OK;
+}
+
 /** Parse integrate npt_isotropic command */
 int integrate_set_npt_isotropic(double ext_pressure, double piston, int xdir,
                                 int ydir, int zdir, bool cubic_box) {
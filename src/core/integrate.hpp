@@ -68,6 +68,11 @@ extern double verlet_reuse;
 /** Communicate signal handling to the Python interpreter */
 extern bool set_py_interrupt;
 
+/** Number of time steps between two evaluations of the long-range
+ *  forces (multiple time stepping), 1 evaluates them every step.
+ */
+extern int long_range_interval;
+
 /*@}*/
 
 /** \name Exported Functions */
@@ -90,11 +95,29 @@ void integrate_ensemble_init();
  */
 void integrate_vv(int n_steps, int reuse_forces);
 
+/** Weight of the long-range forces in the current force calculation.
+ *
+ *  With multiple time stepping (r-RESPA, Tuckerman et al., J. Chem.
+ *  Phys. 97, 1990 (1992)) the long-range forces are only evaluated
+ *  every @ref long_range_interval steps and applied as an impulse, i.e.
+ *  with the weight @ref long_range_interval on these steps and zero in
+ *  between. In the velocity Verlet scheme this is the same as kicking
+ *  the velocities with the long-range forces for half of the outer time
+ *  step at the beginning and at the end of each outer step.
+ *
+ *  \return The weight, 1 if multiple time stepping is not used.
+ */
+int long_range_force_weight();
+
 /*@}*/
 
 int python_integrate(int n_steps, bool recalc_forces, bool reuse_forces);
 
 void integrate_set_nvt();
+/** Set the number of time steps between two evaluations of the long-range
+ *  forces, see @ref long_range_force_weight.
+ */
+int integrate_set_long_range_interval(int interval);
 int integrate_set_npt_isotropic(double ext_pressure, double piston, int xdir,
                                 int ydir, int zdir, bool cubic_box);
 
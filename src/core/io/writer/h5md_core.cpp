@@ -21,15 +21,74 @@
 
 #include "h5md_core.hpp"
 #include "bonded_interactions/bonded_interaction_data.hpp"
+#include "cells.hpp"
 #include "communication.hpp"
 #include "grid.hpp"
 #include "integrate.hpp"
 
+#include <utils/mpi/gather_buffer.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <numeric>
+#include <tuple>
 #include <vector>
 
 namespace Writer {
 namespace H5md {
 
+/* Call f(partner) for all bonds of a particle with one partner. */
+template <typename F>
+static void for_each_pair_bond(Particle const &p, F f) {
+  for (auto it = p.bl.begin(); it != p.bl.end();) {
+    auto const n_partners = bonded_ia_params[*it++].num;
+
+    if (1 == n_partners) {
+      f(*it++);
+    } else {
+      it += n_partners;
+    }
+  }
+}
+
+/* Hash of a property of a particle. The hashes of the particles are summed
+ * up, so that the result does not depend on the order of the particles or on
+ * the node they are on. */
+template <typename T>
+static std::uint64_t particle_hash(int id, T const &value) {
+  std::size_t seed = boost::hash_value(id);
+  boost::hash_combine(seed, value);
+  return seed;
+}
+
+/* Reorder the blocks of stride elements of data by order. */
+template <typename T>
+static void permute(std::vector<T> &data, std::vector<int> const &order,
+                    int stride, std::vector<T> &scratch) {
+  scratch.resize(data.size());
+  for (std::size_t i = 0; i < order.size(); i++) {
+    std::copy_n(data.begin() + stride * order[i], stride,
+                scratch.begin() + stride * i);
+  }
+  std::swap(data, scratch);
+}
+
+/* Whether the object at path is linked from more than one group, like the
+ * time and step datasets that are shared with the id. */
+static bool is_shared(hid_t loc, std::string const &path) {
+#if H5_VERSION_GE(1, 12, 0)
+  H5O_info2_t info;
+  H5Oget_info_by_name3(loc, path.c_str(), &info, H5O_INFO_BASIC, H5P_DEFAULT);
+#elif H5_VERSION_GE(1, 10, 3)
+  H5O_info_t info;
+  H5Oget_info_by_name2(loc, path.c_str(), &info, H5O_INFO_BASIC, H5P_DEFAULT);
+#else
+  H5O_info_t info;
+  H5Oget_info_by_name(loc, path.c_str(), &info, H5P_DEFAULT);
+#endif
+  return info.rc > 1;
+}
+
 static void backup_file(const std::string &from, const std::string &to) {
 #ifdef H5MD_DEBUG
   std::cout << "Called " << __func__ << " on node " << this_node << std::endl;
@@ -102,6 +161,8 @@ void File::InitFile() {
   std::cout << "Called " << __func__ << " on node " << this_node << std::endl;
 #endif
   m_backup_filename = m_filename + ".bak";
+  m_static_written = {};
+  m_static_linked = false;
   // use a separate mpi communicator if we want to write out ordered data. This
   // is in order to avoid  blocking by collective functions
   if (m_write_ordered)
@@ -139,7 +200,6 @@ void File::InitFile() {
       if (this_node == 0)
         backup_file(m_filename, m_backup_filename);
       load_file(m_filename);
-      m_already_wrote_bonds = true;
     } else {
       throw incompatible_h5mdfile();
     }
@@ -174,11 +234,17 @@ void File::init_filestructure() {
       // path, dim, type
       {"particles/atoms/box/edges", 1, type_double},
       {"particles/atoms/mass/value", 2, type_double},
+      {"particles/atoms/mass/time", 1, type_double},
+      {"particles/atoms/mass/step", 1, type_int},
       {"particles/atoms/charge/value", 2, type_double},
+      {"particles/atoms/charge/time", 1, type_double},
+      {"particles/atoms/charge/step", 1, type_int},
       {"particles/atoms/id/value", 2, type_int},
       {"particles/atoms/id/time", 1, type_double},
       {"particles/atoms/id/step", 1, type_int},
       {"particles/atoms/species/value", 2, type_int},
+      {"particles/atoms/species/time", 1, type_double},
+      {"particles/atoms/species/step", 1, type_int},
       {"particles/atoms/position/value", 3, type_double},
       {"particles/atoms/velocity/value", 3, type_double},
       {"particles/atoms/force/value", 3, type_double},
@@ -249,18 +315,6 @@ void File::create_links_for_time_and_step_datasets() {
                  "particles/atoms/position/time", H5P_DEFAULT, H5P_DEFAULT);
   H5Lcreate_hard(m_h5md_file.hid(), path_step.c_str(), m_h5md_file.hid(),
                  "particles/atoms/position/step", H5P_DEFAULT, H5P_DEFAULT);
-  H5Lcreate_hard(m_h5md_file.hid(), path_time.c_str(), m_h5md_file.hid(),
-                 "particles/atoms/species/time", H5P_DEFAULT, H5P_DEFAULT);
-  H5Lcreate_hard(m_h5md_file.hid(), path_step.c_str(), m_h5md_file.hid(),
-                 "particles/atoms/species/step", H5P_DEFAULT, H5P_DEFAULT);
-  H5Lcreate_hard(m_h5md_file.hid(), path_time.c_str(), m_h5md_file.hid(),
-                 "particles/atoms/mass/time", H5P_DEFAULT, H5P_DEFAULT);
-  H5Lcreate_hard(m_h5md_file.hid(), path_step.c_str(), m_h5md_file.hid(),
-                 "particles/atoms/mass/step", H5P_DEFAULT, H5P_DEFAULT);
-  H5Lcreate_hard(m_h5md_file.hid(), path_time.c_str(), m_h5md_file.hid(),
-                 "particles/atoms/charge/time", H5P_DEFAULT, H5P_DEFAULT);
-  H5Lcreate_hard(m_h5md_file.hid(), path_step.c_str(), m_h5md_file.hid(),
-                 "particles/atoms/charge/step", H5P_DEFAULT, H5P_DEFAULT);
 }
 
 void File::load_file(const std::string &filename) {
@@ -275,6 +329,8 @@ void File::load_file(const std::string &filename) {
 #endif
   bool only_load = true;
   create_datasets(only_load);
+  m_static_linked =
+      is_shared(m_h5md_file.hid(), "particles/atoms/species/step");
 }
 
 void File::create_new_file(const std::string &filename) {
@@ -322,87 +378,155 @@ void File::Close() {
     boost::filesystem::remove(m_backup_filename);
 }
 
-void File::fill_arrays_for_h5md_write_with_particle_property(
-    int particle_index, int_array_3d &id, int_array_3d &typ,
-    double_array_3d &mass, double_array_3d &pos, int_array_3d &image,
-    double_array_3d &vel, double_array_3d &f, double_array_3d &charge,
-    Particle const &current_particle, int write_dat, int_array_3d &bond) {
+void File::fill_buffers(int write_dat) {
 #ifdef H5MD_DEBUG
-  /* Turn on hdf5 error messages */
   std::cout << "Called " << __func__ << " on node " << this_node << std::endl;
 #endif
-  bool write_species = write_dat & W_TYPE;
-  bool write_pos = write_dat & W_POS;
-  bool write_vel = write_dat & W_V;
-  bool write_force = write_dat & W_F;
-  bool write_mass = write_dat & W_MASS;
-  bool write_charge = write_dat & W_CHARGE;
-
-  id[0][particle_index][0] = current_particle.p.identity;
-  if (write_species)
-    typ[0][particle_index][0] = current_particle.p.type;
-  if (write_mass)
-    mass[0][particle_index][0] = current_particle.p.mass;
-  /* store folded particle positions. */
-  if (write_pos) {
-    Utils::Vector3d p = current_particle.r.p;
-    Utils::Vector3i i = current_particle.l.i;
-    fold_position(p, i, box_geo);
-
-    pos[0][particle_index][0] = p[0];
-    pos[0][particle_index][1] = p[1];
-    pos[0][particle_index][2] = p[2];
-    image[0][particle_index][0] = i[0];
-    image[0][particle_index][1] = i[1];
-    image[0][particle_index][2] = i[2];
+  auto &b = m_buffers;
+  /* clear() keeps the capacity, so the buffers are only reallocated if the
+   * number of particles grows. */
+  for (auto *v : {&b.id, &b.type, &b.image, &b.bonds})
+    v->clear();
+  for (auto *v : {&b.mass, &b.charge, &b.pos, &b.vel, &b.f})
+    v->clear();
+
+  for (auto const &p : local_cells.particles()) {
+    b.id.push_back(p.p.identity);
+    if (write_dat & W_TYPE)
+      b.type.push_back(p.p.type);
+    if (write_dat & W_MASS)
+      b.mass.push_back(p.p.mass);
+    if (write_dat & W_CHARGE)
+      b.charge.push_back(p.p.q);
+    /* store folded particle positions. */
+    if (write_dat & W_POS) {
+      Utils::Vector3d pos = p.r.p;
+      Utils::Vector3i image = p.l.i;
+      fold_position(pos, image, box_geo);
+      b.pos.insert(b.pos.end(), pos.begin(), pos.end());
+      b.image.insert(b.image.end(), image.begin(), image.end());
+    }
+    if (write_dat & W_V)
+      b.vel.insert(b.vel.end(), p.m.v.begin(), p.m.v.end());
+    if (write_dat & W_F)
+      b.f.insert(b.f.end(), p.f.f.begin(), p.f.f.end());
+    if (write_dat & W_BONDS) {
+      for_each_pair_bond(p, [&b, &p](int partner) {
+        b.bonds.push_back(p.p.identity);
+        b.bonds.push_back(partner);
+      });
+    }
   }
+}
 
-  if (write_vel) {
-    vel[0][particle_index][0] = current_particle.m.v[0];
-    vel[0][particle_index][1] = current_particle.m.v[1];
-    vel[0][particle_index][2] = current_particle.m.v[2];
-  }
-  if (write_force) {
-    f[0][particle_index][0] = current_particle.f.f[0];
-    f[0][particle_index][1] = current_particle.f.f[1];
-    f[0][particle_index][2] = current_particle.f.f[2];
-  }
-  if (write_charge) {
-#ifdef ELECTROSTATICS
-    charge[0][particle_index][0] = current_particle.p.q;
+void File::gather_buffers(int write_dat) {
+#ifdef H5MD_DEBUG
+  std::cout << "Called " << __func__ << " on node " << this_node << std::endl;
 #endif
+  auto &b = m_buffers;
+  Utils::Mpi::gather_buffer(b.id, comm_cart);
+  if (write_dat & W_TYPE)
+    Utils::Mpi::gather_buffer(b.type, comm_cart);
+  if (write_dat & W_MASS)
+    Utils::Mpi::gather_buffer(b.mass, comm_cart);
+  if (write_dat & W_CHARGE)
+    Utils::Mpi::gather_buffer(b.charge, comm_cart);
+  if (write_dat & W_POS) {
+    Utils::Mpi::gather_buffer(b.pos, comm_cart);
+    Utils::Mpi::gather_buffer(b.image, comm_cart);
   }
+  if (write_dat & W_V)
+    Utils::Mpi::gather_buffer(b.vel, comm_cart);
+  if (write_dat & W_F)
+    Utils::Mpi::gather_buffer(b.f, comm_cart);
+  if (write_dat & W_BONDS)
+    Utils::Mpi::gather_buffer(b.bonds, comm_cart);
+
+  if (this_node != 0)
+    return;
 
-  if (!m_already_wrote_bonds) {
-    int nbonds_local = bond.shape()[1];
-    for (auto it = current_particle.bl.begin();
-         it != current_particle.bl.end();) {
-
-      auto const n_partners = bonded_ia_params[*it++].num;
+  /* Sort the particles by id. Only the present properties are
+   * permuted, the others are empty. */
+  m_order.resize(b.id.size());
+  std::iota(m_order.begin(), m_order.end(), 0);
+  std::sort(m_order.begin(), m_order.end(),
+            [&b](int i, int j) { return b.id[i] < b.id[j]; });
+  for (auto *v : {&b.id, &b.type})
+    if (!v->empty())
+      permute(*v, m_order, 1, m_int_scratch);
+  if (!b.image.empty())
+    permute(b.image, m_order, 3, m_int_scratch);
+  for (auto *v : {&b.mass, &b.charge})
+    if (!v->empty())
+      permute(*v, m_order, 1, m_double_scratch);
+  for (auto *v : {&b.pos, &b.vel, &b.f})
+    if (!v->empty())
+      permute(*v, m_order, 3, m_double_scratch);
+
+  /* Sort the bonds by particle id and partner. */
+  m_order.resize(b.bonds.size() / 2);
+  std::iota(m_order.begin(), m_order.end(), 0);
+  std::sort(m_order.begin(), m_order.end(), [&b](int i, int j) {
+    return std::tie(b.bonds[2 * i], b.bonds[2 * i + 1]) <
+           std::tie(b.bonds[2 * j], b.bonds[2 * j + 1]);
+  });
+  permute(b.bonds, m_order, 2, m_int_scratch);
+}
 
-      if (1 == n_partners) {
-        bond.resize(boost::extents[1][nbonds_local + 1][2]);
-        bond[0][nbonds_local][0] = current_particle.p.identity;
-        bond[0][nbonds_local][1] = *it++;
-        nbonds_local++;
-      } else {
-        it += n_partners;
-      }
+int File::changed_data(int write_dat) {
+#ifdef H5MD_DEBUG
+  std::cout << "Called " << __func__ << " on node " << this_node << std::endl;
+#endif
+#ifndef ELECTROSTATICS
+  write_dat &= ~W_CHARGE;
+#endif
+  std::array<std::uint64_t, S_COUNT> hashes = {};
+  for (auto const &p : local_cells.particles()) {
+    auto const id = p.p.identity;
+    hashes[S_TYPE] += particle_hash(id, p.p.type);
+    hashes[S_MASS] += particle_hash(id, p.p.mass);
+    hashes[S_CHARGE] += particle_hash(id, p.p.q);
+    for_each_pair_bond(p, [&hashes, id](int partner) {
+      hashes[S_BONDS] += particle_hash(id, partner);
+    });
+  }
+  MPI_Allreduce(MPI_IN_PLACE, hashes.data(), S_COUNT, MPI_UINT64_T, MPI_SUM,
+                comm_cart);
+
+  std::array<int, S_COUNT> const flags = {W_TYPE, W_MASS, W_CHARGE, W_BONDS};
+  for (int i = 0; i < S_COUNT; i++) {
+    if (!(write_dat & flags[i]))
+      continue;
+    /* Properties sharing the step dataset of the id have to be written
+     * in every frame. */
+    auto const linked = m_static_linked && i != S_BONDS;
+    if (m_static_written[i] && hashes[i] == m_static_hashes[i] && !linked) {
+      write_dat &= ~flags[i];
+    } else {
+      m_static_hashes[i] = hashes[i];
+      m_static_written[i] = true;
     }
   }
+
+  /* In ordered mode only the first node has opened the file and knows its
+   * layout. */
+  if (m_write_ordered)
+    MPI_Bcast(&write_dat, 1, MPI_INT, 0, comm_cart);
+
+  return write_dat;
 }
 
-void File::Write(int write_dat, PartCfg &partCfg) {
+void File::Write(int write_dat) {
 #ifdef H5MD_DEBUG
   std::cout << "Called " << __func__ << " on node " << this_node << std::endl;
 #endif
-  int num_particles_to_be_written = 0;
-  if (m_write_ordered && this_node == 0)
-    num_particles_to_be_written = n_part;
-  else if (m_write_ordered && this_node != 0)
-    return;
-  else if (!m_write_ordered)
-    num_particles_to_be_written = cells_get_n_particles();
+  write_dat = changed_data(write_dat | W_BONDS);
+  fill_buffers(write_dat);
+  if (m_write_ordered) {
+    gather_buffers(write_dat);
+    if (this_node != 0)
+      return;
+  }
 
   bool write_species = write_dat & W_TYPE;
   bool write_pos = write_dat & W_POS;
@@ -410,159 +534,127 @@ void File::Write(int write_dat, PartCfg &partCfg) {
   bool write_force = write_dat & W_F;
   bool write_mass = write_dat & W_MASS;
   bool write_charge = write_dat & W_CHARGE;
+  bool write_bonds = write_dat & W_BONDS;
 
-  double_array_3d pos(boost::extents[1][num_particles_to_be_written][3]);
-  double_array_3d vel(boost::extents[1][num_particles_to_be_written][3]);
-  double_array_3d f(boost::extents[1][num_particles_to_be_written][3]);
-  int_array_3d image(boost::extents[1][num_particles_to_be_written][3]);
-  int_array_3d id(boost::extents[1][num_particles_to_be_written][1]);
-  int_array_3d typ(boost::extents[1][num_particles_to_be_written][1]);
-  double_array_3d mass(boost::extents[1][num_particles_to_be_written][1]);
-  double_array_3d charge(boost::extents[1][num_particles_to_be_written][1]);
-  double_array_3d time(boost::extents[1][1][1]);
-  time[0][0][0] = sim_time;
-  int_array_3d step(boost::extents[1][1][1]);
-  step[0][0][0] = (int)std::round(sim_time / time_step);
-  int_array_3d bond(boost::extents[0][0][0]);
+  auto const &b = m_buffers;
+  auto const num_particles_to_be_written = static_cast<int>(b.id.size());
 
-  if (m_write_ordered) {
-    if (this_node == 0) {
-      /* Fetch bond info */
-      partCfg.update_bonds();
-      // loop over all particles
-      int particle_index = 0;
-      for (auto const &current_particle : partCfg) {
-        fill_arrays_for_h5md_write_with_particle_property(
-            particle_index++, id, typ, mass, pos, image, vel, f, charge,
-            current_particle, write_dat, bond);
-      }
-    }
-  } else {
-    /* loop over all local cells. */
-    int particle_index = 0;
-
-    for (auto &current_particle : local_cells.particles()) {
-      fill_arrays_for_h5md_write_with_particle_property(
-          particle_index, id, typ, mass, pos, image, vel, f, charge,
-          current_particle, write_dat, bond);
-      particle_index++;
-    }
-  }
-
-  // calculate count and offset
-  int prefix = 0;
   // calculate prefix for write of the current process
+  int prefix = 0;
   MPI_Exscan(&num_particles_to_be_written, &prefix, 1, MPI_INT, MPI_SUM,
              m_hdf5_comm);
-  hid_t ds = H5Dget_space(datasets["particles/atoms/id/value"].hid());
-  hsize_t dims_id[2], maxdims_id[2];
-  H5Sget_simple_extent_dims(ds, dims_id, maxdims_id);
-  H5Sclose(ds);
-
-  hsize_t offset_1d[1] = {dims_id[0]};
-  hsize_t offset_2d[2] = {dims_id[0], (hsize_t)prefix};
-  hsize_t offset_3d[3] = {dims_id[0], (hsize_t)prefix, 0};
-
-  hsize_t count_1d[1] = {1};
-  hsize_t count_2d[2] = {1, (hsize_t)num_particles_to_be_written};
-  hsize_t count_3d[3] = {1, (hsize_t)num_particles_to_be_written, 3};
-
-  // calculate the change of the extent for fluctuating particle numbers
-  int old_max_n_part =
-      std::max(m_max_n_part, (int)dims_id[1]); // check that dataset is not
-                                               // shrinked: take into account
-                                               // previous dimension, if we
-                                               // append to an already existing
-                                               // dataset
-  if (n_part > old_max_n_part) {
-    m_max_n_part = n_part;
-  } else {
-    m_max_n_part = old_max_n_part;
-  }
-  int extent_particle_number = m_max_n_part - old_max_n_part;
-
-  std::vector<int> change_extent_1d = {1};
-  std::vector<int> change_extent_2d = {1, extent_particle_number};
-  std::vector<int> change_extent_3d = {1, extent_particle_number, 0};
-
-  if (!m_already_wrote_bonds) {
-    // communicate the total number of bonds to all processes since extending is
-    // a collective hdf5 function
-    int nbonds_local = bond.shape()[1];
-    int nbonds_total = nbonds_local;
+  auto const offset = static_cast<hsize_t>(prefix);
+  auto const count = static_cast<hsize_t>(num_particles_to_be_written);
+
+  // the particle dimension is adapted to fluctuating particle numbers, but
+  // never shrinked: take into account previous dimension, if we append to an
+  // already existing dataset
+  auto const dims_id = dataset_dims("particles/atoms/id/value");
+  m_max_n_part =
+      std::max({m_max_n_part, static_cast<int>(dims_id[1]), n_part});
+
+  // step and time are written by one node only
+  double const time = sim_time;
+  int const step = static_cast<int>(std::round(sim_time / time_step));
+  hsize_t const count_frame = (this_node == 0) ? 1 : 0;
+
+  if (write_bonds) {
+    // communicate the total number of bonds to all processes since extending
+    // is a collective hdf5 function
+    int nbonds_local = static_cast<int>(b.bonds.size() / 2);
+    int nbonds_total = 0;
     int prefix_bonds = 0;
-    if (!m_write_ordered) {
-      MPI_Exscan(&nbonds_local, &prefix_bonds, 1, MPI_INT, MPI_SUM,
-                 m_hdf5_comm);
-      MPI_Allreduce(&nbonds_local, &nbonds_total, 1, MPI_INT, MPI_SUM,
-                    m_hdf5_comm);
-    }
+    MPI_Exscan(&nbonds_local, &prefix_bonds, 1, MPI_INT, MPI_SUM, m_hdf5_comm);
+    MPI_Allreduce(&nbonds_local, &nbonds_total, 1, MPI_INT, MPI_SUM,
+                  m_hdf5_comm);
+    // the bonds replace the ones of the last write
+    auto const dims_bonds = dataset_dims("connectivity/atoms");
     hsize_t offset_bonds[2] = {(hsize_t)prefix_bonds, 0};
     hsize_t count_bonds[2] = {(hsize_t)nbonds_local, 2};
-    std::vector<int> change_extent_bonds = {nbonds_total, 2};
-    WriteDataset(bond, "connectivity/atoms", change_extent_bonds, offset_bonds,
-                 count_bonds);
-    m_already_wrote_bonds = true;
+    std::vector<int> change_extent_bonds = {
+        nbonds_total - static_cast<int>(dims_bonds[0]),
+        2 - static_cast<int>(dims_bonds[1])};
+    WriteDataset(b.bonds.data(), "connectivity/atoms", change_extent_bonds,
+                 offset_bonds, count_bonds);
   }
 
-  WriteDataset(id, "particles/atoms/id/value", change_extent_2d, offset_2d,
-               count_2d);
-  WriteDataset(time, "particles/atoms/id/time", change_extent_1d, offset_1d,
-               count_1d);
-  WriteDataset(step, "particles/atoms/id/step", change_extent_1d, offset_1d,
-               count_1d);
+  WriteFrame(b.id.data(), "particles/atoms/id/value", offset, count);
+  WriteFrame(&time, "particles/atoms/id/time", 0, count_frame);
+  WriteFrame(&step, "particles/atoms/id/step", 0, count_frame);
 
+  auto write_static = [&](std::string const &group, auto const &data) {
+    WriteFrame(data.data(), group + "/value", offset, count);
+    if (!m_static_linked) {
+      WriteFrame(&time, group + "/time", 0, count_frame);
+      WriteFrame(&step, group + "/step", 0, count_frame);
+    }
+  };
   if (write_species) {
-    WriteDataset(typ, "particles/atoms/species/value", change_extent_2d,
-                 offset_2d, count_2d);
+    write_static("particles/atoms/species", b.type);
   }
   if (write_mass) {
-    WriteDataset(mass, "particles/atoms/mass/value", change_extent_2d,
-                 offset_2d, count_2d);
+    write_static("particles/atoms/mass", b.mass);
+  }
+  if (write_charge) {
+    write_static("particles/atoms/charge", b.charge);
   }
   if (write_pos) {
-    WriteDataset(pos, "particles/atoms/position/value", change_extent_3d,
-                 offset_3d, count_3d);
-    WriteDataset(image, "particles/atoms/image/value", change_extent_3d,
-                 offset_3d, count_3d);
+    WriteFrame(b.pos.data(), "particles/atoms/position/value", offset, count);
+    WriteFrame(b.image.data(), "particles/atoms/image/value", offset, count);
   }
   if (write_vel) {
-    WriteDataset(vel, "particles/atoms/velocity/value", change_extent_3d,
-                 offset_3d, count_3d);
+    WriteFrame(b.vel.data(), "particles/atoms/velocity/value", offset, count);
   }
   if (write_force) {
-    WriteDataset(f, "particles/atoms/force/value", change_extent_3d, offset_3d,
-                 count_3d);
-  }
-  if (write_charge) {
-#ifdef ELECTROSTATICS
-    WriteDataset(charge, "particles/atoms/charge/value", change_extent_2d,
-                 offset_2d, count_2d);
-#endif
+    WriteFrame(b.f.data(), "particles/atoms/force/value", offset, count);
   }
 }
 
+std::vector<hsize_t> File::dataset_dims(const std::string &path) {
+  hid_t ds = H5Dget_space(datasets[path].hid());
+  auto rank = static_cast<hsize_t>(H5Sget_simple_extent_ndims(ds));
+  std::vector<hsize_t> dims(rank), maxdims(rank);
+  H5Sget_simple_extent_dims(ds, dims.data(), maxdims.data());
+  H5Sclose(ds);
+  return dims;
+}
+
 void File::ExtendDataset(const std::string &path,
                          const std::vector<int> &change_extent) {
   /* Until now the h5xx does not support dataset extending, so we
      have to use the lower level hdf5 library functions. */
   auto &dataset = datasets[path];
   /* Get the current dimensions of the dataspace. */
-  hid_t ds = H5Dget_space(dataset.hid());
-  auto rank = static_cast<hsize_t>(H5Sget_simple_extent_ndims(ds));
-  std::vector<hsize_t> dims(rank), maxdims(rank);
-  H5Sget_simple_extent_dims(ds, dims.data(), maxdims.data());
-  H5Sclose(ds);
+  auto dims = dataset_dims(path);
   /* Extend the dataset for another timestep (extent = 1) */
-  for (int i = 0; i < rank; i++) {
+  for (std::size_t i = 0; i < dims.size(); i++) {
     dims[i] += change_extent[i];
   }
   H5Dset_extent(dataset.hid(), dims.data()); // extend all dims is collective
 }
 
-/* data is assumed to be three dimensional */
 template <typename T>
-void File::WriteDataset(T &data, const std::string &path,
+void File::WriteFrame(T const *data, const std::string &path, hsize_t prefix,
+                      hsize_t count) {
+  auto const dims = dataset_dims(path);
+  auto const rank = dims.size();
+  std::vector<int> change_extent(rank, 0);
+  std::vector<hsize_t> offset(rank, 0), counts(dims);
+  change_extent[0] = 1;
+  offset[0] = dims[0];
+  counts[0] = 1;
+  if (rank == 1) {
+    counts[0] = count;
+  } else {
+    change_extent[1] = std::max(0, m_max_n_part - static_cast<int>(dims[1]));
+    offset[1] = prefix;
+    counts[1] = count;
+  }
+  WriteDataset(data, path, change_extent, offset.data(), counts.data());
+}
+
+template <typename T>
+void File::WriteDataset(T const *data, const std::string &path,
                         const std::vector<int> &change_extent, hsize_t *offset,
                         hsize_t *count) {
 #ifdef H5MD_DEBUG
@@ -582,9 +674,16 @@ void File::WriteDataset(T &data, const std::string &path,
   H5Sselect_hyperslab(ds, H5S_SELECT_SET, offset, nullptr, count, nullptr);
   /* Create a temporary dataspace. */
   hid_t ds_new = H5Screate_simple(rank, count, maxdims.data());
+  /* In parallel, all nodes write their part of the data at once. */
+  hid_t plist = H5P_DEFAULT;
+  if (!m_write_ordered) {
+    plist = H5Pcreate(H5P_DATASET_XFER);
+    H5Pset_dxpl_mpio(plist, H5FD_MPIO_COLLECTIVE);
+  }
   /* Finally write the data to the dataset. */
-  H5Dwrite(dataset.hid(), dataset.get_type(), ds_new, ds, H5P_DEFAULT,
-           data.origin());
+  H5Dwrite(dataset.hid(), dataset.get_type(), ds_new, ds, plist, data);
+  if (plist != H5P_DEFAULT)
+    H5Pclose(plist);
   H5Sclose(ds_new);
   H5Sclose(ds);
 }
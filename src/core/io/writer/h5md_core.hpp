@@ -23,22 +23,20 @@
 #define ESPRESSO_H5MD_CORE_HPP
 
 #include <algorithm>
+#include <array>
 #include <boost/filesystem.hpp>
+#include <cstdint>
 #include <fstream>
 #include <h5xx/h5xx.hpp>
 #include <iostream>
 #include <mpi.h>
 #include <string>
 #include <unordered_map>
-
-#include "PartCfg.hpp"
+#include <vector>
 
 namespace Writer {
 namespace H5md {
 
-typedef boost::multi_array<double, 3> double_array_3d;
-typedef boost::multi_array<int, 3> int_array_3d;
-
 /**
  * @brief Class for writing H5MD files.
  **/
@@ -66,14 +64,18 @@ public:
     W_F = 1 << 2,
     W_TYPE = 1 << 3,
     W_MASS = 1 << 4,
-    W_CHARGE = 1 << 5
+    W_CHARGE = 1 << 5,
+    /* Bonds are always written, this is only used internally. */
+    W_BONDS = 1 << 6
   };
   /**
    * @brief General method to write to the datasets which calls more specific
    * write methods.
    * Boolean values for position, velocity, force and mass.
+   * Species, masses, charges and bonds are only written if they changed
+   * since the last write. Has to be called on all nodes.
    */
-  void Write(int write_dat, PartCfg &partCfg);
+  void Write(int write_dat);
 
   std::string &filename() { return m_filename; };
   std::string &scriptname() { return m_scriptname; };
@@ -90,7 +92,6 @@ public:
 
 private:
   MPI_Comm m_hdf5_comm;
-  bool m_already_wrote_bonds = false;
 
   /**
    * @brief Method to check if the H5MD structure is present in the file.
@@ -105,16 +106,34 @@ private:
    * positions to the dataset.
    */
   template <typename T>
-  void WriteDataset(T &data, const std::string &path,
+  void WriteDataset(T const *data, const std::string &path,
                     const std::vector<int> &change_extent, hsize_t *offset,
                     hsize_t *count);
 
+  /**
+   * @brief Method that appends a frame to a time series, the particle
+   * dimension is extended to the maximal number of particles if necessary.
+   * @param data   Data of @p count particles, or of the frame for step and
+   *               time.
+   * @param path   Path of the dataset.
+   * @param prefix Index of the first particle of this node in the frame.
+   * @param count  Number of particles (or values) written by this node.
+   */
+  template <typename T>
+  void WriteFrame(T const *data, const std::string &path, hsize_t prefix,
+                  hsize_t count);
+
   /**
    * @brief Method that extends datasets by the given extent.
    */
   void ExtendDataset(const std::string &path,
                      const std::vector<int> &change_extent);
 
+  /**
+   * @brief Method that returns the current dimensions of a dataset.
+   */
+  std::vector<hsize_t> dataset_dims(const std::string &path);
+
   /**
    * @brief Method that returns chunk dimensions.
    */
@@ -122,14 +141,23 @@ private:
                                          hsize_t chunk_size);
 
   /*
-   * @brief Method to fill the arrays that are used by WriteDataset particle by
-   * particle.
-   */
-  void fill_arrays_for_h5md_write_with_particle_property(
-      int particle_index, int_array_3d &id, int_array_3d &typ,
-      double_array_3d &mass, double_array_3d &pos, int_array_3d &image,
-      double_array_3d &vel, double_array_3d &f, double_array_3d &charge,
-      Particle const &current_particle, int write_dat, int_array_3d &bond);
+   * @brief Method to fill the buffers of the local particles that are used
+   * by WriteDataset.
+   */
+  void fill_buffers(int write_dat);
+
+  /*
+   * @brief Method to gather the buffers on the first node and sort them by
+   * particle id, for ordered output.
+   */
+  void gather_buffers(int write_dat);
+
+  /*
+   * @brief Method that removes the static data (species, masses, charges
+   * and bonds) from @p write_dat which did not change since the last write.
+   * Has to be called on all nodes.
+   */
+  int changed_data(int write_dat);
   /*
    * @brief Method to write the simulation script to the dataset.
    */
@@ -161,9 +189,10 @@ private:
   void create_datasets(bool only_load);
 
   /**
-   * @brief Links the time and step datasets to of all properties to the time
-   * and step dataset of the id property. All properties are written at the same
-   * time.
+   * @brief Links the time and step datasets of the properties that are
+   * written in every frame to the time and step dataset of the id property.
+   * Species, masses and charges have their own time and step datasets,
+   * since they are only written when they change.
    */
   void create_links_for_time_and_step_datasets();
 
@@ -187,6 +216,27 @@ private:
   std::vector<std::string> group_names;
   std::vector<DatasetDescriptor> dataset_descriptors;
   std::unordered_map<std::string, h5xx::dataset> datasets;
+
+  /**
+   * Per-node buffers of the particle data, reused between the writes.
+   * Vectors have three entries per particle, bonds two per bond.
+   */
+  struct Buffers {
+    std::vector<int> id, type, image, bonds;
+    std::vector<double> mass, charge, pos, vel, f;
+  } m_buffers;
+  /** Scratch space to sort the buffers in ordered mode. */
+  std::vector<int> m_order, m_int_scratch;
+  std::vector<double> m_double_scratch;
+
+  enum StaticData { S_TYPE, S_MASS, S_CHARGE, S_BONDS, S_COUNT };
+  /** Hashes of the static data at its last write. */
+  std::array<std::uint64_t, S_COUNT> m_static_hashes;
+  std::array<bool, S_COUNT> m_static_written = {};
+  /** Whether species, masses and charges share the time and step datasets
+   *  of the id, as in files written by older versions. Then they have to
+   *  be written in every frame. */
+  bool m_static_linked = false;
 };
 
 struct incompatible_h5mdfile : public std::exception {
@@ -0,0 +1,103 @@
+/*
+  Copyright (C) 2019 The ESPResSo project
+
+  This file is part of ESPResSo.
+
+  ESPResSo is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "lj_wca_batch.hpp"
+
+#include "collision.hpp"
+#include "electrostatics_magnetostatics/coulomb.hpp"
+#include "electrostatics_magnetostatics/dipole.hpp"
+#include "electrostatics_magnetostatics/elc.hpp"
+#include "electrostatics_magnetostatics/p3m.hpp"
+#include "thermostat.hpp"
+
+#include <utils/math/sqr.hpp>
+
+namespace LJWCABatch {
+bool enabled() {
+#if !(defined(LENNARD_JONES) || defined(WCA)) || defined(NO_INTRA_NB)
+  return false;
+#else
+#ifdef COLLISION_DETECTION
+  if (collision_params.mode != COLLISION_MODE_OFF)
+    return false;
+#endif
+#ifdef DPD
+  if (thermo_switch & THERMO_DPD)
+    return false;
+#endif
+#ifdef DIPOLES
+  if (dipole.method != DIPOLAR_NONE)
+    return false;
+#endif
+  return true;
+#endif
+}
+
+Kernel::Kernel(double cutoff)
+    : m_params(Utils::sqr(max_seen_particle_type)),
+      m_n_types(max_seen_particle_type), m_cutoff2(Utils::sqr(cutoff)) {
+  for (int i = 0; i < m_n_types; i++)
+    for (int j = 0; j < m_n_types; j++) {
+      auto const *ia_params = get_ia_param(i, j);
+      auto &p = m_params[i * m_n_types + j];
+
+      p.batched = ia_params->lj_wca_only;
+
+#ifdef LENNARD_JONES
+      /* The batched kernel does not support an offset */
+      if (ia_params->LJ_offset != 0.) {
+        p.batched = false;
+      } else if (ia_params->LJ_cut > 0.) {
+        p.lj_eps48 = 48. * ia_params->LJ_eps;
+        p.lj_sig2 = Utils::sqr(ia_params->LJ_sig);
+        p.lj_cut2 = Utils::sqr(ia_params->LJ_cut);
+        p.lj_min2 =
+            (ia_params->LJ_min < 0.) ? -1. : Utils::sqr(ia_params->LJ_min);
+      }
+#endif
+
+#ifdef WCA
+      if (ia_params->WCA_cut > 0.) {
+        p.wca_eps48 = 48. * ia_params->WCA_eps;
+        p.wca_sig2 = Utils::sqr(ia_params->WCA_sig);
+        p.wca_cut2 = Utils::sqr(ia_params->WCA_cut);
+      }
+#endif
+
+      if (not p.batched) {
+        p = Parameters{};
+      }
+    }
+
+#ifdef P3M
+  /* The real space part of P3M is batched if it has been tabulated and no
+     dielectric layers of ELC add per pair contributions. */
+  auto const p3m_real_space =
+      (coulomb.method == COULOMB_P3M || coulomb.method == COULOMB_P3M_GPU ||
+       (coulomb.method == COULOMB_ELC_P3M &&
+        not elc_params.dielectric_contrast_on));
+  if (p3m_real_space and p3m.params.r_cut > 0. and
+      p3m.real_space.s_max() == Utils::sqr(p3m.params.r_cut)) {
+    m_real_space = &p3m.real_space;
+    m_coulomb_cut2 = p3m.real_space.s_max();
+    m_coulomb_prefactor = coulomb.prefactor;
+  }
+#endif
+}
+} // namespace LJWCABatch
@@ -0,0 +1,213 @@
+/*
+  Copyright (C) 2019 The ESPResSo project
+
+  This file is part of ESPResSo.
+
+  ESPResSo is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef CORE_NB_IA_LJ_WCA_BATCH_HPP
+#define CORE_NB_IA_LJ_WCA_BATCH_HPP
+
+/** \file
+ *  Batched force kernel for pairs of particle types that only
+ *  interact via Lennard-Jones (without offset) and/or WCA.
+ *  With P3M, the real space Coulomb interaction of charged pairs
+ *  is evaluated in the same pass from the tabulated real space
+ *  kernel (see \ref P3MRealSpaceTable).
+ *
+ *  A particle is processed against a block of particles of a
+ *  cell, reading the packed particle data (see \ref CellSoA).
+ *  The block is worked on in chunks of fixed width without
+ *  branches in the inner loops, so that the compiler can map
+ *  the chunks onto SIMD lanes, the cutoffs are applied as masks.
+ *  Pairs the kernel can not handle (other potentials, charges
+ *  without P3M, exclusions) are handed to a scalar fallback.
+ */
+
+#include "config.hpp"
+
+#include "Cell.hpp"
+#include "electrostatics_magnetostatics/p3m_real_space.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interaction_data.hpp"
+#include "npt.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace LJWCABatch {
+/** Number of pairs that are processed at once */
+constexpr int lanes = 8;
+
+/** Parameters of the batched kernel for one pair of types.
+ *  Inactive potentials have a negative squared cutoff.
+ */
+struct Parameters {
+  /** The pair can be handled by the batched kernel. */
+  bool batched = false;
+  double lj_eps48 = 0.;
+  double lj_sig2 = 0.;
+  double lj_cut2 = -1.;
+  double lj_min2 = -1.;
+  double wca_eps48 = 0.;
+  double wca_sig2 = 0.;
+  double wca_cut2 = -1.;
+};
+
+/** @brief Whether the global state of the system allows to use
+ *         the batched kernel, e.g. there is no collision detection,
+ *         DPD or magnetostatics, which would need every pair.
+ */
+bool enabled();
+
+class Kernel {
+public:
+  /**
+   * @brief Set up the kernel for the current interaction parameters.
+   *
+   * @param cutoff Pairs up to this distance are handed to the
+   *               fallback if they can not be batched.
+   */
+  explicit Kernel(double cutoff);
+
+  /**
+   * @brief Calculate the forces between particle i of cell c1 and the
+   *        particles [begin, end) of cell c2.
+   *
+   * Batched forces are accumulated in the packed force arrays of the
+   * cells, the fallback is called as fallback(p1, p2, vec21) for the
+   * remaining pairs within the cutoff.
+   */
+  template <typename Fallback>
+  void operator()(Cell &c1, int i, Cell &c2, int begin, int end,
+                  Fallback &&fallback) const {
+    auto &s1 = c1.m_soa;
+    auto &s2 = c2.m_soa;
+
+    auto const xi = s1.x[i], yi = s1.y[i], zi = s1.z[i];
+    auto const qi = s1.q[i];
+    auto const *const params = m_params.data() + s1.type[i] * m_n_types;
+#ifdef EXCLUSIONS
+    /* The exclusions are symmetric, so the exclusion list of
+       the first particle decides. */
+    auto const no_batch = not c1.part[i].el.empty();
+#else
+    auto const no_batch = false;
+#endif
+
+    double fix = 0., fiy = 0., fiz = 0.;
+#ifdef NPT
+    double vir_x = 0., vir_y = 0., vir_z = 0.;
+#endif
+
+    double dx[lanes], dy[lanes], dz[lanes], fac[lanes];
+    bool scalar[lanes];
+
+    for (int j0 = begin; j0 < end; j0 += lanes) {
+      auto const n = std::min(lanes, end - j0);
+
+      for (int l = 0; l < n; l++) {
+        auto const j = j0 + l;
+        dx[l] = xi - s2.x[j];
+        dy[l] = yi - s2.y[j];
+        dz[l] = zi - s2.z[j];
+        auto const dist2 = dx[l] * dx[l] + dy[l] * dy[l] + dz[l] * dz[l];
+        auto const &p = params[s2.type[j]];
+
+        auto const q1q2 = qi * s2.q[j];
+
+        scalar[l] = (dist2 <= m_cutoff2) &&
+                    (no_batch || !p.batched ||
+                     (q1q2 != 0. && m_real_space == nullptr));
+
+        auto const inv_dist2 = 1. / dist2;
+        auto const lj_frac2 = p.lj_sig2 * inv_dist2;
+        auto const lj_frac6 = lj_frac2 * lj_frac2 * lj_frac2;
+        auto const wca_frac2 = p.wca_sig2 * inv_dist2;
+        auto const wca_frac6 = wca_frac2 * wca_frac2 * wca_frac2;
+
+        auto const lj =
+            ((dist2 < p.lj_cut2) && (dist2 > p.lj_min2))
+                ? p.lj_eps48 * lj_frac6 * (lj_frac6 - 0.5) * inv_dist2
+                : 0.;
+        auto const wca =
+            (dist2 < p.wca_cut2)
+                ? p.wca_eps48 * wca_frac6 * (wca_frac6 - 0.5) * inv_dist2
+                : 0.;
+
+        auto const real_space =
+            (q1q2 != 0. && dist2 > 0. && dist2 < m_coulomb_cut2)
+                ? m_coulomb_prefactor * q1q2 *
+                      m_real_space->force(std::sqrt(dist2), dist2)
+                : 0.;
+
+        fac[l] = scalar[l] ? 0. : lj + wca + real_space;
+      }
+
+      for (int l = 0; l < n; l++) {
+        auto const j = j0 + l;
+        auto const fx = fac[l] * dx[l];
+        auto const fy = fac[l] * dy[l];
+        auto const fz = fac[l] * dz[l];
+
+        fix += fx;
+        fiy += fy;
+        fiz += fz;
+        s2.fx[j] -= fx;
+        s2.fy[j] -= fy;
+        s2.fz[j] -= fz;
+
+#ifdef NPT
+        vir_x += fx * dx[l];
+        vir_y += fy * dy[l];
+        vir_z += fz * dz[l];
+#endif
+      }
+
+      for (int l = 0; l < n; l++) {
+        if (scalar[l]) {
+          fallback(c1.part[i], c2.part[j0 + l],
+                   Utils::Vector3d{dx[l], dy[l], dz[l]});
+        }
+      }
+    }
+
+    s1.fx[i] += fix;
+    s1.fy[i] += fiy;
+    s1.fz[i] += fiz;
+
+#ifdef NPT
+    if (integ_switch == INTEG_METHOD_NPT_ISO) {
+      nptiso.p_vir[0] += vir_x;
+      nptiso.p_vir[1] += vir_y;
+      nptiso.p_vir[2] += vir_z;
+    }
+#endif
+  }
+
+private:
+  std::vector<Parameters> m_params;
+  int m_n_types;
+  double m_cutoff2;
+  /** Real space Coulomb interaction, if it can be batched */
+  P3MRealSpaceTable const *m_real_space = nullptr;
+  double m_coulomb_cut2 = -1.;
+  double m_coulomb_prefactor = 0.;
+};
+} // namespace LJWCABatch
+
+#endif
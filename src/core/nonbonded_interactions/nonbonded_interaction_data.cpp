@@ -164,17 +164,18 @@ static void recalc_maximal_cutoff_nonbonded() {
 
   for (i = 0; i < max_seen_particle_type; i++)
     for (j = i; j < max_seen_particle_type; j++) {
+      double max_cut_lj_wca = INACTIVE_CUTOFF;
       double max_cut_current = INACTIVE_CUTOFF;
 
       IA_parameters *data = get_ia_param(i, j);
 
 #ifdef LENNARD_JONES
-      if (max_cut_current < (data->LJ_cut + data->LJ_offset))
-        max_cut_current = (data->LJ_cut + data->LJ_offset);
+      if (max_cut_lj_wca < (data->LJ_cut + data->LJ_offset))
+        max_cut_lj_wca = (data->LJ_cut + data->LJ_offset);
 #endif
 
 #ifdef WCA
-      max_cut_current = std::max(max_cut_current, data->WCA_cut);
+      max_cut_lj_wca = std::max(max_cut_lj_wca, data->WCA_cut);
 #endif
 
 #ifdef DPD
@@ -272,6 +273,11 @@ static void recalc_maximal_cutoff_nonbonded() {
 
       IA_parameters *data_sym = get_ia_param(j, i);
 
+      /* no other interaction than LJ and WCA is set */
+      data_sym->lj_wca_only = data->lj_wca_only = (max_cut_current <= 0.0);
+
+      max_cut_current = std::max(max_cut_current, max_cut_lj_wca);
+
       /* no interaction ever touched it, at least no real
          short-ranged one (that writes to the nonbonded energy) */
       data_sym->particlesInteract = data->particlesInteract =
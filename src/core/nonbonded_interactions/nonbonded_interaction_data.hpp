@@ -75,6 +75,10 @@ struct IA_parameters {
       e.g. electrostatics. */
   int particlesInteract;
 
+  /** flag that tells whether Lennard-Jones and WCA are the only
+      short-ranged interactions set for this pair. */
+  bool lj_wca_only = true;
+
 #ifdef LENNARD_JONES_GENERIC
   /** \name Generic Lennard-Jones with shift */
   /*@{*/
@@ -44,6 +44,7 @@
 
 #include <utils/Cache.hpp>
 #include <utils/constants.hpp>
+#include <utils/mpi/gather_buffer.hpp>
 #include <utils/mpi/gatherv.hpp>
 
 #include <boost/range/algorithm.hpp>
@@ -51,9 +52,13 @@
 #include <boost/serialization/vector.hpp>
 #include <boost/variant.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 /************************************************
@@ -833,6 +838,307 @@ void prefetch_particle_data(std::vector<int> ids) {
                            std::make_move_iterator(parts.begin()));
 }
 
+int bulk_property_size(BulkProperty prop) {
+  switch (prop) {
+  case BulkProperty::POS:
+  case BulkProperty::V:
+  case BulkProperty::F:
+    return 3;
+  case BulkProperty::Q:
+  case BulkProperty::TYPE:
+    return 1;
+  }
+  throw std::runtime_error("Unknown particle property.");
+}
+
+namespace {
+/** Copy a property of the local particles @p ids to @p values. */
+void local_get_particles_property(std::vector<int> const &ids,
+                                  BulkProperty prop,
+                                  std::vector<double> &values) {
+  auto const size = bulk_property_size(prop);
+  values.resize(size * ids.size());
+
+  auto out = values.begin();
+  for (auto const &id : ids) {
+    assert(local_particles[id]);
+    auto const &p = *local_particles[id];
+
+    switch (prop) {
+    case BulkProperty::POS:
+      out = std::copy_n(
+          unfolded_position(p.r.p, p.l.i, box_geo.length()).begin(), 3, out);
+      break;
+    case BulkProperty::V:
+      out = std::copy_n(p.m.v.begin(), 3, out);
+      break;
+    case BulkProperty::F:
+      out = std::copy_n(p.f.f.begin(), 3, out);
+      break;
+    case BulkProperty::Q:
+      *out++ = p.p.q;
+      break;
+    case BulkProperty::TYPE:
+      *out++ = p.p.type;
+      break;
+    }
+  }
+}
+
+/** Set a property of the local particles @p ids from @p values. */
+void local_set_particles_property(std::vector<int> const &ids,
+                                  BulkProperty prop,
+                                  std::vector<double> const &values) {
+  auto const size = bulk_property_size(prop);
+  assert(values.size() == size * ids.size());
+
+  auto in = values.begin();
+  for (auto const &id : ids) {
+    assert(local_particles[id]);
+    auto &p = *local_particles[id];
+
+    switch (prop) {
+    case BulkProperty::POS:
+      local_place_particle(id, {in[0], in[1], in[2]}, 0);
+      break;
+    case BulkProperty::V:
+      std::copy_n(in, 3, p.m.v.begin());
+      break;
+    case BulkProperty::F:
+      std::copy_n(in, 3, p.f.f.begin());
+      break;
+    case BulkProperty::Q:
+#ifdef ELECTROSTATICS
+      p.p.q = *in;
+#endif
+      break;
+    case BulkProperty::TYPE:
+      p.p.type = static_cast<int>(*in);
+      break;
+    }
+    in += size;
+  }
+
+  if (prop == BulkProperty::POS)
+    set_resort_particles(Cells::RESORT_GLOBAL);
+  on_particle_change();
+}
+
+/** Create particles on this node. If a position is not in the local
+ *  domain, e.g. because of rounding or because the cell system does
+ *  not distribute the particles by position, the particle is kept
+ *  in a local cell until the next global resort.
+ */
+void local_place_new_particles(std::vector<int> const &ids,
+                               std::vector<double> const &pos) {
+  for (std::size_t i = 0; i < ids.size(); i++) {
+    auto const p_pos =
+        Utils::Vector3d{pos[3 * i], pos[3 * i + 1], pos[3 * i + 2]};
+
+    if (not local_place_particle(ids[i], p_pos, 1)) {
+      Particle new_part;
+      new_part.p.identity = ids[i];
+      new_part.r.p = p_pos;
+      fold_position(new_part.r.p, new_part.l.i, box_geo);
+      append_indexed_particle(local_cells.cell[0], std::move(new_part));
+    }
+  }
+
+  set_resort_particles(Cells::RESORT_GLOBAL);
+  on_particle_change();
+}
+
+/** Bookkeeping for new particles on all nodes, see \ref added_particle. */
+void added_particles(int n_new, int max_id) {
+  n_part += n_new;
+
+  if (max_id > max_seen_particle) {
+    realloc_local_particles(max_id);
+    max_seen_particle = max_id;
+  }
+}
+
+/** Group the ids and values of particles by the node of the particle. */
+void group_by_node(std::vector<int> const &ids, std::vector<int> const &nodes,
+                   std::vector<double> const &values, int size,
+                   std::vector<std::vector<int>> &node_ids,
+                   std::vector<std::vector<double>> &node_values) {
+  node_ids.assign(comm_cart.size(), {});
+  node_values.assign(comm_cart.size(), {});
+
+  for (std::size_t i = 0; i < ids.size(); i++) {
+    node_ids[nodes[i]].push_back(ids[i]);
+    std::copy_n(values.begin() + size * i, size,
+                std::back_inserter(node_values[nodes[i]]));
+  }
+}
+
+void mpi_get_particles_property_slave(int prop) {
+  std::vector<int> ids;
+  boost::mpi::scatter(comm_cart, ids, 0);
+
+  std::vector<double> values;
+  local_get_particles_property(ids, static_cast<BulkProperty>(prop), values);
+  Utils::Mpi::gather_buffer(values, comm_cart);
+}
+
+void mpi_set_particles_property_slave(int prop) {
+  std::vector<int> ids;
+  std::vector<double> values;
+  boost::mpi::scatter(comm_cart, ids, 0);
+  boost::mpi::scatter(comm_cart, values, 0);
+
+  local_set_particles_property(ids, static_cast<BulkProperty>(prop), values);
+}
+
+void mpi_place_new_particles_slave(int n_new, int max_id) {
+  std::vector<int> ids;
+  std::vector<double> pos;
+  boost::mpi::scatter(comm_cart, ids, 0);
+  boost::mpi::scatter(comm_cart, pos, 0);
+
+  added_particles(n_new, max_id);
+  local_place_new_particles(ids, pos);
+}
+} // namespace
+
+REGISTER_CALLBACK(mpi_get_particles_property_slave)
+REGISTER_CALLBACK(mpi_set_particles_property_slave)
+REGISTER_CALLBACK(mpi_place_new_particles_slave)
+
+std::vector<double> get_particles_property(std::vector<int> const &ids,
+                                           BulkProperty prop) {
+  if (ids.empty())
+    return {};
+
+  auto const size = bulk_property_size(prop);
+
+  /* Group ids per node, and remember where they go */
+  std::vector<std::vector<int>> node_ids(comm_cart.size());
+  std::vector<std::vector<int>> node_index(comm_cart.size());
+  for (std::size_t i = 0; i < ids.size(); i++) {
+    auto const pnode = get_particle_node(ids[i]);
+
+    node_ids[pnode].push_back(ids[i]);
+    node_index[pnode].push_back(i);
+  }
+
+  mpi_call(mpi_get_particles_property_slave, static_cast<int>(prop));
+
+  std::vector<int> local_ids;
+  boost::mpi::scatter(comm_cart, node_ids, local_ids, 0);
+
+  std::vector<double> node_values;
+  local_get_particles_property(local_ids, prop, node_values);
+  Utils::Mpi::gather_buffer(node_values, comm_cart);
+
+  /* The values arrive ordered by node */
+  std::vector<double> values(size * ids.size());
+  auto in = node_values.begin();
+  for (auto const &index : node_index) {
+    for (auto const &i : index) {
+      in = std::next(in, size);
+      std::copy(std::prev(in, size), in, values.begin() + size * i);
+    }
+  }
+
+  return values;
+}
+
+void set_particles_property(std::vector<int> const &ids, BulkProperty prop,
+                            std::vector<double> const &values) {
+  auto const size = bulk_property_size(prop);
+  if (values.size() != size * ids.size())
+    throw std::invalid_argument("Wrong number of values.");
+  if (ids.empty())
+    return;
+
+  std::vector<int> nodes(ids.size());
+  std::transform(ids.begin(), ids.end(), nodes.begin(), get_particle_node);
+
+  if (prop == BulkProperty::TYPE) {
+    if (std::any_of(values.begin(), values.end(),
+                    [](double type) { return type < 0; }))
+      throw std::invalid_argument("Particle types have to be >= 0.");
+
+    make_particle_type_exist(
+        static_cast<int>(*std::max_element(values.begin(), values.end())));
+
+    if (type_list_enable) {
+      auto const old_types = get_particles_property(ids, prop);
+      for (std::size_t i = 0; i < ids.size(); i++) {
+        if (old_types[i] != values[i])
+          remove_id_from_map(ids[i], static_cast<int>(old_types[i]));
+        add_id_to_type_map(ids[i], static_cast<int>(values[i]));
+      }
+    }
+  }
+
+  std::vector<std::vector<int>> node_ids;
+  std::vector<std::vector<double>> node_values;
+  group_by_node(ids, nodes, values, size, node_ids, node_values);
+
+  mpi_call(mpi_set_particles_property_slave, static_cast<int>(prop));
+
+  std::vector<int> local_ids;
+  std::vector<double> local_values;
+  boost::mpi::scatter(comm_cart, node_ids, local_ids, 0);
+  boost::mpi::scatter(comm_cart, node_values, local_values, 0);
+
+  local_set_particles_property(local_ids, prop, local_values);
+}
+
+void place_new_particles(std::vector<int> const &ids,
+                         std::vector<double> const &pos) {
+  if (pos.size() != 3 * ids.size())
+    throw std::invalid_argument("Wrong number of positions.");
+  if (ids.empty())
+    return;
+
+  auto sorted_ids = ids;
+  std::sort(sorted_ids.begin(), sorted_ids.end());
+  if (sorted_ids.front() < 0)
+    throw std::invalid_argument("Particle ids have to be >= 0.");
+  if (std::adjacent_find(sorted_ids.begin(), sorted_ids.end()) !=
+      sorted_ids.end())
+    throw std::invalid_argument("Duplicate particle ids.");
+  /* Not particle_exists(), which gathers the particle nodes
+   * for every id as long as there are no particles. */
+  if (particle_node.empty())
+    build_particle_node();
+  for (auto const &id : sorted_ids) {
+    if (particle_node.count(id))
+      throw std::invalid_argument("Particle " + std::to_string(id) +
+                                  " already exists.");
+  }
+
+  std::vector<int> nodes(ids.size());
+  for (std::size_t i = 0; i < ids.size(); i++) {
+    nodes[i] = map_position_node_array(
+        {pos[3 * i], pos[3 * i + 1], pos[3 * i + 2]});
+  }
+
+  std::vector<std::vector<int>> node_ids;
+  std::vector<std::vector<double>> node_pos;
+  group_by_node(ids, nodes, pos, 3, node_ids, node_pos);
+
+  auto const n_new = static_cast<int>(ids.size());
+  auto const max_id = sorted_ids.back();
+  mpi_call(mpi_place_new_particles_slave, n_new, max_id);
+
+  std::vector<int> local_ids;
+  std::vector<double> local_pos;
+  boost::mpi::scatter(comm_cart, node_ids, local_ids, 0);
+  boost::mpi::scatter(comm_cart, node_pos, local_pos, 0);
+
+  added_particles(n_new, max_id);
+  local_place_new_particles(local_ids, local_pos);
+
+  for (std::size_t i = 0; i < ids.size(); i++) {
+    particle_node[ids[i]] = nodes[i];
+  }
+}
+
 int place_particle(int part, const double *pos) {
   Utils::Vector3d p{pos[0], pos[1], pos[2]};
 
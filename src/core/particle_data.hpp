@@ -209,6 +209,56 @@ struct ParticleProperties {
   Utils::Vector3d ext_torque = {0, 0, 0};
 #endif
 #endif
+
+  /** Compare all members, without the padding. */
+  bool operator==(ParticleProperties const &rhs) const {
+    return identity == rhs.identity and mol_id == rhs.mol_id and
+           type == rhs.type
+#ifdef MASS
+           and mass == rhs.mass
+#endif
+#ifdef ROTATIONAL_INERTIA
+           and rinertia == rhs.rinertia
+#endif
+#ifdef AFFINITY
+           and bond_site == rhs.bond_site
+#endif
+#ifdef MEMBRANE_COLLISION
+           and out_direction == rhs.out_direction
+#endif
+           and rotation == rhs.rotation
+#ifdef ELECTROSTATICS
+           and q == rhs.q
+#endif
+#ifdef LB_ELECTROHYDRODYNAMICS
+           and mu_E == rhs.mu_E
+#endif
+#ifdef DIPOLES
+           and dipm == rhs.dipm
+#endif
+#ifdef VIRTUAL_SITES
+           and is_virtual == rhs.is_virtual
+#ifdef VIRTUAL_SITES_RELATIVE
+           and vs_relative.to_particle_id == rhs.vs_relative.to_particle_id and
+           vs_relative.distance == rhs.vs_relative.distance and
+           vs_relative.rel_orientation == rhs.vs_relative.rel_orientation and
+           vs_relative.quat == rhs.vs_relative.quat
+#endif
+#endif
+#ifdef LANGEVIN_PER_PARTICLE
+           and T == rhs.T and gamma == rhs.gamma
+#ifdef ROTATION
+           and gamma_rot == rhs.gamma_rot
+#endif
+#endif
+#ifdef EXTERNAL_FORCES
+           and ext_flag == rhs.ext_flag and ext_force == rhs.ext_force
+#ifdef ROTATION
+           and ext_torque == rhs.ext_torque
+#endif
+#endif
+        ;
+  }
 };
 
 /** Positional information on a particle. Information that is
@@ -233,6 +283,17 @@ struct ParticlePosition {
   /**stores the particle position at the previous time step*/
   Utils::Vector3d p_old = {0., 0., 0.};
 #endif
+
+  bool operator==(ParticlePosition const &rhs) const {
+    return p == rhs.p
+#ifdef ROTATION
+           and quat == rhs.quat
+#endif
+#ifdef BOND_CONSTRAINT
+           and p_old == rhs.p_old
+#endif
+        ;
+  }
 };
 
 /** Force information on a particle. Forces of ghost particles are
@@ -262,6 +323,14 @@ struct ParticleForce {
   /** torque */
   Utils::Vector3d torque = {0., 0., 0.};
 #endif
+
+  bool operator==(ParticleForce const &rhs) const {
+    return f == rhs.f
+#ifdef ROTATION
+           and torque == rhs.torque
+#endif
+        ;
+  }
 };
 
 /** Momentum information on a particle. Information not contained in
@@ -276,6 +345,14 @@ struct ParticleMomentum {
       ALWAYS IN PARTICLE FIXED, I.E., CO-ROTATING COORDINATE SYSTEM */
   Utils::Vector3d omega = {0., 0., 0.};
 #endif
+
+  bool operator==(ParticleMomentum const &rhs) const {
+    return v == rhs.v
+#ifdef ROTATION
+           and omega == rhs.omega
+#endif
+        ;
+  }
 };
 
 /** Information on a particle that is needed only on the
@@ -289,6 +366,10 @@ struct ParticleLocal {
 
   /** check whether a particle is a ghost or not */
   int ghost = 0;
+
+  bool operator==(ParticleLocal const &rhs) const {
+    return p_old == rhs.p_old and i == rhs.i and ghost == rhs.ghost;
+  }
 };
 
 struct ParticleParametersSwimming {
@@ -308,6 +389,18 @@ struct ParticleParametersSwimming {
 #ifdef ENGINE
     ar &swimming &f_swim &v_swim &push_pull &dipole_length &v_center &v_source
         &rotational_friction;
+#endif
+  }
+
+  bool operator==(ParticleParametersSwimming const &rhs) const {
+#ifdef ENGINE
+    return swimming == rhs.swimming and f_swim == rhs.f_swim and
+           v_swim == rhs.v_swim and push_pull == rhs.push_pull and
+           dipole_length == rhs.dipole_length and v_center == rhs.v_center and
+           v_source == rhs.v_source and
+           rotational_friction == rhs.rotational_friction;
+#else
+    return true;
 #endif
   }
 };
@@ -350,6 +443,23 @@ struct Particle {
     return ret;
   }
 
+  /**
+   * @brief Compare the parts of the particle that
+   *        flat_copy copies, member by member.
+   *
+   * Unlike a bytewise comparison, this does not
+   * depend on the padding bytes, which are not
+   * kept by copies.
+   */
+  bool flat_equal(Particle const &rhs) const {
+    return p == rhs.p and r == rhs.r and m == rhs.m and f == rhs.f and
+           l == rhs.l
+#ifdef ENGINE
+           and swim == rhs.swim
+#endif
+        ;
+  }
+
   ///
   ParticleProperties p;
   ///
@@ -578,6 +688,58 @@ void prefetch_particle_data(std::vector<int> ids);
 /** @brief Invalidate the fetch cache for get_particle_data. */
 void invalidate_fetch_cache();
 
+/** Particle properties that can be accessed for many particles at once,
+ *  see \ref get_particles_property and \ref set_particles_property.
+ */
+enum class BulkProperty : int {
+  /** unfolded position, 3 values */
+  POS,
+  /** velocity, 3 values */
+  V,
+  /** force, 3 values */
+  F,
+  /** charge, 1 value */
+  Q,
+  /** type, 1 value */
+  TYPE
+};
+
+/** Number of values per particle of a \ref BulkProperty. */
+int bulk_property_size(BulkProperty prop);
+
+/** Call only on the master node.
+ *  Get a property of many particles with one collective exchange,
+ *  instead of one message per particle.
+ *  @param ids   identities of the particles, which have to exist
+ *  @param prop  the property
+ *  @return the values in the order of @p ids, with
+ *          \ref bulk_property_size values per particle
+ */
+std::vector<double> get_particles_property(std::vector<int> const &ids,
+                                           BulkProperty prop);
+
+/** Call only on the master node.
+ *  Set a property of many particles with one collective exchange,
+ *  instead of one message per particle. Setting the charge has no
+ *  effect without ELECTROSTATICS, like \ref set_particle_q.
+ *  @param ids     identities of the particles, which have to exist
+ *  @param prop    the property
+ *  @param values  the values in the order of @p ids, with
+ *                 \ref bulk_property_size values per particle
+ */
+void set_particles_property(std::vector<int> const &ids, BulkProperty prop,
+                            std::vector<double> const &values);
+
+/** Call only on the master node.
+ *  Create many particles with one collective exchange. The particles
+ *  are sent to the node of their position, and end up on the right node
+ *  at the next global resort at the latest.
+ *  @param ids  identities of the new particles, which must not exist
+ *  @param pos  their positions, 3 values per particle
+ */
+void place_new_particles(std::vector<int> const &ids,
+                         std::vector<double> const &pos);
+
 /** Call only on the master node.
  *  Move a particle to a new position.
  *  If it does not exist, it is created.
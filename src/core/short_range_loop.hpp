@@ -19,18 +19,28 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef CORE_SHORT_RANGE_HPP
 #define CORE_SHORT_RANGE_HPP
 
+#include "algorithm/for_each_cell_colored.hpp"
 #include "algorithm/for_each_pair.hpp"
+#include "algorithm/link_cell_soa.hpp"
 #include "cells.hpp"
 #include "collision.hpp"
+#include "domain_decomposition.hpp"
 #include "electrostatics_magnetostatics/coulomb.hpp"
 #include "electrostatics_magnetostatics/dipole.hpp"
+#include "forces.hpp"
 #include "grid.hpp"
 #include "integrate.hpp"
 
 #include <boost/iterator/indirect_iterator.hpp>
 #include <profiler/profiler.hpp>
 
+#include <iterator>
 #include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 /**
  * @brief Distance vector and length handed to pair kernels.
@@ -105,16 +115,136 @@ void decide_distance(CellIterator first, CellIterator last,
 }
 } // namespace detail
 
+/**
+ * @brief Whether the short range loop runs on the packed
+ *        particle data of the cells, see @ref CellSoA.
+ */
+inline bool short_range_loop_uses_soa() {
+  return cell_structure.use_soa && !cell_structure.use_verlet_list &&
+         cell_structure.type == CELL_STRUCTURE_DOMDEC;
+}
+
+/**
+ * @brief Whether the short range loop can be distributed
+ *        over threads, which needs OpenMP and the domain
+ *        decomposition.
+ */
+inline bool short_range_loop_can_thread() {
+#ifdef _OPENMP
+  return (cell_structure.type == CELL_STRUCTURE_DOMDEC) &&
+         (omp_get_max_threads() > 1);
+#else
+  return false;
+#endif
+}
+
+namespace detail {
+/**
+ * @brief Call the kernel with ranges of local cells.
+ *
+ * If threaded, the kernel is called concurrently for single
+ * cells of the same color (see DomainDecomposition::cell_colors),
+ * and the particle kernel, which is not required to be thread safe,
+ * is run for the particles of the cells before. Otherwise the kernel
+ * is called once with all the cells.
+ *
+ * If the ghost update is still in flight (see @ref
+ * cells_update_ghosts_begin), the interior cells, which do not need
+ * the ghosts, are done first. Then the update is completed, the
+ * ghost forces are initialized (which @ref init_forces skips while
+ * the update is pending) and the boundary cells are done.
+ */
+template <typename ParticleKernel, typename CellRangeKernel>
+void for_local_cells(bool threaded, ParticleKernel &&particle_kernel,
+                     CellRangeKernel &&kernel) {
+  auto const for_cells = [threaded, &particle_kernel, &kernel](
+                             Cell *const *first, Cell *const *last,
+                             std::vector<std::vector<Cell *>> const &colors) {
+    if (threaded) {
+      for (auto c = first; c != last; ++c) {
+        for (int i = 0; i < (*c)->n; i++) {
+          particle_kernel((*c)->part[i]);
+        }
+      }
+
+      Algorithm::for_each_cell_colored(
+          colors.begin(), colors.end(), [&kernel](Cell *const &c) {
+            auto cell = boost::make_indirect_iterator(&c);
+            kernel(cell, std::next(cell));
+          });
+    } else {
+      kernel(boost::make_indirect_iterator(first),
+             boost::make_indirect_iterator(last));
+    }
+  };
+
+  if (cells_ghosts_pending() &&
+      cell_structure.type == CELL_STRUCTURE_DOMDEC) {
+    for_cells(dd.interior_cells.data(),
+              dd.interior_cells.data() + dd.interior_cells.size(),
+              dd.interior_colors);
+    cells_update_ghosts_finish();
+    init_forces_ghosts();
+    for_cells(dd.boundary_cells.data(),
+              dd.boundary_cells.data() + dd.boundary_cells.size(),
+              dd.boundary_colors);
+  } else {
+    cells_update_ghosts_finish();
+    for_cells(local_cells.begin(), local_cells.end(), dd.cell_colors);
+  }
+}
+} // namespace detail
+
+/**
+ * @brief Short range loop with a kernel that processes a particle
+ *        against a block of partner particles at once,
+ *        see @ref Algorithm::link_cell_blocks.
+ *
+ * Only valid if @ref short_range_loop_uses_soa is true.
+ * See @ref short_range_loop for the thread_safe argument.
+ */
+template <typename ParticleKernel, typename BlockKernel>
+void short_range_block_loop(ParticleKernel &&particle_kernel,
+                            BlockKernel &&block_kernel,
+                            bool thread_safe = false) {
+  ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
+
+  assert(get_resort_particles() == Cells::RESORT_NONE);
+  assert(short_range_loop_uses_soa());
+
+  auto const threaded = thread_safe && short_range_loop_can_thread();
+
+  detail::for_local_cells(threaded, particle_kernel, [&](auto first, auto last) {
+    Algorithm::link_cell_blocks(
+        first, last,
+        [threaded, &particle_kernel](Particle &p) {
+          if (not threaded)
+            particle_kernel(p);
+        },
+        block_kernel);
+  });
+
+  rebuild_verletlist = 0;
+}
+
+/**
+ * @brief Run the kernels on all local particles and all pairs
+ *        within the interaction range.
+ *
+ * If thread_safe is set, the pair kernel only writes to the
+ * two particles it is called with. In this case the pairs
+ * are distributed over the OpenMP threads, if available.
+ * The particle kernel is then run for the particles of the
+ * cells before their pairs, since it is not required to be
+ * thread safe.
+ */
 template <typename ParticleKernel, typename PairKernel>
 void short_range_loop(ParticleKernel &&particle_kernel,
-                      PairKernel &&pair_kernel) {
+                      PairKernel &&pair_kernel, bool thread_safe = false) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
 
   assert(get_resort_particles() == Cells::RESORT_NONE);
 
-  auto first = boost::make_indirect_iterator(local_cells.begin());
-  auto last = boost::make_indirect_iterator(local_cells.end());
-
 #ifdef ELECTROSTATICS
   auto const coulomb_cutoff = Coulomb::cutoff(box_geo.length());
 #else
@@ -127,11 +257,34 @@ void short_range_loop(ParticleKernel &&particle_kernel,
   auto const dipole_cutoff = INACTIVE_CUTOFF;
 #endif
 
-  detail::decide_distance(
-      first, last, std::forward<ParticleKernel>(particle_kernel),
-      std::forward<PairKernel>(pair_kernel),
+  auto const threaded = thread_safe && short_range_loop_can_thread();
+
+  auto cell_particle_kernel = [threaded, &particle_kernel](Particle &p) {
+    if (not threaded)
+      particle_kernel(p);
+  };
+  auto const verlet_criterion =
       VerletCriterion{skin, max_cut, coulomb_cutoff, dipole_cutoff,
-                      collision_detection_cutoff()});
+                      collision_detection_cutoff()};
+
+  detail::for_local_cells(threaded, particle_kernel, [&](auto first, auto last) {
+    /* Without Verlet lists, the domain decomposition can run on the
+       packed particle data. Pairs beyond the Verlet range are skipped,
+       which are the pairs a Verlet list would not contain either. */
+    if (short_range_loop_uses_soa()) {
+      Algorithm::link_cell_soa(
+          first, last, cell_particle_kernel,
+          [&pair_kernel](Particle &p1, Particle &p2,
+                         Utils::Vector3d const &vec21) {
+            Distance d(vec21);
+            pair_kernel(p1, p2, d);
+          },
+          max_cut + skin);
+    } else {
+      detail::decide_distance(first, last, cell_particle_kernel, pair_kernel,
+                              verlet_criterion);
+    }
+  });
 
   rebuild_verletlist = 0;
 }
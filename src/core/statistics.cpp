@@ -26,6 +26,8 @@
 
 #include "statistics.hpp"
 
+#include "algorithm/link_cell.hpp"
+#include "cells.hpp"
 #include "communication.hpp"
 #include "energy.hpp"
 #include "errorhandling.hpp"
@@ -41,12 +43,19 @@
 #include "statistics_chain.hpp"
 #include "virtual_sites.hpp"
 
+#include <boost/mpi/collectives/all_gather.hpp>
+#include <boost/mpi/collectives/reduce.hpp>
+#include <boost/mpi/operations.hpp>
+#include <boost/serialization/vector.hpp>
+
 #include <utils/NoOp.hpp>
 #include <utils/constants.hpp>
 #include <utils/contains.hpp>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <limits>
 
 /** Previous particle configurations (needed for offline analysis and
@@ -62,9 +71,75 @@ int n_part_conf = 0;
  *                                 basic observables calculation
  ****************************************************************************************/
 
-double mindist(PartCfg &partCfg, IntList const &set1, IntList const &set2) {
+namespace {
+/** Range up to which the pair loop of the cell system visits all pairs. */
+double cell_system_pair_range() {
+  return (cell_structure.type == CELL_STRUCTURE_NSQUARE)
+             ? std::numeric_limits<double>::infinity()
+             : max_cut;
+}
+
+/** Call @p pair_kernel for all pairs of the local particles with each other
+ *  and with the ghosts that the cell system provides, like @ref
+ *  mpi_get_pairs. Every pair closer than @ref cell_system_pair_range is
+ *  visited exactly once on one of the nodes.
+ */
+template <class PairKernel> void for_each_cell_system_pair(PairKernel &&kernel) {
+  cells_update_ghosts();
+
+  auto first = boost::make_indirect_iterator(local_cells.begin());
+  auto last = boost::make_indirect_iterator(local_cells.end());
+
+  switch (cell_structure.type) {
+  case CELL_STRUCTURE_DOMDEC:
+    Algorithm::link_cell(first, last, Utils::NoOp{}, kernel,
+                         detail::EuclidianDistance{});
+    break;
+  case CELL_STRUCTURE_NSQUARE:
+    Algorithm::link_cell(first, last, Utils::NoOp{}, kernel,
+                         detail::MinimalImageDistance{box_geo});
+    break;
+  case CELL_STRUCTURE_LAYERED:
+    Algorithm::link_cell(first, last, Utils::NoOp{}, kernel,
+                         detail::LayeredMinimalImageDistance{box_geo});
+    break;
+  }
+}
+
+double mindist2_local(std::vector<int> set1, std::vector<int> set2) {
+  auto const in_set = [](std::vector<int> const &set, int type) {
+    return set.empty() || Utils::contains(set, type);
+  };
+
   auto mindist2 = std::numeric_limits<double>::infinity();
+  for_each_cell_system_pair(
+      [&](Particle const &p1, Particle const &p2, Distance const &d) {
+        if ((in_set(set1, p1.p.type) && in_set(set2, p2.p.type)) ||
+            (in_set(set2, p1.p.type) && in_set(set1, p2.p.type)))
+          mindist2 = std::min(mindist2, d.dist2);
+      });
+
+  return mindist2;
+}
+} // namespace
+
+REGISTER_CALLBACK_REDUCTION(mindist2_local, boost::mpi::minimum<double>())
 
+double mindist(PartCfg &partCfg, IntList const &set1, IntList const &set2) {
+  /* All pairs within the range of the cell system are found in parallel,
+     so if the minimum is within that range, it is exact. */
+  auto const range = cell_system_pair_range();
+  if (range > 0.) {
+    auto const mindist2 =
+        mpi_call(Communication::Result::reduction,
+                 boost::mpi::minimum<double>(), mindist2_local,
+                 std::vector<int>(set1.begin(), set1.end()),
+                 std::vector<int>(set2.begin(), set2.end()));
+    if (mindist2 <= range * range)
+      return std::sqrt(mindist2);
+  }
+
+  auto mindist2 = std::numeric_limits<double>::infinity();
   for (auto jt = partCfg.begin(); jt != partCfg.end(); ++jt) {
     /* check which sets particle j belongs to
        bit 0: set1, bit1: set2
@@ -279,156 +354,277 @@ void calc_part_distribution(PartCfg &partCfg, int const *p1_types, int n_p1,
     dist[i] /= (double)cnt;
 }
 
-void calc_rdf(PartCfg &partCfg, std::vector<int> const &p1_types,
-              std::vector<int> const &p2_types, double r_min, double r_max,
-              int r_bins, std::vector<double> &rdf) {
-  calc_rdf(partCfg, &p1_types[0], p1_types.size(), &p2_types[0],
-           p2_types.size(), r_min, r_max, r_bins, &rdf[0]);
+namespace {
+/** Distance histogram of the pairs of particles of two sets of types,
+ *  see @ref calc_rdf.
+ */
+class RDFHistogram {
+public:
+  RDFHistogram(std::vector<int> const &p1_types,
+               std::vector<int> const &p2_types, double r_min, double r_max,
+               int r_bins)
+      : m_mixed(p1_types != p2_types), m_r_min(r_min), m_r_max(r_max),
+        m_inv_bin_width(r_bins / (r_max - r_min)), m_hist(r_bins, 0.) {
+    for (auto const type : p1_types)
+      add_to_set(type, 1);
+    for (auto const type : p2_types)
+      add_to_set(type, 2);
+  }
+
+  /** Sets a type belongs to, bit 0: first set, bit 1: second set. */
+  int sets(int type) const {
+    if (type < 0 || type >= static_cast<int>(m_sets.size()))
+      return 0;
+    return m_sets[type];
+  }
+
+  /** Whether the two sets differ, in which case the ordered pairs from
+   *  the first into the second set are counted, otherwise every unordered
+   *  pair is counted once.
+   */
+  bool mixed() const { return m_mixed; }
+
+  /** Number of counted pairs of two distinct particles. */
+  int n_pairs(int sets1, int sets2) const {
+    if (not m_mixed)
+      return sets1 & sets2 & 1;
+    return ((sets1 & 1) && (sets2 & 2)) + ((sets2 & 1) && (sets1 & 2));
+  }
+
+  void add(double dist, int n_pairs) {
+    if (n_pairs && dist > m_r_min && dist < m_r_max) {
+      auto const ind = std::min(
+          static_cast<int>((dist - m_r_min) * m_inv_bin_width),
+          static_cast<int>(m_hist.size()) - 1);
+      m_hist[ind] += n_pairs;
+    }
+  }
+
+  std::vector<double> &hist() { return m_hist; }
+
+private:
+  void add_to_set(int type, int set) {
+    if (type < 0)
+      return;
+    if (type >= static_cast<int>(m_sets.size()))
+      m_sets.resize(type + 1, 0);
+    m_sets[type] |= set;
+  }
+
+  std::vector<int> m_sets;
+  bool m_mixed;
+  double m_r_min, m_r_max, m_inv_bin_width;
+  std::vector<double> m_hist;
+};
+
+/** Position, identity and sets of a particle for the all-pairs RDF. */
+struct RDFParticle {
+  Utils::Vector3d pos;
+  int id;
+  int sets;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &pos;
+    ar &id;
+    ar &sets;
+  }
+};
+
+/** Add the pairs of the particles in [@p first, @p last) from the first set
+ *  with all particles @p all from the second set.
+ */
+template <class Iterator>
+void add_all_pairs(RDFHistogram &histogram, Iterator first, Iterator last,
+                   std::vector<RDFParticle> const &all) {
+  for (; first != last; ++first) {
+    auto const &a = *first;
+    if (not(a.sets & 1))
+      continue;
+    for (auto const &b : all) {
+      if (not(b.sets & 2) ||
+          (histogram.mixed() ? (a.id == b.id) : (a.id >= b.id)))
+        continue;
+      histogram.add(get_mi_vector(a.pos, b.pos, box_geo).norm(), 1);
+    }
+  }
 }
 
-void calc_rdf(PartCfg &partCfg, int const *p1_types, int n_p1,
-              int const *p2_types, int n_p2, double r_min, double r_max,
-              int r_bins, double *rdf) {
-  long int cnt = 0;
-  int i, t1, t2, ind;
-  int mixed_flag = 0;
-  double inv_bin_width = 0.0, bin_width = 0.0;
-  double volume, bin_volume, r_in, r_out;
-
-  if (n_p1 == n_p2) {
-    for (i = 0; i < n_p1; i++)
-      if (p1_types[i] != p2_types[i])
-        mixed_flag = 1;
-  } else
-    mixed_flag = 1;
-
-  bin_width = (r_max - r_min) / (double)r_bins;
-  inv_bin_width = 1.0 / bin_width;
-  for (i = 0; i < r_bins; i++)
-    rdf[i] = 0.0;
-  /* particle loop: p1_types*/
-  for (auto it = partCfg.begin(); it != partCfg.end(); ++it) {
-    for (t1 = 0; t1 < n_p1; t1++) {
-      if (it->p.type == p1_types[t1]) {
-        /* distinguish mixed and identical rdf's */
-        auto jt = (mixed_flag == 1) ? partCfg.begin() : std::next(it);
+/** Number of pairs of a histogram, for the normalization of the RDF. */
+double rdf_n_pairs(bool mixed, double n1, double n2) {
+  return mixed ? n1 * n2 : 0.5 * n1 * (n1 - 1.);
+}
 
-        /* particle loop: p2_types*/
-        for (; jt != partCfg.end(); ++jt) {
-          for (t2 = 0; t2 < n_p2; t2++) {
-            if (jt->p.type == p2_types[t2]) {
-              auto const dist = get_mi_vector(it->r.p, jt->r.p, box_geo).norm();
-              if (dist > r_min && dist < r_max) {
-                ind = (int)((dist - r_min) * inv_bin_width);
-                rdf[ind]++;
-              }
-              cnt++;
-            }
-          }
-        }
-      }
+/** Add the histogram @p hist of @p cnt pairs, normalized by the volumes
+ *  of the bins and the box, to @p rdf.
+ */
+void add_normalized_rdf(std::vector<double> const &hist, double cnt,
+                        double r_min, double r_max, double *rdf) {
+  auto const r_bins = static_cast<int>(hist.size());
+  auto const bin_width = (r_max - r_min) / r_bins;
+  auto const volume =
+      box_geo.length()[0] * box_geo.length()[1] * box_geo.length()[2];
+  for (int i = 0; i < r_bins; i++) {
+    auto const r_in = i * bin_width + r_min;
+    auto const r_out = r_in + bin_width;
+    auto const bin_volume = (4.0 / 3.0) * Utils::pi() *
+                            ((r_out * r_out * r_out) - (r_in * r_in * r_in));
+    rdf[i] += hist[i] * volume / (bin_volume * cnt);
+  }
+}
+
+/** Sum of the histograms of all nodes, on the head node. */
+std::vector<double> reduce_histogram(std::vector<double> const &local) {
+  std::vector<double> global;
+  boost::mpi::reduce(comm_cart, local, global, std::plus<double>(), 0);
+  return global;
+}
+
+/** Pair histogram of the local particles, with the numbers of the local
+ *  particles in the two sets appended.
+ *
+ *  If @p r_max is within the range of the cell system, the pairs are taken
+ *  from the cell system. Otherwise the particles of the second set are
+ *  gathered on all nodes and paired with the local particles of the first
+ *  set.
+ */
+std::vector<double> rdf_histogram_local(std::vector<int> const &p1_types,
+                                        std::vector<int> const &p2_types,
+                                        double r_min, double r_max,
+                                        int r_bins) {
+  RDFHistogram histogram(p1_types, p2_types, r_min, r_max, r_bins);
+
+  if (r_max <= cell_system_pair_range()) {
+    auto const r_max2 = r_max * r_max;
+    for_each_cell_system_pair(
+        [&histogram, r_max2](Particle const &p1, Particle const &p2,
+                             Distance const &d) {
+          if (d.dist2 < r_max2)
+            histogram.add(std::sqrt(d.dist2),
+                          histogram.n_pairs(histogram.sets(p1.p.type),
+                                            histogram.sets(p2.p.type)));
+        });
+  } else {
+    std::vector<RDFParticle> local, local_second;
+    for (auto const &p : local_cells.particles()) {
+      auto const sets = histogram.sets(p.p.type);
+      if (sets & 1)
+        local.push_back({p.r.p, p.p.identity, sets});
+      if (sets & 2)
+        local_second.push_back({p.r.p, p.p.identity, sets});
     }
+
+    std::vector<std::vector<RDFParticle>> gathered;
+    boost::mpi::all_gather(comm_cart, local_second, gathered);
+    std::vector<RDFParticle> all;
+    for (auto const &parts : gathered)
+      all.insert(all.end(), parts.begin(), parts.end());
+
+    add_all_pairs(histogram, local.begin(), local.end(), all);
   }
 
-  /* normalization */
-  volume = box_geo.length()[0] * box_geo.length()[1] * box_geo.length()[2];
-  for (i = 0; i < r_bins; i++) {
-    r_in = i * bin_width + r_min;
-    r_out = r_in + bin_width;
-    bin_volume = (4.0 / 3.0) * Utils::pi() *
-                 ((r_out * r_out * r_out) - (r_in * r_in * r_in));
-    rdf[i] *= volume / (bin_volume * cnt);
+  double n1 = 0., n2 = 0.;
+  for (auto const &p : local_cells.particles()) {
+    auto const sets = histogram.sets(p.p.type);
+    n1 += sets & 1;
+    n2 += (sets >> 1) & 1;
   }
+
+  auto result = std::move(histogram.hist());
+  result.push_back(n1);
+  result.push_back(n2);
+  return result;
+}
+
+/** Pair histogram of a stored configuration @p parts, where every node
+ *  handles an equal share of the particles of the first set.
+ */
+std::vector<double> rdf_config_histogram_local(
+    std::vector<RDFParticle> const &parts, std::vector<int> const &p1_types,
+    std::vector<int> const &p2_types, double r_min, double r_max,
+    int r_bins) {
+  RDFHistogram histogram(p1_types, p2_types, r_min, r_max, r_bins);
+
+  auto const n_local = (parts.size() + n_nodes - 1) / n_nodes;
+  auto const first = std::min(this_node * n_local, parts.size());
+  auto const last = std::min(first + n_local, parts.size());
+  add_all_pairs(histogram, parts.begin() + first, parts.begin() + last,
+                parts);
+
+  return std::move(histogram.hist());
+}
+
+void mpi_rdf_histogram_slave(std::vector<int> p1_types,
+                             std::vector<int> p2_types, double r_min,
+                             double r_max, int r_bins) {
+  reduce_histogram(
+      rdf_histogram_local(p1_types, p2_types, r_min, r_max, r_bins));
+}
+
+void mpi_rdf_config_histogram_slave(std::vector<RDFParticle> parts,
+                                    std::vector<int> p1_types,
+                                    std::vector<int> p2_types, double r_min,
+                                    double r_max, int r_bins) {
+  reduce_histogram(rdf_config_histogram_local(parts, p1_types, p2_types, r_min,
+                                              r_max, r_bins));
+}
+} // namespace
+
+REGISTER_CALLBACK(mpi_rdf_histogram_slave)
+REGISTER_CALLBACK(mpi_rdf_config_histogram_slave)
+
+void calc_rdf(std::vector<int> const &p1_types,
+              std::vector<int> const &p2_types, double r_min, double r_max,
+              int r_bins, std::vector<double> &rdf) {
+  mpi_call(mpi_rdf_histogram_slave, p1_types, p2_types, r_min, r_max, r_bins);
+  auto hist = reduce_histogram(
+      rdf_histogram_local(p1_types, p2_types, r_min, r_max, r_bins));
+
+  auto const n2 = hist.back();
+  hist.pop_back();
+  auto const n1 = hist.back();
+  hist.pop_back();
+
+  std::fill(rdf.begin(), rdf.end(), 0.);
+  add_normalized_rdf(hist, rdf_n_pairs(p1_types != p2_types, n1, n2), r_min,
+                     r_max, rdf.data());
 }
 
 void calc_rdf_av(PartCfg &partCfg, std::vector<int> const &p1_types,
                  std::vector<int> const &p2_types, double r_min, double r_max,
                  int r_bins, std::vector<double> &rdf, int n_conf) {
-  calc_rdf_av(partCfg, &p1_types[0], p1_types.size(), &p2_types[0],
-              p2_types.size(), r_min, r_max, r_bins, &rdf[0], n_conf);
-}
+  RDFHistogram const histogram(p1_types, p2_types, r_min, r_max, r_bins);
 
-void calc_rdf_av(PartCfg &partCfg, int const *p1_types, int n_p1,
-                 int const *p2_types, int n_p2, double r_min, double r_max,
-                 int r_bins, double *rdf, int n_conf) {
-  long int cnt = 0;
-  int cnt_conf = 1;
-  int mixed_flag = 0;
-  double inv_bin_width = 0.0, bin_width = 0.0;
-  double volume, bin_volume, r_in, r_out;
-  double *rdf_tmp;
-
-  rdf_tmp = (double *)Utils::malloc(r_bins * sizeof(double));
-
-  if (n_p1 == n_p2) {
-    for (int i = 0; i < n_p1; i++)
-      if (p1_types[i] != p2_types[i])
-        mixed_flag = 1;
-  } else
-    mixed_flag = 1;
-
-  bin_width = (r_max - r_min) / (double)r_bins;
-  inv_bin_width = 1.0 / bin_width;
-  volume = box_geo.length()[0] * box_geo.length()[1] * box_geo.length()[2];
-  for (int l = 0; l < r_bins; l++)
-    rdf_tmp[l] = rdf[l] = 0.0;
-
-  while (cnt_conf <= n_conf) {
-    for (int l = 0; l < r_bins; l++)
-      rdf_tmp[l] = 0.0;
-    cnt = 0;
+  std::fill(rdf.begin(), rdf.end(), 0.);
+  for (int cnt_conf = 1; cnt_conf <= n_conf; cnt_conf++) {
     auto const k = n_configs - cnt_conf;
+
+    /* the types are those of the current configuration */
+    std::vector<RDFParticle> parts;
+    double n1 = 0., n2 = 0.;
     int i = 0;
-    for (auto it = partCfg.begin(); it != partCfg.end(); ++it) {
-      for (int t1 = 0; t1 < n_p1; t1++) {
-        if (it->p.type == p1_types[t1]) {
-          /* distinguish mixed and identical rdf's */
-          auto jt = (mixed_flag == 1) ? partCfg.begin() : std::next(it);
-          int j = (mixed_flag == 1) ? 0 : i + 1;
-
-          // particle loop: p2_types
-          for (; jt != partCfg.end(); ++jt) {
-            for (int t2 = 0; t2 < n_p2; t2++) {
-              if (jt->p.type == p2_types[t2]) {
-                using Utils::make_const_span;
-                using Utils::Vector3d;
-
-                auto const dist =
-                    get_mi_vector(
-                        Vector3d{make_const_span(configs[k] + 3 * i, 3)},
-                        Vector3d{make_const_span(configs[k] + 3 * j, 3)},
-                        box_geo)
-                        .norm();
-                if (dist > r_min && dist < r_max) {
-                  auto const ind =
-                      static_cast<int>((dist - r_min) * inv_bin_width);
-                  rdf_tmp[ind]++;
-                }
-                cnt++;
-              }
-            }
-            j++;
-          }
-        }
+    for (auto const &p : partCfg) {
+      auto const sets = histogram.sets(p.p.type);
+      if (sets) {
+        parts.push_back(
+            {Utils::Vector3d{Utils::make_const_span(configs[k] + 3 * i, 3)},
+             i, sets});
+        n1 += sets & 1;
+        n2 += (sets >> 1) & 1;
       }
       i++;
     }
-    // normalization
-
-    for (int i = 0; i < r_bins; i++) {
-      r_in = i * bin_width + r_min;
-      r_out = r_in + bin_width;
-      bin_volume = (4.0 / 3.0) * Utils::pi() *
-                   ((r_out * r_out * r_out) - (r_in * r_in * r_in));
-      rdf[i] += rdf_tmp[i] * volume / (bin_volume * cnt);
-    }
 
-    cnt_conf++;
-  } // cnt_conf loop
-  for (int i = 0; i < r_bins; i++) {
-    rdf[i] /= (cnt_conf - 1);
+    mpi_call(mpi_rdf_config_histogram_slave, parts, p1_types, p2_types, r_min,
+             r_max, r_bins);
+    auto const hist = reduce_histogram(rdf_config_histogram_local(
+        parts, p1_types, p2_types, r_min, r_max, r_bins));
+    add_normalized_rdf(hist, rdf_n_pairs(histogram.mixed(), n1, n2), r_min,
+                       r_max, rdf.data());
+  }
+
+  for (auto &v : rdf) {
+    v /= n_conf;
   }
-  free(rdf_tmp);
 }
 
 void calc_structurefactor(PartCfg &partCfg, int const *p_types, int n_types,
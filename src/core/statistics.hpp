@@ -52,6 +52,9 @@ extern int n_part_conf;
 
 /** Calculate the minimal distance of two particles with types in set1 resp.
  *  set2.
+ *
+ *  The pairs within the range of the cell system are searched in parallel.
+ *  Only if there is none, all pairs are checked on the head node.
  *  @param set1 types of particles
  *  @param set2 types of particles
  *  @return the minimal distance of two particles
@@ -116,21 +119,20 @@ void calc_part_distribution(PartCfg &, int const *p1_types, int n_p1,
  *  the distribution function is binned into @p r_bin bins, which are
  *  equidistant. The result is stored in the array @p rdf.
  *
- *  @param partCfg  @copybrief PartCfg
+ *  The pair distances are binned on the nodes that own the particles, and
+ *  only the histograms are reduced. If @p r_max is within the interaction
+ *  range of the cell system, the pairs are taken from the cell system.
+ *  Otherwise the particles of @p p2_types are gathered on all nodes.
+ *
  *  @param p1_types list with types of particles to find the distribution for.
- *  @param n_p1     length of @p p1_types.
  *  @param p2_types list with types of particles the others are distributed
  *                  around.
- *  @param n_p2     length of @p p2_types.
  *  @param r_min    Minimal distance for the distribution.
  *  @param r_max    Maximal distance for the distribution.
  *  @param r_bins   Number of bins.
  *  @param rdf      Array to store the result (size: @p r_bins).
  */
-void calc_rdf(PartCfg &partCfg, int const *p1_types, int n_p1,
-              int const *p2_types, int n_p2, double r_min, double r_max,
-              int r_bins, double *rdf);
-void calc_rdf(PartCfg &partCfg, std::vector<int> const &p1_types,
+void calc_rdf(std::vector<int> const &p1_types,
               std::vector<int> const &p2_types, double r_min, double r_max,
               int r_bins, std::vector<double> &rdf);
 
@@ -143,21 +145,19 @@ void calc_rdf(PartCfg &partCfg, std::vector<int> const &p1_types,
  *  the distribution function is binned into @p r_bin bins, which are
  *  equidistant. The result is stored in the array @p rdf.
  *
+ *  The stored configurations only exist on the head node. They are
+ *  broadcast, and the pairs are distributed over all nodes.
+ *
  *  @param partCfg  @copybrief PartCfg
  *  @param p1_types list with types of particles to find the distribution for.
- *  @param n_p1     length of @p p1_types.
  *  @param p2_types list with types of particles the others are distributed
  *                  around.
- *  @param n_p2     length of @p p2_types.
  *  @param r_min    Minimal distance for the distribution.
  *  @param r_max    Maximal distance for the distribution.
  *  @param r_bins   Number of bins.
  *  @param rdf      Array to store the result (size: @p r_bins).
  *  @param n_conf   Number of configurations from the last stored configuration.
  */
-void calc_rdf_av(PartCfg &partCfg, int const *p1_types, int n_p1,
-                 int const *p2_types, int n_p2, double r_min, double r_max,
-                 int r_bins, double *rdf, int n_conf);
 void calc_rdf_av(PartCfg &partCfg, std::vector<int> const &p1_types,
                  std::vector<int> const &p2_types, double r_min, double r_max,
                  int r_bins, std::vector<double> &rdf, int n_conf);
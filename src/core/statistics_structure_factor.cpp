@@ -0,0 +1,279 @@
+/*
+  Copyright (C) 2019 The ESPResSo project
+
+  This file is part of ESPResSo.
+
+  ESPResSo is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** \file
+ *
+ *  The corresponding header file is statistics_structure_factor.hpp.
+ */
+#include "statistics_structure_factor.hpp"
+
+#if defined(P3M) || defined(DP3M)
+
+#include "cells.hpp"
+#include "communication.hpp"
+#include "electrostatics_magnetostatics/fft.hpp"
+#include "electrostatics_magnetostatics/p3m-common.hpp"
+#include "errorhandling.hpp"
+#include "global.hpp"
+#include "grid.hpp"
+#include "integrate.hpp"
+
+#include <utils/math/sinc.hpp>
+#include <utils/math/sqr.hpp>
+
+#include <boost/mpi/collectives/reduce.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace {
+/* After the FFT the data is in order YZX, see p3m.cpp. */
+constexpr int KX = 2;
+
+/** Mesh, FFT plans and buffers of the density, kept between the calls as
+ *  long as the mesh and the geometry do not change.
+ */
+struct DensityMesh {
+  P3MParameters params;
+  p3m_local_mesh local_mesh;
+  p3m_send_mesh sm;
+  fft_data_struct fft;
+  double *rs_mesh = nullptr;
+  std::vector<double> send_grid;
+  std::vector<double> recv_grid;
+  int ks_pnum = 0;
+  /** offset of the first mesh point of the charge assignment stencil */
+  double pos_shift = 0.;
+
+  /** geometry the mesh was set up for */
+  Utils::Vector3d box_l = {};
+  Utils::Vector3i grid = {};
+  double skin = -1.;
+};
+
+DensityMesh density_mesh;
+
+void density_mesh_init(int mesh, int cao) {
+  auto &dm = density_mesh;
+  if (dm.params.mesh[0] == mesh && dm.params.cao == cao &&
+      dm.box_l == box_geo.length() && dm.grid == node_grid &&
+      dm.skin == skin)
+    return;
+
+  dm.box_l = box_geo.length();
+  dm.grid = node_grid;
+  dm.skin = skin;
+
+  dm.params.cao = cao;
+  dm.params.cao3 = cao * cao * cao;
+  for (int i = 0; i < 3; i++) {
+    dm.params.mesh[i] = mesh;
+    dm.params.ai[i] = mesh / box_geo.length()[i];
+    dm.params.a[i] = 1.0 / dm.params.ai[i];
+    dm.params.cao_cut[i] = 0.5 * dm.params.a[i] * cao;
+  }
+
+  p3m_calc_local_ca_mesh(dm.local_mesh, dm.params, local_geo.my_left(),
+                         local_geo.my_right(), skin);
+  for (int i = 0; i < 3; i++) {
+    dm.local_mesh.ld_pos[i] =
+        (dm.local_mesh.ld_ind[i] + dm.params.mesh_off[i]) * dm.params.a[i];
+  }
+  p3m_calc_send_mesh(dm.local_mesh, dm.sm, comm_cart);
+  dm.send_grid.resize(dm.sm.max);
+  dm.recv_grid.resize(dm.sm.max);
+
+  fft_init(&dm.rs_mesh, dm.local_mesh.dim, dm.local_mesh.margin,
+           dm.params.mesh, dm.params.mesh_off, &dm.ks_pnum, dm.fft, node_grid,
+           comm_cart);
+
+  dm.pos_shift = std::floor((cao - 1) / 2.0) - (cao % 2) / 2.0;
+}
+
+/** Add a unit weight at @p pos to the local mesh. */
+void assign_density(Utils::Vector3d const &pos) {
+  auto const &dm = density_mesh;
+  auto const cao = dm.params.cao;
+  double caf[3][7];
+  int ind = 0;
+
+  for (int d = 0; d < 3; d++) {
+    /* position in mesh coordinates */
+    auto const x = ((pos[d] - dm.local_mesh.ld_pos[d]) * dm.params.ai[d]) -
+                   dm.pos_shift;
+    /* nearest mesh point */
+    auto const nmp = static_cast<int>(x);
+    ind = (d == 0) ? nmp : nmp + dm.local_mesh.dim[d] * ind;
+    for (int i = 0; i < cao; i++)
+      caf[d][i] = p3m_caf(i, (x - nmp) - 0.5, cao);
+  }
+
+  for (int i0 = 0; i0 < cao; i0++) {
+    for (int i1 = 0; i1 < cao; i1++) {
+      auto *mesh_line = dm.rs_mesh + ind;
+      auto const w01 = caf[0][i0] * caf[1][i1];
+      for (int i2 = 0; i2 < cao; i2++) {
+        mesh_line[i2] += w01 * caf[2][i2];
+      }
+      ind += cao + dm.local_mesh.q_2_off;
+    }
+    ind += dm.local_mesh.q_21_off;
+  }
+}
+
+/** Sum of the squared Fourier transformed assignment function over the
+ *  aliases of the wave vector @p n in one direction.
+ */
+double aliasing_sum(int n, int mesh, int cao) {
+  double sum = 0.;
+  for (int m = -P3M_BRILLOUIN - 1; m <= P3M_BRILLOUIN + 1; m++) {
+    sum += std::pow(Utils::sinc(static_cast<double>(n) / mesh + m), 2 * cao);
+  }
+  return sum;
+}
+
+/** Local part of the structure factor sums, with the local number of
+ *  particles appended.
+ */
+std::vector<double> structurefactor_mesh_local(std::vector<int> const &p_types,
+                                               int order, int mesh, int cao) {
+  /* particles moved since the last integration may still sit on their old
+   * node, outside of the local mesh */
+  cells_update_ghosts();
+  density_mesh_init(mesh, cao);
+  auto &dm = density_mesh;
+
+  std::fill_n(dm.rs_mesh, dm.local_mesh.size, 0.);
+  double n_part = 0.;
+  for (auto const &p : local_cells.particles()) {
+    auto const n = std::count(p_types.begin(), p_types.end(), p.p.type);
+    for (int i = 0; i < n; i++) {
+      assign_density(p.r.p);
+    }
+    n_part += n;
+  }
+
+  p3m_gather_fft_grid(dm.rs_mesh, dm.local_mesh, dm.sm, dm.send_grid,
+                      dm.recv_grid, comm_cart);
+  fft_perform_forw(dm.rs_mesh, dm.fft, comm_cart);
+
+  std::vector<double> alias(mesh), shift(mesh);
+  for (int i = 0; i < mesh; i++) {
+    shift[i] = (i <= mesh / 2) ? i : i - mesh;
+    alias[i] = aliasing_sum(shift[i], mesh, cao);
+  }
+
+  auto const order2 = order * order;
+  std::vector<double> ff(2 * order2 + 1, 0.);
+  auto const &plan = dm.fft.plan[3];
+  int ind = 0;
+  int n[3];
+  for (n[0] = plan.start[0]; n[0] < plan.start[0] + plan.new_mesh[0]; n[0]++) {
+    for (n[1] = plan.start[1]; n[1] < plan.start[1] + plan.new_mesh[1];
+         n[1]++) {
+      for (n[2] = plan.start[2]; n[2] < plan.start[2] + plan.new_mesh[2];
+           n[2]++, ind++) {
+        auto const n2 = Utils::sqr(shift[n[0]]) + Utils::sqr(shift[n[1]]) +
+                        Utils::sqr(shift[n[2]]);
+        if (n2 < 1 || n2 > order2 || shift[n[KX]] < 0)
+          continue;
+
+        auto const rho2 = Utils::sqr(dm.rs_mesh[2 * ind]) +
+                          Utils::sqr(dm.rs_mesh[2 * ind + 1]);
+        ff[2 * n2 - 2] += rho2 / (alias[n[0]] * alias[n[1]] * alias[n[2]]);
+        ff[2 * n2 - 1]++;
+      }
+    }
+  }
+  ff[2 * order2] = n_part;
+
+  return ff;
+}
+
+void mpi_structurefactor_mesh_slave(std::vector<int> const &p_types, int order,
+                                    int mesh, int cao) {
+  auto const ff = structurefactor_mesh_local(p_types, order, mesh, cao);
+  boost::mpi::reduce(comm_cart, ff.data(), static_cast<int>(ff.size()),
+                     std::plus<double>(), 0);
+}
+} // namespace
+
+REGISTER_CALLBACK(mpi_structurefactor_mesh_slave)
+
+std::vector<double> calc_structurefactor_mesh(std::vector<int> const &p_types,
+                                              int order, int mesh, int cao) {
+  if (order < 1) {
+    runtimeErrorMsg() << "structure factor: order has to be positive";
+    return {};
+  }
+  if (mesh <= 2 * order) {
+    runtimeErrorMsg() << "structure factor: mesh has to be larger than 2 * "
+                         "order";
+    return {};
+  }
+  if (cao < 1 || cao > 7) {
+    runtimeErrorMsg() << "structure factor: cao has to be between 1 and 7";
+    return {};
+  }
+  if (box_geo.length()[0] != box_geo.length()[1] ||
+      box_geo.length()[1] != box_geo.length()[2]) {
+    runtimeErrorMsg() << "structure factor: the mesh requires a cubic box";
+    return {};
+  }
+  if (!box_geo.periodic(0) || !box_geo.periodic(1) || !box_geo.periodic(2)) {
+    runtimeErrorMsg() << "structure factor: the mesh requires periodicity 1 "
+                         "1 1";
+    return {};
+  }
+  if (cell_structure.type != CELL_STRUCTURE_DOMDEC) {
+    runtimeErrorMsg() << "structure factor: the mesh requires the domain "
+                         "decomposition cell system";
+    return {};
+  }
+  if (node_grid[0] < node_grid[1] || node_grid[1] < node_grid[2]) {
+    runtimeErrorMsg()
+        << "structure factor: node grid must be sorted, largest first";
+    return {};
+  }
+  for (int i = 0; i < 3; i++) {
+    if (0.5 * cao * box_geo.length()[i] / mesh >= local_geo.length()[i]) {
+      runtimeErrorMsg() << "structure factor: the charge assignment cutoff "
+                           "is larger than the local box";
+      return {};
+    }
+  }
+
+  mpi_call(mpi_structurefactor_mesh_slave, p_types, order, mesh, cao);
+  auto const ff_local = structurefactor_mesh_local(p_types, order, mesh, cao);
+  std::vector<double> ff(ff_local.size());
+  boost::mpi::reduce(comm_cart, ff_local.data(),
+                     static_cast<int>(ff_local.size()), ff.data(),
+                     std::plus<double>(), 0);
+
+  auto const n_part = ff.back();
+  ff.pop_back();
+  for (int qi = 0; qi < order * order; qi++)
+    if (ff[2 * qi + 1] != 0)
+      ff[2 * qi] /= n_part * ff[2 * qi + 1];
+
+  return ff;
+}
+
+#endif
@@ -0,0 +1,59 @@
+/*
+  Copyright (C) 2019 The ESPResSo project
+
+  This file is part of ESPResSo.
+
+  ESPResSo is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef STATISTICS_STRUCTURE_FACTOR_HPP
+#define STATISTICS_STRUCTURE_FACTOR_HPP
+/** \file
+ *  Static structure factor from the Fourier transformed particle density
+ *  on a mesh.
+ *
+ *  The particles are assigned to the mesh with the charge assignment
+ *  functions of P3M, and the mesh is transformed with the parallel FFT of
+ *  P3M (see \ref p3m-common.hpp and \ref fft.hpp). The squared amplitudes
+ *  are corrected for the charge assignment and its aliases, assuming that
+ *  the structure factor varies slowly over the aliased wave vectors.
+ *  This makes the cost independent of the number of wave vectors, in
+ *  contrast to the direct sum in \ref calc_structurefactor.
+ */
+
+#include "config.hpp"
+
+#if defined(P3M) || defined(DP3M)
+
+#include <vector>
+
+/** Calculate the spherically averaged structure factor on a mesh.
+ *
+ *  The result has the layout of \ref calc_structurefactor: for every
+ *  \f$ n^2 = 1, \dots, \mathrm{order}^2 \f$ the averaged structure factor
+ *  of the wave vectors \f$ 2 \pi \vec n / L \f$ with \f$ n_x \ge 0 \f$ and
+ *  their number, so it can be passed to \ref modify_stucturefactor.
+ *  Requires a cubic, fully periodic box and the domain decomposition.
+ *
+ *  @param p_types  types of the particles
+ *  @param order    largest wave vector in units of \f$ 2 \pi / L \f$
+ *  @param mesh     number of mesh points per direction, has to be larger
+ *                  than 2 @p order
+ *  @param cao      charge assignment order (1 to 7)
+ *  @return the structure factor, empty on error
+ */
+std::vector<double> calc_structurefactor_mesh(std::vector<int> const &p_types,
+                                              int order, int mesh, int cao);
+
+#endif
+#endif
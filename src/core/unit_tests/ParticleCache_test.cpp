@@ -23,7 +23,9 @@
  *
  */
 
+#include <algorithm>
 #include <random>
+#include <stdexcept>
 #include <vector>
 
 #include "ParticleCache.hpp"
@@ -46,17 +48,27 @@ namespace mpi = boost::mpi;
 class Particle : public Testing::Particle {
 public:
   Particle() = default;
-  Particle(int id) : Testing::Particle(id) {}
+  Particle(int id) : Testing::Particle(id), m_value(id) {}
 
+  int m_value = 0;
   IntList bl;
 
   IntList &bonds() { return bl; }
   IntList const &bonds() const { return bl; }
 
-  Particle flat_copy() const { return Particle(m_id); }
+  Particle flat_copy() const {
+    Particle ret(m_id);
+    ret.m_value = m_value;
+    return ret;
+  }
+
+  bool flat_equal(Particle const &rhs) const {
+    return m_id == rhs.m_id and m_value == rhs.m_value;
+  }
 
   template <typename Archive> void serialize(Archive &ar, unsigned int) {
     ar &m_id;
+    ar &m_value;
     ar &bl.n;
   }
 };
@@ -213,6 +225,91 @@ BOOST_AUTO_TEST_CASE(iterators) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(incremental_update) {
+  Particles local_parts;
+  mpi::communicator world;
+  MpiCallbacks cb(world);
+
+  auto const rank = cb.comm().rank();
+  auto const size = cb.comm().size();
+  auto const n_part = 1000;
+
+  for (int i = 0; i < n_part; i++) {
+    local_parts.emplace_back(rank * n_part + i);
+  }
+
+  auto get_parts = [&local_parts]() -> Particles const & {
+    return local_parts;
+  };
+  ParticleCache<decltype(get_parts)> part_cfg(cb, get_parts);
+
+  /* Step 0 removes the first particle of every node, moves
+   * the last one to the next node and changes every other
+   * value, step 1 changes all values. */
+  auto modify_local = [&local_parts, rank, size](int step) {
+    if (step == 0) {
+      auto const prev = (rank + size - 1) % size;
+      local_parts.erase(local_parts.begin());
+      local_parts.pop_back();
+      local_parts.emplace_back(prev * n_part + n_part - 1);
+      for (auto &p : local_parts) {
+        if (p.identity() % 2 == 0)
+          p.m_value = -p.identity();
+      }
+    } else {
+      for (auto &p : local_parts) {
+        p.m_value++;
+      }
+    }
+  };
+  Communication::CallbackHandle<int> modify(&cb, modify_local);
+
+  auto expected_value = [](int id, int step) {
+    auto const value = (id % 2 == 0) ? -id : id;
+    return (step == 0) ? value : value + 1;
+  };
+
+  if (rank == 0) {
+    part_cfg.update();
+    BOOST_CHECK(part_cfg.size() == size * n_part);
+
+    for (int step = 0; step < 2; step++) {
+      modify(step);
+      modify_local(step);
+      part_cfg.invalidate();
+
+      BOOST_CHECK(part_cfg.size() == size * (n_part - 1));
+      BOOST_CHECK(std::is_sorted(part_cfg.begin(), part_cfg.end(),
+                                 [](Particle const &a, Particle const &b) {
+                                   return a.identity() < b.identity();
+                                 }));
+      for (auto const &p : part_cfg) {
+        BOOST_CHECK(p.identity() % n_part != 0);
+        BOOST_CHECK(p.m_value == expected_value(p.identity(), step));
+        BOOST_CHECK(part_cfg[p.identity()].identity() == p.identity());
+      }
+      BOOST_CHECK_THROW(part_cfg[0], std::out_of_range);
+
+      /* Nothing changed */
+      part_cfg.invalidate();
+      BOOST_CHECK(part_cfg.size() == size * (n_part - 1));
+      for (auto const &p : part_cfg) {
+        BOOST_CHECK(p.m_value == expected_value(p.identity(), step));
+      }
+    }
+
+    /* Full update */
+    part_cfg.clear();
+    part_cfg.invalidate();
+    BOOST_CHECK(part_cfg.size() == size * (n_part - 1));
+    for (auto const &p : part_cfg) {
+      BOOST_CHECK(p.m_value == expected_value(p.identity(), 1));
+    }
+  } else {
+    cb.loop();
+  }
+}
+
 int main(int argc, char **argv) {
   mpi::environment mpi_env(argc, argv);
 
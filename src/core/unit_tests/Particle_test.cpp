@@ -31,6 +31,9 @@
 
 #include "serialization/Particle.hpp"
 
+#include <cstring>
+#include <new>
+
 BOOST_AUTO_TEST_CASE(comparison) {
   {
     Particle p, q;
@@ -53,6 +56,40 @@ BOOST_AUTO_TEST_CASE(comparison) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(flat_equal) {
+  /* Fill the storage of the copies with different garbage,
+   * so that the padding bytes differ. */
+  alignas(Particle) unsigned char buf_a[sizeof(Particle)];
+  alignas(Particle) unsigned char buf_b[sizeof(Particle)];
+  std::memset(buf_a, 0x00, sizeof(Particle));
+  std::memset(buf_b, 0xff, sizeof(Particle));
+
+  auto p = Particle();
+  p.p.identity = 3;
+  p.r.p = {1., 2., 3.};
+  p.bl = {1, 2};
+
+  auto *a = new (buf_a) Particle(p.flat_copy());
+  auto *b = new (buf_b) Particle(p.flat_copy());
+
+  BOOST_CHECK(a->flat_equal(*b));
+  BOOST_CHECK(b->flat_equal(p));
+
+  b->p.type = 1;
+  BOOST_CHECK(not a->flat_equal(*b));
+  b->p.type = a->p.type;
+  b->m.v[2] = 1.;
+  BOOST_CHECK(not a->flat_equal(*b));
+  b->m.v = a->m.v;
+  b->l.i[0] = 1;
+  BOOST_CHECK(not a->flat_equal(*b));
+  b->l.i = a->l.i;
+  BOOST_CHECK(a->flat_equal(*b));
+
+  a->~Particle();
+  b->~Particle();
+}
+
 BOOST_AUTO_TEST_CASE(serialization) {
   auto p = Particle();
 
@@ -0,0 +1,64 @@
+/*
+Copyright (C) 2010-2018 The ESPResSo project
+
+This file is part of ESPResSo.
+
+ESPResSo is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ESPResSo is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <vector>
+
+#define BOOST_TEST_MODULE for_each_cell_colored test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "algorithm/for_each_cell_colored.hpp"
+
+BOOST_AUTO_TEST_CASE(for_each_cell_colored) {
+  /* Cell "c" is represented by its index, color k has the
+     cells k, k + n_colors, ... */
+  const int n_colors = 3;
+  const int n_cells = 30;
+
+  std::vector<std::vector<int>> colors(n_colors);
+  for (int c = 0; c < n_cells; c++) {
+    colors[c % n_colors].push_back(c);
+  }
+
+  std::vector<int> visits(n_cells, 0);
+  std::vector<int> visit_color(n_cells, -1);
+
+  for (int k = 0; k < n_colors; k++) {
+    Algorithm::for_each_cell_colored(
+        colors.begin() + k, colors.begin() + k + 1,
+        [&visits, &visit_color, k](int c) {
+          visits[c]++;
+          visit_color[c] = k;
+        });
+  }
+
+  /* Every cell is visited once, with its color */
+  BOOST_CHECK(std::all_of(visits.begin(), visits.end(),
+                          [](int count) { return count == 1; }));
+  for (int c = 0; c < n_cells; c++) {
+    BOOST_CHECK(visit_color[c] == c % n_colors);
+  }
+
+  /* All colors in one call */
+  std::fill(visits.begin(), visits.end(), 0);
+  Algorithm::for_each_cell_colored(colors.begin(), colors.end(),
+                                   [&visits](int c) { visits[c]++; });
+  BOOST_CHECK(std::all_of(visits.begin(), visits.end(),
+                          [](int count) { return count == 1; }));
+}
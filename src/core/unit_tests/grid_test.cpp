@@ -25,6 +25,7 @@
 
 #include <cmath>
 #include <limits>
+#include <vector>
 
 template <class T> auto const epsilon = std::numeric_limits<T>::epsilon();
 
@@ -190,4 +191,73 @@ BOOST_AUTO_TEST_CASE(regular_decomposition_test) {
           BOOST_CHECK_CLOSE(lower_corner[2], local_box_l[2] * node_pos[2], eps);
         }
   }
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(balanced_partition_test) {
+  /* even weights */
+  {
+    auto const cuts = balanced_partition(std::vector<double>(12, 1.), 3);
+    BOOST_CHECK((cuts == std::vector<int>{0, 4, 8, 12}));
+  }
+
+  /* no weights at all */
+  {
+    auto const cuts = balanced_partition(std::vector<double>(10, 0.), 2);
+    BOOST_CHECK((cuts == std::vector<int>{0, 5, 10}));
+  }
+
+  /* all the weight in the first elements */
+  {
+    auto const weights = std::vector<double>{4., 4., 0., 0., 0., 0.};
+    auto const cuts = balanced_partition(weights, 2);
+    BOOST_CHECK((cuts == std::vector<int>{0, 1, 6}));
+  }
+
+  /* every part gets at least one element */
+  {
+    auto const weights = std::vector<double>{10., 0., 0., 0.};
+    auto const cuts = balanced_partition(weights, 4);
+    BOOST_CHECK((cuts == std::vector<int>{0, 1, 2, 3, 4}));
+  }
+
+  /* single part */
+  {
+    auto const cuts = balanced_partition(std::vector<double>(3, 1.), 1);
+    BOOST_CHECK((cuts == std::vector<int>{0, 3}));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(balanced_decomposition_test) {
+  auto const box_l = Utils::Vector3d{10, 20, 30};
+  auto box = BoxGeometry();
+  box.set_length(box_l);
+
+  NodeDomainBounds bounds;
+  bounds.n_cells = {5, 4, 3};
+  bounds.cuts[0] = {0, 5};
+  bounds.cuts[1] = {0, 1, 4};
+  bounds.cuts[2] = {0, 1, 2, 3};
+  BOOST_CHECK(not bounds.regular());
+
+  /* the domains cover the box without gaps */
+  for (int j = 0; j < 2; j++) {
+    for (int k = 0; k < 3; k++) {
+      auto const result = balanced_decomposition(box, {0, j, k}, bounds);
+      auto const my_right = result.my_left() + result.length();
+
+      BOOST_CHECK_EQUAL(result.my_left()[0], 0.);
+      BOOST_CHECK_EQUAL(result.length()[0], box_l[0]);
+      BOOST_CHECK_EQUAL(result.my_left()[1], bounds.cuts[1][j] * 5.);
+      BOOST_CHECK_EQUAL(my_right[1], bounds.cuts[1][j + 1] * 5.);
+      BOOST_CHECK_EQUAL(result.my_left()[2], k * 10.);
+      BOOST_CHECK_EQUAL(result.length()[2], 10.);
+
+      BOOST_CHECK_EQUAL(result.boundary()[0], 1);
+      BOOST_CHECK_EQUAL(result.boundary()[1], -1);
+      BOOST_CHECK_EQUAL(result.boundary()[2], (j == 0));
+      BOOST_CHECK_EQUAL(result.boundary()[3], -(j == 1));
+      BOOST_CHECK_EQUAL(result.boundary()[4], (k == 0));
+      BOOST_CHECK_EQUAL(result.boundary()[5], -(k == 2));
+    }
+  }
+}
@@ -0,0 +1,174 @@
+/*
+Copyright (C) 2010-2018 The ESPResSo project
+
+This file is part of ESPResSo.
+
+ESPResSo is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ESPResSo is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#define BOOST_TEST_MODULE link_cell_soa test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "Cell.hpp"
+#include "algorithm/link_cell_soa.hpp"
+
+BOOST_AUTO_TEST_CASE(soa_update) {
+  Particle parts[3];
+  for (int i = 0; i < 3; i++) {
+    parts[i].r.p = {1. * i, 2. * i, 3. * i};
+    parts[i].p.type = i;
+  }
+
+  CellSoA soa;
+  soa.update(parts, 3);
+
+  BOOST_CHECK(soa.size() == 3);
+  for (int i = 0; i < 3; i++) {
+    BOOST_CHECK(soa.x[i] == 1. * i);
+    BOOST_CHECK(soa.y[i] == 2. * i);
+    BOOST_CHECK(soa.z[i] == 3. * i);
+    BOOST_CHECK(soa.type[i] == i);
+    BOOST_CHECK(soa.fx[i] == 0.);
+  }
+
+  soa.fx[1] = 1.;
+  soa.fy[1] = 2.;
+  soa.fz[1] = 3.;
+  soa.add_forces(parts, 3);
+
+  BOOST_CHECK((parts[1].f.f == Utils::Vector3d{1., 2., 3.}));
+  BOOST_CHECK((parts[0].f.f == Utils::Vector3d{}));
+  BOOST_CHECK(soa.fx[1] == 0.);
+}
+
+BOOST_AUTO_TEST_CASE(link_cell_soa) {
+  const unsigned n_cells = 10;
+  const auto n_part_per_cell = 10;
+  const auto n_part = n_cells * n_part_per_cell;
+  /* Particles are placed on a line with unit spacing,
+   * so every particle has two partners on each side. */
+  const double cutoff = 2.5;
+
+  std::vector<Cell> cells(n_cells);
+
+  auto id = 0;
+  for (auto &c : cells) {
+    /* Half shell: every cell only has the following cells
+     * as red neighbors, so that every pair is visited once. */
+    std::vector<Cell *> neighbors;
+
+    for (auto n = cells.begin() + (&c - cells.data()) + 1; n != cells.end();
+         ++n) {
+      neighbors.push_back(&(*n));
+    }
+
+    c.m_neighbors = Neighbors<Cell *>(neighbors, {});
+
+    c.part = new Particle[n_part_per_cell];
+    c.n = c.max = n_part_per_cell;
+
+    for (unsigned i = 0; i < n_part_per_cell; ++i) {
+      c.part[i].p.identity = id;
+      c.part[i].r.p = {1. * id, 0., 0.};
+      id++;
+    }
+
+    c.m_soa.update(c.part, c.n);
+  }
+
+  std::vector<std::pair<int, int>> pairs;
+  std::vector<unsigned> id_counts(n_part, 0u);
+
+  Algorithm::link_cell_soa(
+      cells.begin(), cells.end(),
+      [&id_counts](Particle const &p) { id_counts[p.p.identity]++; },
+      [&pairs](Particle const &p1, Particle const &p2,
+               Utils::Vector3d const &d) {
+        /* Check that the distance vector is p1 - p2 */
+        BOOST_CHECK((d == p1.r.p - p2.r.p));
+        pairs.emplace_back(std::min(p1.p.identity, p2.p.identity),
+                           std::max(p1.p.identity, p2.p.identity));
+      },
+      cutoff);
+
+  /* Check that the particle kernel has been executed exactly once for every
+   * particle. */
+  BOOST_CHECK(std::all_of(id_counts.begin(), id_counts.end(),
+                          [](int count) { return count == 1; }));
+
+  /* Exactly the pairs within the cutoff are visited, each once */
+  std::sort(pairs.begin(), pairs.end());
+  std::vector<std::pair<int, int>> expected;
+  for (int i = 0; i < n_part; i++)
+    for (int j = i + 1; j < n_part; j++) {
+      if (std::abs(i - j) <= cutoff)
+        expected.emplace_back(i, j);
+    }
+
+  BOOST_CHECK(pairs == expected);
+
+  for (auto &c : cells) {
+    delete[] c.part;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(link_cell_blocks) {
+  const unsigned n_cells = 4;
+  const auto n_part_per_cell = 5;
+
+  std::vector<Cell> cells(n_cells);
+
+  for (auto &c : cells) {
+    std::vector<Cell *> neighbors;
+
+    for (auto n = cells.begin() + (&c - cells.data()) + 1; n != cells.end();
+         ++n) {
+      neighbors.push_back(&(*n));
+    }
+
+    c.m_neighbors = Neighbors<Cell *>(neighbors, {});
+    c.n = c.max = n_part_per_cell;
+    c.part = new Particle[n_part_per_cell];
+  }
+
+  unsigned n_particles = 0;
+  unsigned n_pairs = 0;
+
+  Algorithm::link_cell_blocks(
+      cells.begin(), cells.end(), [&n_particles](Particle &) { n_particles++; },
+      [&n_pairs](Cell &c1, int i, Cell &c2, int begin, int end) {
+        /* Blocks in the same cell start after the particle */
+        if (&c1 == &c2) {
+          BOOST_CHECK(begin == i + 1);
+        } else {
+          BOOST_CHECK(&c1 < &c2);
+          BOOST_CHECK(begin == 0);
+        }
+        BOOST_CHECK(end == c2.n);
+        n_pairs += end - begin;
+      });
+
+  auto const n_part = n_cells * n_part_per_cell;
+  BOOST_CHECK(n_particles == n_part);
+  BOOST_CHECK(n_pairs == (n_part * (n_part - 1)) / 2);
+
+  for (auto &c : cells) {
+    delete[] c.part;
+  }
+}
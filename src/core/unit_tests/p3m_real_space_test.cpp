@@ -0,0 +1,71 @@
+/*
+  Copyright (C) 2019 The ESPResSo project
+
+  This file is part of ESPResSo.
+
+  ESPResSo is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  ESPResSo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#define BOOST_TEST_MODULE P3MRealSpaceTable test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "electrostatics_magnetostatics/p3m_real_space.hpp"
+
+#include <utils/constants.hpp>
+
+#include <cmath>
+
+BOOST_AUTO_TEST_CASE(interpolation) {
+  for (double alpha : {0.5, 1., 2.}) {
+    auto const r_cut = 3.2 / alpha;
+    auto const tolerance = 1e-3;
+    P3MRealSpaceTable const table(alpha, r_cut, tolerance);
+
+    BOOST_CHECK_EQUAL(table.s_max(), r_cut * r_cut);
+
+    auto const exact = [alpha](double r, double &energy, double &force) {
+      energy = std::erfc(alpha * r) / r;
+      force = (energy + 2. * alpha * Utils::sqrt_pi_i() *
+                            std::exp(-alpha * alpha * r * r)) /
+              (r * r);
+    };
+
+    /* The error is controlled relative to the values at the cutoff */
+    double energy_cut, force_cut;
+    exact(r_cut, energy_cut, force_cut);
+
+    for (int i = 1; i < 1000; i++) {
+      auto const r = i * r_cut / 1000.;
+      double energy, force;
+      exact(r, energy, force);
+
+      BOOST_CHECK_SMALL(table.energy(r, r * r) - energy,
+                        2. * tolerance * energy_cut + 1e-12 * energy);
+      BOOST_CHECK_SMALL(table.force(r, r * r) - force,
+                        2. * tolerance * force_cut + 1e-12 * force);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(smooth_parts) {
+  /* At vanishing distance, E = 2 alpha / sqrt(pi) and
+     F = 4 alpha^3 / (3 sqrt(pi)) */
+  auto const alpha = 1.3;
+  P3MRealSpaceTable const table(alpha, 2.5);
+  double e, f;
+  table(0., e, f);
+  BOOST_CHECK_CLOSE(e, 2. * alpha * Utils::sqrt_pi_i(), 1e-10);
+  BOOST_CHECK_CLOSE(f, 4. * std::pow(alpha, 3) * Utils::sqrt_pi_i() / 3.,
+                    1e-10);
+}
@@ -151,3 +151,54 @@ BOOST_AUTO_TEST_CASE(verlet_ia) {
     delete[] c.part;
   }
 }
+
+BOOST_AUTO_TEST_CASE(verlet_ia_empty_cells) {
+  /* Every other cell is empty, so that some neighbors
+     do not contribute to the index range. */
+  const unsigned n_cells = 20;
+  const auto n_part_per_cell = 5;
+  const auto n_part = (n_cells / 2) * n_part_per_cell;
+
+  std::vector<Cell> cells(n_cells);
+
+  auto id = 0;
+  for (unsigned c = 0; c < n_cells; c++) {
+    std::vector<Cell *> neighbors;
+
+    for (auto &n : cells) {
+      if (&cells[c] != &n)
+        neighbors.push_back(&n);
+    }
+
+    cells[c].m_neighbors = Neighbors<Cell *>(neighbors, {});
+
+    if (c % 2) {
+      cells[c].part = new Particle[n_part_per_cell];
+      cells[c].n = cells[c].max = n_part_per_cell;
+
+      for (unsigned i = 0; i < n_part_per_cell; ++i) {
+        cells[c].part[i].p.identity = id++;
+      }
+    }
+  }
+
+  for (auto rebuild : {true, false}) {
+    std::vector<std::pair<int, int>> pairs;
+
+    Algorithm::verlet_ia(
+        cells.begin(), cells.end(), [](Particle const &) {},
+        [&pairs](Particle const &p1, Particle const &p2, Distance const &) {
+          pairs.emplace_back(p1.p.identity, p2.p.identity);
+        },
+        [](Particle const &p1, Particle const &p2) {
+          return Distance{p1.p.identity <= p2.p.identity};
+        },
+        VerletCriterion{}, rebuild);
+
+    check_pairs(n_part, pairs);
+  }
+
+  for (auto &c : cells) {
+    delete[] c.part;
+  }
+}
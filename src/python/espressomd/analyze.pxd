@@ -76,7 +76,7 @@ cdef extern from "statistics.hpp":
         double length, double radius, int bins_axial, int bins_radial,
         vector[int] types, map[string, vector[vector[vector[double]]]] & distribution)
 
-    void calc_rdf(PartCfg & , vector[int] p1_types, vector[int] p2_types,
+    void calc_rdf(vector[int] p1_types, vector[int] p2_types,
                   double r_min, double r_max, int r_bins, vector[double] rdf)
 
     void calc_rdf_av(PartCfg & , vector[int] p1_types, vector[int] p2_types,
@@ -94,6 +94,9 @@ cdef extern from "statistics.hpp":
         double r_min, double r_max, int r_bins, int log_flag, double * low,
         double * dist)
 
+cdef extern from "statistics_structure_factor.hpp":
+    vector[double] calc_structurefactor_mesh(const vector[int] & p_types, int order, int mesh, int cao)
+
 cdef extern from "statistics_chain.hpp":
     int chain_start
     int chain_n_chains
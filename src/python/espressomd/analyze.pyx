@@ -847,7 +847,8 @@ class Analysis(object):
     # Structure factor
     #
 
-    def structure_factor(self, sf_types=None, sf_order=None):
+    def structure_factor(self, sf_types=None, sf_order=None, mesh=None,
+                         cao=5):
         """
         Calculate the structure factor for given types.  Returns the
         spherically averaged structure factor of particles specified in
@@ -855,6 +856,11 @@ class Analysis(object):
         vectors q up to `order` Do not choose parameter `order` too large
         because the number of calculations grows as `order` to the third power.
 
+        If `mesh` is given, the particle density is instead assigned to a
+        mesh and Fourier transformed with the parallel FFT of P3M, which
+        costs the same for all wave vectors. This requires a cubic, periodic
+        box and the domain decomposition cell system.
+
         Parameters
         ----------
         sf_types : list of :obj:`int`
@@ -862,6 +868,11 @@ class Analysis(object):
             should be considered.
         sf_order : :obj:`int`
             Specifies the maximum wavevector.
+        mesh : :obj:`int`, optional
+            Number of mesh points per direction, has to be larger than
+            2 `sf_order`. Requires feature ``P3M`` or ``DP3M``.
+        cao : :obj:`int`, optional
+            Charge assignment order of the mesh (1 to 7).
 
         Returns
         -------
@@ -877,6 +888,22 @@ class Analysis(object):
             sf_order, 1, int, "sf_order has to be an int!")
 
         cdef double * sf
+        cdef vector[double] sf_mesh
+        if mesh is not None:
+            IF P3M == 1 or DP3M == 1:
+                check_type_or_throw_except(
+                    mesh, 1, int, "mesh has to be an int!")
+                check_type_or_throw_except(
+                    cao, 1, int, "cao has to be an int!")
+                sf_mesh = analyze.calc_structurefactor_mesh(
+                    sf_types, sf_order, mesh, cao)
+                handle_errors("calc_structurefactor_mesh failed")
+                return np.transpose(analyze.modify_stucturefactor(
+                    sf_order, sf_mesh.data()))
+            ELSE:
+                raise Exception(
+                    "The mesh structure factor requires P3M or DP3M")
+
         p_types = create_int_list_from_python_object(sf_types)
 
         analyze.calc_structurefactor(analyze.partCfg(), p_types.e, p_types.n, sf_order, & sf)
@@ -947,8 +974,7 @@ class Analysis(object):
         cdef vector[int] p2_types = type_list_b
 
         if rdf_type == 'rdf':
-            analyze.calc_rdf(analyze.partCfg(), p1_types,
-                               p2_types, r_min, r_max, r_bins, rdf)
+            analyze.calc_rdf(p1_types, p2_types, r_min, r_max, r_bins, rdf)
         elif rdf_type == '<rdf>':
             analyze.calc_rdf_av(
                 analyze.partCfg(), p1_types, p2_types, r_min,
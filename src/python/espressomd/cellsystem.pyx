@@ -31,7 +31,9 @@ cdef class CellSystem(object):
         use_verlet_lists=True,
      fully_connected=[False,
                       False,
-                      False]):
+                      False],
+        use_soa=False,
+        balance_interval=0):
         """
         Activates domain decomposition cell system.
 
@@ -40,11 +42,26 @@ cdef class CellSystem(object):
         'use_verlet_lists' : :obj:`bool`, optional
                              Activates or deactivates the usage of Verlet lists
                              in the algorithm.
+        'use_soa' : :obj:`bool`, optional
+                    Keep a packed structure-of-arrays copy of the particle
+                    positions, types and charges per cell and run the
+                    short-range loop on it. Only used without Verlet lists.
+        'balance_interval' : :obj:`int`, optional
+                             If positive, the boundaries of the node domains
+                             are moved every ``balance_interval`` integration
+                             steps so that all nodes hold about the same
+                             number of particles. 0 (default) splits the box
+                             into equal parts.
 
         """
 
+        if not is_valid_type(balance_interval, int) or balance_interval < 0:
+            raise ValueError("balance_interval has to be a non-negative int")
+
         cell_structure.use_verlet_list = use_verlet_lists
+        cell_structure.use_soa = use_soa
         dd.fully_connected = fully_connected
+        dd.balance_interval = balance_interval
         # grid.h::node_grid
         mpi_bcast_cell_structure(CELL_STRUCTURE_DOMDEC)
 
@@ -63,6 +80,7 @@ cdef class CellSystem(object):
 
         """
         cell_structure.use_verlet_list = use_verlet_lists
+        cell_structure.use_soa = False
 
         mpi_bcast_cell_structure(CELL_STRUCTURE_NSQUARE)
         # @TODO: gathering should be interface independent
@@ -84,6 +102,7 @@ cdef class CellSystem(object):
 
         """
         cell_structure.use_verlet_list = use_verlet_lists
+        cell_structure.use_soa = False
 
         if n_layers:
             if not is_valid_type(n_layers, int):
@@ -116,7 +135,8 @@ cdef class CellSystem(object):
         return True
 
     def get_state(self):
-        s = {"use_verlet_list": cell_structure.use_verlet_list}
+        s = {"use_verlet_list": cell_structure.use_verlet_list,
+             "use_soa": cell_structure.use_soa}
 
         if cell_structure.type == CELL_STRUCTURE_LAYERED:
             s["type"] = "layered"
@@ -141,11 +161,13 @@ cdef class CellSystem(object):
         s["max_num_cells"] = max_num_cells
         s["min_num_cells"] = min_num_cells
         s["fully_connected"] = dd.fully_connected
+        s["balance_interval"] = dd.balance_interval
 
         return s
 
     def __getstate__(self):
-        s = {"use_verlet_list": cell_structure.use_verlet_list}
+        s = {"use_verlet_list": cell_structure.use_verlet_list,
+             "use_soa": cell_structure.use_soa}
 
         if cell_structure.type == CELL_STRUCTURE_LAYERED:
             s["type"] = "layered"
@@ -160,10 +182,13 @@ cdef class CellSystem(object):
         s["max_num_cells"] = max_num_cells
         s["min_num_cells"] = min_num_cells
         s["fully_connected"] = dd.fully_connected
+        s["balance_interval"] = dd.balance_interval
         return s
 
     def __setstate__(self, d):
         use_verlet_lists = None
+        use_soa = d.get("use_soa", False)
+        balance_interval = d.get("balance_interval", 0)
         for key in d:
             if key == "use_verlet_list":
                 use_verlet_lists = d[key]
@@ -173,7 +198,8 @@ cdef class CellSystem(object):
                         n_layers=d['n_layers'], use_verlet_lists=use_verlet_lists)
                 elif d[key] == "domain_decomposition":
                     self.set_domain_decomposition(
-                        use_verlet_lists=use_verlet_lists)
+                        use_verlet_lists=use_verlet_lists, use_soa=use_soa,
+                        balance_interval=balance_interval)
                 elif d[key] == "nsquare":
                     self.set_n_square(use_verlet_lists=use_verlet_lists)
         self.skin = d['skin']
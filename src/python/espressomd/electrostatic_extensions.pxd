@@ -24,6 +24,7 @@ from espressomd.system cimport *
 from espressomd.utils cimport *
 from espressomd.electrostatics cimport *
 from libcpp cimport vector
+from libcpp cimport bool
 from utils cimport Vector3d
 
 IF ELECTROSTATICS and P3M:
@@ -59,6 +60,8 @@ IF ELECTROSTATICS and P3M:
             double relax
             int citeration
             int first_id
+            int anderson_depth
+            bool extrapolate
 
         # links intern C-struct with python object
         iccp3m_struct iccp3m_cfg
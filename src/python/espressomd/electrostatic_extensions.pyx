@@ -189,6 +189,14 @@ IF ELECTROSTATICS and P3M:
             check_type_or_throw_except(
                 self._params["eps_out"], 1, float, "")
 
+            check_type_or_throw_except(
+                self._params["anderson_depth"], 1, int, "")
+            check_range_or_except(
+                self._params, "anderson_depth", 0, True, "inf", True)
+
+            check_type_or_throw_except(
+                self._params["extrapolate"], 1, type(True), "")
+
             # Required list input
             self._params["normals"] = np.array(self._params["normals"])
             if self._params["normals"].size != self._params["n_icc"] * 3:
@@ -214,7 +222,7 @@ IF ELECTROSTATICS and P3M:
                 self._params["epsilons"] = np.zeros(self._params["n_icc"])
 
         def valid_keys(self):
-            return "n_icc", "convergence", "relaxation", "ext_field", "max_iterations", "first_id", "eps_out", "normals", "areas", "sigmas", "epsilons", "check_neutrality"
+            return "n_icc", "convergence", "relaxation", "ext_field", "max_iterations", "first_id", "eps_out", "normals", "areas", "sigmas", "epsilons", "check_neutrality", "anderson_depth", "extrapolate"
 
         def required_keys(self):
             return ["n_icc", "normals", "areas"]
@@ -231,7 +239,9 @@ IF ELECTROSTATICS and P3M:
                     "areas": [],
                     "sigmas": [],
                     "epsilons": [],
-                    "check_neutrality": True}
+                    "check_neutrality": True,
+                    "anderson_depth": 0,
+                    "extrapolate": False}
 
         def _get_params_from_es_core(self):
             params = {}
@@ -261,6 +271,8 @@ IF ELECTROSTATICS and P3M:
             params["convergence"] = iccp3m_cfg.convergence
             params["relaxation"] = iccp3m_cfg.relax
             params["eps_out"] = iccp3m_cfg.eout
+            params["anderson_depth"] = iccp3m_cfg.anderson_depth
+            params["extrapolate"] = iccp3m_cfg.extrapolate
 
             return params
 
@@ -288,6 +300,8 @@ IF ELECTROSTATICS and P3M:
             iccp3m_cfg.convergence = self._params["convergence"]
             iccp3m_cfg.relax = self._params["relaxation"]
             iccp3m_cfg.eout = self._params["eps_out"]
+            iccp3m_cfg.anderson_depth = self._params["anderson_depth"]
+            iccp3m_cfg.extrapolate = self._params["extrapolate"]
 
             # Broadcasts vars
             mpi_iccp3m_init()
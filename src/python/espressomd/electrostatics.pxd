@@ -87,6 +87,7 @@ IF ELECTROSTATICS:
                 int    inter2
                 int    cao3
                 double additional_mesh[3]
+                bool analytical_differentiation
 
         cdef extern from "electrostatics_magnetostatics/p3m.hpp":
             int p3m_set_params(double r_cut, int * mesh, int cao, double alpha, double accuracy)
@@ -94,6 +95,7 @@ IF ELECTROSTATICS:
             int p3m_set_mesh_offset(double x, double y, double z)
             int p3m_set_eps(double eps)
             int p3m_set_ninterpol(int n)
+            int p3m_set_analytical_differentiation(bool ad)
             int p3m_adaptive_tune(char ** log)
 
             ctypedef struct p3m_data_struct:
@@ -206,12 +208,14 @@ IF ELECTROSTATICS:
             double far_switch_radius_2;
             double maxPWerror;
             int    bessel_cutoff;
+            double near_cut;
 
         cdef extern MMM1D_struct mmm1d_params;
 
-        int MMM1D_set_params(double switch_rad, double maxPWerror);
+        int MMM1D_set_params(double switch_rad, double maxPWerror, double near_cut);
         void MMM1D_init();
         int MMM1D_sanity_checks();
+        int MMM1D_image_table_size();
         int mmm1d_tune(char ** log);
 
     cdef extern from "nonbonded_interactions/nonbonded_interaction_data.hpp":
@@ -225,7 +229,7 @@ IF ELECTROSTATICS:
             handle_errors(
                 "MMM1D Sanity check failed: wrong periodicity or wrong cellsystem, PRTFM")
         resp = mmm1d_tune(& log)
-        if resp:
+        if resp and log != NULL:
             print(to_str(log))
         return resp
 
@@ -32,6 +32,7 @@ from espressomd.utils import is_valid_type, to_str
 from . cimport checks
 from .analyze cimport partCfg, PartCfg
 from .particle_data cimport particle
+from .tuning_cache import cached_tune
 
 
 IF ELECTROSTATICS == 1:
@@ -226,6 +227,17 @@ IF P3M == 1:
         check_neutrality : :obj:`bool`, optional
             Raise a warning if the system is not electrically neutral when
             set to ``True`` (default).
+        analytical_differentiation : :obj:`bool`, optional
+            Obtain the forces from the gradient of the charge assignment
+            function, which needs one instead of three backward FFTs.
+            Requires ``cao`` > 1. Defaults to False (ik-differentiation).
+        tuning_cache : :obj:`str`, optional
+            File in which the tuned parameters are cached, see
+            :ref:`Caching the tuning results`. Defaults to the value of the
+            environment variable ``ESPRESSO_TUNING_CACHE``.
+        retune : :obj:`bool`, optional
+            Tune even if the cache contains parameters for this system and
+            replace them. Defaults to False.
 
         """
 
@@ -275,8 +287,12 @@ IF P3M == 1:
                 raise ValueError(
                     "alpha should be positive")
 
+            if self._params["analytical_differentiation"] and self._params["cao"] == 1:
+                raise ValueError(
+                    "analytical differentiation requires cao > 1")
+
         def valid_keys(self):
-            return "mesh", "cao", "accuracy", "epsilon", "alpha", "r_cut", "prefactor", "tune", "check_neutrality", "inter"
+            return "mesh", "cao", "accuracy", "epsilon", "alpha", "r_cut", "prefactor", "tune", "check_neutrality", "inter", "analytical_differentiation", "tuning_cache", "retune"
 
         def required_keys(self):
             return ["prefactor", "accuracy"]
@@ -291,7 +307,10 @@ IF P3M == 1:
                     "epsilon": 0.0,
                     "mesh_off": [-1, -1, -1],
                     "tune": True,
-                    "check_neutrality": True}
+                    "check_neutrality": True,
+                    "analytical_differentiation": False,
+                    "tuning_cache": None,
+                    "retune": False}
 
         def _get_params_from_es_core(self):
             params = {}
@@ -303,6 +322,9 @@ IF P3M == 1:
         def _set_params_in_es_core(self):
             #Sets lb, bcast, resets vars to zero if lb=0
             set_prefactor(self._params["prefactor"])
+            #Selects the differentiation scheme, bcast
+            p3m_set_analytical_differentiation(
+                self._params["analytical_differentiation"])
             #Sets cdef vars and calls p3m_set_params() in core
             python_p3m_set_params(self._params["r_cut"],
                                   self._params["mesh"], self._params["cao"],
@@ -318,6 +340,8 @@ IF P3M == 1:
 
         def _tune(self):
             set_prefactor(self._params["prefactor"])
+            p3m_set_analytical_differentiation(
+                self._params["analytical_differentiation"])
             python_p3m_set_tune_params(self._params["r_cut"],
                                        self._params["mesh"],
                                        self._params["cao"],
@@ -333,7 +357,10 @@ IF P3M == 1:
         def _activate_method(self):
             check_neutrality(self._params)
             if self._params["tune"]:
-                self._tune()
+                cached_tune(self, "P3M",
+                            ["prefactor", "accuracy", "r_cut", "mesh", "cao",
+                             "inter", "epsilon", "analytical_differentiation"],
+                            ["r_cut", "mesh", "cao", "alpha", "accuracy"])
             self._set_params_in_es_core()
 
     IF CUDA:
@@ -369,6 +396,13 @@ IF P3M == 1:
             check_neutrality : :obj:`bool`, optional
                 Raise a warning if the system is not electrically neutral when
                 set to ``True`` (default).
+            tuning_cache : :obj:`str`, optional
+                File in which the tuned parameters are cached, see
+                :ref:`Caching the tuning results`. Defaults to the value of
+                the environment variable ``ESPRESSO_TUNING_CACHE``.
+            retune : :obj:`bool`, optional
+                Tune even if the cache contains parameters for this system
+                and replace them. Defaults to False.
 
             """
 
@@ -414,7 +448,7 @@ IF P3M == 1:
                         "mesh_off should be a list of length 3 with values between 0.0 and 1.0")
 
             def valid_keys(self):
-                return "mesh", "cao", "accuracy", "epsilon", "alpha", "r_cut", "prefactor", "tune", "check_neutrality"
+                return "mesh", "cao", "accuracy", "epsilon", "alpha", "r_cut", "prefactor", "tune", "check_neutrality", "tuning_cache", "retune"
 
             def required_keys(self):
                 return ["prefactor", "accuracy"]
@@ -429,7 +463,9 @@ IF P3M == 1:
                         "epsilon": 0.0,
                         "mesh_off": [-1, -1, -1],
                         "tune": True,
-                        "check_neutrality": True}
+                        "check_neutrality": True,
+                        "tuning_cache": None,
+                        "retune": False}
 
             def _get_params_from_es_core(self):
                 params = {}
@@ -457,7 +493,10 @@ IF P3M == 1:
                 python_p3m_gpu_init(self._params)
                 coulomb.method = COULOMB_P3M_GPU
                 if self._params["tune"]:
-                    self._tune()
+                    cached_tune(self, "P3MGPU",
+                                ["prefactor", "accuracy", "r_cut", "mesh",
+                                 "cao", "inter", "epsilon"],
+                                ["r_cut", "mesh", "cao", "alpha", "accuracy"])
                 python_p3m_gpu_init(self._params)
                 self._set_params_in_es_core()
 
@@ -488,8 +527,22 @@ IF ELECTROSTATICS:
         far_switch_radius : :obj:`float`, optional
             Radius where near-field and far-field calculation are switched.
         bessel_cutoff : :obj:`int`, optional
+        near_cut : :obj:`float`, optional
+            Cutoff of the short range loop. If given, the pairs beyond this
+            distance are distributed evenly over all nodes and their image
+            interaction is interpolated from a table, so that the
+            domain decomposition can be used. By default, all pairs are
+            calculated in the short range loop, which requires the
+            nsquared cell system.
         tune : :obj:`bool`, optional
             Specify whether to automatically tune ore not. The default is True.
+        tuning_cache : :obj:`str`, optional
+            File in which the tuned parameters are cached, see
+            :ref:`Caching the tuning results`. Defaults to the value of the
+            environment variable ``ESPRESSO_TUNING_CACHE``.
+        retune : :obj:`bool`, optional
+            Tune even if the cache contains parameters for this system and
+            replace them. Defaults to False.
 
         """
 
@@ -503,17 +556,22 @@ IF ELECTROSTATICS:
                 raise ValueError("switch radius should be a positive double")
             if self._params["bessel_cutoff"] < 0 and self._params["bessel_cutoff"] != default_params["bessel_cutoff"]:
                 raise ValueError("bessel_cutoff should be a positive integer")
+            if self._params["near_cut"] <= 0 and self._params["near_cut"] != default_params["near_cut"]:
+                raise ValueError("near_cut should be a positive double")
 
         def default_params(self):
             return {"prefactor": -1,
                     "maxPWerror": -1,
                     "far_switch_radius": -1,
                     "bessel_cutoff": -1,
+                    "near_cut": -1,
                     "tune": True,
-                    "check_neutrality": True}
+                    "check_neutrality": True,
+                    "tuning_cache": None,
+                    "retune": False}
 
         def valid_keys(self):
-            return "prefactor", "maxPWerror", "far_switch_radius", "bessel_cutoff", "tune", "check_neutrality"
+            return "prefactor", "maxPWerror", "far_switch_radius", "bessel_cutoff", "near_cut", "tune", "check_neutrality", "tuning_cache", "retune"
 
         def required_keys(self):
             return ["prefactor", "maxPWerror"]
@@ -529,9 +587,12 @@ IF ELECTROSTATICS:
             return params
 
         def _set_params_in_es_core(self):
-            set_prefactor(self._params["prefactor"])
+            # the cutoff has to be known before the prefactor update
+            # reinitializes the cell system
             MMM1D_set_params(
-                self._params["far_switch_radius"], self._params["maxPWerror"])
+                self._params["far_switch_radius"], self._params["maxPWerror"],
+                self._params["near_cut"])
+            set_prefactor(self._params["prefactor"])
 
         def _tune(self):
             cdef int resp
@@ -545,10 +606,26 @@ IF ELECTROSTATICS:
             coulomb.method = COULOMB_MMM1D
             self._set_params_in_es_core()
             if self._params["tune"]:
-                self._tune()
+                cached_tune(self, "MMM1D",
+                            ["maxPWerror", "far_switch_radius", "near_cut"],
+                            ["far_switch_radius", "bessel_cutoff"])
 
             self._set_params_in_es_core()
 
+        def image_table_size(self):
+            """
+            Number of nodes of the table from which the image interaction
+            of the pairs beyond ``near_cut`` is interpolated.
+
+            Returns
+            -------
+            size : :obj:`int`
+                Number of table nodes, 0 if the image interaction is
+                calculated directly
+
+            """
+            return MMM1D_image_table_size()
+
 IF ELECTROSTATICS and MMM1D_GPU:
     cdef class MMM1DGPU(ElectrostaticInteraction):
         """
@@ -63,6 +63,7 @@ cdef extern from "domain_decomposition.hpp":
         int cell_grid[3]
         double cell_size[3]
         bool fully_connected[3]
+        int balance_interval
 
     extern DomainDecomposition dd
     extern int max_num_cells
@@ -104,6 +105,7 @@ cdef extern from "cells.hpp":
     ctypedef struct CellStructure:
         int type
         bool use_verlet_list
+        bool use_soa
 
     CellStructure cell_structure
 
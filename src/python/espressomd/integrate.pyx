@@ -19,8 +19,10 @@
 from __future__ import print_function, absolute_import
 from cpython.exc cimport PyErr_CheckSignals, PyErr_SetInterrupt
 include "myconfig.pxi"
+import numpy as np
 import espressomd.code_info
 from espressomd.utils cimport *
+from . cimport analyze
 cimport globals
 
 cdef class Integrator(object):
@@ -45,14 +47,19 @@ cdef class Integrator(object):
         state['_method'] = self._method
         state['_steepest_descent_params'] = self._steepest_descent_params
         state['_isotropic_npt_params'] = self._isotropic_npt_params
+        state['_long_range_interval'] = long_range_interval
         return state
 
     def __setstate__(self, state):
         self._method = state['_method']
         if self._method == "STEEPEST_DESCENT":
             self.set_steepest_descent(state['_steepest_descent_params'])
+        elif self._method == "VV":
+            self.set_vv(
+                long_range_interval=state.get('_long_range_interval', 1))
         elif self._method == "NVT":
-            self.set_nvt()
+            self.set_nvt(
+                long_range_interval=state.get('_long_range_interval', 1))
         elif self._method == "NPT":
             npt_params = state['_isotropic_npt_params']
             self.set_isotropic_npt(npt_params['ext_pressure'], npt_params[
@@ -114,18 +121,105 @@ cdef class Integrator(object):
         self._steepest_descent_params.update(kwargs)
         self._method = "STEEPEST_DESCENT"
 
-    def set_vv(self):
+    def energy_drift(self, steps, samples=10):
+        """
+        Integrate and measure the drift of the total energy.
+
+        The total energy is sampled before and ``samples`` times during
+        the integration. The sampling interval is ``steps // samples``,
+        rounded down to a multiple of :attr:`long_range_interval` (but at
+        least one long-range interval), so that all samples are taken
+        at the end of an outer time step. Use it without a thermostat.
+
+        Parameters
+        ----------
+        steps : :obj:`int`
+            Number of time steps to integrate.
+        samples : :obj:`int`, optional
+            Number of energy samples taken during the integration.
+
+        Returns
+        -------
+        :obj:`dict`
+            ``time`` and ``energy`` of the samples, the ``drift`` of the
+            total energy per unit time from a linear fit, and the root
+            mean square ``fluctuation`` of the energy around the fit.
+
+        """
+        check_type_or_throw_except(
+            steps, 1, int, "energy_drift requires an integer number of steps")
+        check_type_or_throw_except(
+            samples, 1, int, "energy_drift requires an integer number of samples")
+        if samples < 1:
+            raise ValueError("energy_drift needs at least one sample")
+        interval = max(steps // samples // long_range_interval,
+                       1) * long_range_interval
+
+        time = [globals.sim_time]
+        energy = [self._total_energy()]
+        for _ in range(samples):
+            self.run(interval)
+            time.append(globals.sim_time)
+            energy.append(self._total_energy())
+
+        time = np.array(time)
+        energy = np.array(energy)
+        drift, offset = np.polyfit(time - time[0], energy, 1)
+        fluctuation = np.sqrt(
+            np.mean((energy - offset - drift * (time - time[0]))**2))
+        return {"time": time, "energy": energy,
+                "drift": drift, "fluctuation": fluctuation}
+
+    def _total_energy(self):
+        e_pot = analyze.calculate_current_potential_energy_of_system()
+        handle_errors("Encountered errors during energy calculation")
+        return e_pot + analyze.total_energy.data.e[0]
+
+    property long_range_interval:
+        """
+        Number of time steps between two evaluations of the long-range
+        forces (read-only), see :meth:`set_vv`.
+
+        """
+
+        def __get__(self):
+            return long_range_interval
+
+    def _set_long_range_interval(self, interval):
+        check_type_or_throw_except(
+            interval, 1, int, "long_range_interval has to be an integer")
+        if interval < 1:
+            raise ValueError("long_range_interval has to be positive")
+        if integrate_set_long_range_interval(interval):
+            handle_errors("Encountered errors setting the long-range interval")
+
+    def set_vv(self, long_range_interval=1):
         """
         Set the integration method to Velocity Verlet.
 
+        Parameters
+        ----------
+        long_range_interval : :obj:`int`, optional
+            Number of time steps between two evaluations of the
+            long-range forces (multiple time stepping). The long-range
+            forces are applied as an impulse for that many steps.
+
         """
+        self._set_long_range_interval(long_range_interval)
         self._method = "VV"
 
-    def set_nvt(self):
+    def set_nvt(self, long_range_interval=1):
         """
         Set the integration method to NVT.
 
+        Parameters
+        ----------
+        long_range_interval : :obj:`int`, optional
+            Number of time steps between two evaluations of the
+            long-range forces, see :meth:`set_vv`.
+
         """
+        self._set_long_range_interval(long_range_interval)
         self._method = "NVT"
         integrate_set_nvt()
 
@@ -146,6 +240,7 @@ cdef class Integrator(object):
             If this optional parameter is true, a cubic box is assumed.
 
         """
+        self._set_long_range_interval(1)
         self._method = "NPT"
         self._isotropic_npt_params['ext_pressure'] = ext_pressure
         self._isotropic_npt_params['piston'] = piston
@@ -39,6 +39,8 @@ else:
 
         .. note::
            Bonds will be written to the file automatically if they exist.
+           Bonds, species, masses and charges are only written when they
+           changed since the last write.
 
         Parameters
         ----------
@@ -90,6 +90,8 @@ cdef extern from "grid_based_algorithms/lb_interface.hpp":
     void lb_lbfluid_set_rng_state(stdint.uint64_t) except +
     void lb_lbfluid_set_kT(double) except +
     double lb_lbfluid_get_kT() except +
+    void lb_lbfluid_set_in_place_streaming(bool) except +
+    bool lb_lbfluid_get_in_place_streaming() except +
     double lb_lbfluid_get_lattice_speed() except +
 
 cdef extern from "grid_based_algorithms/lb_particle_coupling.hpp":
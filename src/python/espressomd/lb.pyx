@@ -77,7 +77,7 @@ cdef class HydrodynamicInteraction(Actor):
     # list of valid keys for parameters
     ####################################################
     def valid_keys(self):
-        return "agrid", "dens", "ext_force_density", "visc", "tau", "bulk_visc", "gamma_odd", "gamma_even", "kT", "seed"
+        return "agrid", "dens", "ext_force_density", "visc", "tau", "bulk_visc", "gamma_odd", "gamma_even", "kT", "seed", "in_place_streaming"
 
     # list of essential keys required for the fluid
     ####################################################
@@ -94,7 +94,8 @@ cdef class HydrodynamicInteraction(Actor):
                 "bulk_visc": -1.0,
                 "tau": -1.0,
                 "seed": None,
-                "kT": 0.}
+                "kT": 0.,
+                "in_place_streaming": False}
 
     # function that calls wrapper functions which set the parameters at C-Level
     ####################################################
@@ -105,6 +106,8 @@ cdef class HydrodynamicInteraction(Actor):
     def _set_params_in_es_core(self):
         default_params = self.default_params()
 
+        lb_lbfluid_set_in_place_streaming(self._params["in_place_streaming"])
+
         cdef stdint.uint64_t seed
         if self._params["kT"] > 0.:
             seed = self._params["seed"]
@@ -147,6 +150,7 @@ cdef class HydrodynamicInteraction(Actor):
     ####################################################
     def _get_params_from_es_core(self):
         default_params = self.default_params()
+        self._params["in_place_streaming"] = lb_lbfluid_get_in_place_streaming()
         cdef double kT = lb_lbfluid_get_kT()
         self._params["kT"] = kT
         cdef stdint.uint64_t seed
@@ -31,6 +31,16 @@ IF DIPOLES == 1:
         int mdds_set_params(int n_cut)
         int Ncut_off_magnetic_dipolar_direct_sum
 
+    cdef extern from "electrostatics_magnetostatics/dipolar_barnes_hut.hpp":
+        ctypedef struct DipolarBarnesHutParameters:
+            double accuracy
+            int n_replica
+            double theta
+
+        cdef extern DipolarBarnesHutParameters dbh_params
+
+        int dbh_set_params(double accuracy, int n_replica)
+
     IF(CUDA == 1) and (ROTATION == 1):
         cdef extern from "actor/DipolarDirectSum.hpp":
             void activate_dipolar_direct_sum_gpu()
@@ -27,6 +27,7 @@ IF SCAFACOS == 1:
 
 from espressomd.utils cimport handle_errors
 from espressomd.utils import is_valid_type, to_str
+from .tuning_cache import cached_tune
 
 IF DIPOLES == 1:
     cdef class MagnetostaticInteraction(Actor):
@@ -87,6 +88,13 @@ IF DP3M == 1:
         tune : :obj:`bool`, optional
             Activate/deactivate the tuning method on activation
             (default is True, i.e., activated).
+        tuning_cache : :obj:`str`, optional
+            File in which the tuned parameters are cached, see
+            :ref:`Caching the tuning results`. Defaults to the value of the
+            environment variable ``ESPRESSO_TUNING_CACHE``.
+        retune : :obj:`bool`, optional
+            Tune even if the cache contains parameters for this system and
+            replace them. Defaults to False.
 
         """
 
@@ -134,7 +142,8 @@ IF DP3M == 1:
         def valid_keys(self):
             return ["prefactor", "alpha_L", "r_cut_iL", "mesh", "mesh_off",
                     "cao", "inter", "accuracy", "epsilon", "cao_cut", "a", "ai",
-                    "alpha", "r_cut", "inter2", "cao3", "additional_mesh", "tune"]
+                    "alpha", "r_cut", "inter2", "cao3", "additional_mesh", "tune",
+                    "tuning_cache", "retune"]
 
         def required_keys(self):
             return ["accuracy", ]
@@ -147,7 +156,9 @@ IF DP3M == 1:
                     "mesh": -1,
                     "epsilon": 0.0,
                     "mesh_off": [-1, -1, -1],
-                    "tune": True}
+                    "tune": True,
+                    "tuning_cache": None,
+                    "retune": False}
 
         def _get_params_from_es_core(self):
             params = {}
@@ -180,7 +191,11 @@ IF DP3M == 1:
 
         def _activate_method(self):
             if self._params["tune"]:
-                self._tune()
+                cached_tune(self, "DipolarP3M",
+                            ["prefactor", "accuracy", "r_cut", "mesh", "cao",
+                             "inter", "epsilon"],
+                            ["r_cut", "mesh", "cao", "alpha", "accuracy"],
+                            moment="dipm")
 
             self._set_params_in_es_core()
             mpi_bcast_coulomb_params()
@@ -312,6 +327,57 @@ IF DIPOLES == 1:
             handle_errors("Could not activate magnetostatics method "
                           + self.__class__.__name__)
 
+    cdef class DipolarBarnesHutCpu(MagnetostaticInteraction):
+        """Calculate magnetostatic interactions with a Barnes-Hut tree code.
+
+        The opening angle of the tree traversal is tuned on activation, such
+        that the relative root mean square errors of the forces and torques
+        are below `accuracy`. If the system has periodic boundaries,
+        `n_replica` copies of the system are taken into account in the
+        respective directions. Spherical cutoff is applied.
+
+        Attributes
+        ----------
+        prefactor : :obj:`float`
+            Magnetostatics prefactor (:math:`\mu_0/(4\pi)`)
+        accuracy : :obj:`float`
+            Relative root mean square error of the forces and torques.
+        n_replica : :obj:`int`
+            Number of replicas to be taken into account at periodic boundaries.
+
+        """
+
+        def validate_params(self):
+            super(DipolarBarnesHutCpu, self).validate_params()
+            if not self._params["accuracy"] > 0:
+                raise ValueError("accuracy has to be a positive float")
+            if not self._params["n_replica"] >= 0:
+                raise ValueError("n_replica has to be a non-negative integer")
+
+        def default_params(self):
+            return {"accuracy": 1e-3, "n_replica": 0}
+
+        def required_keys(self):
+            return ()
+
+        def valid_keys(self):
+            return ("prefactor", "accuracy", "n_replica")
+
+        def _get_params_from_es_core(self):
+            return {"prefactor": dipole.prefactor,
+                    "accuracy": dbh_params.accuracy,
+                    "n_replica": dbh_params.n_replica,
+                    "theta": dbh_params.theta}
+
+        def _activate_method(self):
+            self._set_params_in_es_core()
+
+        def _set_params_in_es_core(self):
+            self.set_magnetostatics_prefactor()
+            dbh_set_params(self._params["accuracy"], self._params["n_replica"])
+            handle_errors("Could not activate magnetostatics method "
+                          + self.__class__.__name__)
+
     IF SCAFACOS_DIPOLES == 1:
         class Scafacos(ScafacosConnector, MagnetostaticInteraction):
 
@@ -79,6 +79,18 @@ cdef extern from "particle_data.hpp":
     # Setter/getter/modifier functions functions
     void prefetch_particle_data(vector[int] ids)
 
+    cdef enum BulkProperty:
+        pass
+    cdef BulkProperty BULK_POS "BulkProperty::POS"
+    cdef BulkProperty BULK_V "BulkProperty::V"
+    cdef BulkProperty BULK_F "BulkProperty::F"
+    cdef BulkProperty BULK_Q "BulkProperty::Q"
+    cdef BulkProperty BULK_TYPE "BulkProperty::TYPE"
+
+    vector[double] get_particles_property(const vector[int] & ids, BulkProperty prop) except +
+    void set_particles_property(const vector[int] & ids, BulkProperty prop, const vector[double] & values) except +
+    void place_new_particles(const vector[int] & ids, const vector[double] & pos) except +
+
     int place_particle(int part, double p[3])
 
     void set_particle_v(int part, double v[3])
@@ -1593,7 +1593,7 @@ cdef class _ParticleSliceImpl(object):
         mask = np.empty(len(self.id_selection), dtype=np.bool)
         cdef int i
         for i in range(len(self.id_selection) - 1, -1, -1):
-            mask[i] = particle_exists(i)
+            mask[i] = particle_exists(self.id_selection[i])
         self.id_selection = self.id_selection[mask]
 
     def __iter__(self):
@@ -1832,16 +1832,10 @@ cdef class ParticleList(object):
         else:
             return self._place_new_particle(P)
 
-    def _place_new_particle(self, P):
-        # Handling of particle id
-        if not "id" in P:
-            # Generate particle id
-            P["id"] = max_seen_particle + 1
-        else:
-            if particle_exists(P["id"]):
-                raise Exception("Particle %d already exists." % P["id"])
+    def _check_contradicting_attributes(self, P):
+        """Prevent setting of contradicting attributes.
 
-        # Prevent setting of contradicting attributes
+        """
         IF DIPOLES:
             if 'dip' in P and 'dipm' in P:
                 raise ValueError("Contradicting attributes: dip and dipm. Setting\
@@ -1852,6 +1846,17 @@ dip is sufficient as the length of the vector defines the scalar dipole moment."
 Setting dip overwrites the rotation of the particle around the dipole axis.\
 Set quat and scalar dipole moment (dipm) instead.")
 
+    def _place_new_particle(self, P):
+        # Handling of particle id
+        if not "id" in P:
+            # Generate particle id
+            P["id"] = max_seen_particle + 1
+        else:
+            if particle_exists(P["id"]):
+                raise Exception("Particle %d already exists." % P["id"])
+
+        self._check_contradicting_attributes(P)
+
         # The ParticleList[]-getter ist not valid yet, as the particle
         # doesn't yet exist. Hence, the setting of position has to be
         # done here. the code is from the pos:property of ParticleHandle
@@ -1880,13 +1885,34 @@ Set quat and scalar dipole moment (dipm) instead.")
             raise ValueError(
                 "When adding several particles at once, all lists of attributes have to have the same size")
 
-        # Place new particles and collect ids
-        ids = []
-        for i in range(n_parts):
+        self._check_contradicting_attributes(Ps)
+
+        if "id" in Ps:
+            if not all(is_valid_type(i, int) for i in Ps["id"]):
+                raise ValueError("Particle ids must be integers.")
+            ids = [int(i) for i in Ps["id"]]
+        else:
+            ids = list(range(max_seen_particle + 1,
+                             max_seen_particle + 1 + n_parts))
+
+        # Place all particles and set the properties which support it
+        # with one collective exchange each, the rest per particle
+        pos = np.array(Ps["pos"], dtype=float)
+        if pos.shape != (n_parts, 3):
+            raise ValueError("Postion must be 3 floats.")
+        place_new_particles(ids, pos.flatten())
+
+        for k in Ps:
+            if k in _bulk_properties and k != "pos":
+                _set_bulk_property(ids, k, Ps[k])
+
+        for i, id in enumerate(ids):
             P = {}
             for k in Ps:
-                P[k] = Ps[k][i]
-            ids.append(self._place_new_particle(P).id)
+                if k not in _bulk_properties and k != "id":
+                    P[k] = Ps[k][i]
+            if P != {}:
+                self[id].update(P)
 
         return self[ids]
 
@@ -2099,6 +2125,52 @@ Set quat and scalar dipole moment (dipm) instead.")
                 "select() takes either selection function as positional argument or a set of keyword arguments.")
 
 
+# Properties which are read and written for all particles of a slice
+# with one collective exchange, with their shape and type per particle
+_bulk_properties = {"pos": ((3,), float),
+                    "v": ((3,), float),
+                    "f": ((3,), float),
+                    "type": ((), int)}
+IF ELECTROSTATICS:
+    _bulk_properties["q"] = ((), float)
+
+
+cdef BulkProperty _bulk_property(attribute):
+    if attribute == "pos":
+        return BULK_POS
+    if attribute == "v":
+        return BULK_V
+    if attribute == "f":
+        return BULK_F
+    if attribute == "q":
+        return BULK_Q
+    return BULK_TYPE
+
+
+def _get_bulk_property(ids, attribute):
+    shape, dtype = _bulk_properties[attribute]
+    values = np.array(get_particles_property(
+        ids, _bulk_property(attribute)), dtype=dtype)
+    return values.reshape((len(ids),) + shape)
+
+
+def _set_bulk_property(ids, attribute, values):
+    shape, dtype = _bulk_properties[attribute]
+    values = np.asarray(values)
+    if dtype is int and values.size and (
+            not np.issubdtype(values.dtype, np.integer) or np.min(values) < 0):
+        raise ValueError("{} must be an integer >= 0".format(attribute))
+
+    if values.shape == shape:
+        values = np.broadcast_to(values, (len(ids),) + shape)
+    elif values.shape != (len(ids),) + shape:
+        raise Exception("Shape of value (%s) does not broadcast to shape of attribute (%s)." % (
+            values.shape, shape))
+
+    set_particles_property(ids, _bulk_property(attribute),
+                           values.astype(float).flatten())
+
+
 def set_slice_one_for_all(particle_slice, attribute, values):
     for i in particle_slice.id_selection:
         setattr(ParticleHandle(i), attribute, values)
@@ -2162,6 +2234,11 @@ def _add_particle_slice_properties():
 
             return
 
+        elif attribute in _bulk_properties:
+            _set_bulk_property(particle_slice.id_selection, attribute, values)
+
+            return
+
         else:
             target = getattr(
                 ParticleHandle(particle_slice.id_selection[0]), attribute)
@@ -2202,6 +2279,9 @@ def _add_particle_slice_properties():
         if N == 0:
             return np.empty(0, dtype=type(None))
 
+        if attribute in _bulk_properties:
+            return _get_bulk_property(particle_slice.id_selection, attribute)
+
         # get first slice member to determine its type
         target = getattr(ParticleHandle(
             particle_slice.id_selection[0]), attribute)
@@ -0,0 +1,211 @@
+#
+# Copyright (C) 2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+"""
+Persistent cache for the parameters found by the tuning routines of the
+long-range solvers.
+
+The timing-based tuning of P3M, dipolar P3M and MMM1D has to be repeated
+every time a script starts, although scripts in a job array usually set
+up the same system over and over again. The cache stores the tuned
+parameters in a JSON file, keyed on everything the tuning depends on:
+the method and its user-supplied parameters, the box geometry, the
+number of particles and the sum of the squared charges or dipole moments,
+the node grid, the Verlet skin and the compiled-in features. A later
+activation with the same key reuses the stored parameters instead of
+tuning again.
+
+"""
+from __future__ import print_function, absolute_import
+import fcntl
+import json
+import os
+import tempfile
+import numpy as np
+
+from . import code_info
+from .cellsystem import CellSystem
+from .globals import Globals
+from .particle_data import ParticleList
+
+#: Environment variable naming the cache file used by all actors which do
+#: not set the ``tuning_cache`` parameter explicitly.
+ENV_VARIABLE = "ESPRESSO_TUNING_CACHE"
+
+
+def _plain(value):
+    """Convert numpy types to their JSON-serializable equivalents."""
+    if isinstance(value, np.ndarray):
+        return value.tolist()
+    if isinstance(value, np.generic):
+        return value.item()
+    if isinstance(value, (list, tuple)):
+        return [_plain(v) for v in value]
+    return value
+
+
+def _rounded(value):
+    """Round floats so that the key is insensitive to summation order."""
+    return float("%.12g" % value)
+
+
+def system_state(moment):
+    """
+    Collect the state of the system the tuning result depends on.
+
+    Parameters
+    ----------
+    moment : :obj:`str`
+        Name of the particle property the method acts on, ``'q'`` for
+        electrostatics or ``'dipm'`` for magnetostatics.
+
+    """
+    cell_system = CellSystem()
+    box = Globals()
+    n_part = len(ParticleList())
+    if n_part:
+        moments = np.asarray(getattr(ParticleList()[:], moment), dtype=float)
+    else:
+        moments = np.zeros(0)
+    return {"box_l": _plain(box.box_l),
+            "periodicity": [bool(p) for p in box.periodicity],
+            "n_part": n_part,
+            "n_" + moment: int(np.count_nonzero(moments)),
+            "sum_" + moment + "2": _rounded(np.sum(moments**2)),
+            "node_grid": _plain(cell_system.node_grid),
+            "skin": _rounded(cell_system.skin),
+            "features": code_info.features()}
+
+
+class TuningCache(object):
+    """
+    Tuned parameters of the long-range solvers stored in a JSON file.
+
+    Parameters
+    ----------
+    filename : :obj:`str`
+        Path of the cache file. It is created on the first store.
+
+    """
+
+    def __init__(self, filename):
+        self.filename = filename
+
+    def key(self, method, params, moment):
+        """
+        Build the cache key of a tuning run.
+
+        Parameters
+        ----------
+        method : :obj:`str`
+            Name of the long-range method.
+        params : :obj:`dict`
+            User-supplied parameters the tuning depends on.
+        moment : :obj:`str`
+            See :func:`system_state`.
+
+        """
+        state = system_state(moment)
+        state["method"] = method
+        state["params"] = dict((k, _plain(v)) for k, v in params.items())
+        return json.dumps(state, sort_keys=True)
+
+    def _load(self):
+        try:
+            with open(self.filename, "r") as f:
+                return json.load(f)
+        except (IOError, OSError, ValueError):
+            return {}
+
+    def lookup(self, key):
+        """Return the stored parameters for ``key`` or ``None``."""
+        return self._load().get(key)
+
+    def store(self, key, params):
+        """
+        Store the tuned parameters for ``key``. The file is replaced
+        atomically, so that concurrent jobs sharing a cache never read a
+        partially written file, and the update holds a lock on the
+        sidecar file ``<filename>.lock``, so that they do not drop each
+        other's entries.
+
+        """
+        directory = os.path.dirname(os.path.abspath(self.filename))
+        with open(self.filename + ".lock", "a") as lock:
+            fcntl.flock(lock, fcntl.LOCK_EX)
+            try:
+                entries = self._load()
+                entries[key] = dict((k, _plain(v)) for k, v in params.items())
+                fd, tmp = tempfile.mkstemp(dir=directory, suffix=".tmp")
+                with os.fdopen(fd, "w") as f:
+                    json.dump(entries, f, indent=1, sort_keys=True)
+                # mkstemp creates the file readable by the owner only
+                umask = os.umask(0)
+                os.umask(umask)
+                os.chmod(tmp, 0o666 & ~umask)
+                os.rename(tmp, self.filename)
+            finally:
+                fcntl.flock(lock, fcntl.LOCK_UN)
+
+    def __len__(self):
+        return len(self._load())
+
+
+def cached_tune(actor, method, input_keys, result_keys, moment="q"):
+    """
+    Tune ``actor`` or take its parameters from the cache.
+
+    The cache file is given by the ``tuning_cache`` parameter of the actor
+    or, if that is ``None``, by the environment variable
+    ``ESPRESSO_TUNING_CACHE``. Without a cache file, this simply calls the
+    tuning routine of the actor. If the ``retune`` parameter of the actor
+    is set, the tuning is always performed and the stored entry is
+    replaced.
+
+    Parameters
+    ----------
+    actor : :class:`espressomd.actors.Actor`
+        The actor to tune. Its ``_tune()`` method stores the tuned
+        parameters in ``actor._params``.
+    method : :obj:`str`
+        Name of the long-range method.
+    input_keys : :obj:`list` of :obj:`str`
+        Parameters of the actor which enter the key.
+    result_keys : :obj:`list` of :obj:`str`
+        Tuned parameters of the actor which are stored.
+    moment : :obj:`str`
+        See :func:`system_state`.
+
+    """
+    filename = actor._params.get("tuning_cache") or os.environ.get(
+        ENV_VARIABLE)
+    if not filename:
+        actor._tune()
+        return
+
+    cache = TuningCache(filename)
+    key = cache.key(method, dict((k, actor._params[k])
+                                 for k in input_keys), moment)
+    if not actor._params.get("retune", False):
+        cached = cache.lookup(key)
+        if cached is not None:
+            actor._params.update(cached)
+            return
+
+    actor._tune()
+    cache.store(key, dict((k, actor._params[k]) for k in result_keys))
@@ -84,6 +84,21 @@ class AnalyzeDistance(ut.TestCase):
                                    self.min_dist(),
                                    delta=1e-7)
 
+    def test_min_dist_cell_system(self):
+        # pairs within the interaction range are found in the cell system,
+        # otherwise all pairs are checked
+        for cutoff in [8., 0.1]:
+            self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+                epsilon=1., sigma=0.1, cutoff=cutoff, shift=0.)
+            for i in range(5):
+                self.system.part[:].pos = np.random.random(
+                    (len(self.system.part), 3)) * BOX_L
+                self.assertAlmostEqual(self.system.analysis.min_dist(),
+                                       self.min_dist(),
+                                       delta=1e-7)
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=0., sigma=0., cutoff=0., shift=0.)
+
     def test_min_dist_empty(self):
         self.system.part.clear()
         self.assertEqual(self.system.analysis.min_dist(), float("inf"))
@@ -0,0 +1,77 @@
+# Copyright (C) 2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+from __future__ import print_function
+import unittest as ut
+import unittest_decorators as utx
+import numpy as np
+import espressomd
+
+BOX_L = 12.
+
+
+@utx.skipIfMissingFeatures("P3M")
+class AnalyzeStructureFactor(ut.TestCase):
+
+    """
+    Compare the structure factor from the Fourier transformed density mesh
+    with the direct sum over the particles.
+
+    """
+    system = espressomd.System(box_l=3 * [BOX_L])
+    system.cell_system.skin = 0.4
+    np.random.seed(1234)
+
+    def setUp(self):
+        self.system.part.add(pos=np.random.random((500, 3)) * BOX_L,
+                             type=np.random.randint(3, size=500))
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.box_l = 3 * [BOX_L]
+
+    def test_mesh(self):
+        order = 5
+        q, sf = self.system.analysis.structure_factor(
+            sf_types=[0, 1], sf_order=order)
+        q_mesh, sf_mesh = self.system.analysis.structure_factor(
+            sf_types=[0, 1], sf_order=order, mesh=32, cao=5)
+        np.testing.assert_allclose(q_mesh, q)
+        np.testing.assert_allclose(sf_mesh, sf, rtol=1e-3)
+
+    def test_moved_particles(self):
+        # move the particles across the node domains without integrating
+        self.system.part[:].pos = np.random.random((500, 3)) * BOX_L
+        order = 5
+        q, sf = self.system.analysis.structure_factor(
+            sf_types=[0, 1, 2], sf_order=order)
+        q_mesh, sf_mesh = self.system.analysis.structure_factor(
+            sf_types=[0, 1, 2], sf_order=order, mesh=32, cao=5)
+        np.testing.assert_allclose(q_mesh, q)
+        np.testing.assert_allclose(sf_mesh, sf, rtol=1e-3)
+
+    def test_errors(self):
+        with self.assertRaises(Exception):
+            self.system.analysis.structure_factor(
+                sf_types=[0], sf_order=5, mesh=10)
+        self.system.box_l = [BOX_L, BOX_L, 2 * BOX_L]
+        with self.assertRaises(Exception):
+            self.system.analysis.structure_factor(
+                sf_types=[0], sf_order=5, mesh=32)
+
+
+if __name__ == "__main__":
+    ut.main()
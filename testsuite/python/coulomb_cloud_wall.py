@@ -133,6 +133,22 @@ class CoulombCloudWall(ut.TestCase):
         self.S.integrator.run(0)
         self.compare("p3m", energy=True, prefactor=3)
 
+    @utx.skipIfMissingFeatures(["P3M"])
+    def test_p3m_analytical_differentiation(self):
+        """
+        This checks P3M with the forces obtained from the gradient
+        of the charge assignment function.
+
+        """
+
+        self.S.actors.add(
+            espressomd.electrostatics.P3M(
+                prefactor=3, r_cut=1.001, accuracy=1e-3,
+                mesh=64, cao=7, alpha=2.70746, tune=False,
+                analytical_differentiation=True))
+        self.S.integrator.run(0)
+        self.compare("p3m", energy=True, prefactor=3)
+
     @utx.skipIfMissingGPU(skip_ci_amd=True)
     def test_p3m_gpu(self):
             self.S.actors.add(
@@ -79,6 +79,15 @@ class CoulombCloudWallTune(ut.TestCase):
         self.system.integrator.run(0)
         self.compare("p3m")
 
+    @utx.skipIfMissingFeatures(["P3M"])
+    def test_p3m_analytical_differentiation(self):
+        self.system.actors.add(
+            espressomd.electrostatics.P3M(prefactor=1., accuracy=5e-4,
+                                          tune=True,
+                                          analytical_differentiation=True))
+        self.system.integrator.run(0)
+        self.compare("p3m_ad")
+
     @utx.skipIfMissingGPU(skip_ci_amd=True)
     def test_p3m_gpu(self):
         # We have to add some tolerance here, because the reference
@@ -0,0 +1,117 @@
+#
+# Copyright (C) 2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import itertools
+import unittest as ut
+import unittest_decorators as utx
+import numpy as np
+
+import espressomd
+import espressomd.magnetostatics
+
+"""
+Check the forces, torques and energy of the Barnes-Hut tree code for
+magnetic dipoles against the direct sum.
+
+"""
+
+
+def direct_sum(pos, dip, box_l, n_replica, periodic):
+    """Fields and forces of all dipoles, including the periodic images
+    up to ``n_replica`` box lengths in spherical order."""
+    n = [n_replica if p else 0 for p in periodic]
+    B = np.zeros_like(pos)
+    F = np.zeros_like(pos)
+    for shift in itertools.product(*[range(-k, k + 1) for k in n]):
+        if np.dot(shift, shift) > n_replica**2:
+            continue
+        R = pos[:, np.newaxis, :] - pos[np.newaxis, :, :] - \
+            np.multiply(shift, box_l)
+        r2 = np.sum(R**2, axis=2)
+        if not any(shift):
+            np.fill_diagonal(r2, np.inf)
+        ir3 = r2**-1.5
+        ir5 = ir3 / r2
+        ir7 = ir5 / r2
+        Rm = np.einsum("ijk,jk->ij", R, dip)
+        Rmu = np.einsum("ijk,ik->ij", R, dip)
+        mmu = np.dot(dip, dip.T)
+        B += np.einsum("ij,ijk->ik", 3. * Rm * ir5, R) - np.dot(ir3, dip)
+        F += np.einsum("ij,ijk->ik", -15. * Rm * Rmu * ir7 + 3. * mmu * ir5, R) \
+            + np.dot(3. * Rmu * ir5, dip) \
+            + np.sum(3. * Rm * ir5, axis=1)[:, np.newaxis] * dip
+    return B, F
+
+
+@utx.skipIfMissingFeatures(["DIPOLES", "ROTATION"])
+class DipolarBarnesHutCpu(ut.TestCase):
+    system = espressomd.System(box_l=[1.0, 1.0, 1.0])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+
+    def setUp(self):
+        np.random.seed(42)
+        self.system.box_l = [10., 10., 10.]
+        n = 300
+        self.system.part.add(pos=np.random.random((n, 3)) * self.system.box_l,
+                             dip=np.random.normal(size=(n, 3)))
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.part.clear()
+        self.system.periodicity = [1, 1, 1]
+
+    def check(self, prefactor, accuracy, n_replica):
+        bh = espressomd.magnetostatics.DipolarBarnesHutCpu(
+            prefactor=prefactor, accuracy=accuracy, n_replica=n_replica)
+        self.system.actors.add(bh)
+        self.assertGreater(bh.get_params()["theta"], 0.)
+        self.system.integrator.run(0, recalc_forces=True)
+
+        pos = np.copy(self.system.part[:].pos_folded)
+        dip = np.copy(self.system.part[:].dip)
+        B, F = direct_sum(pos, dip, self.system.box_l, n_replica,
+                          self.system.periodicity)
+        F *= prefactor
+        T = prefactor * np.cross(dip, B)
+        energy = -0.5 * prefactor * np.sum(dip * B)
+
+        def rms_error(a, b):
+            return np.sqrt(np.sum((a - b)**2) / np.sum(b**2))
+
+        # the tuning only estimates the error from a sample of the dipoles
+        self.assertLess(rms_error(self.system.part[:].f, F), 2. * accuracy)
+        self.assertLess(rms_error(self.system.part[:].torque_lab, T),
+                        2. * accuracy)
+        self.assertAlmostEqual(
+            self.system.analysis.energy()["dipolar"] / energy, 1.,
+            delta=2. * accuracy)
+
+    def test_open(self):
+        self.system.periodicity = [0, 0, 0]
+        self.check(prefactor=1.7, accuracy=1e-3, n_replica=0)
+        self.system.actors.clear()
+        self.check(prefactor=1.7, accuracy=1e-5, n_replica=0)
+
+    def test_periodic(self):
+        self.system.periodicity = [1, 1, 0]
+        self.check(prefactor=0.8, accuracy=1e-4, n_replica=2)
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -18,6 +18,7 @@
 #
 from __future__ import print_function
 import unittest as ut
+import unittest_decorators as utx
 import espressomd
 import numpy as np
 
@@ -64,5 +65,56 @@ class DomainDecomposition(ut.TestCase):
         self.assertGreaterEqual(n_cells, cs.min_num_cells)
         self.assertLessEqual(n_cells, cs.max_num_cells)
 
+    def balance_setup(self):
+        s = self.system
+        s.time_step = 0.001
+        s.cell_system.skin = 0.2
+        s.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=.4, cutoff=.8, shift="auto")
+
+        # Dense cluster in one corner of the box ...
+        dense = .25 + .5 * np.mgrid[0:8, 0:8, 0:8].reshape(3, -1).T
+        # ... and a coarse lattice in the rest
+        dilute = 1. + 2. * np.mgrid[0:5, 0:5, 0:5].reshape(3, -1).T
+        dilute = dilute[np.any(dilute > 4.5, axis=1)]
+        s.part.add(pos=np.vstack((dense, dilute)))
+
+    @utx.skipIfMissingFeatures(["LENNARD_JONES"])
+    def test_balance(self):
+        s = self.system
+        self.balance_setup()
+        n_part = len(s.part)
+
+        s.integrator.run(1)
+        f_regular = np.copy(s.part[:].f)
+        dist_regular = s.cell_system.resort()
+
+        s.part.clear()
+        self.balance_setup()
+        s.cell_system.set_domain_decomposition(
+            use_verlet_lists=False, balance_interval=1)
+        self.assertEqual(s.cell_system.get_state()["balance_interval"], 1)
+        s.integrator.run(1)
+        f_balanced = np.copy(s.part[:].f)
+        dist_balanced = s.cell_system.resort()
+
+        # The forces do not depend on the decomposition
+        self.assertEqual(sum(dist_balanced), n_part)
+        np.testing.assert_allclose(f_balanced, f_regular, rtol=1e-8,
+                                   atol=1e-8)
+
+        if s.cell_system.get_state()["n_nodes"] > 1:
+            self.assertLess(max(dist_balanced), max(dist_regular))
+            self.assertLessEqual(max(dist_balanced), 1.5 * n_part /
+                                 len(dist_balanced))
+
+        # Switching load balancing off restores the equal domains
+        s.cell_system.set_domain_decomposition(use_verlet_lists=False)
+        self.assertEqual(s.cell_system.resort(), dist_regular)
+
+        s.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=0., sigma=0., cutoff=0., shift=0.)
+
+
 if __name__ == "__main__":
     ut.main()
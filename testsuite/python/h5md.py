@@ -110,6 +110,14 @@ class CommonTests(ut.TestCase):
             np.array([x for (_, x) in sorted(zip(self.py_id, self.py_f))])),
             msg="Forces not written correctly by H5md!")
 
+    def test_static_data(self):
+        """Test if unchanged species and masses are written only once."""
+        self.assertEqual(
+            len(self.py_file['particles/atoms/position/value']), 2)
+        self.assertEqual(len(self.py_file['particles/atoms/species/value']), 1)
+        self.assertEqual(len(self.py_file['particles/atoms/species/step']), 1)
+        self.assertEqual(len(self.py_file['particles/atoms/mass/value']), 1)
+
     def test_bonds(self):
         """Test if bonds have been written properly."""
         self.assertEqual(len(self.py_bonds), npart - 1)
@@ -140,6 +148,7 @@ class H5mdTestOrdered(CommonTests):
             write_mass=True,
             write_ordered=write_ordered)
         h5.write()
+        h5.write()
         h5.flush()
         h5.close()
         cls.py_file = h5py.File("test.h5", 'r')
@@ -180,6 +189,7 @@ class H5mdTestUnordered(CommonTests):
             write_mass=True,
             write_ordered=write_ordered)
         h5.write()
+        h5.write()
         h5.flush()
         h5.close()
         cls.py_file = h5py.File("test.h5", 'r')
@@ -195,9 +205,93 @@ class H5mdTestUnordered(CommonTests):
         os.remove("test.h5")
 
 
+@utx.skipIfMissingFeatures(['H5MD'])
+class H5mdTestStaticData(ut.TestCase):
+
+    """
+    Test that species, masses, charges and bonds are written again when
+    they change.
+    """
+    system = CommonTests.system
+    changed = 3
+
+    @classmethod
+    def setUpClass(cls):
+        from espressomd.io.writer import h5md  # pylint: disable=import-error
+        system = cls.system
+        p = system.part[cls.changed]
+        h5 = h5md.H5md(
+            filename="test_static.h5",
+            write_species=True,
+            write_mass=True,
+            write_charge=True,
+            write_ordered=True)
+        h5.write()
+        system.time = system.time_step
+        h5.write()
+        system.time = 2 * system.time_step
+        p.type = 24
+        if espressomd.has_features(['MASS']):
+            p.mass = 1.5
+        if espressomd.has_features(['ELECTROSTATICS']):
+            p.q = 1.0
+        p.delete_bond((CommonTests.vb, cls.changed + 1))
+        h5.write()
+        h5.flush()
+        h5.close()
+
+        # restore the system for the other tests
+        system.time = 0.
+        p.type = 23
+        if espressomd.has_features(['MASS']):
+            p.mass = 2.3
+        if espressomd.has_features(['ELECTROSTATICS']):
+            p.q = 0.0
+        p.add_bond((CommonTests.vb, cls.changed + 1))
+
+        cls.py_file = h5py.File("test_static.h5", 'r')
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.py_file.close()
+        os.remove("test_static.h5")
+
+    def check_static(self, name, old, new):
+        """The property is written at step 0 and after it changed at step 2,
+        with its own step dataset."""
+        self.assertEqual(
+            list(self.py_file['particles/atoms/id/step']), [0, 1, 2])
+        self.assertEqual(
+            list(self.py_file['particles/atoms/{}/step'.format(name)]), [0, 2])
+        values = self.py_file['particles/atoms/{}/value'.format(name)]
+        self.assertEqual(len(values), 2)
+        expected = npart * [old]
+        np.testing.assert_allclose(values[0], expected)
+        expected[self.changed] = new
+        np.testing.assert_allclose(values[1], expected)
+
+    def test_species(self):
+        self.check_static('species', 23, 24)
+
+    @utx.skipIfMissingFeatures(['MASS'])
+    def test_mass(self):
+        self.check_static('mass', 2.3, 1.5)
+
+    @utx.skipIfMissingFeatures(['ELECTROSTATICS'])
+    def test_charge(self):
+        self.check_static('charge', 0.0, 1.0)
+
+    def test_bonds(self):
+        """The connectivity is replaced by the bonds of the last write."""
+        bonds = [list(b) for b in self.py_file['connectivity/atoms']]
+        expected = [[i, i + 1] for i in range(npart - 1) if i != self.changed]
+        self.assertEqual(bonds, expected)
+
+
 if __name__ == "__main__":
     suite = ut.TestSuite()
     suite.addTests(ut.TestLoader().loadTestsFromTestCase(H5mdTestUnordered))
     suite.addTests(ut.TestLoader().loadTestsFromTestCase(H5mdTestOrdered))
+    suite.addTests(ut.TestLoader().loadTestsFromTestCase(H5mdTestStaticData))
     result = ut.TextTestRunner(verbosity=4).run(suite)
     sys.exit(not result.wasSuccessful())
@@ -0,0 +1,145 @@
+#
+# Copyright (C) 2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import unittest as ut
+import unittest_decorators as utx
+import numpy as np
+import espressomd
+
+"""
+Check the Anderson mixing and the extrapolation of the induced charges of
+ICC against the damped fixed-point iteration, for two electrodes with a
+moving dipole in between.
+
+"""
+
+
+@utx.skipIfMissingFeatures(["P3M", "EXTERNAL_FORCES"])
+class IccAnderson(ut.TestCase):
+    S = espressomd.System(box_l=[1.0, 1.0, 1.0])
+    S.seed = S.cell_system.get_state()['n_nodes'] * [1234]
+    n_nodes = S.cell_system.get_state()['n_nodes']
+    node_grid = list(S.cell_system.node_grid)
+    # Parameters
+    box_l = 20.0
+    nicc = 10
+    q_test = 10.0
+    q_dist = 5.0
+
+    def tearDown(self):
+        self.S.actors.clear()
+        self.S.part.clear()
+        self.S.cell_system.node_grid = self.node_grid
+
+    def setup_system(self, axis, **icc_params):
+        """Electrodes normal to ``axis``, at 0 and ``box_l``."""
+        from espressomd.electrostatics import P3M
+        from espressomd.electrostatic_extensions import ICC
+
+        S = self.S
+        box_l = self.box_l
+        nicc = self.nicc
+
+        def rotate(v):
+            return np.roll(v, axis - 2)
+
+        S.box_l = rotate([box_l, box_l, box_l + 5.0])
+        S.cell_system.skin = 0.4
+        S.time_step = 0.01
+
+        # ICC particles
+        l = box_l / nicc
+        normals = []
+        for z, q, normal in [(0, -0.0001, 1), (box_l, 0.0001, -1)]:
+            for xi in range(nicc):
+                for yi in range(nicc):
+                    S.part.add(pos=rotate([l * xi, l * yi, z]), q=q,
+                               fix=[1, 1, 1])
+                    normals.append(rotate([0, 0, normal]))
+        n_icc = len(normals)
+
+        # Test Dipole
+        b2 = box_l * 0.5
+        S.part.add(pos=rotate([b2, b2, b2 - self.q_dist / 2]),
+                   q=self.q_test, fix=[1, 1, 1])
+        S.part.add(pos=rotate([b2, b2, b2 + self.q_dist / 2]),
+                   q=-self.q_test, fix=[1, 1, 1])
+
+        # Actors
+        p3m = P3M(prefactor=1, mesh=32, cao=7, accuracy=1e-5)
+        icc = ICC(
+            n_icc=n_icc,
+            convergence=1e-6,
+            relaxation=0.75,
+            ext_field=[0, 0, 0],
+            max_iterations=100,
+            first_id=0,
+            eps_out=1,
+            normals=normals,
+            areas=n_icc * [box_l * box_l / nicc**2],
+            sigmas=n_icc * [0],
+            epsilons=n_icc * [10000000],
+            **icc_params)
+
+        S.actors.add(p3m)
+        S.actors.add(icc)
+        return icc, rotate
+
+    def simulate(self, steps, axis=2, **icc_params):
+        icc, rotate = self.setup_system(axis, **icc_params)
+        self.S.integrator.run(0)
+        iterations = [icc.last_iterations()]
+        # let the test dipole move towards the electrodes
+        self.S.part[-2:].fix = [[0, 0, 0], [0, 0, 0]]
+        self.S.part[-2:].v = [rotate([0.3, 0.2, 0.5]),
+                              rotate([-0.2, 0.1, -0.4])]
+        for _ in range(steps):
+            self.S.integrator.run(1)
+            iterations.append(icc.last_iterations())
+        charges = self.S.part[:].q
+        self.tearDown()
+        return charges, np.array(iterations)
+
+    def test_anderson_and_extrapolation(self):
+        ref, it_ref = self.simulate(20)
+        res, it = self.simulate(20, anderson_depth=5)
+        np.testing.assert_allclose(res, ref, atol=1e-6)
+        self.assertLess(it[0], it_ref[0])
+        self.assertLess(np.sum(it), np.sum(it_ref))
+
+        # extrapolating the charges in time shortens the iteration further
+        res, it_ex = self.simulate(20, anderson_depth=5, extrapolate=True)
+        np.testing.assert_allclose(res, ref, atol=1e-6)
+        self.assertEqual(it_ex[0], it[0])
+        self.assertLess(np.sum(it_ex[3:]), np.sum(it[3:]))
+
+    def test_nodes_without_icc_particles(self):
+        # the electrodes are normal to x and the nodes are stacked along
+        # x, so with more than two nodes the inner ones hold no ICC
+        # particles
+        node_grid = [self.n_nodes, 1, 1]
+        self.S.cell_system.node_grid = node_grid
+        ref, _ = self.simulate(5, axis=0)
+        self.S.cell_system.node_grid = node_grid
+        res, _ = self.simulate(5, axis=0, anderson_depth=5,
+                               extrapolate=True)
+        np.testing.assert_allclose(res, ref, atol=1e-6)
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -0,0 +1,98 @@
+# Copyright (C) 2010-2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+import unittest as ut
+import unittest_decorators as utx
+import itertools
+import numpy as np
+
+import espressomd
+import espressomd.lb
+import espressomd.lbboundaries
+import espressomd.shapes
+
+"""
+Check that the CPU LB collision of blocks of nodes gives the same
+populations as the collision node by node.
+
+The rows of the lattice along x are collided in blocks of eight nodes,
+except for the blocks with boundary nodes and the remainders, which are
+collided node by node. A fluid on a 16x4x4 lattice, which is mostly
+collided in blocks, is compared to the same fluid with x and y swapped on
+a 4x16x4 lattice, which is collided node by node only.
+
+"""
+
+AGRID = 1.0
+LB_PARAMETERS = {
+    'agrid': AGRID,
+    'dens': 0.9,
+    'visc': 1.1,
+    'tau': 0.01,
+    'kT': 0.0
+}
+# Index of each velocity with x and y swapped
+SWAP_XY = [0, 3, 4, 1, 2, 5, 6, 7, 8, 10, 9, 15, 16, 17, 18, 11, 12, 13, 14]
+
+
+@utx.skipIfMissingFeatures(["LB_BOUNDARIES"])
+class LBBlockedCollision(ut.TestCase):
+    system = espressomd.System(box_l=[16.0, 4.0, 4.0])
+    system.time_step = LB_PARAMETERS['tau']
+    system.cell_system.skin = 0.4
+    np.random.seed(42)
+    velocities = 0.01 * (np.random.random((16, 4, 4, 3)) - 0.5)
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.lbboundaries.clear()
+
+    def simulate(self, swap, steps):
+        def order(v):
+            return [v[1], v[0], v[2]] if swap else list(v)
+
+        self.system.box_l = order([16.0, 4.0, 4.0])
+        lbf = espressomd.lb.LBFluid(
+            ext_force_density=order([0.01, 0.005, 0.0]), **LB_PARAMETERS)
+        self.system.actors.add(lbf)
+        # the boundary nodes are in the middle of a block
+        self.system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+            shape=espressomd.shapes.Sphere(
+                center=order([6.0, 2.0, 2.0]), radius=1.2, direction=1)))
+
+        nodes = list(itertools.product(range(16), range(4), range(4)))
+        for n in nodes:
+            lbf[order(n)].velocity = order(self.velocities[n])
+
+        self.system.integrator.run(steps)
+
+        populations = np.array([lbf[order(n)].population for n in nodes])
+        if swap:
+            populations = populations[:, SWAP_XY]
+        boundaries = np.array([lbf[order(n)].boundary for n in nodes])
+        self.tearDown()
+        return populations, boundaries
+
+    def test_blocks(self):
+        ref, ref_boundaries = self.simulate(True, 10)
+        res, res_boundaries = self.simulate(False, 10)
+        np.testing.assert_array_equal(res_boundaries, ref_boundaries)
+        self.assertTrue(np.any(res_boundaries))
+        np.testing.assert_allclose(res, ref, rtol=1e-10, atol=1e-14)
+
+
+if __name__ == "__main__":
+    ut.main()
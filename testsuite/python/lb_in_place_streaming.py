@@ -0,0 +1,106 @@
+# Copyright (C) 2010-2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+import unittest as ut
+import unittest_decorators as utx
+import itertools
+import numpy as np
+
+import espressomd
+import espressomd.lb
+import espressomd.lbboundaries
+import espressomd.shapes
+
+"""
+Check that the in-place (AA pattern) streaming of the CPU LB gives the
+same populations and particle trajectories as the default push scheme.
+
+"""
+
+AGRID = 1.0
+LB_PARAMETERS = {
+    'agrid': AGRID,
+    'dens': 0.9,
+    'visc': 1.1,
+    'tau': 0.01,
+    'kT': 1e-3,
+    'seed': 42,
+    'ext_force_density': [0.01, 0.0, 0.0]
+}
+
+
+@utx.skipIfMissingFeatures(["LB_BOUNDARIES"])
+class LBInPlaceStreaming(ut.TestCase):
+    system = espressomd.System(box_l=[6.0, 6.0, 8.0])
+    system.time_step = LB_PARAMETERS['tau']
+    system.cell_system.skin = 0.4
+    grid = np.array(system.box_l / AGRID, dtype=int)
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.lbboundaries.clear()
+        self.system.part.clear()
+        self.system.thermostat.turn_off()
+
+    def simulate(self, in_place_streaming, steps):
+        lbf = espressomd.lb.LBFluid(
+            in_place_streaming=in_place_streaming, **LB_PARAMETERS)
+        self.system.actors.add(lbf)
+        self.assertEqual(lbf.get_params()['in_place_streaming'],
+                         in_place_streaming)
+        self.system.thermostat.set_lb(LB_fluid=lbf, seed=23, gamma=2.0)
+        # the boundary nodes of a channel are also boundary nodes in the
+        # halo, which is not the case for a single wall
+        self.system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+            shape=espressomd.shapes.Wall(normal=[0, 0, 1], dist=1.5),
+            velocity=[0.01, 0.0, 0.0]))
+        self.system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+            shape=espressomd.shapes.Wall(normal=[0, 0, -1], dist=-7.0)))
+        self.system.part.add(pos=[[1.2, 3.4, 4.1], [4.9, 0.3, 6.6]],
+                             v=[[0.1, -0.2, 0.3], [-0.3, 0.0, 0.1]])
+        lbf[2, 3, 4].velocity = [0.0, 0.02, -0.01]
+
+        # the populations are written and read between the steps, too
+        self.system.integrator.run(steps // 2)
+        lbf[3, 1, 5].velocity = [0.01, 0.0, 0.01]
+        self.system.integrator.run(steps - steps // 2)
+
+        populations = np.array([lbf[n].population for n in itertools.product(
+            *map(range, self.grid))])
+        velocities = np.array([lbf[n].velocity for n in itertools.product(
+            *map(range, self.grid))])
+        particles = np.copy(self.system.part[:].pos), np.copy(
+            self.system.part[:].v)
+        self.tearDown()
+        return populations, velocities, particles
+
+    def check(self, steps):
+        ref = self.simulate(False, steps)
+        res = self.simulate(True, steps)
+        np.testing.assert_array_equal(res[0], ref[0])
+        np.testing.assert_array_equal(res[1], ref[1])
+        np.testing.assert_array_equal(res[2][0], ref[2][0])
+        np.testing.assert_array_equal(res[2][1], ref[2][1])
+
+    def test_even_steps(self):
+        self.check(20)
+
+    def test_odd_steps(self):
+        self.check(13)
+
+
+if __name__ == "__main__":
+    ut.main()
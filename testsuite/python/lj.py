@@ -81,5 +81,12 @@ class LennardJonesTest(ut.TestCase):
         self.system.integrator.run(recalc_forces=True, steps=0)
         self.check()
 
+    def test_dd_soa(self):
+        self.system.cell_system.set_domain_decomposition(
+            use_verlet_lists=False, use_soa=True)
+        self.system.integrator.run(recalc_forces=True, steps=0)
+
+        self.check()
+
 if __name__ == '__main__':
     ut.main()
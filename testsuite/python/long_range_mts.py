@@ -0,0 +1,95 @@
+# Copyright (C) 2010-2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+import unittest as ut
+import unittest_decorators as utx
+import itertools
+import numpy as np
+
+import espressomd
+import espressomd.electrostatics
+
+"""
+Check the multiple time stepping of the long-range forces: the
+trajectories stay close to the ones with the long-range forces in every
+step, and the energy drift stays small.
+
+"""
+
+
+@utx.skipIfMissingFeatures(["P3M", "WCA"])
+class LongRangeMTS(ut.TestCase):
+    system = espressomd.System(box_l=[10.0, 10.0, 10.0])
+    system.time_step = 0.005
+    system.cell_system.skin = 0.4
+
+    def setUp(self):
+        np.random.seed(42)
+        grid = (np.array(list(itertools.product(range(6), repeat=3))) + 0.5)
+        pos = grid * self.system.box_l[0] / 6
+        pos += 0.1 * (np.random.random(pos.shape) - 0.5)
+        q = np.where(np.sum(grid - 0.5, axis=1) % 2, 1., -1.)
+        self.system.part.add(pos=pos, q=q,
+                             v=np.random.random(pos.shape) - 0.5)
+        self.system.non_bonded_inter[0, 0].wca.set_params(
+            epsilon=1.0, sigma=1.0)
+        p3m = espressomd.electrostatics.P3M(
+            prefactor=1.0, accuracy=1e-3, mesh=32, cao=5, r_cut=2.0,
+            alpha=1.6, tune=False)
+        self.system.actors.add(p3m)
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.part.clear()
+        self.system.non_bonded_inter[0, 0].wca.set_params(
+            epsilon=0.0, sigma=1.0)
+        self.system.integrator.set_vv()
+        self.system.time = 0.
+
+    def simulate(self, interval):
+        self.system.integrator.set_vv(long_range_interval=interval)
+        self.assertEqual(self.system.integrator.long_range_interval, interval)
+        drift = self.system.integrator.energy_drift(400, samples=10)
+        return np.copy(self.system.part[:].pos), drift
+
+    def test_mts(self):
+        ref_pos, ref_drift = self.simulate(1)
+        self.tearDown()
+        self.setUp()
+        pos, drift = self.simulate(4)
+
+        self.assertEqual(len(drift["energy"]), 11)
+        np.testing.assert_allclose(drift["time"][-1], 400 * 0.005)
+        np.testing.assert_allclose(drift["energy"][0], ref_drift["energy"][0])
+        # the impulse only perturbs the trajectories slightly
+        np.testing.assert_allclose(pos, ref_pos, atol=1e-3)
+        # the energy is conserved as well as without multiple time stepping
+        e_scale = abs(drift["energy"][0])
+        self.assertLess(abs(drift["drift"]) * drift["time"][-1],
+                        1e-3 * e_scale)
+        self.assertLess(drift["fluctuation"], 1e-3 * e_scale)
+
+    def test_interval_validation(self):
+        with self.assertRaises(ValueError):
+            self.system.integrator.set_vv(long_range_interval=0)
+        self.system.integrator.set_nvt(long_range_interval=3)
+        self.assertEqual(self.system.integrator.long_range_interval, 3)
+        self.system.integrator.set_vv()
+        self.assertEqual(self.system.integrator.long_range_interval, 1)
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -48,6 +48,11 @@ class MagnetostaticsInteractionsTests(ut.TestCase):
             system, magnetostatics.DipolarDirectSumWithReplicaCpu,
             dict(prefactor=3.4, n_replica=2))
 
+    if espressomd.has_features(["DIPOLES"]):
+        test_DbhCpu = generate_test_for_class(
+            system, magnetostatics.DipolarBarnesHutCpu,
+            dict(prefactor=3.4, accuracy=1e-4, n_replica=1))
+
 
 if __name__ == "__main__":
     ut.main()
@@ -22,6 +22,7 @@ import unittest as ut
 import unittest_decorators as utx
 import tests_common
 import espressomd
+import espressomd.electrostatics
 
 
 if(not espressomd.has_features(("ELECTROSTATICS"))):
@@ -126,5 +127,38 @@ class MMM1D_GPU_Test(ElectrostaticInteractionsTests, ut.TestCase):
 class MMM1D_Test(ElectrostaticInteractionsTests, ut.TestCase):
     from espressomd.electrostatics import MMM1D
 
+
+@utx.skipIfMissingFeatures(["ELECTROSTATICS"])
+class MMM1D_DomainDecomposition_Test(ElectrostaticInteractionsTests,
+                                     ut.TestCase):
+
+    def MMM1D(self, **kwargs):
+        return espressomd.electrostatics.MMM1D(near_cut=2.0, **kwargs)
+
+    def setUp(self):
+        self.system.cell_system.set_domain_decomposition()
+        super().setUp()
+
+    def tearDown(self):
+        super().tearDown()
+        self.system.cell_system.set_n_square()
+
+    def test_table(self):
+        # the tabulated image interaction for the pairs beyond near_cut
+        self.assertEqual(self.mmm1d.image_table_size(), 0)
+        f_direct = np.copy(self.system.part[:].f)
+        self.system.actors.clear()
+        mmm1d = self.MMM1D(prefactor=1.0, maxPWerror=1e-6)
+        self.system.actors.add(mmm1d)
+        self.system.integrator.run(steps=0)
+        self.assertGreater(mmm1d.image_table_size(), 0)
+        f_table = self.system.part[:].f
+        # the interpolated forces are close to the direct ones, but differ
+        self.assertGreater(np.max(np.abs(f_table - f_direct)), 0)
+        np.testing.assert_allclose(f_table, f_direct, atol=1e-5)
+        self.test_forces()
+        self.test_energy()
+
+
 if __name__ == "__main__":
     ut.main()
@@ -0,0 +1,81 @@
+# Copyright (C) 2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+from __future__ import print_function
+import unittest as ut
+import unittest_decorators as utx
+import numpy as np
+
+import espressomd
+import espressomd.electrostatics
+import tests_common
+
+"""
+Check the P3M forces and energy of a random charged system on several
+nodes with several OpenMP threads, where the charge assignment and force
+interpolation are threaded and the FFT redistribution overlaps with the
+1D transforms, against those of a single node with a single thread.
+The reference data was computed with OMP_NUM_THREADS=1 on one node, with
+the parameters below.
+
+"""
+
+P3M_PARAMETERS = {
+    'prefactor': 1.0,
+    'accuracy': 1e-4,
+    'mesh': 32,
+    'cao': 5,
+    'r_cut': 2.0,
+    'alpha': 1.2,
+    'tune': False
+}
+
+
+@utx.skipIfMissingFeatures(["P3M"])
+class P3MThreads(ut.TestCase):
+    system = espressomd.System(box_l=3 * [10.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+    data = np.load(tests_common.abspath("data/p3m_threads_system.npz"))
+
+    def setUp(self):
+        self.system.part.add(pos=self.data['pos'], q=self.data['q'])
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.part.clear()
+
+    def check(self, analytical_differentiation, suffix):
+        self.system.actors.add(espressomd.electrostatics.P3M(
+            analytical_differentiation=analytical_differentiation,
+            **P3M_PARAMETERS))
+        self.system.integrator.run(0)
+        np.testing.assert_allclose(
+            self.system.part[:].f, self.data['f_' + suffix],
+            rtol=1e-9, atol=1e-9)
+        self.assertAlmostEqual(
+            self.system.analysis.energy()['coulomb'],
+            self.data['energy_' + suffix], delta=1e-9)
+
+    def test_ik(self):
+        self.check(False, 'ik')
+
+    def test_ad(self):
+        self.check(True, 'ad')
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -385,8 +385,61 @@ class ParticleSliceTest(ut.TestCase):
         self.assertEqual(self.system.part[0].type, 0)
         self.assertEqual(self.system.part[1].type, 1)
 
+    def test_bulk(self):
+        # the particles of the other tests are kept
+        n_old = len(self.system.part)
+        n = 100
+        pos = np.random.random((n, 3)) * 30. - 10.
+        v = np.random.random((n, 3))
+        types = np.random.randint(5, size=n)
+        ids = 10 + 2 * np.arange(n)[::-1]
+        self.system.part.add(id=ids, pos=pos, v=v, type=types)
+        self.assertEqual(len(self.system.part), n_old + n)
+        for i, pid in enumerate(ids):
+            np.testing.assert_allclose(self.system.part[pid].pos, pos[i])
+            np.testing.assert_array_equal(self.system.part[pid].v, v[i])
+            self.assertEqual(self.system.part[pid].type, types[i])
+
+        # Bulk access in an arbitrary order
+        order = np.random.permutation(ids)
+        sel = self.system.part[order]
+        np.testing.assert_allclose(
+            sel.pos, pos[np.argsort(ids)][(order - 10) // 2])
+        self.assertEqual(sel.type.dtype, np.dtype(int))
+
+        pos_new = np.random.random((n, 3)) * 10.
+        f_new = np.random.random((n, 3))
+        sel.pos = pos_new
+        sel.f = f_new
+        sel.type = 3
+        for i, pid in enumerate(order):
+            np.testing.assert_allclose(self.system.part[pid].pos, pos_new[i])
+            np.testing.assert_array_equal(self.system.part[pid].f, f_new[i])
+            self.assertEqual(self.system.part[pid].type, 3)
+        np.testing.assert_allclose(sel.pos, pos_new)
+
+        with self.assertRaises(ValueError):
+            sel.type = -1
+        with self.assertRaises(ValueError):
+            sel.type = 1.5
+        with self.assertRaises(Exception):
+            sel.v = np.zeros((n - 1, 3))
+        with self.assertRaises(ValueError):
+            self.system.part.add(id=[1, 2], pos=[[0, 0, 0], [1, 1, 1]])
+        with self.assertRaises(ValueError):
+            self.system.part.add(id=[1001, 1002.5],
+                                 pos=[[0, 0, 0], [1, 1, 1]])
+        self.assertFalse(self.system.part.exists(1001))
+        sel.remove()
+        self.assertEqual(len(self.system.part), n_old)
+
     def test_empty(self):
         self.assertTrue(np.array_equal(self.system.part[0:0].pos, np.empty(0)))
+        self.assertEqual(len(self.system.part[0:0].type), 0)
+        old_types = self.system.part[:].type
+        self.system.part[0:0].type = 3
+        self.system.part[0:0].pos = [1., 2., 3.]
+        np.testing.assert_array_equal(self.system.part[:].type, old_types)
 
     def test_len(self):
         self.assertEqual(len(self.system.part[0:0]), 0)
@@ -19,6 +19,7 @@
 
 from __future__ import print_function
 import unittest as ut
+import unittest_decorators as utx
 import espressomd
 import numpy as np
 
@@ -115,5 +116,47 @@ class RdfTest(ut.TestCase):
 
         self.assertTrue(np.allclose(rdf[1], rdf_av[1]))
 
+    def reference_rdf(self, type_list_a, type_list_b, r_min, r_max, r_bins):
+        pos = self.s.part[:].pos
+        types = self.s.part[:].type
+        a = pos[np.isin(types, type_list_a)]
+        b = pos[np.isin(types, type_list_b)]
+        d = a[:, np.newaxis, :] - b[np.newaxis, :, :]
+        d -= np.rint(d / self.s.box_l) * self.s.box_l
+        dist = np.linalg.norm(d, axis=2)
+        if type_list_a == type_list_b:
+            dist = dist[np.triu_indices(len(a), k=1)]
+            n_pairs = 0.5 * len(a) * (len(a) - 1)
+        else:
+            n_pairs = len(a) * len(b)
+        hist = np.histogram(dist, bins=r_bins, range=(r_min, r_max))[0]
+        bins = np.linspace(r_min, r_max, r_bins + 1)
+        bin_volumes = 4. / 3. * np.pi * (bins[1:]**3 - bins[:-1]**3)
+        return hist * self.s.volume() / (bin_volumes * n_pairs)
+
+    @utx.skipIfMissingFeatures("LENNARD_JONES")
+    def test_cell_system(self):
+        s = self.s
+
+        s.part.add(pos=s.box_l * np.random.random((300, 3)),
+                   type=np.arange(300) % 3)
+        s.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=0.1, cutoff=3., shift=0.)
+
+        # r_max within the interaction range uses the cell system,
+        # beyond it the particles are gathered
+        for r_max in [2.5, 4.9]:
+            for type_list_a, type_list_b in [([0, 1], [0, 1]), ([0], [1, 2])]:
+                rdf = s.analysis.rdf(
+                    rdf_type='rdf', type_list_a=type_list_a,
+                    type_list_b=type_list_b, r_min=0.1, r_max=r_max,
+                    r_bins=20)
+                ref = self.reference_rdf(
+                    type_list_a, type_list_b, 0.1, r_max, 20)
+                np.testing.assert_allclose(rdf[1], ref, rtol=1e-10)
+
+        s.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=0., sigma=0., cutoff=0., shift=0.)
+
 if __name__ == "__main__":
     ut.main()
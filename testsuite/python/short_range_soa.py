@@ -0,0 +1,102 @@
+#
+# Copyright (C) 2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+from __future__ import print_function
+import unittest as ut
+import unittest_decorators as utx
+import numpy as np
+import espressomd
+import espressomd.electrostatics
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES", "WCA"])
+class ShortRangeSoATest(ut.TestCase):
+
+    """Compare the forces calculated on the packed particle data,
+       where pairs of types with only LJ/WCA are done by the batched
+       kernel, to the forces of the regular pair loop. The system
+       mixes batched pairs with pairs that need the scalar path
+       (LJ with offset, exclusions). With P3M, the real space Coulomb
+       interaction of the charged pairs is fused into the batched kernel.
+
+    """
+    system = espressomd.System(box_l=3 * [8.])
+
+    def setUp(self):
+        s = self.system
+        s.time_step = .01
+        s.cell_system.skin = 0.3
+        np.random.seed(42)
+
+        # Jittered lattice, so that there are no overlaps
+        n_side = 7
+        lattice = np.mgrid[0:n_side, 0:n_side, 0:n_side].reshape(3, -1).T
+        pos = (lattice + .5) * s.box_l[0] / n_side
+        pos += .25 * (2. * np.random.random(pos.shape) - 1.)
+        n_part = len(pos)
+        s.part.add(pos=pos, type=np.random.randint(3, size=n_part))
+
+        ia = s.non_bonded_inter
+        ia[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=.7, cutoff=1.5, shift="auto")
+        ia[0, 1].wca.set_params(epsilon=.8, sigma=.8)
+        ia[1, 1].lennard_jones.set_params(
+            epsilon=.5, sigma=.6, cutoff=1.2, shift=0., min=.2)
+        ia[1, 1].wca.set_params(epsilon=1.2, sigma=.75)
+        ia[1, 2].lennard_jones.set_params(
+            epsilon=.7, sigma=.6, cutoff=1., shift=0., offset=.1)
+        ia[2, 2].wca.set_params(epsilon=1., sigma=.8)
+
+        if espressomd.has_features("EXCLUSIONS"):
+            for i in range(0, n_part - 1, 10):
+                s.part[i].add_exclusion(i + 1)
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.part.clear()
+        self.system.cell_system.set_domain_decomposition()
+
+    def forces(self, **kwargs):
+        self.system.cell_system.set_domain_decomposition(**kwargs)
+        self.system.integrator.run(recalc_forces=True, steps=0)
+        return np.copy(self.system.part[:].f)
+
+    def test(self):
+        ref = self.forces(use_verlet_lists=False)
+        soa = self.forces(use_verlet_lists=False, use_soa=True)
+
+        self.assertGreater(np.max(np.abs(ref)), 0.)
+        np.testing.assert_allclose(soa, ref, rtol=1e-8, atol=1e-8)
+
+    @utx.skipIfMissingFeatures(["P3M"])
+    def test_p3m(self):
+        q = np.resize([1., -1.], len(self.system.part))
+        q[-1] -= np.sum(q)
+        self.system.part[:].q = q
+        self.system.actors.add(espressomd.electrostatics.P3M(
+            prefactor=1., accuracy=1e-3, r_cut=2., mesh=16, cao=5, alpha=1.5,
+            tune=False))
+
+        ref = self.forces(use_verlet_lists=False)
+        soa = self.forces(use_verlet_lists=False, use_soa=True)
+
+        np.testing.assert_allclose(soa, ref, rtol=1e-8, atol=1e-8)
+
+
+if __name__ == '__main__':
+    ut.main()
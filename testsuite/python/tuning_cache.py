@@ -0,0 +1,134 @@
+#
+# Copyright (C) 2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import os
+import shutil
+import tempfile
+import unittest as ut
+import unittest_decorators as utx
+import numpy as np
+
+import espressomd
+import espressomd.electrostatics
+import espressomd.tuning_cache
+
+"""
+Check that the tuned parameters of the long-range solvers are stored in
+and reused from the tuning cache.
+
+"""
+
+P3M_KEYS = ["prefactor", "accuracy", "r_cut", "mesh", "cao", "inter",
+            "epsilon", "analytical_differentiation"]
+
+
+@utx.skipIfMissingFeatures(["P3M"])
+class TuningCache(ut.TestCase):
+    system = espressomd.System(box_l=[10.0, 10.0, 10.0])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+
+    def setUp(self):
+        self.tmpdir = tempfile.mkdtemp()
+        self.filename = os.path.join(self.tmpdir, "tuning.json")
+        np.random.seed(42)
+        self.system.part.add(pos=np.random.random((100, 3)) * self.system.box_l,
+                             q=np.repeat([-1, 1], 50))
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.part.clear()
+        os.environ.pop(espressomd.tuning_cache.ENV_VARIABLE, None)
+        shutil.rmtree(self.tmpdir)
+
+    def p3m(self, **kwargs):
+        self.system.actors.clear()
+        p3m = espressomd.electrostatics.P3M(prefactor=1.0, accuracy=1e-3,
+                                            **kwargs)
+        self.system.actors.add(p3m)
+        return p3m.get_params()
+
+    def test_reuse(self):
+        tuned = self.p3m(tuning_cache=self.filename)
+        cache = espressomd.tuning_cache.TuningCache(self.filename)
+        self.assertEqual(len(cache), 1)
+        # the file has the default permissions, not the ones of mkstemp
+        umask = os.umask(0)
+        os.umask(umask)
+        self.assertEqual(os.stat(self.filename).st_mode & 0o777,
+                         0o666 & ~umask)
+
+        # overwrite the entry with a different, but valid parameter set;
+        # the next activation has to pick it up instead of tuning
+        p3m = espressomd.electrostatics.P3M(prefactor=1.0, accuracy=1e-3)
+        key = cache.key("P3M", dict((k, p3m._params[k])
+                                    for k in P3M_KEYS), "q")
+        entry = cache.lookup(key)
+        self.assertEqual(entry["cao"], tuned["cao"])
+        self.assertEqual(list(entry["mesh"]), list(tuned["mesh"]))
+        self.assertAlmostEqual(entry["r_cut"], tuned["r_cut"], delta=1e-12)
+        entry["cao"] = 2 if tuned["cao"] != 2 else 3
+        cache.store(key, entry)
+
+        params = self.p3m(tuning_cache=self.filename)
+        self.assertEqual(params["cao"], entry["cao"])
+        self.assertEqual(len(cache), 1)
+
+        # a retune replaces the entry
+        params = self.p3m(tuning_cache=self.filename, retune=True)
+        self.assertEqual(params["cao"], tuned["cao"])
+        self.assertEqual(cache.lookup(key)["cao"], tuned["cao"])
+        self.assertEqual(len(cache), 1)
+
+    def test_key(self):
+        self.p3m(tuning_cache=self.filename)
+        cache = espressomd.tuning_cache.TuningCache(self.filename)
+        self.assertEqual(len(cache), 1)
+
+        # a fixed parameter, a different accuracy and a different charge
+        # distribution all require a new tuning run
+        self.p3m(tuning_cache=self.filename, cao=5)
+        self.assertEqual(len(cache), 2)
+        self.system.actors.clear()
+        p3m = espressomd.electrostatics.P3M(prefactor=1.0, accuracy=2e-3,
+                                            tuning_cache=self.filename)
+        self.system.actors.add(p3m)
+        self.assertEqual(len(cache), 3)
+        self.system.part[[0, 50]].q = [-2, 2]
+        self.p3m(tuning_cache=self.filename)
+        self.assertEqual(len(cache), 4)
+
+        # the same system again is a hit
+        self.p3m(tuning_cache=self.filename)
+        self.assertEqual(len(cache), 4)
+
+    def test_environment(self):
+        self.p3m()
+        self.assertFalse(os.path.exists(self.filename))
+        os.environ[espressomd.tuning_cache.ENV_VARIABLE] = self.filename
+        tuned = self.p3m()
+        cache = espressomd.tuning_cache.TuningCache(self.filename)
+        self.assertEqual(len(cache), 1)
+        params = self.p3m(tune=True)
+        self.assertEqual(params["cao"], tuned["cao"])
+        self.assertAlmostEqual(params["r_cut"], tuned["r_cut"], delta=1e-12)
+        self.assertAlmostEqual(params["alpha"], tuned["alpha"], delta=1e-12)
+
+
+if __name__ == "__main__":
+    ut.main()